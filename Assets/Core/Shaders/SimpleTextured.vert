@@ -8,6 +8,7 @@
 
 #pragma import_defines ( CAST_SHADOWS )
 #pragma import_defines ( ENABLE_ATMOSPHERE )
+#pragma import_defines ( ENABLE_INSTANCING )
 #pragma import_defines ( ENABLE_NORMAL_MAP )
 #pragma import_defines ( FLIP_V )
 
@@ -29,16 +30,37 @@ out vec3 shadowTexCoord;
 out AtmosphericScattering scattering;
 
 uniform mat4 osg_ModelViewProjectionMatrix;
-uniform mat4 modelMatrix;
 uniform vec3 cameraPosition;
 uniform vec3 lightDirection;
 uniform mat4 shadowProjectionMatrix0;
 
 uniform sampler2D cloudSampler;
 
+#ifdef ENABLE_INSTANCING
+uniform samplerBuffer instanceTransformSampler;
+uniform mat4 viewProjectionMatrix;
+
+mat4 getInstanceModelMatrix()
+{
+	int i = gl_InstanceID * 4;
+	return mat4(
+		texelFetch(instanceTransformSampler, i),
+		texelFetch(instanceTransformSampler, i + 1),
+		texelFetch(instanceTransformSampler, i + 2),
+		texelFetch(instanceTransformSampler, i + 3));
+}
+#else
+uniform mat4 modelMatrix;
+#endif
+
 void main()
 {
+#ifdef ENABLE_INSTANCING
+	mat4 modelMatrix = getInstanceModelMatrix();
+	gl_Position = viewProjectionMatrix * (modelMatrix * osg_Vertex);
+#else
 	gl_Position = osg_ModelViewProjectionMatrix * osg_Vertex;
+#endif
 	
 #ifdef CAST_SHADOWS
 	return;
@@ -40,6 +40,7 @@ class SkyboltConan(ConanFile):
         "cpp-httplib/0.10.1",
         "earcut/2.2.3",
         "glm/0.9.9.8",
+        "libpng/[>=1.6 <2]", # Range allows reuse of the version required by OSG
         "nlohmann_json/3.10.5",
 	]
 
@@ -55,6 +56,7 @@ class SkyboltConan(ConanFile):
     def configure(self):
         self.options["openscenegraph-mr"].with_curl = True # Required for loading terrain tiles from http sources
         self.options["bullet3"].double_precision = True
+        self.options["cpp-httplib"].with_openssl = True # Required for fetching terrain tiles from https sources with HttpTileFetcher
         if self.settings.compiler == 'msvc':
             del self.options.fPIC
 
@@ -0,0 +1,142 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "FeatureTileTools.h"
+#include <SkyboltVis/Renderable/Planet/Features/MappedFeatureTile.h>
+#include <SkyboltVis/Renderable/Planet/Features/PlanetFeaturesSource.h>
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <numeric>
+#include <sstream>
+
+namespace skybolt {
+namespace mapfeatures {
+
+namespace fs = std::filesystem;
+
+static std::vector<std::string> findTileFilenames(const std::string& directory)
+{
+	std::vector<std::string> filenames;
+	for (const fs::directory_entry& entry : fs::recursive_directory_iterator(directory))
+	{
+		if (entry.is_regular_file() && entry.path().extension() == ".ftr")
+		{
+			filenames.push_back(entry.path().string());
+		}
+	}
+	std::sort(filenames.begin(), filenames.end());
+	return filenames;
+}
+
+int upgradeFeatureTiles(const std::string& directory)
+{
+	int upgradedCount = 0;
+	for (const std::string& filename : findTileFilenames(directory))
+	{
+		if (MappedFeatureTile::isMappedFormat(filename))
+		{
+			continue;
+		}
+
+		std::vector<FeaturePtr> features;
+		loadTile(filename, features);
+
+		// Write to a temporary file first so that an interrupted upgrade never leaves a truncated tile
+		std::string tempFilename = filename + ".tmp";
+		saveMappedFeatureTile(features, tempFilename);
+		fs::rename(tempFilename, filename);
+		++upgradedCount;
+	}
+	return upgradedCount;
+}
+
+static double elapsedMs(const std::chrono::steady_clock::time_point& start)
+{
+	return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+static double calcMean(const std::vector<double>& values)
+{
+	return values.empty() ? 0.0 : std::accumulate(values.begin(), values.end(), 0.0) / double(values.size());
+}
+
+static double calcP95(std::vector<double> values)
+{
+	if (values.empty())
+	{
+		return 0.0;
+	}
+	size_t index = std::min(values.size() - 1, size_t(0.95 * double(values.size())));
+	std::nth_element(values.begin(), values.begin() + index, values.end());
+	return values[index];
+}
+
+//! Reads every point so that the mapped pages are actually touched, as they would be by a consumer
+static double sumMappedTile(const MappedFeatureTile& tile)
+{
+	double sum = 0;
+	auto sumPoints = [&](const mappedfeaturetile::PointRange& range) {
+		for (const sim::LatLonAlt& point : tile.getPoints(range))
+		{
+			sum += point.alt;
+		}
+	};
+
+	for (const auto& record : tile.getRoads()) { sumPoints(record.points); }
+	for (const auto& record : tile.getBuildings()) { sumPoints(record.points); }
+	for (const auto& record : tile.getWaters()) { sumPoints(record.points); }
+	sum += double(tile.loadAirports().size());
+	return sum;
+}
+
+FeatureTileLoadBenchmark benchmarkFeatureTileLoading(const std::string& directory)
+{
+	std::vector<double> streamTimes;
+	std::vector<double> mappedTimes;
+	volatile double checksum = 0; // Prevents the mapped reads from being optimized away
+
+	const std::string tempFilename = (fs::temp_directory_path() / "skybolt_feature_tile_benchmark.ftr").string();
+
+	for (const std::string& filename : findTileFilenames(directory))
+	{
+		std::vector<FeaturePtr> features;
+		auto start = std::chrono::steady_clock::now();
+		loadTile(filename, features);
+		streamTimes.push_back(elapsedMs(start));
+
+		saveMappedFeatureTile(features, tempFilename);
+
+		start = std::chrono::steady_clock::now();
+		{
+			MappedFeatureTile tile(tempFilename);
+			checksum += sumMappedTile(tile);
+		}
+		mappedTimes.push_back(elapsedMs(start));
+	}
+	fs::remove(tempFilename);
+
+	FeatureTileLoadBenchmark result;
+	result.tileCount = int(streamTimes.size());
+	result.streamMeanMs = calcMean(streamTimes);
+	result.streamP95Ms = calcP95(streamTimes);
+	result.mappedMeanMs = calcMean(mappedTimes);
+	result.mappedP95Ms = calcP95(mappedTimes);
+	return result;
+}
+
+std::string toString(const FeatureTileLoadBenchmark& benchmark)
+{
+	std::ostringstream ss;
+	ss << "Tiles: " << benchmark.tileCount << std::endl;
+	ss << "Stream load: mean " << benchmark.streamMeanMs << " ms, p95 " << benchmark.streamP95Ms << " ms" << std::endl;
+	ss << "Mapped load: mean " << benchmark.mappedMeanMs << " ms, p95 " << benchmark.mappedP95Ms << " ms" << std::endl;
+	return ss.str();
+}
+
+} // namespace mapfeatures
+} // namespace skybolt
@@ -0,0 +1,36 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#pragma once
+
+#include <string>
+
+namespace skybolt {
+namespace mapfeatures {
+
+//! Rewrites all legacy .ftr tiles found recursively in the directory in the memory mapped tile format.
+//! Tiles already in the mapped format are left unchanged.
+//! @return number of tiles upgraded
+int upgradeFeatureTiles(const std::string& directory);
+
+struct FeatureTileLoadBenchmark
+{
+	int tileCount = 0;
+	double streamMeanMs = 0;
+	double streamP95Ms = 0;
+	double mappedMeanMs = 0;
+	double mappedP95Ms = 0;
+};
+
+//! Measures per-tile load latency of all .ftr tiles found recursively in the directory,
+//! comparing stream deserialization into Feature objects against reading the memory mapped format.
+//! Tiles are converted to the mapped format in a temporary file for the comparison.
+FeatureTileLoadBenchmark benchmarkFeatureTileLoading(const std::string& directory);
+
+std::string toString(const FeatureTileLoadBenchmark& benchmark);
+
+} // namespace mapfeatures
+} // namespace skybolt
@@ -5,15 +5,19 @@
  * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
 
 #include "FeaturesConverter.h"
+#include "NodeLocationIndex.h"
 #include <SkyboltSim/Spatial/GreatCircle.h>
 #include <SkyboltVis/Renderable/Planet/Features/PlanetFeaturesHelpers.h>
 #include <SkyboltCommon/Exception.h>
 #include <SkyboltCommon/Math/MathUtility.h>
+#include <px_sched/px_sched.h>
 #include <readosm.h>
+#include <chrono>
 #include <sstream>
 #include <map>
 #include <set>
 #include <iostream>
+#include <unordered_map>
 #include <boost/algorithm/string.hpp>  
 #include <boost/lexical_cast.hpp>
 
@@ -33,34 +37,100 @@ static float calcBuildingHeightFromLevelCount(int levelCount)
 	return buildingGroundLevelHeight * (levelCount - 1) + buildingLevelHeight;
 }
 
-static LatLonAltPoints toLatLonAlt(const LatLonPoints& points, const sim::PlanetAltitudeProvider& provider)
+//! Altitudes are resolved in a batch after parsing, rather than one point at a time while parsing,
+//! so that queries can be spatially sorted and spread across worker threads.
+enum class AltitudeMode
+{
+	PerPoint, //!< Each point is placed on the terrain
+	MinOfPoints //!< All points are placed at the lowest terrain altitude of the points
+};
+
+struct AltitudeJob
+{
+	PolyFeature* feature;
+	AltitudeMode mode;
+};
+
+static LatLonAltPoints toLatLonAltWithZeroAltitude(const LatLonPoints& points)
 {
 	LatLonAltPoints result(points.size());
 	int i = 0;
 	for (const LatLon& point : points)
 	{
-		result[i] = toLatLonAlt(point, provider.getAltitude(point).altitude);
+		result[i] = toLatLonAlt(point, 0.0);
 		++i;
 	}
 	return result;
 }
 
-static LatLonAltPoints toLatLonWithMinAlt(const LatLonPoints& points, const sim::PlanetAltitudeProvider& provider)
+static void resolveAltitude(const AltitudeJob& job, const sim::PlanetAltitudeProvider& provider)
 {
-	LatLonAltPoints result(points.size());
-	double alt = math::posInfinity();
-	for (const LatLon& point : points)
+	LatLonAltPoints& points = job.feature->points;
+	if (job.mode == AltitudeMode::PerPoint)
 	{
-		alt = std::min(alt, provider.getAltitude(point).altitude);
+		for (sim::LatLonAlt& point : points)
+		{
+			point.alt = provider.getAltitude(toLatLon(point)).altitude;
+		}
 	}
+	else
+	{
+		double alt = math::posInfinity();
+		for (const sim::LatLonAlt& point : points)
+		{
+			alt = std::min(alt, provider.getAltitude(toLatLon(point)).altitude);
+		}
 
-	int i = 0;
-	for (const LatLon& point : points)
+		for (sim::LatLonAlt& point : points)
+		{
+			point.alt = alt;
+		}
+	}
+}
+
+//! @returns a key which orders points along a Z-order curve, so that nearby points have nearby keys
+static uint32_t calcSpatialSortKey(const sim::LatLonAlt& point)
+{
+	auto quantize = [] (double value, double range) {
+		return uint32_t(math::clamp((value / range + 0.5) * 65535.0, 0.0, 65535.0));
+	};
+	uint32_t x = quantize(point.lon, 2.0 * piD());
+	uint32_t y = quantize(point.lat, piD());
+
+	uint32_t key = 0;
+	for (int i = 0; i < 16; ++i)
 	{
-		result[i] = toLatLonAlt(point, alt);
-		++i;
+		key |= ((x >> i) & 1u) << (2 * i);
+		key |= ((y >> i) & 1u) << (2 * i + 1);
 	}
-	return result;
+	return key;
+}
+
+static void resolveAltitudes(std::vector<AltitudeJob>& jobs, const sim::PlanetAltitudeProvider& provider, px_sched::Scheduler& scheduler)
+{
+	// Sort jobs spatially so that consecutive queries hit the same elevation tiles
+	std::vector<std::pair<uint32_t, AltitudeJob>> sortedJobs;
+	sortedJobs.reserve(jobs.size());
+	for (const AltitudeJob& job : jobs)
+	{
+		uint32_t key = job.feature->points.empty() ? 0 : calcSpatialSortKey(job.feature->points.front());
+		sortedJobs.emplace_back(key, job);
+	}
+	std::sort(sortedJobs.begin(), sortedJobs.end(), [] (const auto& a, const auto& b) { return a.first < b.first; });
+
+	const size_t jobsPerTask = 1024;
+	px_sched::Sync sync;
+	for (size_t begin = 0; begin < sortedJobs.size(); begin += jobsPerTask)
+	{
+		size_t end = std::min(begin + jobsPerTask, sortedJobs.size());
+		scheduler.run([&sortedJobs, &provider, begin, end] {
+			for (size_t i = begin; i < end; ++i)
+			{
+				resolveAltitude(sortedJobs[i].second, provider);
+			}
+		}, &sync);
+	}
+	scheduler.waitFor(sync);
 }
 
 struct ParserData
@@ -70,8 +140,11 @@ struct ParserData
 		std::vector<long long> nodes;
 	};
 
-	std::map<long long, LatLon> nodes;
-	std::map<long long, Way> ways;
+	NodeLocationIndex nodes;
+	std::vector<long long> requiredNodeIds; //!< Sorted IDs of nodes referenced by features
+	size_t compactedRequiredNodeIdCount = 0;
+	std::vector<long long> relationWayIds; //!< Sorted IDs of ways referenced by relations
+	std::unordered_map<long long, Way> ways; //!< Ways referenced by relations
 
 	struct ParserAirport
 	{
@@ -84,14 +157,15 @@ struct ParserData
 
 	std::vector<FeaturePtr> features;
 	std::map<long long, RoadJunction> nodeRoadJunctions;
+	std::vector<AltitudeJob> altitudeJobs;
 
-	const sim::PlanetAltitudeProvider* altitudeProvider;
+	ReadPbfStats stats;
 };
 
 float getHighwayRoadWidth(int laneCount) {return 3.7f * laneCount;}
 float getResidentialRoadWidth(int laneCount) {return 3.5f * laneCount;}
 
-static int parseNode(const void* user_data, const readosm_node* node)
+static int indexNode(const void* user_data, const readosm_node* node)
 {
 	if (node->latitude == READOSM_UNDEFINED)
 		throw skybolt::Exception("Undefined latitude");
@@ -99,10 +173,14 @@ static int parseNode(const void* user_data, const readosm_node* node)
 		throw skybolt::Exception("Undefined longitude");
 
 	ParserData& data = *(ParserData*)user_data;
-	data.nodes[node->id] = LatLon(node->latitude * degToRadD(), node->longitude * degToRadD());
+	if (std::binary_search(data.requiredNodeIds.begin(), data.requiredNodeIds.end(), node->id))
+	{
+		data.nodes.add(node->id, LatLon(node->latitude * degToRadD(), node->longitude * degToRadD()));
+	}
 
-	if (data.nodes.size() % 1000000 == 0)
-		printf("Loaded %zu nodes\n", data.nodes.size());
+	++data.stats.nodesRead;
+	if (data.stats.nodesRead % 10000000 == 0)
+		printf("Read %zu nodes, indexed %zu\n", data.stats.nodesRead, data.nodes.size());
 
 	return READOSM_OK;
 }
@@ -139,6 +217,13 @@ std::string getTagValueString(const T& object, const char* key)
 	return value ? std::string(value) : "";
 }
 
+template <class T>
+bool tagValueEquals(const T& object, const char* key, const char* value)
+{
+	const char* tagValue = getTagValue(object, key);
+	return tagValue && strcmp(tagValue, value) == 0;
+}
+
 enum class Units
 {
 	Meters,
@@ -208,37 +293,33 @@ static void printTags(const readosm_way& way)
 	}
 }
 
+static void readPoint(long long nodeId, const ParserData& data, std::vector<LatLon>& points)
+{
+	std::optional<LatLon> point = data.nodes.find(nodeId);
+	if (!point)
+	{
+		std::stringstream ss;
+		ss << nodeId;
+		throw skybolt::Exception("Invalid node ID " + ss.str());
+	}
+	points.push_back(*point);
+}
+
 static void readPoints(const readosm_way& way, const ParserData& data, std::vector<LatLon>& points)
 {
+	points.reserve(points.size() + way.node_ref_count);
 	for (int i = 0; i < way.node_ref_count; ++i)
 	{
-		long long nodeId = way.node_refs[i];
-
-		std::map<long long, LatLon>::const_iterator it = data.nodes.find(nodeId);
-		if (it == data.nodes.end())
-		{
-			std::stringstream ss;
-			ss << nodeId;
-			throw skybolt::Exception("Invalid node ID " + ss.str());
-		}
-		points.push_back(it->second);
+		readPoint(way.node_refs[i], data, points);
 	}
 }
 
 static void readPoints(const ParserData::Way& way, const ParserData& data, std::vector<LatLon>& points)
 {
-	for (size_t i = 0; i < way.nodes.size(); ++i)
+	points.reserve(points.size() + way.nodes.size());
+	for (long long nodeId : way.nodes)
 	{
-		long long nodeId = way.nodes[i];
-
-		std::map<long long, LatLon>::const_iterator it = data.nodes.find(nodeId);
-		if (it == data.nodes.end())
-		{
-			std::stringstream ss;
-			ss << nodeId;
-			throw skybolt::Exception("Invalid node ID " + ss.str());
-		}
-		points.push_back(it->second);
+		readPoint(nodeId, data, points);
 	}
 }
 
@@ -291,29 +372,114 @@ bool isClosed(const std::vector<LatLon>& points)
 	return (points.size() >= 2 && points.back() == points.front());
 }
 
+static bool isRoadHighwayType(const char* value)
+{
+	return strcmp(value, "motorway") == 0
+		|| strcmp(value, "motorway_link") == 0
+		|| strcmp(value, "trunk") == 0
+		|| strcmp(value, "primary") == 0
+		|| strcmp(value, "secondary") == 0
+		|| strcmp(value, "tertiary") == 0
+		|| strcmp(value, "residential") == 0;
+}
+
+//! @returns true if parseWay() may create a feature from the way
+static bool isFeatureWay(const readosm_way& way)
+{
+	const char* highway = getTagValue(way, "highway");
+	if (highway && isRoadHighwayType(highway) && !getTag(way, "tunnel"))
+	{
+		return true;
+	}
+
+	if (getTag(way, "building") || getTag(way, "building:part") || tagValueEquals(way, "natural", "water"))
+	{
+		return true;
+	}
+
+	const char* aeroway = getTagValue(way, "aeroway");
+	if (aeroway)
+	{
+		return (strcmp(aeroway, "aerodrome") == 0 && getTag(way, "name"))
+			|| (strcmp(aeroway, "runway") == 0 && getTag(way, "ref"));
+	}
+	return false;
+}
+
+//! @returns true if parseRelation() may create a feature from the relation
+static bool isFeatureRelation(const readosm_relation& relation)
+{
+	return tagValueEquals(relation, "natural", "water")
+		|| (tagValueEquals(relation, "aeroway", "aerodrome") && getTag(relation, "name"));
+}
+
+static void sortAndRemoveDuplicates(std::vector<long long>& ids)
+{
+	std::sort(ids.begin(), ids.end());
+	ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+}
+
+//! First pass. Finds ways referenced by relations.
+static int collectRelationWayIds(const void* user_data, const readosm_relation* relation)
+{
+	ParserData& data = *(ParserData*)user_data;
+	++data.stats.relationsRead;
+
+	if (isFeatureRelation(*relation))
+	{
+		for (int i = 0; i < relation->member_count; ++i)
+		{
+			const readosm_member& member = relation->members[i];
+			if (member.member_type == READOSM_MEMBER_WAY && strcmp(member.role, "outer") == 0)
+			{
+				data.relationWayIds.push_back(member.id);
+			}
+		}
+	}
+	return READOSM_OK;
+}
+
+//! Second pass. Finds nodes referenced by features, and stores ways referenced by relations.
+static int collectWayNodeIds(const void* user_data, const readosm_way* way)
+{
+	ParserData& data = *(ParserData*)user_data;
+	++data.stats.waysRead;
+
+	bool referencedByRelation = std::binary_search(data.relationWayIds.begin(), data.relationWayIds.end(), way->id);
+	if (referencedByRelation)
+	{
+		ParserData::Way& parsedWay = data.ways[way->id];
+		parsedWay.nodes.assign(way->node_refs, way->node_refs + way->node_ref_count);
+	}
+
+	if (referencedByRelation || isFeatureWay(*way))
+	{
+		// Compact the ID list when it doubles in size to bound memory used by nodes shared between ways
+		if (data.requiredNodeIds.size() > 2 * std::max(data.compactedRequiredNodeIdCount, size_t(1000000)))
+		{
+			sortAndRemoveDuplicates(data.requiredNodeIds);
+			data.compactedRequiredNodeIdCount = data.requiredNodeIds.size();
+		}
+		data.requiredNodeIds.insert(data.requiredNodeIds.end(), way->node_refs, way->node_refs + way->node_ref_count);
+	}
+	return READOSM_OK;
+}
+
+//! Final pass. Creates features from ways.
 static int parseWay(const void* user_data, const readosm_way* way)
 {
 	ParserData& data = *(ParserData*)user_data;
 	std::vector<FeaturePtr>& features = data.features;
 
-	ParserData::Way parsedWay;
-	for (int i = 0; i < way->node_ref_count; ++i)
+	if (!isFeatureWay(*way))
 	{
-		parsedWay.nodes.push_back(way->node_refs[i]);
+		return READOSM_OK;
 	}
-	data.ways[way->id] = parsedWay;
 
 	const readosm_tag* tag = getTag(*way, "highway");
 	if (tag)
 	{
-		if (strcmp(tag->value, "motorway") == 0
-			|| strcmp(tag->value, "motorway_link") == 0
-			|| strcmp(tag->value, "trunk") == 0
-			|| strcmp(tag->value, "primary") == 0
-			|| strcmp(tag->value, "secondary") == 0
-			|| strcmp(tag->value, "tertiary") == 0
-			|| strcmp(tag->value, "residential") == 0
-			)
+		if (isRoadHighwayType(tag->value))
 		{
 			if (getTag(*way, "tunnel")) // ignore tunnels
 			{
@@ -340,7 +506,8 @@ static int parseWay(const void* user_data, const readosm_way* way)
 
 				if (latLonPoints.size() >= 2)
 				{
-					road.points = toLatLonAlt(latLonPoints, *data.altitudeProvider);
+					road.points = toLatLonAltWithZeroAltitude(latLonPoints);
+					data.altitudeJobs.push_back({&road, AltitudeMode::PerPoint});
 					features.push_back(roadPtr);
 
 					long long startNode = way->node_refs[0];
@@ -421,7 +588,8 @@ static int parseWay(const void* user_data, const readosm_way* way)
 
 		if (points.size() >= 2)
 		{
-			building.points = toLatLonWithMinAlt(points, *data.altitudeProvider);
+			building.points = toLatLonAltWithZeroAltitude(points);
+			data.altitudeJobs.push_back({&building, AltitudeMode::MinOfPoints});
 			features.push_back(buildingPtr);
 		}
 	}
@@ -439,7 +607,8 @@ static int parseWay(const void* user_data, const readosm_way* way)
 			{
 				std::shared_ptr<Water> waterPtr = std::make_shared<Water>();
 				Water& water = *waterPtr;
-				water.points = toLatLonAlt(points, *data.altitudeProvider);
+				water.points = toLatLonAltWithZeroAltitude(points);
+				data.altitudeJobs.push_back({&water, AltitudeMode::PerPoint});
 				features.push_back(waterPtr);
 			}
 		}
@@ -501,9 +670,13 @@ std::vector<LatLonPoints> readMultiPolygonRelation(const readosm_relation& relat
 		{
 			if (strcmp(member.role, "outer") == 0)
 			{
-				const ParserData::Way& way = data.ways.find(member.id)->second;
+				auto it = data.ways.find(member.id);
+				if (it == data.ways.end())
+				{
+					continue; // way is not in the file, e.g. it was clipped from the extract
+				}
 				LatLonPoints points;
-				readPoints(way, data, points);
+				readPoints(it->second, data, points);
 				if (points.size() >= 2)
 				{
 					parts.emplace_back(points);
@@ -563,9 +736,14 @@ std::vector<LatLonPoints> readMultiPolygonRelation(const readosm_relation& relat
 	return polygons;
 }
 
+//! Final pass. Creates features from relations.
 int parseRelation(const void* user_data, const readosm_relation* relation)
 {
 	ParserData& data = *(ParserData*)user_data;
+	if (!isFeatureRelation(*relation))
+	{
+		return READOSM_OK;
+	}
 
 	if (getTagValueString(*relation, "natural") == "water")
 	{
@@ -575,7 +753,8 @@ int parseRelation(const void* user_data, const readosm_relation* relation)
 		for (const LatLonPoints& polygon : polygons)
 		{
 			auto water = std::make_shared<Water>();
-			water->points = toLatLonAlt(polygon, *data.altitudeProvider);
+			water->points = toLatLonAltWithZeroAltitude(polygon);
+			data.altitudeJobs.push_back({water.get(), AltitudeMode::PerPoint});
 			features.push_back(water);
 		}
 	}
@@ -672,11 +851,9 @@ static void joinRoadsAtJunctions(const ParserData& data)
 	}
 }
 
-ReadPbfResult readPbf(const std::string& filename, const sim::PlanetAltitudeProvider& provider)
+static void parsePbf(const std::string& filename, ParserData& data, readosm_node_callback nodeCallback, readosm_way_callback wayCallback, readosm_relation_callback relationCallback)
 {
-	ParserData data;
-	data.altitudeProvider = &provider;
-	const void *osm_handle;
+	const void *osm_handle = nullptr;
 	try
 	{
 		int ret = readosm_open(filename.c_str(), &osm_handle);
@@ -687,7 +864,7 @@ ReadPbfResult readPbf(const std::string& filename, const sim::PlanetAltitudeProv
 		}
 
 		const void *userData = &data;
-		ret = readosm_parse(osm_handle, userData, parseNode, parseWay, parseRelation);
+		ret = readosm_parse(osm_handle, userData, nodeCallback, wayCallback, relationCallback);
 		if (ret != READOSM_OK)
 		{
 			std::stringstream ss;
@@ -701,6 +878,55 @@ ReadPbfResult readPbf(const std::string& filename, const sim::PlanetAltitudeProv
 		throw skybolt::Exception("Error converting " + filename + ". Reason: " + e.what());
 	}
 	readosm_close(osm_handle);
+}
+
+static double secondsSince(const std::chrono::steady_clock::time_point& start)
+{
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+ReadPbfResult readPbf(const std::string& filename, const sim::PlanetAltitudeProvider& provider, px_sched::Scheduler& scheduler)
+{
+	ParserData data;
+	ReadPbfStats& stats = data.stats;
+
+	auto passStart = std::chrono::steady_clock::now();
+	printf("Pass 1: finding ways referenced by relations\n");
+	parsePbf(filename, data, nullptr, nullptr, collectRelationWayIds);
+	sortAndRemoveDuplicates(data.relationWayIds);
+	stats.relationPassSeconds = secondsSince(passStart);
+
+	passStart = std::chrono::steady_clock::now();
+	printf("Pass 2: finding nodes referenced by features\n");
+	parsePbf(filename, data, nullptr, collectWayNodeIds, nullptr);
+	sortAndRemoveDuplicates(data.requiredNodeIds);
+	data.requiredNodeIds.shrink_to_fit();
+	data.relationWayIds = {};
+	stats.wayReferencePassSeconds = secondsSince(passStart);
+
+	passStart = std::chrono::steady_clock::now();
+	printf("Pass 3: indexing %zu referenced nodes\n", data.requiredNodeIds.size());
+	data.nodes.reserve(data.requiredNodeIds.size());
+	parsePbf(filename, data, indexNode, nullptr, nullptr);
+	data.nodes.finalize();
+	data.requiredNodeIds = {};
+	stats.nodesIndexed = data.nodes.size();
+	stats.nodeIndexBytes = data.nodes.getMemoryUsageBytes();
+	stats.nodePassSeconds = secondsSince(passStart);
+
+	passStart = std::chrono::steady_clock::now();
+	printf("Pass 4: creating features\n");
+	parsePbf(filename, data, nullptr, parseWay, parseRelation);
+	stats.featurePassSeconds = secondsSince(passStart);
+
+	passStart = std::chrono::steady_clock::now();
+	printf("Resolving altitudes for %zu features\n", data.altitudeJobs.size());
+	for (const AltitudeJob& job : data.altitudeJobs)
+	{
+		stats.altitudeQueries += job.feature->points.size();
+	}
+	resolveAltitudes(data.altitudeJobs, provider, scheduler);
+	stats.altitudePassSeconds = secondsSince(passStart);
 
 	printf("Connecting roads at %zu connection points\n", data.nodeRoadJunctions.size());
 	joinRoadsAtJunctions(data);
@@ -713,9 +939,29 @@ ReadPbfResult readPbf(const std::string& filename, const sim::PlanetAltitudeProv
 	{
 		result.features.push_back(v.second);
 	}
+	result.stats = stats;
 
 	return result;
 }
 
+static double perSecond(size_t count, double seconds)
+{
+	return seconds > 0.0 ? double(count) / seconds : 0.0;
+}
+
+std::string statsToString(const ReadPbfStats& stats)
+{
+	std::stringstream ss;
+	ss << "Relations read: " << stats.relationsRead << " in " << stats.relationPassSeconds << "s" << std::endl;
+	ss << "Ways read: " << stats.waysRead << " in " << stats.wayReferencePassSeconds << "s" << std::endl;
+	ss << "Nodes read: " << stats.nodesRead << " in " << stats.nodePassSeconds << "s ("
+		<< perSecond(stats.nodesRead, stats.nodePassSeconds) << " nodes/sec)" << std::endl;
+	ss << "Nodes indexed: " << stats.nodesIndexed << " using " << stats.nodeIndexBytes / (1024 * 1024) << " MB" << std::endl;
+	ss << "Features created in " << stats.featurePassSeconds << "s" << std::endl;
+	ss << "Altitude queries: " << stats.altitudeQueries << " in " << stats.altitudePassSeconds << "s ("
+		<< perSecond(stats.altitudeQueries, stats.altitudePassSeconds) << " queries/sec)" << std::endl;
+	return ss.str();
+}
+
 } // namespace mapfeatures
 } // namespace skybolt
\ No newline at end of file
@@ -9,15 +9,47 @@
 #include <SkyboltSim/PlanetAltitudeProvider.h>
 #include <SkyboltVis/Renderable/Planet/Features/PlanetFeaturesSource.h>
 
+namespace px_sched {
+class Scheduler;
+} // namespace px_sched
+
 namespace skybolt {
 namespace mapfeatures {
 
+struct ReadPbfStats
+{
+	size_t nodesRead = 0; //!< Total nodes in the file
+	size_t nodesIndexed = 0; //!< Nodes referenced by features and stored in the node location index
+	size_t nodeIndexBytes = 0; //!< Memory used by the node location index
+	size_t waysRead = 0;
+	size_t relationsRead = 0;
+	size_t altitudeQueries = 0;
+
+	double relationPassSeconds = 0;
+	double wayReferencePassSeconds = 0;
+	double nodePassSeconds = 0;
+	double featurePassSeconds = 0;
+	double altitudePassSeconds = 0;
+};
+
+std::string statsToString(const ReadPbfStats& stats);
+
 struct ReadPbfResult
 {
 	std::vector<FeaturePtr> features; //!< All the features
 	std::map<std::string, AirportPtr> airports; //!< Map of names to airport features
+	ReadPbfStats stats;
 };
-ReadPbfResult readPbf(const std::string& filename, const sim::PlanetAltitudeProvider& provider);
+
+//! Reads features from an OSM PBF file.
+//! The file is streamed in several passes so that only the nodes referenced by features need to be held in memory:
+//! 1. Relations are read to find the ways they reference.
+//! 2. Ways are read to find the nodes referenced by features.
+//! 3. Nodes are read into a compact sorted node location index.
+//! 4. Ways and relations are read to create the features.
+//! Feature altitudes are then resolved in a batch, in parallel across the scheduler's worker threads.
+//! @param provider must be thread safe
+ReadPbfResult readPbf(const std::string& filename, const sim::PlanetAltitudeProvider& provider, px_sched::Scheduler& scheduler);
 
 } // namespace mapfeatures
-} // namespace skybolt
\ No newline at end of file
+} // namespace skybolt
@@ -0,0 +1,89 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "NodeLocationIndex.h"
+#include <SkyboltCommon/Math/MathUtility.h>
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+namespace skybolt {
+namespace mapfeatures {
+
+using namespace skybolt::math;
+
+constexpr double fixedPointScale = 1e7; // OSM coordinate precision is 1e-7 degrees
+
+static int32_t toFixedPoint(double radians)
+{
+	return int32_t(std::round(radians * radToDegD() * fixedPointScale));
+}
+
+static double fromFixedPoint(int32_t value)
+{
+	return double(value) / fixedPointScale * degToRadD();
+}
+
+void NodeLocationIndex::reserve(size_t nodeCount)
+{
+	mIds.reserve(nodeCount);
+	mLocations.reserve(nodeCount);
+}
+
+void NodeLocationIndex::add(int64_t id, const sim::LatLon& position)
+{
+	if (!mIds.empty() && id <= mIds.back())
+	{
+		mSorted = false;
+	}
+	mIds.push_back(id);
+	mLocations.push_back({toFixedPoint(position.lat), toFixedPoint(position.lon)});
+}
+
+void NodeLocationIndex::finalize()
+{
+	if (!mSorted)
+	{
+		std::vector<size_t> order(mIds.size());
+		std::iota(order.begin(), order.end(), 0);
+		std::sort(order.begin(), order.end(), [this] (size_t a, size_t b) { return mIds[a] < mIds[b]; });
+
+		std::vector<int64_t> ids(mIds.size());
+		std::vector<FixedPointLatLon> locations(mLocations.size());
+		for (size_t i = 0; i < order.size(); ++i)
+		{
+			ids[i] = mIds[order[i]];
+			locations[i] = mLocations[order[i]];
+		}
+		std::swap(mIds, ids);
+		std::swap(mLocations, locations);
+		mSorted = true;
+	}
+
+	mIds.shrink_to_fit();
+	mLocations.shrink_to_fit();
+}
+
+std::optional<sim::LatLon> NodeLocationIndex::find(int64_t id) const
+{
+	assert(mSorted);
+	auto it = std::lower_bound(mIds.begin(), mIds.end(), id);
+	if (it != mIds.end() && *it == id)
+	{
+		const FixedPointLatLon& location = mLocations[it - mIds.begin()];
+		return sim::LatLon(fromFixedPoint(location.lat), fromFixedPoint(location.lon));
+	}
+	return std::nullopt;
+}
+
+size_t NodeLocationIndex::getMemoryUsageBytes() const
+{
+	return mIds.capacity() * sizeof(int64_t) + mLocations.capacity() * sizeof(FixedPointLatLon);
+}
+
+} // namespace mapfeatures
+} // namespace skybolt
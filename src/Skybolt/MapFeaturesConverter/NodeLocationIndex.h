@@ -0,0 +1,52 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#pragma once
+
+#include <SkyboltSim/Spatial/LatLon.h>
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace skybolt {
+namespace mapfeatures {
+
+//! Compact flat index from OSM node ID to node location.
+//! Locations are stored as 32 bit fixed point values at OSM's native precision of 1e-7 degrees, which is lossless for OSM data.
+//! Each node costs 16 bytes, compared to roughly 64 bytes for a node in a std::map.
+//! Nodes should be added in ascending ID order, which is the order used by OSM PBF files.
+//! Out of order nodes are supported, but require a sort in finalize().
+class NodeLocationIndex
+{
+public:
+	void reserve(size_t nodeCount);
+
+	void add(int64_t id, const sim::LatLon& position);
+
+	//! Must be called after all nodes have been added and before find() is called
+	void finalize();
+
+	//! @ThreadSafe after finalize() has been called
+	std::optional<sim::LatLon> find(int64_t id) const;
+
+	size_t size() const { return mIds.size(); }
+	size_t getMemoryUsageBytes() const;
+
+private:
+	struct FixedPointLatLon
+	{
+		int32_t lat;
+		int32_t lon;
+	};
+
+	std::vector<int64_t> mIds;
+	std::vector<FixedPointLatLon> mLocations;
+	bool mSorted = true;
+};
+
+} // namespace mapfeatures
+} // namespace skybolt
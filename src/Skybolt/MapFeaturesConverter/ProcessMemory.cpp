@@ -0,0 +1,44 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "ProcessMemory.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#pragma comment(lib, "psapi.lib")
+#else
+#include <sys/resource.h>
+#endif
+
+namespace skybolt {
+namespace mapfeatures {
+
+size_t getPeakResidentSetSizeBytes()
+{
+#ifdef _WIN32
+	PROCESS_MEMORY_COUNTERS counters;
+	if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+	{
+		return size_t(counters.PeakWorkingSetSize);
+	}
+	return 0;
+#else
+	rusage usage;
+	if (getrusage(RUSAGE_SELF, &usage) == 0)
+	{
+#ifdef __APPLE__
+		return size_t(usage.ru_maxrss); // bytes
+#else
+		return size_t(usage.ru_maxrss) * 1024; // kilobytes
+#endif
+	}
+	return 0;
+#endif
+}
+
+} // namespace mapfeatures
+} // namespace skybolt
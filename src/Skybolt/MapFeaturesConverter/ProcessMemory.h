@@ -0,0 +1,18 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#pragma once
+
+#include <cstddef>
+
+namespace skybolt {
+namespace mapfeatures {
+
+//! @return the peak resident set size of the current process in bytes, or 0 if unavailable on this platform
+size_t getPeakResidentSetSizeBytes();
+
+} // namespace mapfeatures
+} // namespace skybolt
@@ -5,6 +5,8 @@
  * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
 
 #include "FeaturesConverter.h"
+#include "FeatureTileTools.h"
+#include "ProcessMemory.h"
 #include <iostream>
 
 //#define PERFORM_HEIGHTMAP_LEVELING_UNDER_FEATURES
@@ -30,25 +32,74 @@ using namespace skybolt;
 using namespace mapfeatures;
 using namespace vis;
 
-int maxFeatureTileLod = 10;
-int maxHeightmapTileLod = 12;
-std::string outputDirectory = "Output";
-std::string tileCacheDirectory = "cache";
-std::string heightmapSourceDirectory = "DEM/CombinedElevation";
-std::string heightmapDestinationDirectory = "SkyboltAssets/Assets/SeattleElevation/Tiles/Earth/Elevation";
+namespace po = boost::program_options;
 
 int main(int argc, char *argv[])
 {
 	try
 	{
-		auto params = EngineCommandLineParser::parse(argc, argv);
+		po::options_description desc("Converts OpenStreetMap PBF files to Skybolt feature tiles");
+		EngineCommandLineParser::addOptions(desc);
+		desc.add_options()
+			("input", po::value<std::string>(), "input OSM PBF file")
+			("upgradeTiles", po::value<std::string>(), "convert legacy feature tiles in the given directory to the memory mapped format, then exit")
+			("benchmarkTiles", po::value<std::string>(), "measure load latency of feature tiles in the given directory, then exit")
+			("outputDir", po::value<std::string>()->default_value("Output"), "output directory for feature tiles")
+			("tileCacheDir", po::value<std::string>()->default_value("cache"), "directory for caching downloaded elevation tiles")
+			("elevationUrlTemplate", po::value<std::string>()->default_value("DEM/{z}/{x}/{y}.png"), "URL template of elevation tiles")
+			("maxFeatureTileLod", po::value<int>()->default_value(10), "maximum LOD level of output feature tiles")
+			("maxHeightmapTileLod", po::value<int>()->default_value(12), "maximum LOD level of elevation tiles used for feature altitudes")
+			("heightmapSourceDir", po::value<std::string>()->default_value("DEM/CombinedElevation"), "heightmap source directory for heightmap leveling")
+			("heightmapDestinationDir", po::value<std::string>()->default_value("SkyboltAssets/Assets/SeattleElevation/Tiles/Earth/Elevation"), "heightmap output directory for heightmap leveling")
+			("threads", po::value<int>()->default_value(0), "number of worker threads, or 0 to use all cores");
+
+		po::variables_map params;
+		po::store(po::parse_command_line(argc, argv, desc), params);
+		if (params.count("help"))
+		{
+			std::cout << desc << std::endl;
+			return 0;
+		}
+		po::notify(params);
+
+		if (params.count("upgradeTiles"))
+		{
+			int count = mapfeatures::upgradeFeatureTiles(params["upgradeTiles"].as<std::string>());
+			printf("Upgraded %i tiles\n", count);
+			return 0;
+		}
+		if (params.count("benchmarkTiles"))
+		{
+			auto benchmark = mapfeatures::benchmarkFeatureTileLoading(params["benchmarkTiles"].as<std::string>());
+			printf("%s", mapfeatures::toString(benchmark).c_str());
+			return 0;
+		}
+		if (!params.count("input"))
+		{
+			throw std::runtime_error("input file not specified");
+		}
+
+		const std::string inputFilename = params["input"].as<std::string>();
+		const std::string outputDirectory = params["outputDir"].as<std::string>();
+		const std::string tileCacheDirectory = params["tileCacheDir"].as<std::string>();
+		const int maxFeatureTileLod = params["maxFeatureTileLod"].as<int>();
+		const int maxHeightmapTileLod = params["maxHeightmapTileLod"].as<int>();
+
 		nlohmann::json settings = readEngineSettings(params);
 		auto tileApiKeys = readNameMap<std::string>(settings, "tileApiKeys");
 
+		px_sched::SchedulerParams schedulerParams;
+		if (int threadCount = params["threads"].as<int>(); threadCount > 0)
+		{
+			schedulerParams.num_threads = uint16_t(threadCount);
+		}
+		px_sched::Scheduler scheduler;
+		scheduler.init(schedulerParams);
+
 #define USE_DEM
 #ifdef USE_DEM
 		XyzTileSourceConfig config;
-		config.urlTemplate = "DEM/{z}/{x}/{y}.png";
+		config.urlTemplate = params["elevationUrlTemplate"].as<std::string>();
 		config.elevationRerange = rerangeElevationFromUInt16WithElevationBounds(-32768, 32767);
 		config.levelRange = {0, 10};
 
@@ -69,8 +120,9 @@ int main(int argc, char *argv[])
 		auto tileSource = std::make_shared<CachedTileSource>(uncachedTileSource, tileSourceCacheDirectory);
 #endif
 		BlockingTilePlanetAltitudeProvider altitudeProvider(tileSource, maxHeightmapTileLod);
-		ReadPbfResult result = mapfeatures::readPbf("washington-latest.osm.pbf", altitudeProvider);
+		ReadPbfResult result = mapfeatures::readPbf(inputFilename, altitudeProvider, scheduler);
 		{
+			printf("Parser Stats:\n%s\n", mapfeatures::statsToString(result.stats).c_str());
 			printf("Feature Conversion Stats:\n%s\n", mapfeatures::statsToString(result.features).c_str());
 
 			mapfeatures::TreeCreatorParams treeCreatorParams;
@@ -85,6 +137,8 @@ int main(int argc, char *argv[])
 			{
 				airportFeatures.push_back(a.second.get());
 			}
+			const std::string heightmapSourceDirectory = params["heightmapSourceDir"].as<std::string>();
+			const std::string heightmapDestinationDirectory = params["heightmapDestinationDir"].as<std::string>();
 			mapfeatures::levelHeightmapsUnderFeatures(heightmapSourceDirectory, heightmapDestinationDirectory, airportFeatures, borderMeters);
 
 			for (const auto& airport : airportFeatures)
@@ -95,9 +149,12 @@ int main(int argc, char *argv[])
 			mapfeatures::save(worldFeatures.tree, outputDirectory);
 			mapfeatures::saveAirports(result.airports, outputDirectory + "/airports.apt");
 		}
+		printf("Peak resident set size: %zu MB\n", mapfeatures::getPeakResidentSetSizeBytes() / (1024 * 1024));
 	}
 	catch (const std::exception& e)
 	{
 		std::cout << "Exception thrown: " << e.what() << std::endl;
+		return 1;
 	}
+	return 0;
 }
\ No newline at end of file
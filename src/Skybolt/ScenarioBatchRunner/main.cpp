@@ -0,0 +1,169 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include <SkyboltEngine/EngineCommandLineParser.h>
+#include <SkyboltEngine/EngineRoot.h>
+#include <SkyboltEngine/EngineRootFactory.h>
+#include <SkyboltEngine/EngineSettings.h>
+#include <SkyboltEngine/Plugin/PluginHelpers.h>
+#include <SkyboltEngine/Scenario/ScenarioSerialization.h>
+#include <SkyboltEngine/UpdateLoop/HeadlessRunner.h>
+#include <SkyboltCommon/Json/JsonHelpers.h>
+#include <SkyboltCommon/Json/ReadJsonFile.h>
+#include <SkyboltCommon/Json/WriteJsonFile.h>
+#include <SkyboltCommon/Profiling/Profiler.h>
+
+#include <osgDB/Registry>
+
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+using namespace skybolt;
+
+namespace po = boost::program_options;
+
+static nlohmann::json toJson(const HeadlessBatchRunSummary& summary)
+{
+	nlohmann::json json;
+	json["run"] = summary.runIndex;
+	json["updateCount"] = summary.updateCount;
+	json["simSeconds"] = summary.simDuration;
+	json["wallSeconds"] = summary.wallDuration;
+	json["realTimeMultiple"] = (summary.wallDuration > 0) ? summary.simDuration / summary.wallDuration : 0.0;
+	if (summary.error)
+	{
+		json["error"] = *summary.error;
+	}
+	return json;
+}
+
+int main(int argc, char *argv[])
+{
+	try
+	{
+		po::options_description desc("Runs a scenario repeatedly without rendering, as fast as possible or at a fixed multiple of real time");
+		EngineCommandLineParser::addOptions(desc);
+		desc.add_options()
+			("scenario", po::value<std::string>(), "scenario file to run")
+			("runs", po::value<int>()->default_value(1), "number of runs")
+			("threads", po::value<int>()->default_value(1), "number of runs to execute concurrently")
+			("engineThreads", po::value<int>()->default_value(1), "number of background engine threads per run")
+			("timeStep", po::value<double>()->default_value(1.0 / 60.0), "simulation time step in seconds")
+			("realTimeMultiple", po::value<double>(), "pace each run to this multiple of real time. If not set, runs as fast as possible")
+			("summaryFile", po::value<std::string>(), "file to write per-run summaries to as JSON lines. If not set, summaries are written to stdout")
+			("finalStateDir", po::value<std::string>(), "directory to write each run's final scenario state to")
+			("traceFile", po::value<std::string>(), "file to write profiled zones to in Chrome trace event format");
+
+		po::variables_map params = EngineCommandLineParser::parse(argc, argv, desc);
+		if (params.count("help"))
+		{
+			std::cout << desc << std::endl;
+			return 0;
+		}
+		if (!params.count("scenario"))
+		{
+			throw std::runtime_error("scenario file not specified");
+		}
+
+		const std::string scenarioFilename = params["scenario"].as<std::string>();
+		const nlohmann::json scenarioJson = readJsonFile(scenarioFilename);
+		const nlohmann::json settings = readEngineSettings(params);
+
+		// Allow the scenario to reference files relative to its own directory
+		osgDB::Registry::instance()->getDataFilePathList().push_back(std::filesystem::path(scenarioFilename).parent_path().string());
+
+		// Load plugins once and share the factories between runs
+		std::vector<PluginFactory> pluginFactories = loadPluginFactories<Plugin, PluginConfig>(getAllPluginFilepathsInDirectories(EngineRootFactory::getDefaultPluginDirs()));
+
+		HeadlessBatchConfig config;
+		config.runCount = params["runs"].as<int>();
+		config.threadCount = params["threads"].as<int>();
+		config.runConfig.timeStep = params["timeStep"].as<double>();
+		if (params.count("realTimeMultiple"))
+		{
+			config.runConfig.realTimeMultiple = params["realTimeMultiple"].as<double>();
+		}
+
+		const int engineThreadCount = params["engineThreads"].as<int>();
+		config.createEngineRoot = [&] (int runIndex) {
+			EngineRootConfig engineConfig;
+			engineConfig.engineSettings = settings;
+			engineConfig.enableVis = false;
+			engineConfig.threadCount = engineThreadCount;
+
+			auto engineRoot = std::make_unique<EngineRoot>(engineConfig);
+			engineRoot->loadPlugins(pluginFactories);
+			return engineRoot;
+		};
+
+		config.prepareRun = [&] (EngineRoot& engineRoot, int runIndex) {
+			ifChildExists(scenarioJson, "scenario", [&] (const nlohmann::json& child) {
+				readScenario(*engineRoot.typeRegistry, *engineRoot.scenario, *engineRoot.entityFactory, child);
+			});
+		};
+
+		std::ofstream summaryFile;
+		if (params.count("summaryFile"))
+		{
+			summaryFile.open(params["summaryFile"].as<std::string>());
+			if (!summaryFile)
+			{
+				throw std::runtime_error("Could not open summary file for writing: " + params["summaryFile"].as<std::string>());
+			}
+		}
+		std::ostream& summaryStream = summaryFile.is_open() ? summaryFile : std::cout;
+
+		std::optional<std::filesystem::path> finalStateDir;
+		if (params.count("finalStateDir"))
+		{
+			finalStateDir = params["finalStateDir"].as<std::string>();
+			std::filesystem::create_directories(*finalStateDir);
+		}
+
+		std::ofstream traceFile;
+		if (params.count("traceFile"))
+		{
+			traceFile.open(params["traceFile"].as<std::string>());
+			if (!traceFile)
+			{
+				throw std::runtime_error("Could not open trace file for writing: " + params["traceFile"].as<std::string>());
+			}
+			Profiler::instance().setThreadName("Main");
+			Profiler::instance().setCapturing(true);
+			Profiler::setEnabled(true);
+		}
+
+		int failedRunCount = 0;
+		runHeadlessBatch(config, [&] (EngineRoot* engineRoot, const HeadlessBatchRunSummary& summary) {
+			summaryStream << toJson(summary).dump() << std::endl;
+
+			if (summary.error)
+			{
+				++failedRunCount;
+			}
+			else if (engineRoot && finalStateDir)
+			{
+				nlohmann::json json;
+				json["scenario"] = writeScenario(*engineRoot->typeRegistry, *engineRoot->scenario);
+				writeJsonFile(json, (*finalStateDir / ("run_" + std::to_string(summary.runIndex) + ".scn")).string());
+			}
+		});
+
+		if (traceFile.is_open())
+		{
+			Profiler::setEnabled(false);
+			Profiler::instance().writeChromeTrace(traceFile);
+		}
+
+		return (failedRunCount == 0) ? 0 : 1;
+	}
+	catch (const std::exception& e)
+	{
+		std::cerr << e.what() << std::endl;
+		return 1;
+	}
+}
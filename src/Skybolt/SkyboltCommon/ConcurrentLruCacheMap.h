@@ -0,0 +1,226 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#pragma once
+
+#include "LruCacheMap.h"
+
+#include <stdint.h>
+#include <atomic>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace skybolt {
+
+struct LruCacheStatistics
+{
+	int64_t hitCount = 0;
+	int64_t missCount = 0;
+	int64_t insertionCount = 0;
+	int64_t evictionCount = 0;
+	size_t itemCount = 0;
+	size_t totalCost = 0;
+};
+
+//! Thread safe key-value map that removes least recently used items when the total cost of items exceeds capacity.
+//! Items are divided between independently locked shards, selected by key hash, so that threads accessing different keys
+//! rarely contend. The total cost is tracked across all shards. An insertion evicts the least recently used items of its
+//! own shard, and then of the other shards if needed, until the total is within capacity. Eviction is therefore
+//! approximately least recently used across the whole map, and the total may briefly exceed capacity while other
+//! threads are inserting.
+template <typename KeyT, typename ValueT, typename HashT = std::hash<KeyT>>
+class ConcurrentLruCacheMap
+{
+public:
+	using CostFunction = typename LruCacheMap<KeyT, ValueT>::CostFunction;
+	using EvictionCallback = typename LruCacheMap<KeyT, ValueT>::EvictionCallback;
+
+	static constexpr size_t defaultShardCount = 16;
+
+	//! @param capacity is the maximum total cost of items in the map
+	//! @param costFunction returns the cost of an item, e.g. its size in bytes. If not provided, each item costs 1.
+	//! @param evictionCallback is called for each item removed to keep the total cost within capacity.
+	//!        It is called from the thread that inserted the item causing the eviction, after the map has been unlocked.
+	//! @param shardCount is the number of shards
+	ConcurrentLruCacheMap(size_t capacity, CostFunction costFunction = nullptr, EvictionCallback evictionCallback = nullptr, size_t shardCount = defaultShardCount) :
+		mCapacity(capacity),
+		mCostFunction(std::move(costFunction)),
+		mEvictionCallback(std::move(evictionCallback))
+	{
+		assert(shardCount > 0);
+		for (size_t i = 0; i < shardCount; ++i)
+		{
+			mShards.push_back(std::make_unique<Shard>(mEvictionCallback != nullptr));
+		}
+	}
+
+	//! @returns true on put, or false if the key already exists or the item costs more than the whole capacity
+	//! @ThreadSafe
+	bool putSafe(const KeyT& key, const ValueT& value)
+	{
+		size_t cost = mCostFunction ? mCostFunction(value) : 1;
+		if (cost > mCapacity)
+		{
+			return false;
+		}
+
+		size_t shardIndex = getShardIndex(key);
+		Shard& shard = *mShards[shardIndex];
+		std::vector<std::pair<KeyT, ValueT>> evicted;
+		{
+			std::scoped_lock<std::mutex> lock(shard.mutex);
+			if (!shard.cache.putSafe(key, value, cost))
+			{
+				return false;
+			}
+			++shard.insertionCount;
+			mTotalCost += cost;
+
+			// Keep the item just inserted
+			evictWhileOverCapacity(shard, /* minItemCount */ 1);
+			evicted.swap(shard.evicted);
+		}
+		notifyEvicted(evicted);
+
+		// Evict from the other shards if this shard did not hold enough.
+		// Only one shard is locked at a time so that concurrent insertions can not deadlock.
+		for (size_t i = 1; i < mShards.size() && mTotalCost.load() > mCapacity; ++i)
+		{
+			Shard& otherShard = *mShards[(shardIndex + i) % mShards.size()];
+			evicted.clear();
+			{
+				std::scoped_lock<std::mutex> lock(otherShard.mutex);
+				evictWhileOverCapacity(otherShard, /* minItemCount */ 0);
+				evicted.swap(otherShard.evicted);
+			}
+			notifyEvicted(evicted);
+		}
+		return true;
+	}
+
+	//! @ThreadSafe
+	bool get(const KeyT& key, ValueT& valueOut)
+	{
+		Shard& shard = getShard(key);
+		std::scoped_lock<std::mutex> lock(shard.mutex);
+		if (shard.cache.get(key, valueOut))
+		{
+			++shard.hitCount;
+			return true;
+		}
+		++shard.missCount;
+		return false;
+	}
+
+	//! Tests whether item exists without 'using' the item (i.e caching is unaffected)
+	//! @ThreadSafe
+	bool exists(const KeyT& key) const
+	{
+		Shard& shard = getShard(key);
+		std::scoped_lock<std::mutex> lock(shard.mutex);
+		return shard.cache.exists(key);
+	}
+
+	//! @ThreadSafe
+	size_t size() const
+	{
+		return getStatistics().itemCount;
+	}
+
+	//! @ThreadSafe
+	size_t getTotalCost() const
+	{
+		return mTotalCost.load();
+	}
+
+	//! @returns statistics summed over all shards. Shards are read one at a time, so the result is approximate while other threads modify the map.
+	//! @ThreadSafe
+	LruCacheStatistics getStatistics() const
+	{
+		LruCacheStatistics statistics;
+		for (const auto& shard : mShards)
+		{
+			std::scoped_lock<std::mutex> lock(shard->mutex);
+			statistics.hitCount += shard->hitCount;
+			statistics.missCount += shard->missCount;
+			statistics.insertionCount += shard->insertionCount;
+			statistics.evictionCount += shard->evictionCount;
+			statistics.itemCount += shard->cache.size();
+			statistics.totalCost += shard->cache.getTotalCost();
+		}
+		return statistics;
+	}
+
+private:
+	struct Shard
+	{
+		//! The shard's cache has no capacity of its own. Items are evicted by the map to keep the total cost of all shards within capacity.
+		Shard(bool retainEvicted) :
+			cache(std::numeric_limits<size_t>::max(), nullptr, [this, retainEvicted] (const KeyT& key, const ValueT& value) {
+				++evictionCount;
+				if (retainEvicted)
+				{
+					evicted.emplace_back(key, value);
+				}
+			})
+		{
+		}
+
+		mutable std::mutex mutex;
+		LruCacheMap<KeyT, ValueT> cache;
+		std::vector<std::pair<KeyT, ValueT>> evicted; //!< Items evicted by the current insertion, to be passed to the eviction callback once unlocked
+		int64_t hitCount = 0;
+		int64_t missCount = 0;
+		int64_t insertionCount = 0;
+		int64_t evictionCount = 0;
+	};
+
+	size_t getShardIndex(const KeyT& key) const
+	{
+		// Mix the hash bits because some hashes, such as those of pointers, have poorly distributed low bits
+		uint64_t hash = uint64_t(HashT()(key)) * 0x9E3779B97F4A7C15ull;
+		return size_t((hash >> 32) % mShards.size());
+	}
+
+	Shard& getShard(const KeyT& key) const
+	{
+		return *mShards[getShardIndex(key)];
+	}
+
+	//! Evicts least recently used items from the shard until the total cost is within capacity or the shard has minItemCount items.
+	//! The shard must be locked.
+	void evictWhileOverCapacity(Shard& shard, size_t minItemCount)
+	{
+		while (mTotalCost.load() > mCapacity && shard.cache.size() > minItemCount)
+		{
+			size_t shardCost = shard.cache.getTotalCost();
+			shard.cache.evictLeastRecentlyUsed();
+			mTotalCost -= shardCost - shard.cache.getTotalCost();
+		}
+	}
+
+	void notifyEvicted(const std::vector<std::pair<KeyT, ValueT>>& evicted) const
+	{
+		if (mEvictionCallback)
+		{
+			for (const auto& [key, value] : evicted)
+			{
+				mEvictionCallback(key, value);
+			}
+		}
+	}
+
+private:
+	const size_t mCapacity;
+	CostFunction mCostFunction;
+	std::vector<std::unique_ptr<Shard>> mShards;
+	EvictionCallback mEvictionCallback;
+	std::atomic<size_t> mTotalCost{0};
+};
+
+} // namespace skybolt
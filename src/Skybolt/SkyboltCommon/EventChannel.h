@@ -0,0 +1,140 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#pragma once
+
+#include <algorithm>
+#include <assert.h>
+#include <vector>
+
+namespace skybolt {
+
+template <typename EventT>
+class EventChannelListener
+{
+public:
+	virtual ~EventChannelListener() = default;
+
+	//! Called with the events published since the previous dispatch, in order of publication
+	virtual void onEvents(const std::vector<EventT>& events) = 0;
+};
+
+/*! Queues events of a single type and delivers them to listeners in batches when dispatch() is called.
+	Unlike EventEmitter, events are stored by value without type erasure, and queue storage is reused
+	between dispatches, so publishing and dispatching do not allocate once the queue has reached its working size.
+
+	Listeners may be added or removed while events are being dispatched. A removed listener receives no further events.
+	An added listener receives events from the next dispatch onwards.
+	Events published while dispatching are delivered in the next dispatch.
+	@NotThreadSafe
+*/
+template <typename EventT>
+class EventChannel
+{
+public:
+	using Listener = EventChannelListener<EventT>;
+
+	explicit EventChannel(size_t reservedEventCount = 64)
+	{
+		reserve(reservedEventCount);
+	}
+
+	void reserve(size_t eventCount)
+	{
+		mPendingEvents.reserve(eventCount);
+		mDispatchingEvents.reserve(eventCount);
+	}
+
+	void addListener(Listener* listener)
+	{
+		assert(listener);
+		mListeners.push_back(listener);
+	}
+
+	void removeListener(Listener* listener)
+	{
+		auto i = std::find(mListeners.begin(), mListeners.end(), listener);
+		if (i == mListeners.end())
+		{
+			return;
+		}
+
+		if (mDispatching)
+		{
+			// Leave a gap so that the indices of listeners still being dispatched to are unchanged
+			*i = nullptr;
+			mListenersRemovedDuringDispatch = true;
+		}
+		else
+		{
+			mListeners.erase(i);
+		}
+	}
+
+	void publish(const EventT& event)
+	{
+		mPendingEvents.push_back(event);
+	}
+
+	void publish(EventT&& event)
+	{
+		mPendingEvents.push_back(std::move(event));
+	}
+
+	template <typename... Args>
+	void emplace(Args&&... args)
+	{
+		mPendingEvents.emplace_back(std::forward<Args>(args)...);
+	}
+
+	size_t getPendingEventCount() const { return mPendingEvents.size(); }
+
+	//! Delivers all pending events to the listeners
+	void dispatch()
+	{
+		if (mPendingEvents.empty() || mDispatching)
+		{
+			return;
+		}
+
+		// Swap buffers so that events published during dispatch are queued for the next dispatch
+		std::swap(mPendingEvents, mDispatchingEvents);
+
+		mDispatching = true;
+		size_t listenerCount = mListeners.size(); // Listeners added during dispatch are not called until the next dispatch
+		for (size_t i = 0; i < listenerCount; ++i)
+		{
+			if (Listener* listener = mListeners[i]; listener)
+			{
+				listener->onEvents(mDispatchingEvents);
+			}
+		}
+		mDispatching = false;
+
+		mDispatchingEvents.clear();
+
+		if (mListenersRemovedDuringDispatch)
+		{
+			mListeners.erase(std::remove(mListeners.begin(), mListeners.end(), nullptr), mListeners.end());
+			mListenersRemovedDuringDispatch = false;
+		}
+	}
+
+	//! Discards pending events without delivering them
+	void clear()
+	{
+		mPendingEvents.clear();
+	}
+
+private:
+	std::vector<EventT> mPendingEvents;
+	std::vector<EventT> mDispatchingEvents;
+	std::vector<Listener*> mListeners;
+	bool mDispatching = false;
+	bool mListenersRemovedDuringDispatch = false;
+};
+
+} // namespace skybolt
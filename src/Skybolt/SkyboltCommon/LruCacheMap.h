@@ -7,6 +7,7 @@
 #pragma once
 
 #include <assert.h>
+#include <functional>
 #include <list>
 #include <unordered_map>
 
@@ -16,20 +17,33 @@ namespace skybolt {
 template <typename KeyT, typename ValueT>
 struct LruCacheMap
 {
-	LruCacheMap(size_t capacity) :
-		mCapacity(capacity)
+	using CostFunction = std::function<size_t(const ValueT&)>;
+	using EvictionCallback = std::function<void(const KeyT&, const ValueT&)>;
+
+	//! @param capacity is the maximum total cost of items in the cache
+	//! @param costFunction returns the cost of an item, e.g. its size in bytes. If not provided, each item costs 1.
+	//! @param evictionCallback is called for each item removed to keep the total cost within capacity
+	LruCacheMap(size_t capacity, CostFunction costFunction = nullptr, EvictionCallback evictionCallback = nullptr) :
+		mCapacity(capacity),
+		mCostFunction(std::move(costFunction)),
+		mEvictionCallback(std::move(evictionCallback))
 	{
 	}
 
 	//! @returns true on put
 	bool putSafe(const KeyT& key, const ValueT& value)
+	{
+		return putSafe(key, value, calcCost(value));
+	}
+
+	//! @param cost is used instead of the cost function's result
+	//! @returns true on put
+	bool putSafe(const KeyT& key, const ValueT& value, size_t cost)
 	{
 		auto it = mEntries.find(key);
 		if (it == mEntries.end())
 		{
-			mQueue.push_front(std::make_pair(key, value));
-			mEntries[key] = mQueue.begin();
-			prune();
+			put(key, value, cost);
 			return true;
 		}
 
@@ -37,11 +51,18 @@ struct LruCacheMap
 	}
 
 	void put(const KeyT& key, const ValueT& value)
+	{
+		put(key, value, calcCost(value));
+	}
+
+	//! @param cost is used instead of the cost function's result
+	void put(const KeyT& key, const ValueT& value, size_t cost)
 	{
 		assert(mEntries.find(key) == mEntries.end());
 
-		mQueue.push_front(std::make_pair(key, value));
+		mQueue.push_front({key, value, cost});
 		mEntries[key] = mQueue.begin();
+		mTotalCost += cost;
 		prune();
 	}
 
@@ -51,7 +72,7 @@ struct LruCacheMap
 		if (it != mEntries.end())
 		{
 			mQueue.splice(mQueue.begin(), mQueue, it->second); // move item to the beginning of the queue
-			valueOut = it->second->second;
+			valueOut = it->second->value;
 			return true;
 		}
 		return false;
@@ -62,28 +83,67 @@ struct LruCacheMap
 		return mEntries.size();
 	}
 
+	//! @returns the total cost of items in the cache, which is equal to size() if no cost function was provided
+	size_t getTotalCost() const
+	{
+		return mTotalCost;
+	}
+
 	//! Tests whether item exists without 'using' the item (i.e caching is unaffected)
 	bool exists(const KeyT& key) const
 	{
 		return mEntries.find(key) != mEntries.end();
 	}
 
+	//! Removes the least recently used item, calling the eviction callback
+	//! @returns false if the cache is empty
+	bool evictLeastRecentlyUsed()
+	{
+		if (mQueue.empty())
+		{
+			return false;
+		}
+
+		auto it = mQueue.end();
+		it--;
+		mTotalCost -= it->cost;
+		mEntries.erase(it->key);
+		if (mEvictionCallback)
+		{
+			mEvictionCallback(it->key, it->value);
+		}
+		mQueue.pop_back();
+		return true;
+	}
+
 private:
+	size_t calcCost(const ValueT& value) const
+	{
+		return mCostFunction ? mCostFunction(value) : 1;
+	}
+
 	void prune()
 	{
-		while (mEntries.size() > mCapacity)
+		while (mTotalCost > mCapacity)
 		{
-			auto it = mQueue.end();
-			it--;
-			mEntries.erase(it->first);
-			mQueue.pop_back();
+			evictLeastRecentlyUsed();
 		}
 	}
 
 private:
 	size_t mCapacity;
+	CostFunction mCostFunction;
+	EvictionCallback mEvictionCallback;
+	size_t mTotalCost = 0;
+
+	struct Entry
+	{
+		KeyT key;
+		ValueT value;
+		size_t cost;
+	};
 
-	std::list<std::pair<KeyT, ValueT>> mQueue;
+	std::list<Entry> mQueue;
 	std::unordered_map<KeyT, decltype(mQueue.begin())> mEntries;
 };
 
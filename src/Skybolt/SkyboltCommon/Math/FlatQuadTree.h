@@ -0,0 +1,180 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#pragma once
+
+#include "QuadTree.h"
+#include <assert.h>
+#include <vector>
+
+namespace skybolt {
+
+//! Read only snapshot of a QuadTree or DiQuadTree, stored in a single array for fast queries.
+//! Nodes are stored level by level, and in Morton (Z-order) order within each level, so the four children of a node are
+//! adjacent and spatially nearby tiles are nearby in memory. Point queries descend directly to the child containing the
+//! point rather than testing each child in turn.
+//! The snapshot references the tiles of the source tree, which must outlive it. The snapshot must be recreated after the
+//! source tree is subdivided or merged.
+template <class TileT>
+class FlatQuadTree
+{
+public:
+	typedef TileT TileType;
+	typedef typename TileT::VectorType VectorType;
+
+	//! @param roots are the root tiles of the trees to store. Queries test the roots in the order given.
+	explicit FlatQuadTree(const std::vector<const TileT*>& roots)
+	{
+		for (const TileT* root : roots)
+		{
+			mRootBounds.push_back(root->bounds);
+			addNode(*root);
+		}
+
+		// Append the children of each node in turn. Children are in north west, north east, south west, south east order,
+		// which is Morton order, so each level is in Morton order if its parent level is.
+		for (size_t i = 0; i < mNodes.size(); ++i)
+		{
+			const TileT& tile = *mNodes[i].tile;
+			if (tile.hasChildren())
+			{
+				const TileT& northWest = static_cast<const TileT&>(*tile.children[0]);
+				mNodes[i].firstChild = int(mNodes.size());
+				mNodes[i].split = VectorType(northWest.bounds.maximum[0], northWest.bounds.minimum[1]);
+				for (int c = 0; c < 4; ++c)
+				{
+					addNode(static_cast<const TileT&>(*tile.children[c]));
+				}
+			}
+		}
+	}
+
+	//! @returns the leaf tile containing the point, or nullptr if the point is outside the tree
+	const TileT* intersectLeaf(const VectorType& p) const
+	{
+		return findNode(p, [] (const Node& node) {
+			return node.firstChild == noChild;
+		});
+	}
+
+	//! Finds the first tile, from the root down, which contains the point and satisfies the predicate.
+	//! Points on the boundary between tiles are treated as being in the tile that comes first in north west, north east,
+	//! south west, south east order.
+	//! @param predicate is a callable with signature bool(const TileT&)
+	//! @returns nullptr if no tile was found
+	template <typename PredicateT>
+	const TileT* intersect(const VectorType& p, const PredicateT& predicate) const
+	{
+		return findNode(p, [&] (const Node& node) {
+			return predicate(*node.tile);
+		});
+	}
+
+	//! Visits tiles depth first, in the same order as a recursive traversal of the source tree
+	//! @param visitor is a callable with signature bool(const TileT&), returning true if the tile's children should be visited
+	template <typename VisitorT>
+	void traverse(const VisitorT& visitor) const
+	{
+		// Each level adds at most 3 unvisited siblings to the stack
+		constexpr int maxStackSize = 1 + 3 * 32;
+		int stack[maxStackSize];
+
+		for (int root = 0; root < int(mRootBounds.size()); ++root)
+		{
+			int stackSize = 0;
+			stack[stackSize++] = root;
+			while (stackSize > 0)
+			{
+				const Node& node = mNodes[stack[--stackSize]];
+				if (visitor(*node.tile) && node.firstChild != noChild)
+				{
+					assert(stackSize + 4 <= maxStackSize);
+					for (int c = 3; c >= 0; --c)
+					{
+						stack[stackSize++] = node.firstChild + c;
+					}
+				}
+			}
+		}
+	}
+
+	//! Visits all tiles in storage order, which is faster than traverse() when the hierarchy is not needed
+	//! @param visitor is a callable with signature void(const TileT&)
+	template <typename VisitorT>
+	void forEachTile(const VisitorT& visitor) const
+	{
+		for (const Node& node : mNodes)
+		{
+			visitor(*node.tile);
+		}
+	}
+
+	size_t getTileCount() const { return mNodes.size(); }
+
+private:
+	static constexpr int noChild = -1;
+
+	struct Node
+	{
+		VectorType split; //!< Point where the node's children meet
+		int firstChild = noChild; //!< Index of the north west child. The other children follow it.
+		const TileT* tile;
+	};
+
+	void addNode(const TileT& tile)
+	{
+		Node node;
+		node.tile = &tile;
+		mNodes.push_back(node);
+	}
+
+	template <typename NodePredicateT>
+	const TileT* findNode(const VectorType& p, const NodePredicateT& predicate) const
+	{
+		for (int root = 0; root < int(mRootBounds.size()); ++root)
+		{
+			if (!mRootBounds[root].intersects(p))
+			{
+				continue;
+			}
+
+			int index = root;
+			while (true)
+			{
+				const Node& node = mNodes[index];
+				if (predicate(node))
+				{
+					return node.tile;
+				}
+				if (node.firstChild == noChild)
+				{
+					break;
+				}
+				int quadrant = (p[0] > node.split[0] ? 1 : 0) + (p[1] < node.split[1] ? 2 : 0);
+				index = node.firstChild + quadrant;
+			}
+		}
+		return nullptr;
+	}
+
+private:
+	std::vector<Box2T<VectorType>> mRootBounds;
+	std::vector<Node> mNodes;
+};
+
+template <class TileT>
+FlatQuadTree<TileT> createFlatQuadTree(const QuadTree<TileT>& tree)
+{
+	return FlatQuadTree<TileT>({&tree.getRoot()});
+}
+
+template <class TileT>
+FlatQuadTree<TileT> createFlatQuadTree(const DiQuadTree<TileT>& tree)
+{
+	return FlatQuadTree<TileT>({&tree.leftTree.getRoot(), &tree.rightTree.getRoot()});
+}
+
+} // namespace skybolt
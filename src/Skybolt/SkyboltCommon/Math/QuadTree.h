@@ -9,6 +9,7 @@
 #include "Box2.h"
 #include "MathUtility.h"
 #include <boost/functional/hash.hpp>
+#include <atomic>
 #include <functional>
 #include <assert.h>
 #include <map>
@@ -161,14 +162,18 @@ struct QuadTree
 		return nullptr;
 	}
 
-	const TileT* intersect(const typename TileT::VectorType& p, std::function<bool (const TileT&)> predicate) const
+	typedef std::function<bool(const TileT&)> IntersectionPredicate;
+
+	//! @param predicate is a callable with signature bool(const TileT&). Taken as a template parameter so that it can be inlined.
+	//! @returns the first tile, in depth first order, which contains the point and satisfies the predicate
+	template <typename PredicateT>
+	const TileT* intersect(const typename TileT::VectorType& p, const PredicateT& predicate) const
 	{
 		return intersect(p, getRoot(), predicate);
 	}
 
-	typedef std::function<bool(const TileT&)> IntersectionPredicate;
-
-	const TileT* intersect(const typename TileT::VectorType& p, const TileT& tile, IntersectionPredicate predicate) const
+	template <typename PredicateT>
+	const TileT* intersect(const typename TileT::VectorType& p, const TileT& tile, const PredicateT& predicate) const
 	{
 		if (tile.bounds.intersects(p))
 		{
@@ -215,7 +220,10 @@ struct QuadTree
 	}
 
 	using SubdivisionPredicate = std::function<bool(const TileT& tile)>;
-	void subdivideRecursively(TileT& tile, const SubdivisionPredicate& subdivisionRequired)
+
+	//! @param subdivisionRequired is a callable with signature bool(const TileT&)
+	template <typename PredicateT>
+	void subdivideRecursively(TileT& tile, const PredicateT& subdivisionRequired)
 	{
 		if (subdivisionRequired(tile))
 		{
@@ -255,7 +263,8 @@ struct DiQuadTree
 	{
 	}
 
-	const TileT* intersect(const typename TileT::VectorType& p, const typename skybolt::QuadTree<TileT>::IntersectionPredicate& predicate) const
+	template <typename PredicateT>
+	const TileT* intersect(const typename TileT::VectorType& p, const PredicateT& predicate) const
 	{
 		const TileT* result = leftTree.intersect(p, predicate);
 		if (!result)
@@ -276,57 +285,70 @@ DiQuadTree<TileT> createGlobeQuadTree(typename QuadTree<TileT>::TileCreator tile
 	return DiQuadTree<TileT>(tileCreator, QuadTreeTileKey(0, 0, 0), leftBounds, QuadTreeTileKey(0, 1, 0), rightBounds);
 }
 
-template <class TreeT>
+//! Finds tiles intersecting points, caching the last tile found by each thread so that queries of nearby points are fast.
+//! @param TreeT is a QuadTree, DiQuadTree or FlatQuadTree
+template <class TreeT, class PredicateT = typename QuadTree<typename TreeT::TileType>::IntersectionPredicate>
 class LruCachedLeafIntersector
 {
 public:
-	LruCachedLeafIntersector(const std::shared_ptr<TreeT>& tree, typename QuadTree<typename TreeT::TileType>::IntersectionPredicate predicate) :
-		tree(tree), predicate(std::move(predicate)) {}
+	using TileType = typename TreeT::TileType;
+
+	LruCachedLeafIntersector(const std::shared_ptr<TreeT>& tree, PredicateT predicate) :
+		tree(tree), predicate(std::move(predicate)), id(createId()) {}
 
 	//! @ThreadSafe
-	const typename TreeT::TileType* intersect(const typename TreeT::TileType::VectorType& p)
+	const TileType* intersect(const typename TileType::VectorType& p)
 	{
-		const typename TreeT::TileType* tile = getLastTile();
-		if (tile && tile->bounds.intersects(p))
+		LastTile& lastTile = getThreadLastTile();
+		uint64_t currentGeneration = generation.load(std::memory_order_acquire);
+		if (lastTile.intersectorId == id && lastTile.generation == currentGeneration
+			&& lastTile.tile && lastTile.tile->bounds.intersects(p))
 		{
-			return tile;
+			return lastTile.tile;
 		}
-		tile = tree->intersect(p, predicate);
-		setLastTile(tile);
+
+		const TileType* tile = tree->intersect(p, predicate);
+		lastTile.intersectorId = id;
+		lastTile.generation = currentGeneration;
+		lastTile.tile = tile;
 		return tile;
 	}
 
 	//! @ThreadSafe
 	void invalidateCache()
 	{
-		std::unique_lock<std::shared_mutex> lock(lastTileMutex);
-		lastTileMap.clear();
+		generation.fetch_add(1, std::memory_order_acq_rel);
 	}
 
 private:
-	const typename TreeT::TileType* getLastTile()
+	struct LastTile
 	{
-		std::shared_lock<std::shared_mutex> lock(lastTileMutex);
-		auto i = lastTileMap.find(std::this_thread::get_id());
-		if (i != lastTileMap.end())
-		{
-			return i->second;
-		}
-		return nullptr;
+		uint64_t intersectorId = 0;
+		uint64_t generation = 0;
+		const TileType* tile = nullptr;
+	};
+
+	//! The last tile is cached per thread without locking. Each thread has a small number of slots, selected by intersector id.
+	//! A slot written by a different intersector, or before the cache was invalidated, is ignored.
+	LastTile& getThreadLastTile() const
+	{
+		static constexpr size_t slotCount = 8;
+		thread_local LastTile slots[slotCount];
+		return slots[id % slotCount];
 	}
 
-	void setLastTile(const typename TreeT::TileType* tile)
+	//! @returns an id which is never reused, so that slots written by destroyed intersectors are never mistaken for our own
+	static uint64_t createId()
 	{
-		std::unique_lock<std::shared_mutex> lock(lastTileMutex);
-		lastTileMap[std::this_thread::get_id()] = tile;
+		static std::atomic<uint64_t> nextId(1);
+		return nextId++;
 	}
 
 private:
 	const std::shared_ptr<TreeT> tree;
-	typename QuadTree<typename TreeT::TileType>::IntersectionPredicate predicate;
-
-	std::map<std::thread::id, const typename TreeT::TileType*> lastTileMap;
-	std::shared_mutex lastTileMutex;
+	PredicateT predicate;
+	const uint64_t id;
+	std::atomic<uint64_t> generation{0};
 };
 
 
@@ -0,0 +1,287 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "Profiler.h"
+
+#include <boost/core/demangle.hpp>
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <map>
+#include <ostream>
+#include <tuple>
+
+namespace skybolt {
+
+std::atomic<bool> Profiler::sEnabled = false;
+
+struct Profiler::ThreadBuffer
+{
+	std::mutex mutex; //!< Guards events
+	std::vector<ProfileEvent> events;
+	int depth = 0; //!< Only accessed by the owning thread
+	int threadIndex;
+	std::string threadName;
+};
+
+struct Profiler::Impl
+{
+	const std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+
+	mutable std::mutex mutex;
+	std::vector<std::shared_ptr<ThreadBuffer>> threadBuffers; //!< Retained after threads exit so their events are not lost
+	std::shared_ptr<const FrameProfile> lastFrameProfile;
+	int64_t frameNumber = 0;
+	int64_t lastFrameEndNanoseconds = 0;
+
+	bool capturing = false;
+	std::vector<ProfileEvent> capturedEvents;
+};
+
+Profiler& Profiler::instance()
+{
+	static Profiler profiler;
+	return profiler;
+}
+
+Profiler::Profiler() :
+	mImpl(std::make_unique<Impl>())
+{
+}
+
+Profiler::~Profiler() = default;
+
+int64_t Profiler::getTimeNanoseconds() const
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - mImpl->epoch).count();
+}
+
+Profiler::ThreadBuffer& Profiler::getThreadBuffer()
+{
+	thread_local ThreadBuffer* threadBuffer = nullptr;
+	if (!threadBuffer)
+	{
+		auto buffer = std::make_shared<ThreadBuffer>();
+
+		std::scoped_lock<std::mutex> lock(mImpl->mutex);
+		buffer->threadIndex = int(mImpl->threadBuffers.size());
+		buffer->threadName = "Thread " + std::to_string(buffer->threadIndex);
+		mImpl->threadBuffers.push_back(buffer);
+		threadBuffer = buffer.get();
+	}
+	return *threadBuffer;
+}
+
+void Profiler::setThreadName(const std::string& name)
+{
+	ThreadBuffer& buffer = getThreadBuffer();
+	std::scoped_lock<std::mutex> lock(mImpl->mutex);
+	buffer.threadName = name;
+}
+
+std::vector<ProfileEvent> Profiler::takeRecordedEvents()
+{
+	std::vector<ProfileEvent> result;
+	for (const auto& buffer : mImpl->threadBuffers)
+	{
+		std::scoped_lock<std::mutex> lock(buffer->mutex);
+		result.insert(result.end(), buffer->events.begin(), buffer->events.end());
+		buffer->events.clear();
+	}
+	return result;
+}
+
+static void mergeChild(ProfileNode& parent, const ProfileEvent& event, std::vector<ProfileNode*>& stack)
+{
+	auto i = std::find_if(parent.children.begin(), parent.children.end(), [&] (const ProfileNode& node) {
+		return node.name == event.name || std::strcmp(node.name, event.name) == 0;
+	});
+
+	if (i == parent.children.end())
+	{
+		ProfileNode node;
+		node.name = event.name;
+		parent.children.push_back(node);
+		i = parent.children.end() - 1;
+	}
+
+	i->totalMilliseconds += double(event.durationNanoseconds) * 1e-6;
+	++i->callCount;
+	stack.push_back(&*i);
+}
+
+ProfileNode buildProfileTree(std::vector<ProfileEvent> events)
+{
+	// Zones are recorded when they end, so children precede their parents.
+	// Sort parents before children so that the hierarchy can be built with a stack.
+	std::sort(events.begin(), events.end(), [] (const ProfileEvent& a, const ProfileEvent& b) {
+		return std::tie(a.startNanoseconds, a.depth) < std::tie(b.startNanoseconds, b.depth);
+	});
+
+	ProfileNode root;
+	std::vector<ProfileNode*> stack; //!< Path from the root's children to the current node
+
+	for (const ProfileEvent& event : events)
+	{
+		// Pop to the event's parent. If the parent's zone had not ended when events were collected,
+		// the event is attached to its nearest recorded ancestor.
+		while (int(stack.size()) > event.depth)
+		{
+			stack.pop_back();
+		}
+		ProfileNode& parent = stack.empty() ? root : *stack.back();
+
+		// Adding a child may reallocate the parent's children, but the stack holds no pointers to them
+		mergeChild(parent, event, stack);
+	}
+	return root;
+}
+
+void Profiler::endFrame()
+{
+	std::scoped_lock<std::mutex> lock(mImpl->mutex);
+
+	std::vector<ProfileEvent> events = takeRecordedEvents();
+	int64_t now = getTimeNanoseconds();
+
+	auto profile = std::make_shared<FrameProfile>();
+	profile->frameNumber = mImpl->frameNumber++;
+	profile->durationMilliseconds = double(now - mImpl->lastFrameEndNanoseconds) * 1e-6;
+	mImpl->lastFrameEndNanoseconds = now;
+
+	std::map<int, std::vector<ProfileEvent>> threadEvents;
+	for (const ProfileEvent& event : events)
+	{
+		threadEvents[event.threadIndex].push_back(event);
+	}
+
+	for (auto& [threadIndex, eventsOfThread] : threadEvents)
+	{
+		ThreadProfile thread;
+		thread.threadIndex = threadIndex;
+		thread.threadName = mImpl->threadBuffers[threadIndex]->threadName;
+		thread.root = buildProfileTree(std::move(eventsOfThread));
+		profile->threads.push_back(std::move(thread));
+	}
+	mImpl->lastFrameProfile = profile;
+
+	if (mImpl->capturing)
+	{
+		mImpl->capturedEvents.insert(mImpl->capturedEvents.end(), events.begin(), events.end());
+	}
+}
+
+std::shared_ptr<const FrameProfile> Profiler::getLastFrameProfile() const
+{
+	std::scoped_lock<std::mutex> lock(mImpl->mutex);
+	return mImpl->lastFrameProfile;
+}
+
+void Profiler::setCapturing(bool capturing)
+{
+	std::scoped_lock<std::mutex> lock(mImpl->mutex);
+	mImpl->capturing = capturing;
+}
+
+bool Profiler::isCapturing() const
+{
+	std::scoped_lock<std::mutex> lock(mImpl->mutex);
+	return mImpl->capturing;
+}
+
+void Profiler::writeChromeTrace(std::ostream& stream)
+{
+	std::vector<ProfileEvent> events;
+	std::vector<std::string> threadNames;
+	{
+		std::scoped_lock<std::mutex> lock(mImpl->mutex);
+		events = std::move(mImpl->capturedEvents);
+		mImpl->capturedEvents.clear();
+
+		std::vector<ProfileEvent> pendingEvents = takeRecordedEvents();
+		events.insert(events.end(), pendingEvents.begin(), pendingEvents.end());
+
+		for (const auto& buffer : mImpl->threadBuffers)
+		{
+			threadNames.push_back(buffer->threadName);
+		}
+	}
+
+	nlohmann::json traceEvents = nlohmann::json::array();
+	for (size_t i = 0; i < threadNames.size(); ++i)
+	{
+		traceEvents.push_back({
+			{"name", "thread_name"},
+			{"ph", "M"},
+			{"pid", 1},
+			{"tid", i},
+			{"args", {{"name", threadNames[i]}}}
+		});
+	}
+
+	std::map<const char*, std::string> displayNames;
+	for (const ProfileEvent& event : events)
+	{
+		auto i = displayNames.find(event.name);
+		if (i == displayNames.end())
+		{
+			i = displayNames.insert({event.name, getProfileZoneDisplayName(event.name)}).first;
+		}
+
+		traceEvents.push_back({
+			{"name", i->second},
+			{"ph", "X"},
+			{"pid", 1},
+			{"tid", event.threadIndex},
+			{"ts", double(event.startNanoseconds) * 1e-3},
+			{"dur", double(event.durationNanoseconds) * 1e-3}
+		});
+	}
+
+	nlohmann::json json;
+	json["traceEvents"] = std::move(traceEvents);
+	json["displayTimeUnit"] = "ms";
+	stream << json.dump();
+}
+
+void ProfileZone::begin(const char* name)
+{
+	Profiler& profiler = Profiler::instance();
+	mBuffer = &profiler.getThreadBuffer();
+	mName = name;
+	mDepth = mBuffer->depth++;
+	mStartNanoseconds = profiler.getTimeNanoseconds();
+}
+
+void ProfileZone::end()
+{
+	Profiler& profiler = Profiler::instance();
+	int64_t endNanoseconds = profiler.getTimeNanoseconds();
+	--mBuffer->depth;
+
+	std::scoped_lock<std::mutex> lock(mBuffer->mutex);
+	mBuffer->events.push_back({mName, mStartNanoseconds, endNanoseconds - mStartNanoseconds, mDepth, mBuffer->threadIndex});
+}
+
+std::string getProfileZoneDisplayName(const char* name)
+{
+	// Type names from std::type_info are mangled on some platforms. Other names pass through unchanged.
+	std::string result = boost::core::demangle(name);
+
+	// Remove redundant qualifiers to keep names short in displays
+	for (const std::string& prefix : {"class ", "struct ", "skybolt::sim::", "skybolt::vis::", "skybolt::"})
+	{
+		for (size_t pos = result.find(prefix); pos != std::string::npos; pos = result.find(prefix, pos))
+		{
+			result.erase(pos, prefix.size());
+		}
+	}
+	return result;
+}
+
+} // namespace skybolt
@@ -0,0 +1,143 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <iosfwd>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace skybolt {
+
+struct ProfileEvent
+{
+	const char* name; //!< Must remain valid for the lifetime of the program, e.g. a string literal or std::type_info::name()
+	int64_t startNanoseconds; //!< Relative to the profiler's creation
+	int64_t durationNanoseconds;
+	int depth; //!< Number of enclosing zones on the same thread
+	int threadIndex;
+};
+
+struct ProfileNode
+{
+	const char* name = nullptr;
+	double totalMilliseconds = 0;
+	int callCount = 0;
+	std::vector<ProfileNode> children;
+};
+
+struct ThreadProfile
+{
+	int threadIndex;
+	std::string threadName;
+	ProfileNode root; //!< The root's children are the thread's outermost zones
+};
+
+struct FrameProfile
+{
+	int64_t frameNumber = 0;
+	double durationMilliseconds = 0;
+	std::vector<ThreadProfile> threads; //!< Threads which recorded zones in the frame
+};
+
+//! Collects timings of scoped zones from all threads.
+//! There is one Profiler per module. Plugins built as separate shared libraries record to their own instance.
+class Profiler
+{
+public:
+	static Profiler& instance();
+
+	//! Profiling is disabled by default. While disabled, a zone costs one relaxed atomic load.
+	static bool isEnabled() { return sEnabled.load(std::memory_order_relaxed); }
+	static void setEnabled(bool enabled) { sEnabled.store(enabled, std::memory_order_relaxed); }
+
+	//! Names the calling thread in profiles and traces
+	void setThreadName(const std::string& name);
+
+	//! Aggregates the zones recorded by all threads since the previous call into a FrameProfile.
+	//! Should be called once per frame while profiling is enabled, otherwise recorded zones accumulate.
+	void endFrame();
+
+	//! @returns the profile of the most recently ended frame, or null if no frames have been profiled
+	std::shared_ptr<const FrameProfile> getLastFrameProfile() const;
+
+	//! While capturing, recorded zones are retained for export by writeChromeTrace()
+	void setCapturing(bool capturing);
+	bool isCapturing() const;
+
+	//! Writes captured zones and any zones recorded since the last endFrame() in Chrome trace event JSON format,
+	//! viewable in chrome://tracing or Perfetto. Written zones are cleared.
+	void writeChromeTrace(std::ostream& stream);
+
+	struct ThreadBuffer;
+	ThreadBuffer& getThreadBuffer(); //!< @returns buffer which the calling thread records zones into
+	int64_t getTimeNanoseconds() const;
+
+private:
+	Profiler();
+	~Profiler();
+
+	std::vector<ProfileEvent> takeRecordedEvents();
+
+private:
+	static std::atomic<bool> sEnabled;
+
+	struct Impl;
+	std::unique_ptr<Impl> mImpl;
+};
+
+//! Records the time between construction and destruction as a zone
+class ProfileZone
+{
+public:
+	//! @param name must remain valid for the lifetime of the program
+	explicit ProfileZone(const char* name)
+	{
+		if (Profiler::isEnabled())
+		{
+			begin(name);
+		}
+	}
+
+	~ProfileZone()
+	{
+		if (mBuffer)
+		{
+			end();
+		}
+	}
+
+	ProfileZone(const ProfileZone&) = delete;
+	ProfileZone& operator=(const ProfileZone&) = delete;
+
+private:
+	void begin(const char* name);
+	void end();
+
+private:
+	Profiler::ThreadBuffer* mBuffer = nullptr;
+	const char* mName;
+	int64_t mStartNanoseconds;
+	int mDepth;
+};
+
+//! @returns a human readable form of a name recorded in a zone, demangling type names where required
+std::string getProfileZoneDisplayName(const char* name);
+
+//! Builds the zone hierarchy from one thread's events
+ProfileNode buildProfileTree(std::vector<ProfileEvent> events);
+
+#define SKYBOLT_PROFILE_CONCAT_INNER(a, b) a##b
+#define SKYBOLT_PROFILE_CONCAT(a, b) SKYBOLT_PROFILE_CONCAT_INNER(a, b)
+
+//! Times the enclosing scope. @param name must remain valid for the lifetime of the program.
+#define SKYBOLT_PROFILE_ZONE(name) skybolt::ProfileZone SKYBOLT_PROFILE_CONCAT(skyboltProfileZone, __LINE__)(name)
+
+} // namespace skybolt
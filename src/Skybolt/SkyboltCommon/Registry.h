@@ -7,6 +7,7 @@
 #pragma once
 
 #include <map>
+#include <stdint.h>
 
 namespace skybolt {
 
@@ -16,11 +17,75 @@ public:
 	virtual ~Registry() = default;
 };
 
+//! Map of factories which tracks modifications, so that users can detect when results derived from the registry are stale.
+//! Items can only be modified through add(), replace(), remove() and clear(), which increment the version when they change the registry.
 template <typename KeyT, typename FactoryT>
-class RegistryT : public std::map<KeyT, FactoryT>, public Registry
+class RegistryT : public Registry
 {
 public:
+	using Map = std::map<KeyT, FactoryT>;
+	using const_iterator = typename Map::const_iterator;
+
 	~RegistryT() override = default;
+
+	//! Adds the item if there is no item with the same key
+	//! @returns false if an item with the key already exists, in which case the registry is unchanged
+	bool add(const KeyT& key, const FactoryT& factory)
+	{
+		bool added = mItems.emplace(key, factory).second;
+		if (added)
+		{
+			++mVersion;
+		}
+		return added;
+	}
+
+	//! Adds the item, replacing any existing item with the same key
+	void replace(const KeyT& key, const FactoryT& factory)
+	{
+		mItems[key] = factory;
+		++mVersion;
+	}
+
+	//! @returns true if an item was removed
+	bool remove(const KeyT& key)
+	{
+		bool removed = mItems.erase(key) > 0;
+		if (removed)
+		{
+			++mVersion;
+		}
+		return removed;
+	}
+
+	void clear()
+	{
+		if (!mItems.empty())
+		{
+			mItems.clear();
+			++mVersion;
+		}
+	}
+
+	//! @returns end() if not found
+	const_iterator find(const KeyT& key) const { return mItems.find(key); }
+
+	//! @throws std::out_of_range if not found
+	const FactoryT& at(const KeyT& key) const { return mItems.at(key); }
+
+	const_iterator begin() const { return mItems.begin(); }
+	const_iterator end() const { return mItems.end(); }
+	size_t size() const { return mItems.size(); }
+	bool empty() const { return mItems.empty(); }
+
+	const Map& getItems() const { return mItems; }
+
+	//! @returns a value which changes whenever an item is added, replaced or removed
+	uint64_t getVersion() const { return mVersion; }
+
+private:
+	Map mItems;
+	uint64_t mVersion = 0;
 };
 
 } // namespace skybolt
\ No newline at end of file
@@ -0,0 +1,215 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include <catch2/catch.hpp>
+#include <SkyboltCommon/ConcurrentLruCacheMap.h>
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+
+using namespace skybolt;
+
+TEST_CASE("ConcurrentLruCacheMap puts and gets items")
+{
+	ConcurrentLruCacheMap<std::string, int> cache(100);
+
+	CHECK(cache.putSafe("1", 1));
+	CHECK(cache.putSafe("2", 2));
+	CHECK(!cache.putSafe("2", 3));
+
+	int value;
+	CHECK(cache.get("1", value));
+	CHECK(value == 1);
+	CHECK(cache.get("2", value));
+	CHECK(value == 2);
+	CHECK(!cache.get("3", value));
+
+	CHECK(cache.exists("1"));
+	CHECK(!cache.exists("3"));
+
+	LruCacheStatistics statistics = cache.getStatistics();
+	CHECK(statistics.hitCount == 2);
+	CHECK(statistics.missCount == 1);
+	CHECK(statistics.insertionCount == 2);
+	CHECK(statistics.evictionCount == 0);
+	CHECK(statistics.itemCount == 2);
+	CHECK(statistics.totalCost == 2);
+}
+
+TEST_CASE("ConcurrentLruCacheMap evicts items to keep total cost within capacity")
+{
+	const size_t shardCount = 4;
+	const size_t capacity = 1000;
+	const size_t itemCost = 100;
+
+	std::vector<int> evictedKeys;
+	ConcurrentLruCacheMap<int, std::string> cache(capacity, [] (const std::string& value) { return value.size(); },
+		[&] (int key, const std::string& value) {
+			evictedKeys.push_back(key);
+			CHECK(value.size() == itemCost);
+		}, shardCount);
+
+	const int itemCount = 100;
+	for (int i = 0; i < itemCount; ++i)
+	{
+		cache.putSafe(i, std::string(itemCost, 'a'));
+		CHECK(cache.getTotalCost() <= capacity);
+	}
+
+	LruCacheStatistics statistics = cache.getStatistics();
+	CHECK(statistics.totalCost == statistics.itemCount * itemCost);
+	CHECK(statistics.evictionCount == int64_t(evictedKeys.size()));
+	CHECK(statistics.itemCount + evictedKeys.size() == itemCount);
+
+	// Total cost is bounded across all shards, so the map is filled to capacity
+	CHECK(statistics.totalCost == capacity);
+	CHECK(cache.getTotalCost() == capacity);
+	for (int key : evictedKeys)
+	{
+		CHECK(!cache.exists(key));
+	}
+}
+
+TEST_CASE("ConcurrentLruCacheMap retains items costing more than a shard's share of capacity")
+{
+	const size_t shardCount = 4;
+	const size_t capacity = 1000;
+
+	int evictionCount = 0;
+	ConcurrentLruCacheMap<int, std::string> cache(capacity, [] (const std::string& value) { return value.size(); },
+		[&] (int, const std::string&) { ++evictionCount; }, shardCount);
+
+	CHECK(cache.putSafe(1, std::string(600, 'a')));
+	CHECK(cache.exists(1));
+
+	// Inserting an item which does not fit evicts the least recently used item, whichever shard holds it
+	CHECK(cache.putSafe(2, std::string(600, 'a')));
+	CHECK(!cache.exists(1));
+	CHECK(cache.exists(2));
+	CHECK(evictionCount == 1);
+	CHECK(cache.getTotalCost() == 600);
+
+	// Items costing more than the whole capacity are refused without evicting anything
+	CHECK(!cache.putSafe(3, std::string(capacity + 1, 'a')));
+	CHECK(!cache.exists(3));
+	CHECK(cache.exists(2));
+	CHECK(evictionCount == 1);
+}
+
+TEST_CASE("ConcurrentLruCacheMap is consistent when used from multiple threads")
+{
+	const size_t capacity = 500;
+	std::atomic<int64_t> evictionCallbackCount = 0;
+	std::atomic<int64_t> wrongValueCount = 0; // Counted rather than checked because Catch assertions are not thread safe
+	ConcurrentLruCacheMap<int, int> cache(capacity, nullptr, [&] (int key, int value) {
+		wrongValueCount += (value != key * 2);
+		++evictionCallbackCount;
+	});
+
+	const int threadCount = 8;
+	const int operationCount = 20000;
+	std::vector<std::thread> threads;
+	for (int t = 0; t < threadCount; ++t)
+	{
+		threads.emplace_back([&, t] {
+			std::mt19937 generator(t);
+			std::uniform_int_distribution<int> distribution(0, 2000);
+			for (int i = 0; i < operationCount; ++i)
+			{
+				int key = distribution(generator);
+				int value;
+				if (cache.get(key, value))
+				{
+					wrongValueCount += (value != key * 2);
+				}
+				else
+				{
+					cache.putSafe(key, key * 2);
+				}
+			}
+		});
+	}
+	for (std::thread& thread : threads)
+	{
+		thread.join();
+	}
+
+	CHECK(wrongValueCount == 0);
+
+	LruCacheStatistics statistics = cache.getStatistics();
+	CHECK(statistics.hitCount + statistics.missCount == threadCount * operationCount);
+	CHECK(statistics.evictionCount == evictionCallbackCount);
+	CHECK(statistics.insertionCount - statistics.evictionCount == int64_t(statistics.itemCount));
+	CHECK(statistics.totalCost <= capacity);
+}
+
+TEST_CASE("Benchmark LruCacheMap contention", "[.benchmark]")
+{
+	const size_t capacity = 10000;
+	const int keyCount = 20000;
+	const int operationsPerThread = 1000000;
+
+	// Returns the value of each key, inserting it on a miss, as a tile cache would
+	auto benchmark = [&] (const std::string& name, int threadCount, const auto& getOrInsert) {
+		auto start = std::chrono::steady_clock::now();
+		std::vector<std::thread> threads;
+		std::atomic<int64_t> checksum = 0;
+		for (int t = 0; t < threadCount; ++t)
+		{
+			threads.emplace_back([&, t] {
+				std::mt19937 generator(t);
+				std::uniform_int_distribution<int> distribution(0, keyCount - 1);
+				int64_t sum = 0;
+				for (int i = 0; i < operationsPerThread; ++i)
+				{
+					sum += getOrInsert(distribution(generator));
+				}
+				checksum += sum;
+			});
+		}
+		for (std::thread& thread : threads)
+		{
+			thread.join();
+		}
+		double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		std::cout << name << " on " << threadCount << " threads: " << operationsPerThread * threadCount / seconds / 1e6
+			<< " million lookups per second (checksum " << checksum << ")" << std::endl;
+	};
+
+	for (int threadCount : {1, 2, 4, 8, 16, 32})
+	{
+		{
+			LruCacheMap<int, int> cache(capacity);
+			std::mutex mutex;
+			benchmark("LruCacheMap with mutex", threadCount, [&] (int key) {
+				std::scoped_lock<std::mutex> lock(mutex);
+				int value;
+				if (!cache.get(key, value))
+				{
+					value = key;
+					cache.putSafe(key, value);
+				}
+				return value;
+			});
+		}
+		{
+			ConcurrentLruCacheMap<int, int> cache(capacity);
+			benchmark("ConcurrentLruCacheMap", threadCount, [&] (int key) {
+				int value;
+				if (!cache.get(key, value))
+				{
+					value = key;
+					cache.putSafe(key, value);
+				}
+				return value;
+			});
+		}
+	}
+}
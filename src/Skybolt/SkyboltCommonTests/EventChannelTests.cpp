@@ -0,0 +1,188 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+
+#include <catch2/catch.hpp>
+#include <SkyboltCommon/Event.h>
+#include <SkyboltCommon/EventChannel.h>
+
+#include <chrono>
+#include <functional>
+#include <iostream>
+
+using namespace skybolt;
+
+namespace {
+
+struct TestEvent
+{
+	int value;
+};
+
+struct RecordingListener : public EventChannelListener<TestEvent>
+{
+	void onEvents(const std::vector<TestEvent>& events) override
+	{
+		for (const TestEvent& event : events)
+		{
+			values.push_back(event.value);
+		}
+		if (callback)
+		{
+			callback();
+		}
+	}
+
+	std::vector<int> values;
+	std::function<void()> callback;
+};
+
+} // namespace
+
+TEST_CASE("EventChannel delivers queued events in a batch on dispatch")
+{
+	EventChannel<TestEvent> channel;
+	RecordingListener listener;
+	channel.addListener(&listener);
+
+	channel.publish({1});
+	channel.emplace(TestEvent{2});
+	CHECK(listener.values.empty());
+	CHECK(channel.getPendingEventCount() == 2);
+
+	channel.dispatch();
+	CHECK(listener.values == std::vector<int>({1, 2}));
+	CHECK(channel.getPendingEventCount() == 0);
+
+	// Events are not redelivered
+	channel.dispatch();
+	CHECK(listener.values.size() == 2);
+}
+
+TEST_CASE("EventChannel listeners can be removed during dispatch")
+{
+	EventChannel<TestEvent> channel;
+	RecordingListener first;
+	RecordingListener second;
+	channel.addListener(&first);
+	channel.addListener(&second);
+
+	first.callback = [&] { channel.removeListener(&second); };
+
+	channel.publish({1});
+	channel.dispatch();
+	CHECK(first.values.size() == 1);
+	CHECK(second.values.empty());
+
+	channel.publish({2});
+	channel.dispatch();
+	CHECK(first.values.size() == 2);
+	CHECK(second.values.empty());
+}
+
+TEST_CASE("EventChannel defers listeners and events added during dispatch to next dispatch")
+{
+	EventChannel<TestEvent> channel;
+	RecordingListener first;
+	RecordingListener added;
+	channel.addListener(&first);
+
+	first.callback = [&] {
+		channel.addListener(&added);
+		channel.publish({2});
+		first.callback = nullptr;
+	};
+
+	channel.publish({1});
+	channel.dispatch();
+	CHECK(first.values == std::vector<int>({1}));
+	CHECK(added.values.empty());
+
+	channel.dispatch();
+	CHECK(first.values == std::vector<int>({1, 2}));
+	CHECK(added.values == std::vector<int>({2}));
+}
+
+namespace {
+
+struct EmitterTestEvent : public Event
+{
+	int value;
+};
+
+struct CountingEventListener : public EventListener
+{
+	void onEvent(const Event& event) override
+	{
+		sum += static_cast<const EmitterTestEvent&>(event).value;
+	}
+	int64_t sum = 0;
+};
+
+struct CountingChannelListener : public EventChannelListener<TestEvent>
+{
+	void onEvents(const std::vector<TestEvent>& events) override
+	{
+		for (const TestEvent& event : events)
+		{
+			sum += event.value;
+		}
+	}
+	int64_t sum = 0;
+};
+
+} // namespace
+
+TEST_CASE("Benchmark EventChannel against EventEmitter", "[.benchmark]")
+{
+	const int eventCount = 1000000;
+	const int eventsPerDispatch = 100; // e.g. collision events in one dynamics substep
+	const int listenerCount = 4;
+
+	auto printRate = [&] (const std::string& method, std::chrono::steady_clock::time_point start) {
+		double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		std::cout << method << ": " << eventCount / seconds << " events per second" << std::endl;
+	};
+
+	{
+		EventEmitter emitter;
+		std::vector<CountingEventListener> listeners(listenerCount);
+		for (auto& listener : listeners)
+		{
+			emitter.addEventListener<EmitterTestEvent>(&listener);
+		}
+
+		auto start = std::chrono::steady_clock::now();
+		EmitterTestEvent event;
+		for (int i = 0; i < eventCount; ++i)
+		{
+			event.value = i;
+			emitter.emitEvent(event);
+		}
+		printRate("EventEmitter", start);
+	}
+
+	{
+		EventChannel<TestEvent> channel(eventsPerDispatch);
+		std::vector<CountingChannelListener> listeners(listenerCount);
+		for (auto& listener : listeners)
+		{
+			channel.addListener(&listener);
+		}
+
+		auto start = std::chrono::steady_clock::now();
+		for (int i = 0; i < eventCount; ++i)
+		{
+			channel.publish({i});
+			if (channel.getPendingEventCount() == eventsPerDispatch)
+			{
+				channel.dispatch();
+			}
+		}
+		channel.dispatch();
+		printRate("EventChannel", start);
+	}
+}
@@ -0,0 +1,254 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include <catch2/catch.hpp>
+#include <SkyboltCommon/Math/FlatQuadTree.h>
+
+#include <osg/Vec2d>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <thread>
+
+using namespace skybolt;
+
+using Tile = DefaultTile<osg::Vec2d>;
+using Tree = DiQuadTree<Tile>;
+
+namespace {
+
+//! @returns a globe tree subdivided to maxLevel near the focus point, and less deeply further away, like a planet's tile tree.
+//! @param fullDetailRadius is the distance from the focus within which all tiles are subdivided to maxLevel
+std::shared_ptr<Tree> createTree(const osg::Vec2d& focus, int maxLevel, double fullDetailRadius = 0.0)
+{
+	auto tree = std::make_shared<Tree>(createGlobeQuadTree<Tile>(createDefaultTile<osg::Vec2d>));
+	auto subdivisionRequired = [&] (const Tile& tile) {
+		osg::Vec2d nearest(std::clamp(focus.x(), tile.bounds.minimum.x(), tile.bounds.maximum.x()),
+			std::clamp(focus.y(), tile.bounds.minimum.y(), tile.bounds.maximum.y()));
+		double distance = (nearest - focus).length();
+		return tile.key.level < maxLevel && distance < std::max(fullDetailRadius, tile.bounds.size().x() * 2.0);
+	};
+	tree->leftTree.subdivideRecursively(tree->leftTree.getRoot(), subdivisionRequired);
+	tree->rightTree.subdivideRecursively(tree->rightTree.getRoot(), subdivisionRequired);
+	return tree;
+}
+
+std::vector<osg::Vec2d> createRandomPoints(size_t count, const osg::Vec2d& center, double radius)
+{
+	std::mt19937 generator(0);
+	std::uniform_real_distribution<double> distribution(-radius, radius);
+	std::vector<osg::Vec2d> points(count);
+	for (osg::Vec2d& point : points)
+	{
+		point = osg::Vec2d(std::clamp(center.x() + distribution(generator), -math::piD(), math::piD()),
+			std::clamp(center.y() + distribution(generator), -math::halfPiD(), math::halfPiD()));
+	}
+	return points;
+}
+
+template <typename TileT, typename VisitorT>
+void traverseRecursively(const TileT& tile, const VisitorT& visitor)
+{
+	if (visitor(tile) && tile.hasChildren())
+	{
+		for (int i = 0; i < 4; ++i)
+		{
+			traverseRecursively(*tile.children[i], visitor);
+		}
+	}
+}
+
+} // namespace
+
+TEST_CASE("Flat quad tree queries match quad tree")
+{
+	const osg::Vec2d focus(0.3, 0.4);
+	std::shared_ptr<Tree> tree = createTree(focus, 12);
+	FlatQuadTree<Tile> flatTree = createFlatQuadTree(*tree);
+
+	std::vector<osg::Vec2d> points = createRandomPoints(10000, focus, 0.5);
+	// Include points on the boundaries between tiles
+	points.push_back(osg::Vec2d(0, 0));
+	points.push_back(osg::Vec2d(-math::piD(), math::halfPiD()));
+	points.push_back(osg::Vec2d(math::piD(), -math::halfPiD()));
+
+	auto isLeaf = [] (const Tile& tile) { return !tile.hasChildren(); };
+	auto isLevel8 = [] (const Tile& tile) { return tile.key.level == 8; };
+
+	for (const osg::Vec2d& point : points)
+	{
+		const Tile* leaf = tree->intersect(point, isLeaf);
+		REQUIRE(leaf);
+		CHECK(flatTree.intersectLeaf(point) == leaf);
+		CHECK(flatTree.intersect(point, isLeaf) == leaf);
+		CHECK(flatTree.intersect(point, isLevel8) == tree->intersect(point, isLevel8));
+	}
+
+	CHECK(flatTree.intersectLeaf(osg::Vec2d(4, 0)) == nullptr);
+}
+
+TEST_CASE("Flat quad tree traverses in depth first order")
+{
+	std::shared_ptr<Tree> tree = createTree(osg::Vec2d(0.3, 0.4), 6);
+	FlatQuadTree<Tile> flatTree = createFlatQuadTree(*tree);
+
+	std::vector<QuadTreeTileKey> expectedKeys;
+	auto shouldTraverse = [] (const Tile& tile) { return tile.key.level < 4 || tile.key.x % 2 == 0; };
+	auto recordExpected = [&] (const Tile& tile) {
+		expectedKeys.push_back(tile.key);
+		return shouldTraverse(tile);
+	};
+	traverseRecursively(tree->leftTree.getRoot(), recordExpected);
+	traverseRecursively(tree->rightTree.getRoot(), recordExpected);
+
+	std::vector<QuadTreeTileKey> keys;
+	flatTree.traverse([&] (const Tile& tile) {
+		keys.push_back(tile.key);
+		return shouldTraverse(tile);
+	});
+	CHECK(keys == expectedKeys);
+
+	size_t tileCount = 0;
+	flatTree.forEachTile([&] (const Tile&) { ++tileCount; });
+	CHECK(tileCount == flatTree.getTileCount());
+}
+
+TEST_CASE("Flat quad tree stores each level in Morton order")
+{
+	std::shared_ptr<Tree> tree = createTree(osg::Vec2d(0.3, 0.4), 6);
+	FlatQuadTree<Tile> flatTree = createFlatQuadTree(*tree);
+
+	auto mortonCode = [] (const QuadTreeTileKey& key) {
+		uint64_t code = 0;
+		for (int bit = 0; bit < 31; ++bit)
+		{
+			code |= uint64_t((key.x >> bit) & 1) << (2 * bit);
+			code |= uint64_t((key.y >> bit) & 1) << (2 * bit + 1);
+		}
+		return std::make_pair(key.level, code);
+	};
+
+	std::vector<std::pair<int, uint64_t>> codes;
+	flatTree.forEachTile([&] (const Tile& tile) { codes.push_back(mortonCode(tile.key)); });
+	CHECK(std::is_sorted(codes.begin(), codes.end()));
+}
+
+TEST_CASE("Benchmark quad tree point queries and traversal", "[.benchmark]")
+{
+	const osg::Vec2d focus(0.3, 0.4);
+	std::shared_ptr<Tree> tree = createTree(focus, 16);
+	FlatQuadTree<Tile> flatTree = createFlatQuadTree(*tree);
+	std::cout << flatTree.getTileCount() << " tiles" << std::endl;
+
+	const size_t queryCount = 1000000;
+	std::vector<osg::Vec2d> points = createRandomPoints(queryCount, focus, 0.01);
+
+	int levelSum = 0;
+	auto printRate = [&] (const std::string& method, std::chrono::steady_clock::time_point start, size_t count) {
+		double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		std::cout << method << ": " << count / seconds / 1e6 << " million per second (checksum " << levelSum << ")" << std::endl;
+		levelSum = 0;
+	};
+
+	auto isLeaf = [] (const Tile& tile) { return !tile.hasChildren(); };
+	{
+		auto start = std::chrono::steady_clock::now();
+		QuadTree<Tile>::IntersectionPredicate predicate = isLeaf;
+		for (const osg::Vec2d& point : points)
+		{
+			levelSum += tree->intersect(point, predicate)->key.level;
+		}
+		printRate("DiQuadTree::intersect with std::function predicate", start, queryCount);
+	}
+	{
+		auto start = std::chrono::steady_clock::now();
+		for (const osg::Vec2d& point : points)
+		{
+			levelSum += tree->intersect(point, isLeaf)->key.level;
+		}
+		printRate("DiQuadTree::intersect with lambda predicate", start, queryCount);
+	}
+	{
+		auto start = std::chrono::steady_clock::now();
+		for (const osg::Vec2d& point : points)
+		{
+			levelSum += flatTree.intersectLeaf(point)->key.level;
+		}
+		printRate("FlatQuadTree::intersectLeaf", start, queryCount);
+	}
+
+	// Query points along a path so that consecutive queries usually hit the same tile, as with a moving entity
+	std::vector<osg::Vec2d> pathPoints(queryCount);
+	for (size_t i = 0; i < queryCount; ++i)
+	{
+		pathPoints[i] = focus + osg::Vec2d(0.01, 0.005) * (double(i) / double(queryCount));
+	}
+
+	auto benchmarkCachedIntersector = [&] (const std::string& name, auto& intersector, int threadCount) {
+		auto start = std::chrono::steady_clock::now();
+		std::vector<std::thread> threads;
+		std::atomic<int> threadLevelSum = 0;
+		for (int t = 0; t < threadCount; ++t)
+		{
+			threads.emplace_back([&] {
+				int sum = 0;
+				for (const osg::Vec2d& point : pathPoints)
+				{
+					sum += intersector.intersect(point)->key.level;
+				}
+				threadLevelSum += sum;
+			});
+		}
+		for (std::thread& thread : threads)
+		{
+			thread.join();
+		}
+		levelSum = threadLevelSum;
+		printRate(name + " on " + std::to_string(threadCount) + " threads", start, queryCount * threadCount);
+	};
+
+	for (int threadCount : {1, 4})
+	{
+		LruCachedLeafIntersector<Tree> intersector(tree, isLeaf);
+		benchmarkCachedIntersector("LruCachedLeafIntersector<DiQuadTree>", intersector, threadCount);
+
+		auto flatTreePtr = std::make_shared<FlatQuadTree<Tile>>(flatTree);
+		LruCachedLeafIntersector<FlatQuadTree<Tile>, decltype(isLeaf)> flatIntersector(flatTreePtr, isLeaf);
+		benchmarkCachedIntersector("LruCachedLeafIntersector<FlatQuadTree>", flatIntersector, threadCount);
+	}
+
+	std::shared_ptr<Tree> denseTree = createTree(focus, 8, 10.0);
+	FlatQuadTree<Tile> denseFlatTree = createFlatQuadTree(*denseTree);
+
+	const int traversalCount = 20;
+	{
+		auto start = std::chrono::steady_clock::now();
+		for (int i = 0; i < traversalCount; ++i)
+		{
+			auto visitor = [&] (const Tile& tile) {
+				levelSum += tile.key.level;
+				return true;
+			};
+			traverseRecursively(denseTree->leftTree.getRoot(), visitor);
+			traverseRecursively(denseTree->rightTree.getRoot(), visitor);
+		}
+		printRate("Recursive DiQuadTree traversal tiles", start, denseFlatTree.getTileCount() * traversalCount);
+	}
+	{
+		auto start = std::chrono::steady_clock::now();
+		for (int i = 0; i < traversalCount; ++i)
+		{
+			denseFlatTree.traverse([&] (const Tile& tile) {
+				levelSum += tile.key.level;
+				return true;
+			});
+		}
+		printRate("FlatQuadTree::traverse tiles", start, denseFlatTree.getTileCount() * traversalCount);
+	}
+}
@@ -69,3 +69,61 @@ TEST_CASE("LruCacheMap least recently used item is pruned when cache capacity ex
 
 	CHECK(!cache.exists("2"));
 }
+
+TEST_CASE("LruCacheMap prunes least recently used items when total cost exceeds capacity")
+{
+	LruCacheMap<std::string, std::string> cache(10, [] (const std::string& value) { return value.size(); });
+
+	cache.put("a", "1234");
+	cache.put("b", "1234");
+	CHECK(cache.getTotalCost() == 8);
+
+	std::string value;
+	CHECK(cache.get("a", value));
+
+	// Adding an item costing 4 exceeds capacity, so the least recently used item is pruned
+	cache.put("c", "1234");
+	CHECK(cache.getTotalCost() == 8);
+	CHECK(cache.exists("a"));
+	CHECK(!cache.exists("b"));
+	CHECK(cache.exists("c"));
+
+	// Items costing more than the capacity are not retained
+	cache.put("d", "12345678901");
+	CHECK(cache.size() == 0);
+	CHECK(cache.getTotalCost() == 0);
+}
+
+TEST_CASE("LruCacheMap calls eviction callback for pruned items")
+{
+	std::vector<std::string> evictedKeys;
+	LruCacheMap<std::string, int> cache(2, nullptr, [&] (const std::string& key, int value) {
+		evictedKeys.push_back(key);
+		CHECK(std::to_string(value) == key);
+	});
+
+	cache.put("1", 1);
+	cache.put("2", 2);
+	CHECK(evictedKeys.empty());
+
+	cache.put("3", 3);
+	CHECK(evictedKeys == std::vector<std::string>({"1"}));
+
+	CHECK(cache.evictLeastRecentlyUsed());
+	CHECK(evictedKeys == std::vector<std::string>({"1", "2"}));
+	CHECK(cache.evictLeastRecentlyUsed());
+	CHECK(!cache.evictLeastRecentlyUsed());
+	CHECK(cache.size() == 0);
+}
+
+TEST_CASE("LruCacheMap uses explicit item cost")
+{
+	LruCacheMap<std::string, std::string> cache(10, [] (const std::string& value) { return value.size(); });
+
+	CHECK(cache.putSafe("a", "1", 6));
+	CHECK(cache.getTotalCost() == 6);
+
+	cache.put("b", "1", 6);
+	CHECK(!cache.exists("a"));
+	CHECK(cache.getTotalCost() == 6);
+}
@@ -0,0 +1,174 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+
+#include <catch2/catch.hpp>
+#include <SkyboltCommon/Profiling/Profiler.h>
+
+#include <nlohmann/json.hpp>
+#include <chrono>
+#include <iostream>
+#include <set>
+#include <sstream>
+#include <typeinfo>
+
+using namespace skybolt;
+
+namespace {
+
+struct ProfilerEnabledScope
+{
+	ProfilerEnabledScope(bool enabled) : wasEnabled(Profiler::isEnabled()) { Profiler::setEnabled(enabled); }
+	~ProfilerEnabledScope() { Profiler::setEnabled(wasEnabled); }
+	bool wasEnabled;
+};
+
+const ProfileNode* findChild(const ProfileNode& node, const std::string& name)
+{
+	for (const ProfileNode& child : node.children)
+	{
+		if (name == child.name)
+		{
+			return &child;
+		}
+	}
+	return nullptr;
+}
+
+const ProfileNode* findOutermostZone(const FrameProfile& profile, const std::string& name)
+{
+	for (const ThreadProfile& thread : profile.threads)
+	{
+		if (const ProfileNode* node = findChild(thread.root, name); node)
+		{
+			return node;
+		}
+	}
+	return nullptr;
+}
+
+} // namespace
+
+TEST_CASE("Profile tree nests zones and merges repeated zones")
+{
+	static const char* outer = "Outer";
+	static const char* inner = "Inner";
+
+	// Events are recorded in order of completion
+	std::vector<ProfileEvent> events = {
+		{inner, 10, 5, 1, 0},
+		{inner, 20, 5, 1, 0},
+		{outer, 0, 30, 0, 0},
+		{outer, 40, 10, 0, 0}
+	};
+
+	ProfileNode root = buildProfileTree(events);
+	REQUIRE(root.children.size() == 1);
+
+	const ProfileNode& outerNode = root.children.front();
+	CHECK(std::string(outerNode.name) == outer);
+	CHECK(outerNode.callCount == 2);
+	CHECK(outerNode.totalMilliseconds == Approx(40e-6));
+
+	REQUIRE(outerNode.children.size() == 1);
+	const ProfileNode& innerNode = outerNode.children.front();
+	CHECK(std::string(innerNode.name) == inner);
+	CHECK(innerNode.callCount == 2);
+	CHECK(innerNode.totalMilliseconds == Approx(10e-6));
+}
+
+TEST_CASE("Profiler records zones only while enabled")
+{
+	Profiler& profiler = Profiler::instance();
+	{
+		ProfilerEnabledScope enabled(true);
+		profiler.endFrame(); // Discard zones recorded by other tests
+
+		{
+			SKYBOLT_PROFILE_ZONE("EnabledZone");
+			SKYBOLT_PROFILE_ZONE("NestedZone");
+		}
+		profiler.endFrame();
+	}
+
+	auto profile = profiler.getLastFrameProfile();
+	REQUIRE(profile);
+
+	const ProfileNode* zone = findOutermostZone(*profile, "EnabledZone");
+	REQUIRE(zone);
+	CHECK(zone->callCount == 1);
+	CHECK(findChild(*zone, "NestedZone"));
+
+	{
+		ProfilerEnabledScope enabled(false);
+		SKYBOLT_PROFILE_ZONE("DisabledZone");
+	}
+	profiler.endFrame();
+
+	profile = profiler.getLastFrameProfile();
+	REQUIRE(profile);
+	CHECK(!findOutermostZone(*profile, "DisabledZone"));
+}
+
+TEST_CASE("Profiler writes captured zones as Chrome trace")
+{
+	Profiler& profiler = Profiler::instance();
+	ProfilerEnabledScope enabled(true);
+	profiler.endFrame();
+	profiler.setCapturing(true);
+
+	{
+		SKYBOLT_PROFILE_ZONE("FirstFrameZone");
+	}
+	profiler.endFrame();
+	{
+		SKYBOLT_PROFILE_ZONE("PendingZone");
+	}
+
+	std::stringstream stream;
+	profiler.writeChromeTrace(stream);
+	profiler.setCapturing(false);
+
+	nlohmann::json json = nlohmann::json::parse(stream.str());
+	const nlohmann::json& traceEvents = json.at("traceEvents");
+
+	std::set<std::string> zoneNames;
+	for (const nlohmann::json& event : traceEvents)
+	{
+		if (event.at("ph") == "X")
+		{
+			zoneNames.insert(event.at("name").get<std::string>());
+			CHECK(event.at("dur").get<double>() >= 0);
+		}
+	}
+	CHECK(zoneNames == std::set<std::string>({"FirstFrameZone", "PendingZone"}));
+}
+
+TEST_CASE("Profile zone display names are demangled and unqualified")
+{
+	CHECK(getProfileZoneDisplayName("Plain name") == "Plain name");
+	CHECK(getProfileZoneDisplayName(typeid(ProfileZone).name()) == "ProfileZone");
+}
+
+TEST_CASE("Benchmark profile zone overhead", "[.benchmark]")
+{
+	const int zoneCount = 1000000;
+	for (bool enabled : {false, true})
+	{
+		ProfilerEnabledScope enabledScope(enabled);
+
+		auto start = std::chrono::steady_clock::now();
+		for (int i = 0; i < zoneCount; ++i)
+		{
+			SKYBOLT_PROFILE_ZONE("BenchmarkZone");
+		}
+		double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		Profiler::instance().endFrame();
+
+		std::cout << (enabled ? "Enabled" : "Disabled") << " profile zone: "
+			<< seconds * 1e9 / zoneCount << " ns per zone" << std::endl;
+	}
+}
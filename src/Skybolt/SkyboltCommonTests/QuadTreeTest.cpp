@@ -11,6 +11,8 @@
 
 #include <osg/Vec2>
 
+#include <thread>
+
 using namespace skybolt;
 
 typedef DefaultTile<osg::Vec2> Tile;
@@ -53,6 +55,37 @@ TEST_CASE("getKeyLonLatBounds")
 	CHECK(bounds.maximum.y() == boundsSwapped.maximum.x());
 }
 
+TEST_CASE("LruCachedLeafIntersector finds leaf tiles")
+{
+	using Tree = QuadTree<Tile>;
+	auto tree = std::make_shared<Tree>(createDefaultTile<osg::Vec2>, QuadTreeTileKey(0, 0, 0), Box2T<osg::Vec2>(osg::Vec2(0, 0), osg::Vec2(1, 1)));
+	auto isLeaf = [] (const Tile& tile) { return !tile.hasChildren(); };
+
+	LruCachedLeafIntersector<Tree> intersector(tree, isLeaf);
+	LruCachedLeafIntersector<Tree> otherIntersector(tree, [] (const Tile&) { return true; });
+
+	osg::Vec2 point(0.25f, 0.75f);
+	CHECK(intersector.intersect(point) == &tree->getRoot());
+
+	// Cached tile is returned until the cache is invalidated
+	tree->subdivide(tree->getRoot());
+	CHECK(intersector.intersect(point) == &tree->getRoot());
+	intersector.invalidateCache();
+	CHECK(intersector.intersect(point) == tree->getRoot().children[0].get());
+
+	// Intersectors have separate caches
+	CHECK(otherIntersector.intersect(point) == &tree->getRoot());
+	CHECK(intersector.intersect(point) == tree->getRoot().children[0].get());
+
+	// Each thread has its own cache
+	const Tile* otherThreadTile = nullptr;
+	std::thread([&] {
+		otherThreadTile = intersector.intersect(osg::Vec2(0.75f, 0.25f));
+	}).join();
+	CHECK(otherThreadTile == tree->getRoot().children[3].get());
+	CHECK(intersector.intersect(point) == tree->getRoot().children[0].get());
+}
+
 TEST_CASE("getKeyAtLevelIntersectingPoint returns key that contains the point")
 {
 	osg::Vec2 point(0.234f, 0.567f);
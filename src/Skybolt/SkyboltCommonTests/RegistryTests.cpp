@@ -0,0 +1,72 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include <catch2/catch.hpp>
+#include <SkyboltCommon/Registry.h>
+
+#include <stdexcept>
+#include <string>
+
+using namespace skybolt;
+
+using TestRegistry = RegistryT<std::string, int>;
+
+TEST_CASE("Registry version changes when items are added, replaced or removed")
+{
+	TestRegistry registry;
+	uint64_t version = registry.getVersion();
+
+	CHECK(registry.add("a", 1));
+	CHECK(registry.getVersion() != version);
+	version = registry.getVersion();
+
+	// Adding an existing key leaves the registry unchanged
+	CHECK(!registry.add("a", 2));
+	CHECK(registry.at("a") == 1);
+	CHECK(registry.getVersion() == version);
+
+	registry.replace("a", 3);
+	CHECK(registry.at("a") == 3);
+	CHECK(registry.getVersion() != version);
+	version = registry.getVersion();
+
+	CHECK(!registry.remove("b"));
+	CHECK(registry.getVersion() == version);
+
+	CHECK(registry.remove("a"));
+	CHECK(registry.getVersion() != version);
+	CHECK(registry.empty());
+}
+
+TEST_CASE("Registry lookups do not change version")
+{
+	TestRegistry registry;
+	registry.add("a", 1);
+	uint64_t version = registry.getVersion();
+
+	auto i = registry.find("a");
+	REQUIRE(i != registry.end());
+	CHECK(i->second == 1);
+	CHECK(registry.find("b") == registry.end());
+	CHECK(registry.at("a") == 1);
+	CHECK_THROWS_AS(registry.at("b"), std::out_of_range);
+	CHECK(registry.size() == 1);
+
+	CHECK(registry.getVersion() == version);
+}
+
+TEST_CASE("Registry is copyable")
+{
+	TestRegistry registry;
+	registry.add("a", 1);
+
+	TestRegistry copy = registry;
+	CHECK(copy.at("a") == 1);
+	CHECK(copy.getVersion() == registry.getVersion());
+
+	copy.replace("a", 2);
+	CHECK(registry.at("a") == 1);
+}
@@ -315,7 +315,7 @@ static sim::ComponentPtr loadAssetDescription(Entity* entity, const ComponentFac
 static sim::ComponentPtr loadScenarioMetadata(Entity* entity, const ComponentFactoryContext& context, const nlohmann::json& json)
 {
 	auto component = std::make_shared<ScenarioMetadataComponent>();
-	component->directory = parseStringList(json.at("scenarioObjectDirectory").get<std::string>(), "/");
+	component->setDirectory(parseStringList(json.at("scenarioObjectDirectory").get<std::string>(), "/"));
 	return component;
 }
 
@@ -327,7 +327,7 @@ static sim::ComponentPtr loadPlanet(Entity* entity, const ComponentFactoryContex
 
 	if (json.contains("atmosphere"))
 	{
-		planetComponent->atmosphere = createEarthAtmosphere(); // TODO: use planet specific atmospheric parameters
+		planetComponent->atmosphere = AtmosphereTable(createEarthAtmosphere()); // TODO: use planet specific atmospheric parameters
 	}
 
 	// FIXME: This should be split out into a separate component loader, instead of added here as a side effect
@@ -356,24 +356,24 @@ static sim::ComponentPtr loadPlanetElevationTileSource(Entity* entity, const Com
 
 void addDefaultFactories(ComponentFactoryRegistry& registry)
 {
-	registry["shipWake"] = std::make_shared<ComponentFactoryFunctionAdapter>(loadShipWake);
-	registry["attacher"] = std::make_shared<ComponentFactoryFunctionAdapter>(loadAttacher);
-	registry["attachmentPoint"] = std::make_shared<ComponentFactoryFunctionAdapter>(loadAttachmentPoint);
-	registry["assetDescription"] = std::make_shared<ComponentFactoryFunctionAdapter>(loadAssetDescription);
-	registry["camera"] = std::make_shared<ComponentFactoryFunctionAdapter>(loadCamera);
-	registry["cameraController"] = std::make_shared<ComponentFactoryFunctionAdapter>(loadCameraController);
-	registry["controlInputs"] = std::make_shared<ComponentFactoryFunctionAdapter>(loadControlInputs);
-	registry["dynamicBody"] = std::make_shared<ComponentFactoryFunctionAdapter>(loadDynamicBody);
-	registry["fuselage"] = std::make_shared<ComponentFactoryFunctionAdapter>(loadFuselage);
-	registry["mainRotor"] = std::make_shared<ComponentFactoryFunctionAdapter>(loadMainRotor);
-	registry["motion"] = std::make_shared<ComponentFactoryFunctionAdapter>(loadMotion);
-	registry["node"] = std::make_shared<ComponentFactoryFunctionAdapter>(loadNode);
-	registry["planet"] = std::make_shared<ComponentFactoryFunctionAdapter>(loadPlanet);
-	registry["planetElevationTileSource"] = std::make_shared<ComponentFactoryFunctionAdapter>(loadPlanetElevationTileSource);
-	registry["reactionControlSystem"] = std::make_shared<ComponentFactoryFunctionAdapter>(loadReactonControlSystem);
-	registry["rocketMotor"] = std::make_shared<ComponentFactoryFunctionAdapter>(loadRocketMotor);
-	registry["scenarioMetadata"] = std::make_shared<ComponentFactoryFunctionAdapter>(loadScenarioMetadata);
-	registry["tailRotor"] = std::make_shared<ComponentFactoryFunctionAdapter>(loadTailRotor);
+	registry.add("shipWake", std::make_shared<ComponentFactoryFunctionAdapter>(loadShipWake));
+	registry.add("attacher", std::make_shared<ComponentFactoryFunctionAdapter>(loadAttacher));
+	registry.add("attachmentPoint", std::make_shared<ComponentFactoryFunctionAdapter>(loadAttachmentPoint));
+	registry.add("assetDescription", std::make_shared<ComponentFactoryFunctionAdapter>(loadAssetDescription));
+	registry.add("camera", std::make_shared<ComponentFactoryFunctionAdapter>(loadCamera));
+	registry.add("cameraController", std::make_shared<ComponentFactoryFunctionAdapter>(loadCameraController));
+	registry.add("controlInputs", std::make_shared<ComponentFactoryFunctionAdapter>(loadControlInputs));
+	registry.add("dynamicBody", std::make_shared<ComponentFactoryFunctionAdapter>(loadDynamicBody));
+	registry.add("fuselage", std::make_shared<ComponentFactoryFunctionAdapter>(loadFuselage));
+	registry.add("mainRotor", std::make_shared<ComponentFactoryFunctionAdapter>(loadMainRotor));
+	registry.add("motion", std::make_shared<ComponentFactoryFunctionAdapter>(loadMotion));
+	registry.add("node", std::make_shared<ComponentFactoryFunctionAdapter>(loadNode));
+	registry.add("planet", std::make_shared<ComponentFactoryFunctionAdapter>(loadPlanet));
+	registry.add("planetElevationTileSource", std::make_shared<ComponentFactoryFunctionAdapter>(loadPlanetElevationTileSource));
+	registry.add("reactionControlSystem", std::make_shared<ComponentFactoryFunctionAdapter>(loadReactonControlSystem));
+	registry.add("rocketMotor", std::make_shared<ComponentFactoryFunctionAdapter>(loadRocketMotor));
+	registry.add("scenarioMetadata", std::make_shared<ComponentFactoryFunctionAdapter>(loadScenarioMetadata));
+	registry.add("tailRotor", std::make_shared<ComponentFactoryFunctionAdapter>(loadTailRotor));
 }
 
 } // namespace skybolt
@@ -5,19 +5,24 @@
  * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
 
 #include "StatsDisplaySystem.h"
+#include "SkyboltEngine/EngineStats.h"
 #include "SkyboltEngine/VisHud.h"
+#include <SkyboltCommon/Profiling/Profiler.h>
 #include <SkyboltVis/Scene.h>
 #include <SkyboltVis/RenderOperation/RenderTarget.h>
 #include <SkyboltVis/Window/Window.h>
 #include <osgViewer/View>
 #include <osg/Texture>
 #include <osg/ContextData>
+#include <algorithm>
+#include <cstdio>
 namespace skybolt {
 
 
-StatsDisplaySystem::StatsDisplaySystem(osgViewer::ViewerBase* viewer, osgViewer::View* view, const osg::ref_ptr<osg::Camera>& camera) :
+StatsDisplaySystem::StatsDisplaySystem(osgViewer::ViewerBase* viewer, osgViewer::View* view, const osg::ref_ptr<osg::Camera>& camera, const EngineStats* engineStats) :
 	mCamera(camera),
-	mView(view)
+	mView(view),
+	mEngineStats(engineStats)
 {
 	assert(mCamera);
 	assert(mView);
@@ -38,10 +43,14 @@ StatsDisplaySystem::StatsDisplaySystem(osgViewer::ViewerBase* viewer, osgViewer:
 
 	mStatsHud = osg::ref_ptr<VisHud>(new VisHud());
 	mCamera->addChild(mStatsHud);
+
+	mProfilerWasEnabled = Profiler::isEnabled();
+	Profiler::setEnabled(true);
 }
 
 StatsDisplaySystem::~StatsDisplaySystem()
 {
+	Profiler::setEnabled(mProfilerWasEnabled);
 	setVisible(false);
 }
 
@@ -94,8 +103,38 @@ struct ContextData_bugFix : public osg::ContextData
         }
 };
 
+static void appendProfileLines(const ProfileNode& node, int depth, int maxDepth, std::vector<std::string>& lines)
+{
+	static const double minDisplayedMilliseconds = 0.05;
+
+	std::vector<const ProfileNode*> children;
+	for (const ProfileNode& child : node.children)
+	{
+		if (child.totalMilliseconds >= minDisplayedMilliseconds)
+		{
+			children.push_back(&child);
+		}
+	}
+	std::sort(children.begin(), children.end(), [] (const ProfileNode* a, const ProfileNode* b) {
+		return a->totalMilliseconds > b->totalMilliseconds;
+	});
+
+	char buffer[32];
+	for (const ProfileNode* child : children)
+	{
+		std::snprintf(buffer, sizeof(buffer), "%.2f ms", child->totalMilliseconds);
+		lines.push_back(std::string(depth * 2, ' ') + getProfileZoneDisplayName(child->name) + ": " + buffer);
+		if (depth < maxDepth)
+		{
+			appendProfileLines(*child, depth + 1, maxDepth, lines);
+		}
+	}
+}
+
 void StatsDisplaySystem::updateState()
 {
+	Profiler::instance().endFrame();
+
 	osg::Viewport* viewport = mCamera->getViewport();
 	mStatsHud->setAspectRatio(viewport->width() / viewport->height());
 
@@ -122,6 +161,15 @@ void StatsDisplaySystem::updateState()
 		}
 	}
 
+	if (mEngineStats)
+	{
+		attributes["Cached models"] = mEngineStats->cachedModelCount;
+		attributes["Instanced models"] = mEngineStats->instancedModelCount;
+		attributes["Model instances"] = mEngineStats->modelInstanceCount;
+		attributes["Model instances culled"] = mEngineStats->culledModelInstanceCount;
+		attributes["Model instance draw calls"] = mEngineStats->instancedModelDrawCallCount;
+	}
+
 	const float lineHeight = 0.05f;
 	const float textSize = lineHeight * 0.8f;
 
@@ -131,6 +179,25 @@ void StatsDisplaySystem::updateState()
 		mStatsHud->drawText(glm::vec2(-0.9f, 0.9f - line * lineHeight), value.first + ": " + std::to_string(value.second), 0.0f, textSize);
 		++line;
 	}
+
+	// Draw the previous frame's zone hierarchy
+	if (auto profile = Profiler::instance().getLastFrameProfile(); profile)
+	{
+		const int maxDepth = 2;
+		std::vector<std::string> lines;
+		for (const ThreadProfile& thread : profile->threads)
+		{
+			lines.push_back(thread.threadName);
+			appendProfileLines(thread.root, 1, maxDepth, lines);
+		}
+
+		++line;
+		for (const std::string& text : lines)
+		{
+			mStatsHud->drawText(glm::vec2(-0.9f, 0.9f - line * lineHeight), text, 0.0f, textSize);
+			++line;
+		}
+	}
 }
 
 } // namespace skybolt
\ No newline at end of file
@@ -24,8 +24,10 @@ namespace skybolt {
 class StatsDisplaySystem : public sim::System
 {
 public:
-	//! Displays the viewer's stats on the given camera
-	StatsDisplaySystem(osgViewer::ViewerBase* viewer, osgViewer::View* view, const osg::ref_ptr<osg::Camera>& camera);
+	//! Displays the viewer's stats and the Profiler's zone timings on the given camera.
+	//! Profiling is enabled for the lifetime of the StatsDisplaySystem.
+	//! @param engineStats is optional. If set, model stats are also displayed.
+	StatsDisplaySystem(osgViewer::ViewerBase* viewer, osgViewer::View* view, const osg::ref_ptr<osg::Camera>& camera, const EngineStats* engineStats = nullptr);
 	~StatsDisplaySystem();
 
 	void setVisible(bool visible);
@@ -39,9 +41,11 @@ public:
 private:
 	osg::ref_ptr<osg::Camera> mCamera;
 	osgViewer::View* mView;
+	const EngineStats* mEngineStats;
 	osg::Stats* mViewerStats;
 	osg::Stats* mCameraStats;
 	osg::ref_ptr<class VisHud> mStatsHud;
+	bool mProfilerWasEnabled;
 };
 
 } // namespace skybolt
\ No newline at end of file
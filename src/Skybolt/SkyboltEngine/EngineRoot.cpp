@@ -6,12 +6,16 @@
 
 #include "EngineRoot.h"
 #include "ComponentFactory.h"
+#include "EngineSettings.h"
+#include "ModelCacheSystem.h"
 #include "SimVisBinding/SimVisSystem.h"
 #include <SkyboltSim/System/EntitySystem.h>
+#include <SkyboltSim/System/PlanetFrameSystem.h>
 #include <SkyboltSim/World.h>
 #include <SkyboltVis/OsgStateSetHelpers.h>
 #include <SkyboltVis/Scene.h>
 #include <SkyboltVis/TextureCache.h>
+#include <SkyboltVis/Renderable/Model/InstancedModelCache.h>
 #include <SkyboltVis/Renderable/Model/ModelFactory.h>
 #include <SkyboltVis/Renderable/Planet/Tile/TileSource/JsonTileSourceFactory.h>
 #include <SkyboltCommon/File/FileUtility.h>
@@ -25,13 +29,22 @@
 #include <osgDB/Registry>
 #include <boost/algorithm/string.hpp>
 #include <boost/log/trivial.hpp>
+#include <algorithm>
+#include <chrono>
 #include <optional>
+#include <sstream>
 
 namespace skybolt {
 
 static void registerAssetPackage(const std::string& folderPath)
 {
-	osgDB::Registry::instance()->getDataFilePathList().push_back(folderPath + "/");
+	// Registration is process-wide, so skip packages already registered by another EngineRoot
+	osgDB::FilePathList& list = osgDB::Registry::instance()->getDataFilePathList();
+	std::string path = folderPath + "/";
+	if (std::find(list.begin(), list.end(), path) == list.end())
+	{
+		list.push_back(path);
+	}
 }
 
 Expected<file::Path> locateFile(const std::string& filename)
@@ -108,7 +121,7 @@ static file::Path getDefaultCacheDir()
 	return file::getAppUserDataDirectory("Skybolt") / "Cache";
 }
 
-static file::Path getCacheDir()
+file::Path getCacheDir()
 {
 	if (const char* dir = std::getenv(skyboltCacheDirEnvironmentVariable.c_str()); dir)
 	{
@@ -122,6 +135,42 @@ static file::Path getCacheDir()
 	return getDefaultCacheDir();
 }
 
+//! Measures the duration of consecutive startup phases
+class StartupPhaseTimer
+{
+public:
+	StartupPhaseTimer(const std::string& name) :
+		mName(name),
+		mStartTime(std::chrono::steady_clock::now()),
+		mPhaseStartTime(mStartTime)
+	{
+	}
+
+	void endPhase(const std::string& phaseName)
+	{
+		auto now = std::chrono::steady_clock::now();
+		mPhases.emplace_back(phaseName, std::chrono::duration<double, std::milli>(now - mPhaseStartTime).count());
+		mPhaseStartTime = now;
+	}
+
+	void log() const
+	{
+		std::ostringstream ss;
+		ss << mName << " took " << std::chrono::duration<double, std::milli>(mPhaseStartTime - mStartTime).count() << " ms:";
+		for (const auto& [phaseName, milliseconds] : mPhases)
+		{
+			ss << " " << phaseName << " " << milliseconds << " ms;";
+		}
+		BOOST_LOG_TRIVIAL(info) << ss.str();
+	}
+
+private:
+	std::string mName;
+	std::chrono::steady_clock::time_point mStartTime;
+	std::chrono::steady_clock::time_point mPhaseStartTime;
+	std::vector<std::pair<std::string, double>> mPhases;
+};
+
 EngineRoot::EngineRoot(const EngineRootConfig& config) :
 	scheduler(new px_sched::Scheduler),
 	fileLocator(locateFile),
@@ -130,12 +179,15 @@ EngineRoot::EngineRoot(const EngineRootConfig& config) :
 	factoryRegistries(std::make_unique<FactoryRegistries>()),
 	engineSettings(config.engineSettings)
 {
-	int threadCount = determineThreadCountFromHardwareAndUserLimits();
+	StartupPhaseTimer timer("EngineRoot startup");
+
+	int threadCount = config.threadCount ? std::max(1, *config.threadCount) : determineThreadCountFromHardwareAndUserLimits();
 
 	px_sched::SchedulerParams schedulerParams;
 	schedulerParams.max_running_threads = threadCount;
 	schedulerParams.num_threads = threadCount;
 	scheduler->init(schedulerParams);
+	timer.endPhase("scheduler");
 
 	std::vector<std::string> assetSearchPaths = {
 		"Assets/",
@@ -169,10 +221,12 @@ EngineRoot::EngineRoot(const EngineRootConfig& config) :
 		throw std::runtime_error("Could not find asset packages: {" + packagesString + "}. Ensure working directory and/or SKYBOLT_ASSETS_PATH is set correctly. "
 			"Please refer to Skybolt documentation for information about finding assets.");
 	}
+	timer.endPhase("asset discovery");
 
 	if (config.enableVis)
 	{
-		programs = vis::createShaderPrograms();
+		programs = vis::createShaderPrograms(scheduler.get());
+		timer.endPhase("shader programs");
 	}
 	scene.reset(new vis::Scene(new osg::StateSet()));
 
@@ -194,14 +248,19 @@ EngineRoot::EngineRoot(const EngineRootConfig& config) :
 		vis::JsonTileSourceFactoryRegistryConfig c;
 		c.apiKeys = readNameMap<std::string>(config.engineSettings, "tileApiKeys");
 		c.cacheDirectory = cacheDir.string();
+		c.httpTileFetcher = getHttpTileFetcherConfig(config.engineSettings);
 		return c;
 	}());
 	vis::addDefaultFactories(*tileSourceFactoryRegistry);
+	timer.endPhase("factories");
+
+	auto planetFrameSystem = std::make_shared<sim::PlanetFrameSystem>(&scenario->world);
 
 	// Create object factory
 	EntityFactory::Context context;
 	context.scheduler = scheduler.get();
 	context.simWorld = &scenario->world;
+	context.planetFrames = planetFrameSystem.get();
 	context.componentFactoryRegistry = componentFactoryRegistry;
 	context.julianDateProvider = julianDateProvider;
 	context.stats = &stats;
@@ -218,6 +277,7 @@ EngineRoot::EngineRoot(const EngineRootConfig& config) :
 			c.programs = &programs;
 			c.visFactoryRegistry = visFactoryRegistry;
 			c.modelFactory = createModelFactory(programs);
+			c.instancedModelCache = std::make_shared<vis::InstancedModelCache>();
 			c.textureCache = std::make_shared<vis::TextureCache>();
 			return c;
 		}();
@@ -225,12 +285,20 @@ EngineRoot::EngineRoot(const EngineRootConfig& config) :
 
 	file::Paths paths = getFilesWithExtensionInDirectoryInAssetPackages(mAssetPackagePaths, "Entities", ".json");
 	entityFactory.reset(new EntityFactory(context, paths));
+	timer.endPhase("entity templates (" + std::to_string(paths.size()) + ")");
 
 	// Create default systems
 	systemRegistry = std::make_shared<sim::SystemRegistry>(sim::SystemRegistry({
 		std::make_shared<sim::EntitySystem>(&scenario->world),
-		std::make_shared<SimVisSystem>(&scenario->world, scene)
+		planetFrameSystem,
+		std::make_shared<SimVisSystem>(&scenario->world, scene, planetFrameSystem.get())
 	}));
+	if (context.visContext)
+	{
+		systemRegistry->push_back(std::make_shared<ModelCacheSystem>(context.visContext->modelFactory->getModelCache(), context.visContext->instancedModelCache, &stats));
+	}
+	timer.endPhase("systems");
+	timer.log();
 }
 
 EngineRoot::~EngineRoot()
@@ -241,6 +309,8 @@ EngineRoot::~EngineRoot()
 
 void EngineRoot::loadPlugins(const std::vector<PluginFactory>& pluginFactories)
 {
+	StartupPhaseTimer timer("Plugin loading");
+
 	PluginConfig config;
 	config.engineRoot = this;
 
@@ -255,6 +325,9 @@ void EngineRoot::loadPlugins(const std::vector<PluginFactory>& pluginFactories)
 
 	// We need to store the factories as well to ensure the plugin symbols do not get unloaded.
 	mPluginFactories = pluginFactories;
+
+	timer.endPhase(std::to_string(mPlugins.size()) + " plugins");
+	timer.log();
 }
 
 file::Paths getPathsInAssetPackages(const std::vector<std::string>& assetPackagePaths, const std::string& relativePath)
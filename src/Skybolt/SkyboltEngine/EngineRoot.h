@@ -18,6 +18,7 @@
 #include <SkyboltCommon/File/FileUtility.h>
 
 #include <memory>
+#include <optional>
 
 namespace skybolt {
 
@@ -27,6 +28,7 @@ struct EngineRootConfig
 {
 	nlohmann::json engineSettings;
 	bool enableVis = true; //!< True if the visual subsystem is enabled
+	std::optional<int> threadCount; //!< Number of background threads. If not set, determined from the hardware and SKYBOLT_MAX_CORES.
 };
 
 class EngineRoot
@@ -60,6 +62,9 @@ public:
 };
 
 Expected<file::Path> locateFile(const std::string& filename);
+
+//! @return directory for cached data such as tiles, set by the SKYBOLT_CACHE_DIR environment variable or the default location if not set
+file::Path getCacheDir();
 file::Paths getPathsInAssetPackages(const std::vector<std::string>& assetPackagePaths, const std::string& relativePath);
 file::Paths getFilesWithExtensionInDirectoryInAssetPackages(const std::vector<std::string>& assetPackagePaths, const std::string& relativeDirectory, const std::string& extension);
 
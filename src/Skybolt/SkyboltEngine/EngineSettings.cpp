@@ -7,6 +7,7 @@
 
 #include "EngineSettings.h"
 #include "EngineCommandLineParser.h"
+#include "UpdateLoop/UpdateLoopUtility.h"
 #include <SkyboltCommon/OptionalUtility.h>
 #include <SkyboltCommon/Json/JsonHelpers.h>
 
@@ -34,6 +35,14 @@ nlohmann::json createDefaultEngineSettings()
 	},
 	"clouds": {
 		"enableTemporalUpscaling": true
+	},
+	"mainLoop": {
+		"pipelined": false,
+		"dynamicsOverloadPolicy": "drop",
+		"renderOnDemand": false
+	},
+	"tileFetcher": {
+		"verifyServerCertificate": true
 	}
 })"_json;
 }
@@ -93,4 +102,50 @@ vis::CloudRenderingParams getCloudRenderingParams(const nlohmann::json& engineSe
 	return params;
 }
 
+MainLoopConfig getMainLoopConfig(const nlohmann::json& engineSettings)
+{
+	MainLoopConfig config;
+
+	auto i = engineSettings.find("mainLoop");
+	if (i != engineSettings.end())
+	{
+		config.minFrameDuration = readOptionalOrDefault<float>(i.value(), "minFrameDuration", config.minFrameDuration);
+		config.pipelined = readOptionalOrDefault<bool>(i.value(), "pipelined", config.pipelined);
+		config.displayRefreshRate = readOptional<double>(i.value(), "displayRefreshRate");
+		config.maxDynamicsDuration = readOptional<double>(i.value(), "maxDynamicsDuration");
+
+		std::string policy = readOptionalOrDefault<std::string>(i.value(), "dynamicsOverloadPolicy", "drop");
+		if (policy == "drop")
+		{
+			config.dynamicsOverloadPolicy = sim::DynamicsOverloadPolicy::Drop;
+		}
+		else if (policy == "stretch")
+		{
+			config.dynamicsOverloadPolicy = sim::DynamicsOverloadPolicy::Stretch;
+		}
+		else if (policy == "catchUp")
+		{
+			config.dynamicsOverloadPolicy = sim::DynamicsOverloadPolicy::CatchUp;
+		}
+		else
+		{
+			throw std::runtime_error("Invalid dynamicsOverloadPolicy: '" + policy + "'. Valid values are 'drop', 'stretch' and 'catchUp'.");
+		}
+	}
+	return config;
+}
+
+vis::HttpTileFetcherConfig getHttpTileFetcherConfig(const nlohmann::json& engineSettings)
+{
+	vis::HttpTileFetcherConfig config;
+
+	auto i = engineSettings.find("tileFetcher");
+	if (i != engineSettings.end())
+	{
+		config.maxConcurrentRequests = readOptionalOrDefault<int>(i.value(), "maxConcurrentRequests", config.maxConcurrentRequests);
+		config.verifyServerCertificate = readOptionalOrDefault<bool>(i.value(), "verifyServerCertificate", config.verifyServerCertificate);
+	}
+	return config;
+}
+
 } // namespace skybolt
@@ -7,6 +7,7 @@
 #pragma once
 
 #include <SkyboltVis/DisplaySettings.h>
+#include <SkyboltVis/Renderable/Planet/Tile/TileSource/HttpTileFetcher.h>
 #include <SkyboltVis/Renderable/Clouds/CloudRenderingParams.h>
 #include <SkyboltVis/Shadow/ShadowParams.h>
 #include <boost/program_options/variables_map.hpp>
@@ -16,11 +17,15 @@
 
 namespace skybolt {
 
+struct MainLoopConfig;
+
 nlohmann::json createDefaultEngineSettings();
 nlohmann::json readEngineSettings(const boost::program_options::variables_map& params);
 
 vis::DisplaySettings getDisplaySettingsFromEngineSettings(const nlohmann::json& engineSettings);
 std::optional<vis::ShadowParams> getShadowParams(const nlohmann::json& engineSettings);
 vis::CloudRenderingParams getCloudRenderingParams(const nlohmann::json& engineSettings);
+MainLoopConfig getMainLoopConfig(const nlohmann::json& engineSettings);
+vis::HttpTileFetcherConfig getHttpTileFetcherConfig(const nlohmann::json& engineSettings);
 
 } // namespace skybolt
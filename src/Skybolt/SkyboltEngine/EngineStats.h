@@ -13,6 +13,13 @@ struct EngineStats
 {
 	size_t terrainTileLoadQueueSize = 0;
 	size_t featureTileLoadQueueSize = 0;
+
+	size_t cachedModelCount = 0;
+	int instancedModelCount = 0;
+	int modelInstanceCount = 0;
+	int visibleModelInstanceCount = 0; //!< Number of model instances submitted for drawing
+	int culledModelInstanceCount = 0; //!< Number of model instances rejected by frustum culling
+	int instancedModelDrawCallCount = 0;
 };
 
-} // namespace skybolt
\ No newline at end of file
+} // namespace skybolt
@@ -36,6 +36,7 @@
 #include <SkyboltSim/Particles/ParticleSystem.h>
 #include <SkyboltSim/Physics/Astronomy.h>
 #include <SkyboltSim/Spatial/GreatCircle.h>
+#include <SkyboltSim/System/PlanetFrameSystem.h>
 
 #include <SkyboltVis/Camera.h>
 #include <SkyboltVis/Light.h>
@@ -57,6 +58,8 @@
 #include <SkyboltVis/Renderable/Planet/Tile/TileSource/JsonTileSourceFactory.h>
 #include <SkyboltVis/Renderable/Stars/Starfield.h>
 #include <SkyboltVis/Renderable/Model/Model.h>
+#include <SkyboltVis/Renderable/Model/InstancedModel.h>
+#include <SkyboltVis/Renderable/Model/InstancedModelCache.h>
 #include <SkyboltVis/Renderable/Model/ModelFactory.h>
 #include <SkyboltVis/Renderable/Water/WaterMaterial.h>
 #include <SkyboltVis/Shader/ShaderProgramRegistry.h>
@@ -67,6 +70,8 @@
 #include <SkyboltCommon/Json/JsonHelpers.h>
 #include <SkyboltCommon/Json/ReadJsonFile.h>
 #include <SkyboltCommon/Math/MathUtility.h>
+#include <boost/log/trivial.hpp>
+#include <algorithm>
 #include <filesystem>
 
 #include <osg/BlendFunc>
@@ -239,10 +244,37 @@ static vis::ModelPtr createVisualModel(const nlohmann::json& json, vis::ModelFac
 	return std::make_shared<vis::Model>(config);
 }
 
+//! Creates an instance of a model which is drawn in a single batch with all other instances of the same model
+static vis::ModelInstancePtr createVisualModelInstance(const nlohmann::json& json, const EntityFactory::VisContext& visContext)
+{
+	std::string filename = json.at("model").get<std::string>();
+	std::vector<vis::ModelFactory::TextureRole> textureRoles = readTextureRoles(json);
+	std::string key = vis::ModelFactory::getModelKey(filename, textureRoles);
+	vis::InstancedModelPtr model = visContext.instancedModelCache->getOrCreateInstancedModel(key, [&] {
+		vis::InstancedModelPtr model = visContext.modelFactory->createInstancedModel(filename, textureRoles);
+		visContext.scene->addObject(model);
+		return model;
+	});
+
+	registerAssetSearchDirectory(getParentDirectory(filename));
+
+	return model->createInstance();
+}
+
 static void loadVisualModel(Entity* entity, const EntityFactory::Context& context, const EntityFactory::VisContext& visContext, const VisObjectsComponentPtr& visObjectsComponent, const SimVisBindingsComponentPtr& simVisBindingComponent, const nlohmann::json& json)
 {
-	vis::ModelPtr model = createVisualModel(json, *visContext.modelFactory);
-	visObjectsComponent->addObject(model);
+	vis::RootNodePtr model;
+	if (readOptionalOrDefault(json, "instanced", false))
+	{
+		// The instance is drawn by its InstancedModel, which is already in the scene
+		model = createVisualModelInstance(json, visContext);
+		visObjectsComponent->addObject(model, /* addToScene */ false);
+	}
+	else
+	{
+		model = createVisualModel(json, *visContext.modelFactory);
+		visObjectsComponent->addObject(model);
+	}
 
 	SimVisBindingPtr simVis(new SimpleSimVisBinding(entity, model,
 		readOptionalVec3f(json, "positionRelBody", osg::Vec3f()),
@@ -284,8 +316,14 @@ static void loadVisualCamera(Entity* entity, const EntityFactory::Context& conte
 
 static void loadParticleSystem(Entity* entity, const EntityFactory::Context& context, const EntityFactory::VisContext& visContext, const VisObjectsComponentPtr& visObjectsComponent, const SimVisBindingsComponentPtr& simVisBindingComponent, const nlohmann::json& json)
 {
-	NearestPlanetProvider nearestPlanetProvider = [world = context.simWorld] (const Vector3& position) {
-		return findNearestEntityWithComponent<sim::PlanetComponent>(world->getEntities(), position).get();
+	NearestPlanetProvider nearestPlanetProvider = [world = context.simWorld, planetFrames = context.planetFrames] (const Vector3& position) -> std::optional<sim::PlanetFrame> {
+		if (planetFrames)
+		{
+			const sim::PlanetFrame* frame = planetFrames->findNearestPlanetFrame(position);
+			return frame ? std::optional<sim::PlanetFrame>(*frame) : std::nullopt;
+		}
+		sim::EntityPtr planet = findNearestEntityWithComponent<sim::PlanetComponent>(world->getEntities(), position);
+		return planet ? std::optional<sim::PlanetFrame>(sim::createPlanetFrame(planet.get())) : std::nullopt;
 	};
 
 	ParticleEmitter::Params emitterParams;
@@ -597,11 +635,92 @@ const ScenarioObjectPath& skybolt::getDefaultEntityScenarioObjectDirectory()
 static std::shared_ptr<ScenarioMetadataComponent> createDefaultEntityScenarioMetadataComponent()
 {
 	auto component = std::make_shared<ScenarioMetadataComponent>();
-	component->directory = getDefaultEntityScenarioObjectDirectory();
+	component->setDirectory(getDefaultEntityScenarioObjectDirectory());
 	return component;
 }
 
-EntityPtr EntityFactory::createEntityFromJson(const nlohmann::json& json, const std::string& templateName, const std::string& instanceName, const Vector3& position, const Quaternion& orientation, EntityId id) const
+static const std::map<std::string, VisComponentLoader>& getVisComponentLoaders()
+{
+	static const std::map<std::string, VisComponentLoader> visComponentLoaders =
+	{
+		{ "camera", loadVisualCamera },
+		{ "particleSystem", loadParticleSystem },
+		{ "visualModel", loadVisualModel },
+		{ "visualMainRotor", loadVisualMainRotor },
+		{ "visualTailRotor", loadVisualTailRotor },
+		{ "visualPlanet", loadVisualPlanet }
+	};
+	return visComponentLoaders;
+}
+
+//! A template with its component factories and loaders resolved, ready to be instantiated
+struct EntityFactory::EntityPrototype
+{
+	struct ComponentPrototype
+	{
+		ComponentFactoryPtr factory; //!< May be null
+		const VisComponentLoader* visLoader = nullptr; //!< May be null
+		const nlohmann::json* json;
+	};
+
+	std::vector<ComponentPrototype> components;
+	uint64_t componentFactoryRegistryVersion; //!< Version of the component factory registry when compiled
+};
+
+std::shared_ptr<const EntityFactory::EntityPrototype> EntityFactory::compilePrototype(const nlohmann::json& json) const
+{
+	auto prototype = std::make_shared<EntityPrototype>();
+	prototype->componentFactoryRegistryVersion = mContext.componentFactoryRegistry->getVersion();
+
+	const auto& visComponentLoaders = getVisComponentLoaders();
+
+	const nlohmann::json& components = json.at("components");
+	for (const auto& component : components)
+	{
+		for (nlohmann::json::const_iterator componentIt = component.begin(); componentIt != component.end(); ++componentIt)
+		{
+			const std::string& key = componentIt.key();
+
+			EntityPrototype::ComponentPrototype componentPrototype;
+			componentPrototype.json = &componentIt.value();
+
+			// Sim components
+			if (auto it = mContext.componentFactoryRegistry->find(key); it != mContext.componentFactoryRegistry->end())
+			{
+				componentPrototype.factory = it->second;
+			}
+
+			// Vis components
+			if (mContext.visContext)
+			{
+				if (auto it = visComponentLoaders.find(key); it != visComponentLoaders.end())
+				{
+					componentPrototype.visLoader = &it->second;
+				}
+			}
+
+			if (componentPrototype.factory || componentPrototype.visLoader)
+			{
+				prototype->components.push_back(componentPrototype);
+			}
+		}
+	}
+	return prototype;
+}
+
+ComponentFactoryContext EntityFactory::createComponentFactoryContext() const
+{
+	ComponentFactoryContext context;
+	context.julianDateProvider = mContext.julianDateProvider;
+	context.scheduler = mContext.scheduler;
+	context.simWorld = mContext.simWorld;
+	context.entityFactory = this;
+	context.stats = mContext.stats;
+	context.tileSourceFactoryRegistry = mContext.tileSourceFactoryRegistry;
+	return context;
+}
+
+EntityPtr EntityFactory::instantiatePrototype(const EntityPrototype& prototype, const ComponentFactoryContext& componentFactoryContext, const std::string& templateName, const std::string& instanceName, const Vector3& position, const Quaternion& orientation, EntityId id) const
 {
 	EntityPtr entity = std::make_shared<sim::Entity>((id != nullEntityId()) ? id : generateNextEntityId());
 
@@ -618,60 +737,25 @@ EntityPtr EntityFactory::createEntityFromJson(const nlohmann::json& json, const
 
 		simVisBindingComponent = std::make_shared<SimVisBindingsComponent>();
 		entity->addComponent(simVisBindingComponent);
-}
-
-	// Create additional components from json
-	ComponentFactoryContext componentFactoryContext;
-	componentFactoryContext.julianDateProvider = mContext.julianDateProvider;
-	componentFactoryContext.scheduler = mContext.scheduler;
-	componentFactoryContext.simWorld = mContext.simWorld;
-	componentFactoryContext.entityFactory = this;
-	componentFactoryContext.stats = mContext.stats;
-	componentFactoryContext.tileSourceFactoryRegistry = mContext.tileSourceFactoryRegistry;
+	}
 
-	const nlohmann::json& components = json.at("components");
-	for (const auto& component : components)
+	// Create additional components
+	for (const EntityPrototype::ComponentPrototype& component : prototype.components)
 	{
-		for (nlohmann::json::const_iterator componentIt = component.begin(); componentIt != component.end(); ++componentIt)
+		if (component.factory)
 		{
-			std::string key = componentIt.key();
-			const nlohmann::json& content = componentIt.value();
-			
-			// Sim components
+			auto newComponent = component.factory->create(entity.get(), componentFactoryContext, *component.json);
+			if (newComponent)
 			{
-				auto it = mContext.componentFactoryRegistry->find(key);
-				if (it != mContext.componentFactoryRegistry->end())
-				{
-					ComponentFactoryPtr factory = it->second;
-					auto newComponent = factory->create(entity.get(), componentFactoryContext, content);
-					if (newComponent)
-					{
-						entity->addComponent(newComponent);
-					}
-				}
-			}
-			// Vis components
-			if (mContext.visContext)
-			{
-				static std::map<std::string, VisComponentLoader> visComponentLoaders =
-				{
-					{ "camera", loadVisualCamera },
-					{ "particleSystem", loadParticleSystem },
-					{ "visualModel", loadVisualModel },
-					{ "visualMainRotor", loadVisualMainRotor },
-					{ "visualTailRotor", loadVisualTailRotor },
-					{ "visualPlanet", loadVisualPlanet }
-				};
-
-				auto it = visComponentLoaders.find(key);
-				if (it != visComponentLoaders.end())
-				{
-					assert(visObjectsComponent);
-					assert(simVisBindingComponent);
-					it->second(entity.get(), mContext, *mContext.visContext, visObjectsComponent, simVisBindingComponent, content);
-				}
+				entity->addComponent(newComponent);
 			}
 		}
+		if (component.visLoader)
+		{
+			assert(visObjectsComponent);
+			assert(simVisBindingComponent);
+			(*component.visLoader)(entity.get(), mContext, *mContext.visContext, visObjectsComponent, simVisBindingComponent, *component.json);
+		}
 	}
 
 	// Add default ScenarioMetadataComponent if one wasn't in the json file
@@ -690,6 +774,12 @@ EntityPtr EntityFactory::createEntityFromJson(const nlohmann::json& json, const
 	return entity;
 }
 
+EntityPtr EntityFactory::createEntityFromJson(const nlohmann::json& json, const std::string& templateName, const std::string& instanceName, const Vector3& position, const Quaternion& orientation, EntityId id) const
+{
+	auto prototype = compilePrototype(json);
+	return instantiatePrototype(*prototype, createComponentFactoryContext(), templateName, instanceName, position, orientation, id);
+}
+
 static ScenarioObjectPath readScenarioObjectDirectory(const nlohmann::json& json)
 {
 	ScenarioObjectPath result;
@@ -712,11 +802,9 @@ EntityFactory::EntityFactory(const EntityFactory::Context& context, const std::v
 	mContext(context)
 {
 	assert(context.julianDateProvider);
-	assert(context.programs);
 	assert(context.simWorld);
 	assert(context.stats);
 	assert(context.tileSourceFactoryRegistry);
-	assert(context.scene);
 
 	if (context.visContext)
 	{
@@ -727,26 +815,123 @@ EntityFactory::EntityFactory(const EntityFactory::Context& context, const std::v
 		};
 	}
 
+	std::vector<EntityTemplate*> templates;
 	for (const std::filesystem::path& filename : entityFilenames)
 	{
 		std::string name = filename.stem().string();
-		nlohmann::json json = readJsonFile(filename.string());
-		mTemplateJsonMap[name] = json;
+		auto entityTemplate = std::make_unique<EntityTemplate>();
+		entityTemplate->filename = filename;
+		templates.push_back(entityTemplate.get());
+		mTemplates[name] = std::move(entityTemplate);
 		mTemplateNames.push_back(name);
-		mTemplateDirectories[name] = readScenarioObjectDirectory(json);
 	}
+
+	if (mContext.scheduler && !templates.empty())
+	{
+		// Parse in batches to keep the number of scheduled tasks small
+		const size_t maxTaskCount = 64;
+		const size_t batchSize = (templates.size() + maxTaskCount - 1) / maxTaskCount;
+		for (size_t begin = 0; begin < templates.size(); begin += batchSize)
+		{
+			std::vector<EntityTemplate*> batch(templates.begin() + begin, templates.begin() + std::min(begin + batchSize, templates.size()));
+			mContext.scheduler->run([this, batch = std::move(batch)] {
+				for (EntityTemplate* entityTemplate : batch)
+				{
+					try
+					{
+						getParsedTemplate(*entityTemplate);
+					}
+					catch (const std::exception&)
+					{
+						// Errors are reported when the template is used
+					}
+				}
+			}, &mTemplateParsingSync);
+		}
+	}
+}
+
+EntityFactory::~EntityFactory()
+{
+	if (mContext.scheduler)
+	{
+		mContext.scheduler->waitFor(mTemplateParsingSync);
+	}
+}
+
+const EntityFactory::ParsedEntityTemplate& EntityFactory::getParsedTemplate(EntityTemplate& entityTemplate) const
+{
+	std::scoped_lock<std::mutex> lock(entityTemplate.parseMutex);
+	if (!entityTemplate.parsed && !entityTemplate.parseError)
+	{
+		try
+		{
+			ParsedEntityTemplate parsed;
+			parsed.json = readJsonFile(entityTemplate.filename.string());
+			parsed.scenarioObjectDirectory = readScenarioObjectDirectory(parsed.json);
+			entityTemplate.parsed = std::move(parsed);
+		}
+		catch (...)
+		{
+			entityTemplate.parseError = std::current_exception();
+		}
+	}
+
+	if (entityTemplate.parseError)
+	{
+		std::rethrow_exception(entityTemplate.parseError);
+	}
+	return *entityTemplate.parsed;
+}
+
+const nlohmann::json& EntityFactory::getTemplateJson(const std::string& templateName) const
+{
+	auto i = mTemplates.find(templateName);
+	if (i == mTemplates.end())
+	{
+		throw std::runtime_error("Invalid templateName: " + templateName);
+	}
+	return getParsedTemplate(*i->second).json;
+}
+
+const EntityFactory::TemplateJsonMap& EntityFactory::getTemplateJsonMap() const
+{
+	std::scoped_lock<std::mutex> lock(mTemplateJsonMapMutex);
+	if (!mTemplateJsonMap && !mTemplateJsonMapError)
+	{
+		try
+		{
+			TemplateJsonMap result;
+			for (const auto& [name, entityTemplate] : mTemplates)
+			{
+				result[name] = getParsedTemplate(*entityTemplate).json;
+			}
+			mTemplateJsonMap = std::move(result);
+		}
+		catch (...)
+		{
+			mTemplateJsonMapError = std::current_exception();
+		}
+	}
+
+	if (mTemplateJsonMapError)
+	{
+		std::rethrow_exception(mTemplateJsonMapError);
+	}
+	return *mTemplateJsonMap;
 }
 
 EntityPtr EntityFactory::createEntity(const std::string& templateName, const std::string& nameIn, const Vector3& position, const Quaternion& orientation, EntityId id) const
 {
 	{
-		auto i = mTemplateJsonMap.find(templateName);
-		if (i != mTemplateJsonMap.end())
+		auto i = mTemplates.find(templateName);
+		if (i != mTemplates.end())
 		{
 			std::string instanceName = nameIn.empty() ? createUniqueObjectName(templateName) : nameIn;
 			try
 			{
-				return createEntityFromJson(i->second, templateName, instanceName, position, orientation, id);
+				auto prototype = getPrototype(*i->second);
+				return instantiatePrototype(*prototype, createComponentFactoryContext(), templateName, instanceName, position, orientation, id);
 			}
 			catch (const std::exception& e)
 			{
@@ -767,6 +952,58 @@ EntityPtr EntityFactory::createEntity(const std::string& templateName, const std
 	throw std::runtime_error("Invalid templateName: " + templateName);
 }
 
+std::vector<EntityPtr> EntityFactory::createEntities(const std::string& templateName, const std::vector<EntityInstance>& instances) const
+{
+	std::vector<EntityPtr> result;
+	result.reserve(instances.size());
+
+	auto i = mTemplates.find(templateName);
+	if (i == mTemplates.end())
+	{
+		for (const EntityInstance& instance : instances)
+		{
+			result.push_back(createEntity(templateName, instance.name, instance.position, instance.orientation, instance.id));
+		}
+		return result;
+	}
+
+	// Generate names for unnamed instances up front so that they are unique within the batch
+	size_t unnamedCount = std::count_if(instances.begin(), instances.end(), [] (const EntityInstance& instance) {
+		return instance.name.empty();
+	});
+	std::vector<std::string> generatedNames = createUniqueObjectNames(templateName, unnamedCount);
+	auto generatedName = generatedNames.begin();
+
+	try
+	{
+		auto prototype = getPrototype(*i->second);
+		ComponentFactoryContext componentFactoryContext = createComponentFactoryContext();
+		for (const EntityInstance& instance : instances)
+		{
+			const std::string& instanceName = instance.name.empty() ? *generatedName++ : instance.name;
+			result.push_back(instantiatePrototype(*prototype, componentFactoryContext, templateName, instanceName, instance.position, instance.orientation, instance.id));
+		}
+	}
+	catch (const std::exception& e)
+	{
+		throw Exception("Error loading '" + templateName + "': " + e.what());
+	}
+	return result;
+}
+
+std::shared_ptr<const EntityFactory::EntityPrototype> EntityFactory::getPrototype(EntityTemplate& entityTemplate) const
+{
+	const nlohmann::json& json = getParsedTemplate(entityTemplate).json;
+
+	std::scoped_lock<std::mutex> lock(mPrototypesMutex);
+	// Recompile if component factories have been registered or replaced since, e.g. by plugins
+	if (!entityTemplate.prototype || entityTemplate.prototype->componentFactoryRegistryVersion != mContext.componentFactoryRegistry->getVersion())
+	{
+		entityTemplate.prototype = compilePrototype(json);
+	}
+	return entityTemplate.prototype;
+}
+
 const float sunDistance = 10000;
 const float moonDistance = sunDistance;
 const float sunDiameter = 2.0f * tan(skybolt::math::degToRadF() * 0.53f * 0.5f) * sunDistance;
@@ -878,9 +1115,16 @@ EntityPtr EntityFactory::createStars(const EntityFactory::VisContext& visContext
 
 const skybolt::ScenarioObjectPath& EntityFactory::getScenarioObjectDirectoryForTemplate(const std::string& templateName) const
 {
-	if (auto i = mTemplateDirectories.find(templateName); i != mTemplateDirectories.end())
+	if (auto i = mTemplates.find(templateName); i != mTemplates.end())
 	{
-		return i->second;
+		try
+		{
+			return getParsedTemplate(*i->second).scenarioObjectDirectory;
+		}
+		catch (const std::exception& e)
+		{
+			BOOST_LOG_TRIVIAL(error) << "Error loading '" << templateName << "': " << e.what();
+		}
 	}
 	return getDefaultEntityScenarioObjectDirectory();
 }
@@ -898,6 +1142,26 @@ std::string EntityFactory::createUniqueObjectName(const std::string& baseName) c
 	throw skybolt::Exception("Could not create unique object name from base name: " + baseName);
 }
 
+std::vector<std::string> EntityFactory::createUniqueObjectNames(const std::string& baseName, size_t count) const
+{
+	std::vector<std::string> result;
+	result.reserve(count);
+	for (int i = 1; i < INT_MAX && result.size() < count; ++i)
+	{
+		std::string name = baseName + std::to_string(i);
+		if (mContext.simWorld->findObjectByName(name) == nullptr)
+		{
+			result.push_back(name);
+		}
+	}
+
+	if (result.size() < count)
+	{
+		throw skybolt::Exception("Could not create unique object name from base name: " + baseName);
+	}
+	return result;
+}
+
 sim::EntityId EntityFactory::generateNextEntityId() const
 {
 	++mNextEntityId.entityId;
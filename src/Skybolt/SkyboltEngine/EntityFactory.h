@@ -17,9 +17,13 @@
 #include <SkyboltCommon/Math/MathUtility.h>
 
 #include <nlohmann/json.hpp>
+#include <px_sched/px_sched.h>
 
 #include <functional>
+#include <exception>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <optional>
 #include <vector>
 
@@ -34,6 +38,7 @@ public:
 		vis::VisFactoryRegistryPtr visFactoryRegistry;
 		const vis::ShaderPrograms* programs;
 		vis::ModelFactoryPtr modelFactory;
+		vis::InstancedModelCachePtr instancedModelCache;
 		vis::TextureCachePtr textureCache;
 	};
 
@@ -41,6 +46,7 @@ public:
 	{
 		px_sched::Scheduler* scheduler;
 		sim::World* simWorld;
+		const sim::PlanetFrameSystem* planetFrames = nullptr; //!< If set, used to find the nearest planet instead of searching the world
 		JulianDateProvider julianDateProvider;
 		ComponentFactoryRegistryPtr componentFactoryRegistry;
 		vis::JsonTileSourceFactoryRegistryPtr tileSourceFactoryRegistry;
@@ -51,22 +57,44 @@ public:
 		std::optional<VisContext> visContext; // !< If empty, visual objects will not be created
 	};
 
+	//! Template files are parsed in the background on the context's scheduler.
+	//! A template which has not been parsed by the time it is first used is parsed on demand.
 	EntityFactory(const Context& context, const std::vector<std::filesystem::path>& entityFilenames);
+	~EntityFactory();
 
 	sim::EntityPtr createEntity(const std::string& templateName, const std::string& instanceName = "", const sim::Vector3& position = math::dvec3Zero(), const sim::Quaternion& orientation = math::dquatIdentity(), sim::EntityId id = sim::nullEntityId()) const;
 	sim::EntityPtr createEntityFromJson(const nlohmann::json& json, const std::string& templateName, const std::string& instanceName, const sim::Vector3& position, const sim::Quaternion& orientation, sim::EntityId id = sim::nullEntityId()) const;
 
+	struct EntityInstance
+	{
+		std::string name; //!< If empty, a unique name is generated from the template name
+		sim::Vector3 position = math::dvec3Zero();
+		sim::Quaternion orientation = math::dquatIdentity();
+		sim::EntityId id = sim::nullEntityId();
+	};
+
+	//! Creates many entities from the same template, e.g. for formations or salvos.
+	//! Faster than calling createEntity() for each instance.
+	std::vector<sim::EntityPtr> createEntities(const std::string& templateName, const std::vector<EntityInstance>& instances) const;
+
 	typedef std::vector<std::string> Strings;
 	Strings getTemplateNames() const { return mTemplateNames; }
 
 	 //!< Gets the default scenario object directory for objects created from the given template
 	const skybolt::ScenarioObjectPath& getScenarioObjectDirectoryForTemplate(const std::string& templateName) const;
 
+	//! Throws if the template does not exist or could not be parsed
+	const nlohmann::json& getTemplateJson(const std::string& templateName) const;
+
 	typedef std::map<std::string, nlohmann::json> TemplateJsonMap;
-	const TemplateJsonMap& getTemplateJsonMap() const { return mTemplateJsonMap; }
+	//! Parses all templates if not already parsed. Throws if any template could not be parsed.
+	const TemplateJsonMap& getTemplateJsonMap() const;
 
 	std::string createUniqueObjectName(const std::string& baseName) const;
 
+	//! @returns count names which are unique in the world and distinct from each other
+	std::vector<std::string> createUniqueObjectNames(const std::string& baseName, size_t count) const;
+
 	sim::EntityId generateNextEntityId() const;
 
 private:
@@ -74,12 +102,49 @@ private:
 	sim::EntityPtr createMoon(const EntityFactory::VisContext& visContext) const;
 	sim::EntityPtr createStars(const EntityFactory::VisContext& visContext) const;
 
+	struct EntityPrototype;
+
+	struct ParsedEntityTemplate
+	{
+		nlohmann::json json;
+		skybolt::ScenarioObjectPath scenarioObjectDirectory;
+	};
+
+	struct EntityTemplate
+	{
+		std::filesystem::path filename;
+
+		//! Guards parsed and parseError. A mutex is used rather than std::call_once
+		//! because some call_once implementations deadlock when the callable throws.
+		std::mutex parseMutex;
+		std::optional<ParsedEntityTemplate> parsed;
+		std::exception_ptr parseError; //!< Set if parsing failed, and rethrown to subsequent callers
+
+		std::shared_ptr<const EntityPrototype> prototype; //!< Compiled on first use. Guarded by mPrototypesMutex.
+	};
+
+	//! @returns the parsed template, parsing it if not already parsed. Thread safe.
+	//! @throws the parsing error if the template could not be parsed
+	const ParsedEntityTemplate& getParsedTemplate(EntityTemplate& entityTemplate) const;
+
+	//! @returns the template's prototype, compiling it if not already compiled. Thread safe.
+	std::shared_ptr<const EntityPrototype> getPrototype(EntityTemplate& entityTemplate) const;
+
+	std::shared_ptr<const EntityPrototype> compilePrototype(const nlohmann::json& json) const;
+	ComponentFactoryContext createComponentFactoryContext() const;
+	sim::EntityPtr instantiatePrototype(const EntityPrototype& prototype, const ComponentFactoryContext& componentFactoryContext, const std::string& templateName, const std::string& instanceName, const sim::Vector3& position, const sim::Quaternion& orientation, sim::EntityId id) const;
+
 private:
 	Strings mTemplateNames;
-	std::map<std::string, skybolt::ScenarioObjectPath> mTemplateDirectories;
+	std::map<std::string, std::unique_ptr<EntityTemplate>> mTemplates;
 	std::map<std::string, std::function<sim::EntityPtr()>> mBuiltinTemplates; // TODO: genericize these
 
-	TemplateJsonMap mTemplateJsonMap;
+	px_sched::Sync mTemplateParsingSync;
+	mutable std::mutex mPrototypesMutex;
+
+	mutable std::mutex mTemplateJsonMapMutex;
+	mutable std::optional<TemplateJsonMap> mTemplateJsonMap; //!< Built on first use. Guarded by mTemplateJsonMapMutex.
+	mutable std::exception_ptr mTemplateJsonMapError; //!< Guarded by mTemplateJsonMapMutex.
 
 	Context mContext;
 	mutable sim::EntityId mNextEntityId{1,0};
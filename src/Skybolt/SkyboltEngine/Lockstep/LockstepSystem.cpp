@@ -0,0 +1,328 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "LockstepSystem.h"
+#include <SkyboltSim/Components/Motion.h>
+#include <SkyboltSim/Components/Node.h>
+#include <SkyboltCommon/Exception.h>
+#include <SkyboltCommon/Profiling/Profiler.h>
+
+#include <assert.h>
+#include <chrono>
+#include <cstring>
+
+namespace skybolt {
+
+using namespace sim;
+
+namespace {
+
+// Message layout, in native byte order since all nodes are expected to run the same build:
+// Header: uint64 step, double simTime, uint32 entityCount
+// Per entity: uint32 applicationId, uint32 entityId, uint8 flags,
+//   then position (3 doubles) and orientation (4 doubles) if flags has transformFlag,
+//   then linear and angular velocity (6 doubles) if flags has motionFlag.
+constexpr std::uint8_t transformFlag = 1;
+constexpr std::uint8_t motionFlag = 2;
+
+class MessageWriter
+{
+public:
+	MessageWriter(std::vector<std::uint8_t>& buffer) : mBuffer(buffer) {}
+
+	template <typename T>
+	void write(const T& value)
+	{
+		size_t offset = mBuffer.size();
+		mBuffer.resize(offset + sizeof(T));
+		std::memcpy(mBuffer.data() + offset, &value, sizeof(T));
+	}
+
+	void write(const Vector3& v)
+	{
+		write(v.x); write(v.y); write(v.z);
+	}
+
+	void write(const Quaternion& q)
+	{
+		write(q.x); write(q.y); write(q.z); write(q.w);
+	}
+
+private:
+	std::vector<std::uint8_t>& mBuffer;
+};
+
+class MessageReader
+{
+public:
+	MessageReader(const std::vector<std::uint8_t>& buffer) : mBuffer(buffer) {}
+
+	template <typename T>
+	T read()
+	{
+		if (mOffset + sizeof(T) > mBuffer.size())
+		{
+			throw Exception("Lockstep message is truncated");
+		}
+		T value;
+		std::memcpy(&value, mBuffer.data() + mOffset, sizeof(T));
+		mOffset += sizeof(T);
+		return value;
+	}
+
+	Vector3 readVector3()
+	{
+		Vector3 v;
+		v.x = read<double>(); v.y = read<double>(); v.z = read<double>();
+		return v;
+	}
+
+	Quaternion readQuaternion()
+	{
+		Quaternion q;
+		q.x = read<double>(); q.y = read<double>(); q.z = read<double>(); q.w = read<double>();
+		return q;
+	}
+
+private:
+	const std::vector<std::uint8_t>& mBuffer;
+	size_t mOffset = 0;
+};
+
+std::uint64_t readStep(const std::vector<std::uint8_t>& message)
+{
+	return MessageReader(message).read<std::uint64_t>();
+}
+
+} // namespace
+
+LockstepEntityOwnership createLockstepOwnershipByEntityId(int nodeCount)
+{
+	assert(nodeCount > 0);
+	return [nodeCount] (const Entity& entity) {
+		return int(entity.getId().entityId % std::uint32_t(nodeCount));
+	};
+}
+
+LockstepSystem::LockstepSystem(World* world, const LockstepTransportPtr& transport, const LockstepEntityOwnership& ownership) :
+	mWorld(world),
+	mTransport(transport),
+	mOwnership(ownership ? ownership : createLockstepOwnershipByEntityId(transport->getNodeCount()))
+{
+	assert(mWorld);
+	assert(mTransport);
+
+	for (const EntityPtr& entity : mWorld->getEntities())
+	{
+		entityAdded(entity);
+	}
+	mWorld->addListener(this);
+}
+
+LockstepSystem::~LockstepSystem()
+{
+	mWorld->removeListener(this);
+
+	for (const auto& [id, record] : mEntities)
+	{
+		if (!record.owned)
+		{
+			record.entity->setDynamicsEnabled(record.dynamicsWasEnabled);
+		}
+	}
+}
+
+bool LockstepSystem::isOwned(const EntityId& id) const
+{
+	auto i = mEntities.find(id);
+	return i != mEntities.end() && i->second.owned;
+}
+
+void LockstepSystem::advanceSimTime(SecondsD newTime, SecondsD dt)
+{
+	mSimTime = newTime;
+}
+
+void LockstepSystem::entityAdded(const EntityPtr& entity)
+{
+	EntityRecord record;
+	record.entity = entity.get();
+	record.owned = (mOwnership(*entity) == mTransport->getNodeIndex());
+	record.dynamicsWasEnabled = entity->isDynamicsEnabled();
+
+	if (!record.owned)
+	{
+		entity->setDynamicsEnabled(false);
+	}
+	mEntities[entity->getId()] = record;
+}
+
+void LockstepSystem::entityAboutToBeRemoved(const EntityPtr& entity)
+{
+	mEntities.erase(entity->getId());
+}
+
+void LockstepSystem::exchangeState()
+{
+	SKYBOLT_PROFILE_ZONE("LockstepSystem::exchangeState");
+
+	if (mTransport->getNodeCount() == 1)
+	{
+		++mStats.step;
+		return;
+	}
+
+	std::vector<std::uint8_t> message = writeOwnedEntityState();
+	mTransport->broadcast(message);
+	mStats.bytesSent += message.size();
+
+	// Apply messages for this step that arrived while we were still on an earlier step
+	int receivedCount = 0;
+	if (auto i = mEarlyMessages.find(mStats.step); i != mEarlyMessages.end())
+	{
+		for (const auto& earlyMessage : i->second)
+		{
+			applyGhostState(earlyMessage);
+			++receivedCount;
+		}
+		mEarlyMessages.erase(i);
+	}
+
+	// Wait for the remaining nodes to finish this step
+	auto waitStartTime = std::chrono::steady_clock::now();
+	while (receivedCount < mTransport->getNodeCount() - 1)
+	{
+		mTransport->receive(message);
+		mStats.bytesReceived += message.size();
+
+		std::uint64_t step = readStep(message);
+		if (step == mStats.step)
+		{
+			applyGhostState(message);
+			++receivedCount;
+		}
+		else if (step > mStats.step)
+		{
+			mEarlyMessages[step].push_back(std::move(message));
+		}
+		else
+		{
+			throw Exception("Lockstep received message for step " + std::to_string(step) + " after step " + std::to_string(mStats.step) + " completed");
+		}
+	}
+	mStats.barrierWaitDuration += std::chrono::duration<double>(std::chrono::steady_clock::now() - waitStartTime).count();
+
+	++mStats.step;
+}
+
+std::vector<std::uint8_t> LockstepSystem::writeOwnedEntityState()
+{
+	std::vector<std::uint8_t> message;
+	MessageWriter writer(message);
+	writer.write(mStats.step);
+	writer.write(mSimTime);
+	writer.write(std::uint32_t(0)); // Placeholder for entity count
+
+	std::uint32_t entityCount = 0;
+	for (auto& [id, record] : mEntities)
+	{
+		if (!record.owned)
+		{
+			continue;
+		}
+
+		std::uint8_t flags = 0;
+		Node* node = record.entity->getFirstComponent<Node>().get();
+		if (node && record.sentTransformVersion != node->getTransformVersion())
+		{
+			flags |= transformFlag;
+			record.sentTransformVersion = node->getTransformVersion();
+		}
+
+		Motion* motion = record.entity->getFirstComponent<Motion>().get();
+		if (motion)
+		{
+			auto velocities = std::make_pair(motion->linearVelocity, motion->angularVelocity);
+			if (record.sentVelocities != velocities)
+			{
+				flags |= motionFlag;
+				record.sentVelocities = velocities;
+			}
+		}
+
+		if (flags)
+		{
+			writer.write(id.applicationId);
+			writer.write(id.entityId);
+			writer.write(flags);
+			if (flags & transformFlag)
+			{
+				writer.write(node->getPosition());
+				writer.write(node->getOrientation());
+			}
+			if (flags & motionFlag)
+			{
+				writer.write(motion->linearVelocity);
+				writer.write(motion->angularVelocity);
+			}
+			++entityCount;
+		}
+	}
+
+	constexpr size_t entityCountOffset = sizeof(std::uint64_t) + sizeof(double);
+	std::memcpy(message.data() + entityCountOffset, &entityCount, sizeof(entityCount));
+	mStats.entityUpdatesSent += entityCount;
+	return message;
+}
+
+void LockstepSystem::applyGhostState(const std::vector<std::uint8_t>& message)
+{
+	MessageReader reader(message);
+	reader.read<std::uint64_t>(); // step
+	double simTime = reader.read<double>();
+	if (simTime != mSimTime)
+	{
+		throw Exception("Lockstep nodes diverged. Received sim time " + std::to_string(simTime) + " but expected " + std::to_string(mSimTime)
+			+ ". All nodes must use the same fixed dynamics step size.");
+	}
+
+	std::uint32_t entityCount = reader.read<std::uint32_t>();
+	for (std::uint32_t i = 0; i < entityCount; ++i)
+	{
+		EntityId id;
+		id.applicationId = reader.read<std::uint32_t>();
+		id.entityId = reader.read<std::uint32_t>();
+		std::uint8_t flags = reader.read<std::uint8_t>();
+
+		auto it = mEntities.find(id);
+		// Entities that are unknown or owned by this node are still read to advance through the message, but are not applied
+		Entity* entity = (it != mEntities.end() && !it->second.owned) ? it->second.entity : nullptr;
+
+		if (flags & transformFlag)
+		{
+			Vector3 position = reader.readVector3();
+			Quaternion orientation = reader.readQuaternion();
+			if (Node* node = entity ? entity->getFirstComponent<Node>().get() : nullptr; node)
+			{
+				node->setPosition(position);
+				node->setOrientation(orientation);
+			}
+		}
+		if (flags & motionFlag)
+		{
+			Vector3 linearVelocity = reader.readVector3();
+			Vector3 angularVelocity = reader.readVector3();
+			if (Motion* motion = entity ? entity->getFirstComponent<Motion>().get() : nullptr; motion)
+			{
+				motion->linearVelocity = linearVelocity;
+				motion->angularVelocity = angularVelocity;
+			}
+		}
+	}
+	mStats.entityUpdatesReceived += entityCount;
+}
+
+} // namespace skybolt
@@ -0,0 +1,96 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#pragma once
+
+#include "LockstepTransport.h"
+#include <SkyboltSim/EntityId.h>
+#include <SkyboltSim/World.h>
+#include <SkyboltSim/System/System.h>
+
+#include <functional>
+#include <map>
+#include <optional>
+
+namespace skybolt {
+
+struct LockstepStats
+{
+	std::uint64_t step = 0; //!< Number of dynamics substeps completed
+	std::uint64_t bytesSent = 0;
+	std::uint64_t bytesReceived = 0;
+	std::uint64_t entityUpdatesSent = 0;
+	std::uint64_t entityUpdatesReceived = 0;
+	double barrierWaitDuration = 0; //!< Total seconds spent waiting for other nodes
+};
+
+//! @returns index of the node that owns the entity
+using LockstepEntityOwnership = std::function<int(const sim::Entity&)>;
+
+//! Assigns entities to nodes by entity ID, so that every node agrees on ownership without communicating
+LockstepEntityOwnership createLockstepOwnershipByEntityId(int nodeCount);
+
+/*! Advances a partition of the world in lockstep with other nodes.
+	Each node runs the dynamics of the entities it owns. Other entities are ghosts, which have dynamics disabled
+	and mirror the state of the owning node. After every dynamics substep, each node broadcasts the Node and Motion
+	state of its owned entities that changed, and then waits for all other nodes to do the same before applying
+	their state to the ghosts. Interactions between partitions therefore see the same state as a single node would.
+
+	Requirements for the nodes to remain in lockstep:
+	- Every node creates the same entities with the same IDs.
+	- Every node uses the same fixed dynamics step size, i.e. not DynamicsOverloadPolicy::Stretch.
+	- The LockstepSystem is added to the SystemRegistry after the EntitySystem.
+*/
+class LockstepSystem : public sim::System, public sim::WorldListener
+{
+public:
+	//! @param ownership assigns entities to nodes. Defaults to createLockstepOwnershipByEntityId.
+	LockstepSystem(sim::World* world, const LockstepTransportPtr& transport, const LockstepEntityOwnership& ownership = nullptr);
+	~LockstepSystem() override;
+
+	bool isOwned(const sim::EntityId& id) const;
+
+	const LockstepStats& getStats() const { return mStats; }
+
+public: // SimUpdatable interface
+	void advanceSimTime(sim::SecondsD newTime, sim::SecondsD dt) override;
+
+	SKYBOLT_BEGIN_REGISTER_UPDATE_HANDLERS
+		SKYBOLT_REGISTER_UPDATE_HANDLER(sim::UpdateStage::PostDynamicsSubStep, exchangeState)
+	SKYBOLT_END_REGISTER_UPDATE_HANDLERS
+
+public: // WorldListener interface
+	void entityAdded(const sim::EntityPtr& entity) override;
+	void entityAboutToBeRemoved(const sim::EntityPtr& entity) override;
+
+private:
+	void exchangeState();
+	std::vector<std::uint8_t> writeOwnedEntityState();
+	void applyGhostState(const std::vector<std::uint8_t>& message);
+
+private:
+	sim::World* mWorld;
+	LockstepTransportPtr mTransport;
+	LockstepEntityOwnership mOwnership;
+	sim::SecondsD mSimTime = 0;
+
+	struct EntityRecord
+	{
+		sim::Entity* entity;
+		bool owned;
+		bool dynamicsWasEnabled;
+
+		// State last sent to other nodes, used to send only changes
+		std::optional<std::uint64_t> sentTransformVersion;
+		std::optional<std::pair<sim::Vector3, sim::Vector3>> sentVelocities; //!< Linear and angular velocity
+	};
+	std::map<sim::EntityId, EntityRecord> mEntities;
+
+	std::map<std::uint64_t, std::vector<std::vector<std::uint8_t>>> mEarlyMessages; //!< Messages for future steps from nodes that are ahead, keyed on step
+	LockstepStats mStats;
+};
+
+} // namespace skybolt
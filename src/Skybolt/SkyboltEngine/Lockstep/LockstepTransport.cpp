@@ -0,0 +1,98 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "LockstepTransport.h"
+#include <SkyboltCommon/Exception.h>
+
+#include <assert.h>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+
+namespace skybolt {
+
+namespace {
+
+struct LoopbackMailbox
+{
+	std::mutex mutex;
+	std::condition_variable condition;
+	std::deque<std::pair<int, std::vector<std::uint8_t>>> messages; //!< Pairs of sender and message
+};
+
+using LoopbackMailboxes = std::vector<std::unique_ptr<LoopbackMailbox>>;
+
+class LoopbackLockstepTransport : public LockstepTransport
+{
+public:
+	LoopbackLockstepTransport(int nodeIndex, const std::shared_ptr<LoopbackMailboxes>& mailboxes, double receiveTimeout) :
+		mNodeIndex(nodeIndex),
+		mMailboxes(mailboxes),
+		mReceiveTimeout(receiveTimeout)
+	{
+		assert(mMailboxes);
+	}
+
+	int getNodeIndex() const override { return mNodeIndex; }
+	int getNodeCount() const override { return int(mMailboxes->size()); }
+
+	void broadcast(const std::vector<std::uint8_t>& message) override
+	{
+		for (int i = 0; i < int(mMailboxes->size()); ++i)
+		{
+			if (i != mNodeIndex)
+			{
+				LoopbackMailbox& mailbox = *(*mMailboxes)[i];
+				{
+					std::scoped_lock<std::mutex> lock(mailbox.mutex);
+					mailbox.messages.emplace_back(mNodeIndex, message);
+				}
+				mailbox.condition.notify_one();
+			}
+		}
+	}
+
+	int receive(std::vector<std::uint8_t>& message) override
+	{
+		LoopbackMailbox& mailbox = *(*mMailboxes)[mNodeIndex];
+		std::unique_lock<std::mutex> lock(mailbox.mutex);
+		if (!mailbox.condition.wait_for(lock, std::chrono::duration<double>(mReceiveTimeout), [&] { return !mailbox.messages.empty(); }))
+		{
+			throw Exception("Lockstep node " + std::to_string(mNodeIndex) + " timed out waiting for a message");
+		}
+
+		int sender = mailbox.messages.front().first;
+		message = std::move(mailbox.messages.front().second);
+		mailbox.messages.pop_front();
+		return sender;
+	}
+
+private:
+	const int mNodeIndex;
+	const std::shared_ptr<LoopbackMailboxes> mMailboxes;
+	const double mReceiveTimeout;
+};
+
+} // namespace
+
+std::vector<LockstepTransportPtr> createLoopbackLockstepTransports(int nodeCount, double receiveTimeout)
+{
+	auto mailboxes = std::make_shared<LoopbackMailboxes>();
+	for (int i = 0; i < nodeCount; ++i)
+	{
+		mailboxes->push_back(std::make_unique<LoopbackMailbox>());
+	}
+
+	std::vector<LockstepTransportPtr> transports;
+	for (int i = 0; i < nodeCount; ++i)
+	{
+		transports.push_back(std::make_shared<LoopbackLockstepTransport>(i, mailboxes, receiveTimeout));
+	}
+	return transports;
+}
+
+} // namespace skybolt
@@ -0,0 +1,40 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace skybolt {
+
+//! Exchanges messages between the nodes of a lockstep simulation.
+//! Messages from a given sender must be received in the order they were sent.
+class LockstepTransport
+{
+public:
+	virtual ~LockstepTransport() = default;
+
+	virtual int getNodeIndex() const = 0;
+	virtual int getNodeCount() const = 0;
+
+	//! Sends the message to every other node
+	virtual void broadcast(const std::vector<std::uint8_t>& message) = 0;
+
+	//! Blocks until a message from another node is received.
+	//! @returns index of the node that sent the message
+	//! @throws skybolt::Exception if no message is received within the transport's timeout
+	virtual int receive(std::vector<std::uint8_t>& message) = 0;
+};
+
+using LockstepTransportPtr = std::shared_ptr<LockstepTransport>;
+
+//! Creates transports that pass messages in memory between nodes running in the same process.
+//! @param receiveTimeout is in seconds
+std::vector<LockstepTransportPtr> createLoopbackLockstepTransports(int nodeCount, double receiveTimeout = 10.0);
+
+} // namespace skybolt
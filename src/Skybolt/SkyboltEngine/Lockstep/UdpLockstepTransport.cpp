@@ -0,0 +1,330 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#define _SILENCE_CXX17_ALLOCATOR_VOID_DEPRECATION_WARNING // Ignore boost/asio warnings
+#include "UdpLockstepTransport.h"
+#include <SkyboltCommon/Exception.h>
+
+#ifdef WIN32
+#define _WIN32_WINNT 0x0601 // Boost/asio requires the windows platform target to be set
+#endif
+#include <boost/asio.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <deque>
+#include <limits>
+#include <map>
+#include <optional>
+#include <thread>
+
+using boost::asio::ip::udp;
+
+namespace skybolt {
+
+namespace {
+
+struct FragmentHeader
+{
+	std::uint32_t sender;
+	std::uint32_t messageId;
+	std::uint32_t messageSize;
+	std::uint16_t fragmentIndex;
+	std::uint16_t fragmentCount;
+};
+
+constexpr size_t maxFragmentPayloadSize = 60000; // Keep datagrams within the 64KB UDP limit
+constexpr size_t maxDatagramSize = sizeof(FragmentHeader) + maxFragmentPayloadSize;
+
+size_t calcFragmentCount(size_t messageSize)
+{
+	return std::max(size_t(1), (messageSize + maxFragmentPayloadSize - 1) / maxFragmentPayloadSize);
+}
+
+//! @returns true if the header describes a fragment that the sender could have produced, given the size of its payload
+bool isValidFragment(const FragmentHeader& header, size_t payloadSize)
+{
+	if (header.fragmentIndex >= header.fragmentCount || header.fragmentCount != calcFragmentCount(header.messageSize))
+	{
+		return false;
+	}
+	size_t offset = size_t(header.fragmentIndex) * maxFragmentPayloadSize;
+	return payloadSize == std::min(maxFragmentPayloadSize, size_t(header.messageSize) - offset);
+}
+
+//! Message being reassembled from fragments
+struct PartialMessage
+{
+	std::uint32_t messageSize;
+	std::vector<std::uint8_t> data;
+	std::vector<bool> receivedFragments; //!< Indexed by fragment index
+	int receivedFragmentCount = 0;
+};
+
+} // namespace
+
+class UdpLockstepTransportImpl
+{
+public:
+	UdpLockstepTransportImpl(const UdpLockstepTransportConfig& config) :
+		mNodeIndex(config.nodeIndex),
+		mReceiveTimeout(config.receiveTimeout),
+		mReceiveBuffer(maxDatagramSize)
+	{
+		if (mNodeIndex < 0 || mNodeIndex >= int(config.nodeEndpoints.size()))
+		{
+			throw Exception("Lockstep node index " + std::to_string(mNodeIndex) + " is out of range");
+		}
+
+		for (const UdpLockstepEndpoint& endpoint : config.nodeEndpoints)
+		{
+			mEndpoints.push_back(resolve(endpoint));
+		}
+		mLastCompletedMessageIds.resize(mEndpoints.size());
+
+		mSocket = std::make_unique<udp::socket>(mService);
+		mSocket->open(udp::v4());
+		mSocket->set_option(boost::asio::socket_base::receive_buffer_size(8 * 1024 * 1024));
+		mSocket->non_blocking(true);
+		mSocket->bind(mEndpoints[mNodeIndex]);
+	}
+
+	~UdpLockstepTransportImpl()
+	{
+		mSocket->close();
+	}
+
+	int getNodeIndex() const { return mNodeIndex; }
+	int getNodeCount() const { return int(mEndpoints.size()); }
+
+	int getLocalPort() const { return int(mSocket->local_endpoint().port()); }
+
+	void setNodeEndpoint(int nodeIndex, const UdpLockstepEndpoint& endpoint)
+	{
+		if (nodeIndex < 0 || nodeIndex >= int(mEndpoints.size()) || nodeIndex == mNodeIndex)
+		{
+			throw Exception("Lockstep node index " + std::to_string(nodeIndex) + " is not a remote node");
+		}
+		mEndpoints[nodeIndex] = resolve(endpoint);
+	}
+
+	void broadcast(const std::vector<std::uint8_t>& message)
+	{
+		size_t fragmentCount = calcFragmentCount(message.size());
+		if (fragmentCount > std::numeric_limits<std::uint16_t>::max())
+		{
+			throw Exception("Lockstep message is too large to send");
+		}
+
+		FragmentHeader header;
+		header.sender = std::uint32_t(mNodeIndex);
+		header.messageId = mNextMessageId++;
+		header.messageSize = std::uint32_t(message.size());
+		header.fragmentCount = std::uint16_t(fragmentCount);
+
+		std::vector<std::uint8_t> datagram;
+		for (size_t i = 0; i < fragmentCount; ++i)
+		{
+			size_t offset = i * maxFragmentPayloadSize;
+			size_t payloadSize = std::min(maxFragmentPayloadSize, message.size() - offset);
+			header.fragmentIndex = std::uint16_t(i);
+
+			datagram.resize(sizeof(FragmentHeader) + payloadSize);
+			std::memcpy(datagram.data(), &header, sizeof(FragmentHeader));
+			std::memcpy(datagram.data() + sizeof(FragmentHeader), message.data() + offset, payloadSize);
+
+			for (int node = 0; node < int(mEndpoints.size()); ++node)
+			{
+				if (node != mNodeIndex)
+				{
+					sendDatagram(datagram, mEndpoints[node]);
+				}
+			}
+		}
+	}
+
+	int receive(std::vector<std::uint8_t>& message)
+	{
+		auto startTime = std::chrono::steady_clock::now();
+		while (mCompleteMessages.empty())
+		{
+			if (!receiveDatagram())
+			{
+				// Spin briefly to keep barrier latency low, then back off to avoid starving other threads
+				auto waitDuration = std::chrono::steady_clock::now() - startTime;
+				if (waitDuration > std::chrono::duration<double>(mReceiveTimeout))
+				{
+					throw Exception("Lockstep node " + std::to_string(mNodeIndex) + " timed out waiting for a message");
+				}
+				else if (waitDuration > std::chrono::milliseconds(1))
+				{
+					std::this_thread::sleep_for(std::chrono::microseconds(100));
+				}
+				else
+				{
+					std::this_thread::yield();
+				}
+			}
+		}
+
+		int sender = mCompleteMessages.front().first;
+		message = std::move(mCompleteMessages.front().second);
+		mCompleteMessages.pop_front();
+		return sender;
+	}
+
+private:
+	udp::endpoint resolve(const UdpLockstepEndpoint& endpoint)
+	{
+		udp::resolver resolver(mService);
+		udp::resolver::query query(udp::v4(), endpoint.address, std::to_string(endpoint.port));
+		return *resolver.resolve(query);
+	}
+
+	void sendDatagram(const std::vector<std::uint8_t>& datagram, const udp::endpoint& endpoint)
+	{
+		// The socket is non-blocking, so retry if the send buffer is full
+		for (;;)
+		{
+			boost::system::error_code error;
+			mSocket->send_to(boost::asio::buffer(datagram), endpoint, 0, error);
+			if (error == boost::asio::error::would_block)
+			{
+				std::this_thread::yield();
+			}
+			else if (error)
+			{
+				throw Exception("Lockstep node " + std::to_string(mNodeIndex) + " failed to send: " + error.message());
+			}
+			else
+			{
+				return;
+			}
+		}
+	}
+
+	//! @returns true if a datagram was received
+	bool receiveDatagram()
+	{
+		udp::endpoint senderEndpoint;
+		boost::system::error_code error;
+		size_t size = mSocket->receive_from(boost::asio::buffer(mReceiveBuffer), senderEndpoint, 0, error);
+		if (error)
+		{
+			return false;
+		}
+
+		if (size < sizeof(FragmentHeader))
+		{
+			return true; // Ignore malformed datagram
+		}
+
+		FragmentHeader header;
+		std::memcpy(&header, mReceiveBuffer.data(), sizeof(FragmentHeader));
+		size_t payloadSize = size - sizeof(FragmentHeader);
+		if (header.sender >= mEndpoints.size() || int(header.sender) == mNodeIndex || !isValidFragment(header, payloadSize))
+		{
+			return true; // Ignore malformed datagram
+		}
+
+		// Messages from a sender are delivered in order, so a fragment of a message at or before the sender's
+		// last completed message is either a duplicate or belongs to a message which can no longer be delivered.
+		const std::optional<std::uint32_t>& lastCompletedMessageId = mLastCompletedMessageIds[header.sender];
+		if (lastCompletedMessageId && header.messageId <= *lastCompletedMessageId)
+		{
+			return true;
+		}
+
+		const std::pair<std::uint32_t, std::uint32_t> key(header.sender, header.messageId);
+		auto i = mPartialMessages.find(key);
+		if (i == mPartialMessages.end())
+		{
+			PartialMessage partial;
+			partial.messageSize = header.messageSize;
+			partial.data.resize(header.messageSize);
+			partial.receivedFragments.resize(header.fragmentCount, false);
+			i = mPartialMessages.emplace(key, std::move(partial)).first;
+		}
+
+		PartialMessage& partial = i->second;
+		if (partial.messageSize != header.messageSize || partial.receivedFragments.size() != header.fragmentCount)
+		{
+			return true; // Ignore fragment which disagrees with earlier fragments of the same message
+		}
+		if (partial.receivedFragments[header.fragmentIndex])
+		{
+			return true; // Ignore duplicate fragment
+		}
+		partial.receivedFragments[header.fragmentIndex] = true;
+
+		size_t offset = size_t(header.fragmentIndex) * maxFragmentPayloadSize;
+		std::memcpy(partial.data.data() + offset, mReceiveBuffer.data() + sizeof(FragmentHeader), payloadSize);
+
+		if (++partial.receivedFragmentCount == int(header.fragmentCount))
+		{
+			mCompleteMessages.emplace_back(int(header.sender), std::move(partial.data));
+			mLastCompletedMessageIds[header.sender] = header.messageId;
+
+			// Drop this message and any earlier messages from the sender that lost fragments.
+			// Otherwise partial messages would accumulate without bound after any datagram loss.
+			mPartialMessages.erase(mPartialMessages.lower_bound({header.sender, 0}), std::next(i));
+		}
+		return true;
+	}
+
+private:
+	const int mNodeIndex;
+	const double mReceiveTimeout;
+	boost::asio::io_service mService;
+	std::unique_ptr<udp::socket> mSocket;
+	std::vector<udp::endpoint> mEndpoints;
+	std::vector<std::uint8_t> mReceiveBuffer;
+	std::uint32_t mNextMessageId = 0;
+
+	std::map<std::pair<std::uint32_t, std::uint32_t>, PartialMessage> mPartialMessages; //!< Keyed on sender and message ID
+	std::vector<std::optional<std::uint32_t>> mLastCompletedMessageIds; //!< Indexed by sender
+	std::deque<std::pair<int, std::vector<std::uint8_t>>> mCompleteMessages; //!< Pairs of sender and message
+};
+
+UdpLockstepTransport::UdpLockstepTransport(const UdpLockstepTransportConfig& config) :
+	mImpl(std::make_unique<UdpLockstepTransportImpl>(config))
+{
+}
+
+UdpLockstepTransport::~UdpLockstepTransport() = default;
+
+int UdpLockstepTransport::getNodeIndex() const
+{
+	return mImpl->getNodeIndex();
+}
+
+int UdpLockstepTransport::getNodeCount() const
+{
+	return mImpl->getNodeCount();
+}
+
+int UdpLockstepTransport::getLocalPort() const
+{
+	return mImpl->getLocalPort();
+}
+
+void UdpLockstepTransport::setNodeEndpoint(int nodeIndex, const UdpLockstepEndpoint& endpoint)
+{
+	mImpl->setNodeEndpoint(nodeIndex, endpoint);
+}
+
+void UdpLockstepTransport::broadcast(const std::vector<std::uint8_t>& message)
+{
+	mImpl->broadcast(message);
+}
+
+int UdpLockstepTransport::receive(std::vector<std::uint8_t>& message)
+{
+	return mImpl->receive(message);
+}
+
+} // namespace skybolt
@@ -0,0 +1,54 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#pragma once
+
+#include "LockstepTransport.h"
+
+#include <memory>
+#include <string>
+
+namespace skybolt {
+
+struct UdpLockstepEndpoint
+{
+	std::string address;
+	int port;
+};
+
+struct UdpLockstepTransportConfig
+{
+	int nodeIndex;
+	std::vector<UdpLockstepEndpoint> nodeEndpoints; //!< Endpoint of every node, indexed by node index. The local node binds to its own endpoint, which may use port 0 to let the OS choose a free port.
+	double receiveTimeout = 10.0; //!< Seconds
+};
+
+//! Exchanges lockstep messages as UDP datagrams. Messages larger than a datagram are split into fragments.
+//! Lost datagrams are not retransmitted, so a lost message results in a receive timeout.
+//! Intended for nodes on a reliable local network, or on the same machine.
+class UdpLockstepTransport : public LockstepTransport
+{
+public:
+	UdpLockstepTransport(const UdpLockstepTransportConfig& config);
+	~UdpLockstepTransport() override;
+
+	int getNodeIndex() const override;
+	int getNodeCount() const override;
+
+	//! @returns port the local node is bound to
+	int getLocalPort() const;
+
+	//! Sets the endpoint of a remote node, e.g. once the port it bound to is known
+	void setNodeEndpoint(int nodeIndex, const UdpLockstepEndpoint& endpoint);
+
+	void broadcast(const std::vector<std::uint8_t>& message) override;
+	int receive(std::vector<std::uint8_t>& message) override;
+
+private:
+	std::unique_ptr<class UdpLockstepTransportImpl> mImpl;
+};
+
+} // namespace skybolt
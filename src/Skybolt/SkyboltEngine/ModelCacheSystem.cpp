@@ -0,0 +1,69 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "ModelCacheSystem.h"
+#include "EngineStats.h"
+#include <SkyboltCommon/Profiling/Profiler.h>
+#include <SkyboltVis/Renderable/Model/InstancedModel.h>
+#include <SkyboltVis/Renderable/Model/InstancedModelCache.h>
+#include <SkyboltVis/Renderable/Model/ModelCache.h>
+
+#include <assert.h>
+
+namespace skybolt {
+
+ModelCacheSystem::ModelCacheSystem(const vis::ModelCachePtr& modelCache, const vis::InstancedModelCachePtr& instancedModelCache, EngineStats* stats, int evictionInterval) :
+	mModelCache(modelCache),
+	mInstancedModelCache(instancedModelCache),
+	mStats(stats),
+	mEvictionInterval(evictionInterval)
+{
+	assert(mModelCache);
+	assert(mEvictionInterval > 0);
+}
+
+ModelCacheSystem::~ModelCacheSystem() = default;
+
+void ModelCacheSystem::updateState()
+{
+	SKYBOLT_PROFILE_ZONE("ModelCacheSystem::updateState");
+
+	// Models of removed entities are released together once every interval, rather than checking the cache every update
+	if (++mUpdatesSinceEviction >= mEvictionInterval)
+	{
+		mUpdatesSinceEviction = 0;
+		mModelCache->evictUnused();
+	}
+
+	if (mStats)
+	{
+		updateStats();
+	}
+}
+
+void ModelCacheSystem::updateStats()
+{
+	mStats->cachedModelCount = mModelCache->size();
+	mStats->instancedModelCount = 0;
+	mStats->modelInstanceCount = 0;
+	mStats->visibleModelInstanceCount = 0;
+	mStats->culledModelInstanceCount = 0;
+	mStats->instancedModelDrawCallCount = 0;
+
+	if (mInstancedModelCache)
+	{
+		mInstancedModelCache->forEachModel([this] (const vis::InstancedModel& model) {
+			const vis::InstancedModelStats& stats = model.getStats();
+			++mStats->instancedModelCount;
+			mStats->modelInstanceCount += stats.instanceCount;
+			mStats->visibleModelInstanceCount += stats.visibleInstanceCount;
+			mStats->culledModelInstanceCount += stats.culledInstanceCount;
+			mStats->instancedModelDrawCallCount += stats.drawCallCount;
+		});
+	}
+}
+
+} // namespace skybolt
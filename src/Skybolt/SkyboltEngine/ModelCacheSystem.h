@@ -0,0 +1,43 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#pragma once
+
+#include "SkyboltEngine/SkyboltEngineFwd.h"
+#include <SkyboltSim/System/System.h>
+#include <SkyboltVis/SkyboltVisFwd.h>
+
+namespace skybolt {
+
+//! Periodically releases cached models which are no longer used by any entity,
+//! and records model cache and instanced model stats in EngineStats.
+class ModelCacheSystem : public sim::System
+{
+public:
+	//! @param instancedModelCache is optional
+	//! @param stats is optional
+	//! @param evictionInterval is the number of updates between releasing unused models
+	ModelCacheSystem(const vis::ModelCachePtr& modelCache, const vis::InstancedModelCachePtr& instancedModelCache, EngineStats* stats, int evictionInterval = 60);
+	~ModelCacheSystem() override;
+
+	SKYBOLT_BEGIN_REGISTER_UPDATE_HANDLERS
+		SKYBOLT_REGISTER_UPDATE_HANDLER(sim::UpdateStage::Output, updateState)
+	SKYBOLT_END_REGISTER_UPDATE_HANDLERS
+
+	void updateState();
+
+private:
+	void updateStats();
+
+private:
+	vis::ModelCachePtr mModelCache;
+	vis::InstancedModelCachePtr mInstancedModelCache;
+	EngineStats* mStats;
+	int mEvictionInterval;
+	int mUpdatesSinceEviction = 0;
+};
+
+} // namespace skybolt
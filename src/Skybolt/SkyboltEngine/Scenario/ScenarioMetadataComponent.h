@@ -8,14 +8,39 @@
 
 #include "ScenarioObjectPath.h"
 #include "SkyboltSim/Component.h"
+#include <SkyboltCommon/Listenable.h>
 
 namespace skybolt {
 
-struct ScenarioMetadataComponent : public sim::Component
+struct ScenarioMetadataComponent;
+
+class ScenarioMetadataComponentListener
+{
+public:
+	virtual ~ScenarioMetadataComponentListener() = default;
+	virtual void directoryChanged(ScenarioMetadataComponent* component) {}
+};
+
+struct ScenarioMetadataComponent : public sim::Component, public skybolt::Listenable<ScenarioMetadataComponentListener>
 {
 	bool serializable = true; //!< True if the entity should be loaded and saved
 	bool deletable = true; //!< True if the entity can be deleted by the user
-	ScenarioObjectPath directory; //!< Directory in the scenario hierarchy in which the entity resides
+
+	//! @returns directory in the scenario hierarchy in which the entity resides
+	const ScenarioObjectPath& getDirectory() const { return mDirectory; }
+
+	//! Notifies listeners if the directory changed
+	void setDirectory(const ScenarioObjectPath& directory)
+	{
+		if (directory != mDirectory)
+		{
+			mDirectory = directory;
+			CALL_LISTENERS(directoryChanged(this));
+		}
+	}
+
+private:
+	ScenarioObjectPath mDirectory;
 };
 
 } // namespace skybolt
\ No newline at end of file
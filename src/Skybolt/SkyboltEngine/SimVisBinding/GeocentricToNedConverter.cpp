@@ -39,10 +39,15 @@ void GeocentricToNedConverter::setOrigin(const sim::Vector3& origin, const std::
 	north = glm::cross(east, down);
 
 	Matrix3 rotation(north, east, down);
-	mNedBasis = Matrix4(rotation);
-	mNedBasis[3] = glm::dvec4(origin, 1);
+	Matrix4 nedBasis = Matrix4(rotation);
+	nedBasis[3] = glm::dvec4(origin, 1);
 
-	mNedBasisInverse = glm::inverse(mNedBasis);
+	if (nedBasis != mNedBasis)
+	{
+		mNedBasis = nedBasis;
+		mNedBasisInverse = glm::inverse(mNedBasis);
+		++mVersion;
+	}
 
 	mPlanetPose = planetPose;
 }
@@ -31,6 +31,9 @@ public:
 
 	std::optional<PlanetPose> getPlanetPose() const { return mPlanetPose; }
 
+	//! @returns a number which is incremented each time the conversion changes
+	uint64_t getVersion() const { return mVersion; }
+
 	osg::Vec3d convertPosition(const sim::Vector3 &position) const;
 	osg::Vec3d convertLocalPosition(const sim::Vector3 &position) const;
 	sim::Vector3 convertLocalPosition(const osg::Vec3d &position) const;
@@ -42,6 +45,7 @@ private:
 	sim::Matrix4 mNedBasis;
 	sim::Matrix4 mNedBasisInverse;
 	std::optional<PlanetPose> mPlanetPose;
+	uint64_t mVersion = 0;
 };
 
 } // namespace skybolt
\ No newline at end of file
@@ -18,6 +18,8 @@ public:
 	PlanetVisBinding(JulianDateProvider dateProvider, const sim::Entity* entity, const vis::PlanetPtr& visObject);
 	void syncVis(const GeocentricToNedConverter& converter) override;
 
+	bool isDrivenByEntityTransform() const override { return false; } // Also depends on date
+
 private:
 	JulianDateProvider mDateProvider;
 };
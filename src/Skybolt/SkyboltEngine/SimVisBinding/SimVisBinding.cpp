@@ -7,6 +7,7 @@
 #include "SimVisBinding.h"
 #include "GeocentricToNedConverter.h"
 #include <SkyboltSim/Entity.h>
+#include <SkyboltSim/Components/Node.h>
 #include <SkyboltSim/World.h>
 #include <SkyboltSim/Spatial/Geocentric.h>
 #include <SkyboltVis/RootNode.h>
@@ -52,12 +53,31 @@ void syncVis(const sim::World& world, const GeocentricToNedConverter& converter)
 	for (const sim::EntityPtr& entity : world.getEntities())
 	{
 		std::vector<SimVisBindingsComponentPtr> components = entity->getComponentsOfType<SimVisBindingsComponent>();
+		if (components.empty())
+		{
+			continue;
+		}
+
+		// Entities without a Node are always synced because their state can not be tracked
+		const sim::Node* node = entity->getFirstComponent<sim::Node>().get();
+
 		for (const SimVisBindingsComponentPtr& component : components)
 		{
+			SimVisBindingsComponent::SyncState state;
+			state.nodeTransformVersion = node ? node->getTransformVersion() : 0;
+			state.converterVersion = converter.getVersion();
+			state.bindingCount = component->bindings.size();
+
+			bool transformChanged = !node || component->lastSyncState != state;
+
 			for (const SimVisBindingPtr& bindings : component->bindings)
 			{
-				bindings->syncVis(converter);
+				if (transformChanged || !bindings->isDrivenByEntityTransform())
+				{
+					bindings->syncVis(converter);
+				}
 			}
+			component->lastSyncState = state;
 		}
 	}
 }
@@ -12,6 +12,9 @@
 #include <SkyboltSim/SkyboltSimFwd.h>
 #include "SkyboltVis/RootNode.h"
 
+#include <optional>
+#include <tuple>
+
 namespace skybolt {
 
 class SimVisBinding
@@ -20,6 +23,10 @@ public:
 	virtual ~SimVisBinding() {};
 
 	virtual void syncVis(const GeocentricToNedConverter& converter) = 0;
+
+	//! @returns true if the vis state depends only on the entity's Node transform and the coordinate conversion,
+	//! in which case syncVis() is skipped while neither has changed.
+	virtual bool isDrivenByEntityTransform() const { return false; }
 };
 
 
@@ -38,6 +45,8 @@ public:
 
 	void syncVis(const GeocentricToNedConverter& converter) override;
 
+	bool isDrivenByEntityTransform() const override { return true; }
+
 protected:
 	const sim::Entity* mEntity;
 
@@ -54,6 +63,22 @@ protected:
 struct SimVisBindingsComponent : public sim::Component
 {
 	std::vector<SimVisBindingPtr> bindings;
+
+	//! Inputs to the most recent sync, used to skip syncing bindings driven by the entity transform when the inputs are unchanged
+	struct SyncState
+	{
+		uint64_t nodeTransformVersion;
+		uint64_t converterVersion;
+		size_t bindingCount;
+
+		bool operator==(const SyncState& other) const
+		{
+			return std::tie(nodeTransformVersion, converterVersion, bindingCount) == std::tie(other.nodeTransformVersion, other.converterVersion, other.bindingCount);
+		}
+
+		bool operator!=(const SyncState& other) const { return !(*this == other); }
+	};
+	std::optional<SyncState> lastSyncState;
 };
 
 typedef std::shared_ptr<SimVisBindingsComponent> SimVisBindingsComponentPtr;
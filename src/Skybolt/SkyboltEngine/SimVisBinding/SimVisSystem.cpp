@@ -9,10 +9,12 @@
 #include "SimVisBinding/GeocentricToNedConverter.h"
 #include "SimVisBinding/SimVisBinding.h"
 #include <SkyboltCommon/VectorUtility.h>
+#include <SkyboltCommon/Profiling/Profiler.h>
 #include <SkyboltSim/Components/CameraComponent.h>
 #include <SkyboltSim/Components/Node.h>
 #include <SkyboltSim/Components/PlanetComponent.h>
 #include <SkyboltSim/Entity.h>
+#include <SkyboltSim/System/PlanetFrameSystem.h>
 #include <SkyboltSim/World.h>
 #include <SkyboltSim/WorldUtil.h>
 #include <SkyboltVis/Scene.h>
@@ -22,10 +24,11 @@ namespace skybolt {
 
 using namespace sim;
 
-SimVisSystem::SimVisSystem(const World* world, const vis::ScenePtr& scene) :
+SimVisSystem::SimVisSystem(const World* world, const vis::ScenePtr& scene, const PlanetFrameSystem* planetFrames) :
 	mSceneOriginProvider(sceneOriginFromFirstCamera(world)),
 	mWorld(world),
 	mScene(scene),
+	mPlanetFrames(planetFrames),
 	mCoordinateConverter(std::make_unique<GeocentricToNedConverter>())
 {
 	assert(mWorld);
@@ -38,12 +41,19 @@ SimVisSystem::~SimVisSystem()
 
 void SimVisSystem::updateState()
 {
+	SKYBOLT_PROFILE_ZONE("SimVisSystem::updateState");
 	Vector3 origin = mSceneOriginProvider();
 
 	// Get nearest planet
-	sim::Entity* planet = findNearestEntityWithComponent<sim::PlanetComponent>(mWorld->getEntities(), origin).get();
 	std::optional<GeocentricToNedConverter::PlanetPose> planetPose;
-	if (planet)
+	if (mPlanetFrames)
+	{
+		if (const PlanetFrame* frame = mPlanetFrames->findNearestPlanetFrame(origin); frame)
+		{
+			planetPose = GeocentricToNedConverter::PlanetPose{frame->position, frame->orientation};
+		}
+	}
+	else if (sim::Entity* planet = findNearestEntityWithComponent<sim::PlanetComponent>(mWorld->getEntities(), origin).get(); planet)
 	{
 		GeocentricToNedConverter::PlanetPose p;
 		p.position = *getPosition(*planet);
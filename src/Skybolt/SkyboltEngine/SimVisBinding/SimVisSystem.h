@@ -22,7 +22,8 @@ class SimVisSystem : public sim::System
 public:
 	using SceneOriginProvider = std::function<sim::Vector3()>;
 
-	SimVisSystem(const sim::World* world, const vis::ScenePtr& scene);
+	//! @param planetFrames is optional. If set, used to find the nearest planet instead of searching the world.
+	SimVisSystem(const sim::World* world, const vis::ScenePtr& scene, const sim::PlanetFrameSystem* planetFrames = nullptr);
 	~SimVisSystem();
 
 	SKYBOLT_BEGIN_REGISTER_UPDATE_HANDLERS
@@ -45,6 +46,7 @@ public:
 private:
 	const sim::World* mWorld;
 	vis::ScenePtr mScene;
+	const sim::PlanetFrameSystem* mPlanetFrames;
 	SceneOriginProvider mSceneOriginProvider;
 	std::unique_ptr<GeocentricToNedConverter> mCoordinateConverter;
 	std::vector<SimVisBindingPtr> mSimVisBindings;
@@ -0,0 +1,137 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "HeadlessRunner.h"
+#include <SkyboltEngine/EngineRoot.h>
+#include <SkyboltEngine/TimeSource.h>
+#include <SkyboltSim/System/SimStepper.h>
+#include <SkyboltSim/System/System.h>
+
+#include <assert.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+namespace skybolt {
+
+using namespace sim;
+
+HeadlessRunSummary runHeadless(const SystemRegistryPtr& systems, TimeSource& timeSource, const HeadlessRunConfig& config)
+{
+	assert(config.timeStep > 0);
+
+	SimStepper stepper(systems);
+	stepper.setTime(timeSource.getTime());
+
+	// Never drop dynamics steps to catch up, as we are not bound to wall clock time
+	stepper.setMaxDynamicsSubsteps(std::nullopt);
+
+	timeSource.setState(TimeSource::StatePlaying);
+
+	HeadlessRunSummary summary;
+	auto startTime = std::chrono::steady_clock::now();
+
+	while (timeSource.getState() == TimeSource::StatePlaying)
+	{
+		SecondsD prevTime = timeSource.getTime();
+		timeSource.advanceTime(config.timeStep);
+		SecondsD dt = timeSource.getTime() - prevTime;
+		if (dt <= 0)
+		{
+			break;
+		}
+
+		stepper.update(dt);
+
+		for (const SystemPtr& system : *systems)
+		{
+			system->advanceWallTime(summary.simDuration, dt);
+		}
+
+		++summary.updateCount;
+		summary.simDuration += dt;
+
+		if (config.realTimeMultiple)
+		{
+			std::this_thread::sleep_until(startTime + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+				std::chrono::duration<double>(summary.simDuration / *config.realTimeMultiple)));
+		}
+	}
+
+	summary.wallDuration = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+	return summary;
+}
+
+HeadlessRunSummary runHeadless(EngineRoot& engineRoot, const HeadlessRunConfig& config)
+{
+	return runHeadless(engineRoot.systemRegistry, engineRoot.scenario->timeSource, config);
+}
+
+void runHeadlessBatch(const HeadlessBatchConfig& config, const HeadlessRunCompleteHandler& onRunComplete)
+{
+	assert(config.createEngineRoot);
+
+	std::atomic<int> nextRunIndex = 0;
+	std::mutex setupMutex;
+	std::mutex completionMutex;
+
+	auto runWorker = [&] {
+		while (true)
+		{
+			int runIndex = nextRunIndex++;
+			if (runIndex >= config.runCount)
+			{
+				return;
+			}
+
+			HeadlessBatchRunSummary summary;
+			summary.runIndex = runIndex;
+
+			std::unique_ptr<EngineRoot> engineRoot;
+			try
+			{
+				{
+					std::lock_guard<std::mutex> lock(setupMutex);
+					engineRoot = config.createEngineRoot(runIndex);
+				}
+
+				if (config.prepareRun)
+				{
+					config.prepareRun(*engineRoot, runIndex);
+				}
+
+				static_cast<HeadlessRunSummary&>(summary) = runHeadless(*engineRoot, config.runConfig);
+			}
+			catch (const std::exception& e)
+			{
+				summary.error = e.what();
+			}
+
+			if (onRunComplete)
+			{
+				std::lock_guard<std::mutex> lock(completionMutex);
+				onRunComplete(engineRoot.get(), summary);
+			}
+		}
+	};
+
+	int threadCount = std::max(1, std::min(config.threadCount, config.runCount));
+	std::vector<std::thread> threads;
+	for (int i = 1; i < threadCount; ++i)
+	{
+		threads.emplace_back(runWorker);
+	}
+	runWorker(); // Use the calling thread as one of the workers
+
+	for (std::thread& thread : threads)
+	{
+		thread.join();
+	}
+}
+
+} // namespace skybolt
@@ -0,0 +1,73 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#pragma once
+
+#include <SkyboltEngine/SkyboltEngineFwd.h>
+#include <SkyboltSim/Chrono.h>
+#include <SkyboltSim/System/SystemRegistry.h>
+
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+
+namespace skybolt {
+
+class TimeSource;
+
+struct HeadlessRunConfig
+{
+	sim::SecondsD timeStep = 1.0 / 60.0; //!< Simulation time advanced per update
+
+	//! If set, the simulation is paced to run at this multiple of wall clock time.
+	//! Otherwise the simulation runs as fast as possible.
+	std::optional<double> realTimeMultiple;
+};
+
+struct HeadlessRunSummary
+{
+	int updateCount = 0;
+	sim::SecondsD simDuration = 0;
+	double wallDuration = 0; //!< Seconds
+};
+
+//! Updates the systems from the time source's current time until the end of its range, without rendering.
+//! Wall time reported to the systems advances with simulation time so that runs are reproducible.
+HeadlessRunSummary runHeadless(const sim::SystemRegistryPtr& systems, TimeSource& timeSource, const HeadlessRunConfig& config);
+
+//! Runs the engine's scenario until the end of the scenario's time range
+HeadlessRunSummary runHeadless(EngineRoot& engineRoot, const HeadlessRunConfig& config);
+
+struct HeadlessBatchRunSummary : HeadlessRunSummary
+{
+	int runIndex = 0;
+	std::optional<std::string> error; //!< Set if the run failed
+};
+
+struct HeadlessBatchConfig
+{
+	int runCount = 1;
+	int threadCount = 1; //!< Number of runs to execute concurrently, each with its own EngineRoot
+
+	//! Creates an independent EngineRoot for a run, typically with vis disabled.
+	//! Calls are serialized because EngineRoot construction registers asset packages in process-wide state.
+	std::function<std::unique_ptr<EngineRoot>(int runIndex)> createEngineRoot;
+
+	//! Optionally prepares the scenario for a run, for example by loading a scenario file and perturbing initial conditions
+	std::function<void(EngineRoot&, int runIndex)> prepareRun;
+
+	HeadlessRunConfig runConfig;
+};
+
+//! Called on completion of each run, before the run's EngineRoot is destroyed. Calls are serialized.
+//! The EngineRoot is null if it could not be created.
+using HeadlessRunCompleteHandler = std::function<void(EngineRoot*, const HeadlessBatchRunSummary&)>;
+
+//! Executes runs across threadCount threads. Runs that throw are reported with an error rather than stopping the batch.
+void runHeadlessBatch(const HeadlessBatchConfig& config, const HeadlessRunCompleteHandler& onRunComplete);
+
+} // namespace skybolt
@@ -11,36 +11,56 @@
 
 #include <osg/Stats>
 
+#include <algorithm>
 #include <chrono>
+#include <cmath>
 #include <thread>
 
 namespace skybolt {
 
-UpdateLoop::UpdateLoop(float minFrameDuration) :
-	mMinFrameDuration(minFrameDuration)
+UpdateLoop::UpdateLoop(float minFrameDuration, std::optional<double> displayRefreshRate) :
+	mTargetFrameDuration(minFrameDuration)
 {
+	if (displayRefreshRate && *displayRefreshRate > 0)
+	{
+		double refreshInterval = 1.0 / *displayRefreshRate;
+		double intervalCount = std::max(1.0, std::ceil(minFrameDuration / refreshInterval - 0.01));
+		mTargetFrameDuration = intervalCount * refreshInterval;
+		mFrameStartLead = refreshInterval * 0.1;
+	}
+}
+
+//! Sleeps until shortly before the deadline, then yields until the deadline.
+//! OS sleeps can overshoot by more than a millisecond, which would cause judder if relied on alone.
+template <class ClockT>
+static void waitUntil(const typename ClockT::time_point& deadline)
+{
+	static const auto spinDuration = std::chrono::milliseconds(2);
+	if (ClockT::now() < deadline - spinDuration)
+	{
+		std::this_thread::sleep_until(deadline - spinDuration);
+	}
+	while (ClockT::now() < deadline)
+	{
+		std::this_thread::yield();
+	}
 }
 
 void UpdateLoop::exec(Updatable updatable, ShouldExit shouldExit)
 {
-	// We must use double precision because time_since_epoch can exceed float precision
-	typedef std::chrono::duration<double> seconds;
-	double prevElapsedTime = 0;
+	using Clock = std::chrono::steady_clock;
+	const auto frameDuration = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(mTargetFrameDuration - mFrameStartLead));
+
+	Clock::time_point prevFrameStartTime = Clock::now();
 
 	while (!shouldExit())
 	{
-		// Get time delta
-		double elapsed;
-		while (true) // this loop enforces max frame rate
-		{
-			elapsed = seconds(std::chrono::high_resolution_clock::now().time_since_epoch()).count();
-			if (float(elapsed - prevElapsedTime) > mMinFrameDuration)
-				break;
-			std::this_thread::sleep_for(std::chrono::milliseconds(1));
-		}
+		// Enforce max frame rate
+		waitUntil<Clock>(prevFrameStartTime + frameDuration);
 
-		float dtWallClock(elapsed - prevElapsedTime);
-		prevElapsedTime = elapsed;
+		Clock::time_point frameStartTime = Clock::now();
+		float dtWallClock = std::chrono::duration<float>(frameStartTime - prevFrameStartTime).count();
+		prevFrameStartTime = frameStartTime;
 
 		if (!updatable(dtWallClock))
 		{
@@ -7,13 +7,16 @@
 #pragma once
 
 #include <functional>
+#include <optional>
 
 namespace skybolt {
 
 class UpdateLoop
 {
 public:
-	UpdateLoop(float minFrameDuration);
+	//! @param displayRefreshRate if set, the frame duration is rounded up to a whole number of display refresh intervals,
+	//! and each frame starts slightly before its deadline so that a vsync-blocked buffer swap does not miss a refresh.
+	UpdateLoop(float minFrameDuration, std::optional<double> displayRefreshRate = std::nullopt);
 
 	typedef std::function<bool()> ShouldExit;
 	static inline bool neverExit() { return false; }
@@ -21,8 +24,12 @@ public:
 	typedef std::function<bool(float dt)> Updatable;
 	void exec(Updatable updatable, ShouldExit shouldExit);
 
+	//! @returns the target duration between the start of consecutive frames
+	double getTargetFrameDuration() const { return mTargetFrameDuration; }
+
 private:
-	float mMinFrameDuration;
+	double mTargetFrameDuration;
+	double mFrameStartLead = 0; //!< Seconds before the target frame duration at which to start the next frame
 };
 
 } // namespace skybolt
\ No newline at end of file
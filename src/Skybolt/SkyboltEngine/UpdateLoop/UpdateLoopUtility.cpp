@@ -5,10 +5,18 @@
  * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
 
 #include "UpdateLoopUtility.h"
+#include "WorkerThread.h"
+#include <SkyboltEngine/EngineSettings.h>
+#include <SkyboltCommon/Profiling/Profiler.h>
 #include <SkyboltSim/System/SimStepper.h>
 #include <SkyboltSim/System/System.h>
 #include <SkyboltVis/VisRoot.h>
 
+#include <osg/Stats>
+#include <osgViewer/ViewerBase>
+
+#include <exception>
+
 namespace skybolt {
 
 using namespace sim;
@@ -19,22 +27,101 @@ void runMainLoop(vis::VisRoot& visRoot, EngineRoot& engineRoot, UpdateLoop::Shou
 	auto systemRegistry = engineRoot.systemRegistry;
 	auto simStepper = std::make_shared<SimStepper>(systemRegistry);
 
-	SecondsD minFrameDuration = 0.01;
+	MainLoopConfig config = getMainLoopConfig(engineRoot.engineSettings);
+	configureSimStepper(*simStepper, config);
+
+	osgViewer::ViewerBase& viewer = visRoot.getViewer();
+	runSimRenderLoop(*simStepper, *systemRegistry, [&] {
+		// Record dynamics telemetry in the viewer stats so that it appears in stats displays
+		if (osg::Stats* stats = viewer.getViewerStats(); stats && viewer.getViewerFrameStamp())
+		{
+			const sim::SimStepperStats& stepperStats = simStepper->getStats();
+			unsigned int frameNumber = viewer.getViewerFrameStamp()->getFrameNumber();
+			stats->setAttribute(frameNumber, "Sim substeps", stepperStats.substepCount);
+			stats->setAttribute(frameNumber, "Sim substep cost (ms)", stepperStats.averageSubstepCost * 1000.0);
+			stats->setAttribute(frameNumber, "Sim dropped time (ms)", stepperStats.droppedTime * 1000.0);
+			stats->setAttribute(frameNumber, "Sim total dropped time (s)", stepperStats.totalDroppedTime);
+		}
+		return visRoot.render();
+	}, shouldExit, paused, config);
+}
+
+void configureSimStepper(SimStepper& simStepper, const MainLoopConfig& config)
+{
+	simStepper.setMaxDynamicsDuration(config.maxDynamicsDuration);
+	simStepper.setOverloadPolicy(config.dynamicsOverloadPolicy);
+}
+
+void runSimRenderLoop(SimStepper& simStepper, const SystemRegistry& systems, const RenderFunction& render,
+	UpdateLoop::ShouldExit shouldExit, SimPausedPredicate paused, const MainLoopConfig& config)
+{
 	SecondsD currentWallTime = 0;
 
-	UpdateLoop loop(minFrameDuration);
+	auto advanceWallTime = [&] (float dtWallClock) {
+		for (const auto& system : systems)
+		{
+			system->advanceWallTime(currentWallTime, dtWallClock);
+		}
+		currentWallTime += dtWallClock;
+	};
+
+	UpdateLoop loop(config.minFrameDuration, config.displayRefreshRate);
+	Profiler::instance().setThreadName("Main");
+
+	if (!config.pipelined)
+	{
+		loop.exec([&](float dtWallClock) {
+			SecondsD dtSim = paused() ? 0.0 : dtWallClock;
+			simStepper.update(dtSim);
+			advanceWallTime(dtWallClock);
+
+			return render();
+		}, shouldExit);
+		return;
+	}
+
+	// The vis state of frame N is published by the Output stage at the end of frame N's update.
+	// Frame N is then rendered while the dynamics of frame N+1 run on the worker thread.
+	WorkerThread worker("Dynamics");
+	bool hasFrameToRender = false;
+
 	loop.exec([&](float dtWallClock) {
 		SecondsD dtSim = paused() ? 0.0 : dtWallClock;
-		simStepper->update(dtSim);
+		simStepper.beginUpdate();
 
-		for (const auto& system : *systemRegistry)
+		worker.start([&simStepper, dtSim] {
+			simStepper.updateDynamics(dtSim);
+		});
+
+		bool keepRunning = true;
+		try
 		{
-			system->advanceWallTime(currentWallTime, dtWallClock);
+			if (hasFrameToRender)
+			{
+				keepRunning = render();
+			}
 		}
-		currentWallTime += dtWallClock;
+		catch (...)
+		{
+			// Don't let the worker outlive the state it references.
+			// Any exception from the worker is discarded so that the render exception is the one propagated.
+			try
+			{
+				worker.wait();
+			}
+			catch (...)
+			{
+			}
+			throw;
+		}
+		worker.wait();
 
-		return visRoot.render();
+		simStepper.endUpdate();
+		advanceWallTime(dtWallClock);
+		hasFrameToRender = true;
+
+		return keepRunning;
 	}, shouldExit);
 }
 
-} // namespace skybolt
\ No newline at end of file
+} // namespace skybolt
@@ -8,12 +8,44 @@
 
 #include "UpdateLoop.h"
 #include <SkyboltEngine/EngineRoot.h>
+#include <SkyboltSim/SkyboltSimFwd.h>
+#include <SkyboltSim/System/SimStepper.h>
+#include <SkyboltSim/System/SystemRegistry.h>
 #include <SkyboltVis/SkyboltVisFwd.h>
 
 namespace skybolt {
 
 using SimPausedPredicate = std::function<bool()>;
 
+struct MainLoopConfig
+{
+	float minFrameDuration = 0.01f;
+
+	//! If true, the simulation dynamics for frame N+1 run on a worker thread while frame N renders.
+	//! This reduces frame time from (sim + render) towards max(sim, render) at the cost of one frame of latency.
+	//! The Input, BeginStateUpdate, EndStateUpdate, Attachments and Output stages still run on the main thread,
+	//! so systems which read input or write vis state (e.g. SimVisSystem) never run concurrently with rendering.
+	//! Systems updated during the dynamics stages must not access vis state.
+	bool pipelined = false;
+
+	//! If set, frame pacing is aligned to the display's refresh interval. Use with vsync.
+	std::optional<double> displayRefreshRate;
+
+	//! Wall clock seconds per frame which the simulation dynamics may take before the overload policy applies
+	std::optional<double> maxDynamicsDuration;
+	sim::DynamicsOverloadPolicy dynamicsOverloadPolicy = sim::DynamicsOverloadPolicy::Drop;
+};
+
+//! @returns true to continue running the loop
+using RenderFunction = std::function<bool()>;
+
 void runMainLoop(vis::VisRoot& visRoot, EngineRoot& engineRoot, UpdateLoop::ShouldExit shouldExit, SimPausedPredicate paused = [] {return false; });
 
-} // namespace skybolt
\ No newline at end of file
+//! Applies the config's dynamics budget and overload policy to the SimStepper
+void configureSimStepper(sim::SimStepper& simStepper, const MainLoopConfig& config);
+
+//! Runs the simulation and calls render() each frame until shouldExit returns true or render returns false
+void runSimRenderLoop(sim::SimStepper& simStepper, const sim::SystemRegistry& systems, const RenderFunction& render,
+	UpdateLoop::ShouldExit shouldExit, SimPausedPredicate paused, const MainLoopConfig& config);
+
+} // namespace skybolt
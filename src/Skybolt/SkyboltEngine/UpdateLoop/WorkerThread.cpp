@@ -0,0 +1,82 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "WorkerThread.h"
+#include <SkyboltCommon/Profiling/Profiler.h>
+
+#include <assert.h>
+
+namespace skybolt {
+
+WorkerThread::WorkerThread(const std::string& name) :
+	mName(name),
+	mThread([this] { run(); })
+{
+}
+
+WorkerThread::~WorkerThread()
+{
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mExit = true;
+	}
+	mCv.notify_all();
+	mThread.join();
+}
+
+void WorkerThread::start(std::function<void()> job)
+{
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		assert(!mJob);
+		mJob = std::move(job);
+	}
+	mCv.notify_all();
+}
+
+void WorkerThread::wait()
+{
+	std::unique_lock<std::mutex> lock(mMutex);
+	mCv.wait(lock, [this] { return !mJob; });
+
+	if (mException)
+	{
+		std::exception_ptr exception = mException;
+		mException = nullptr;
+		std::rethrow_exception(exception);
+	}
+}
+
+void WorkerThread::run()
+{
+	Profiler::instance().setThreadName(mName);
+
+	std::unique_lock<std::mutex> lock(mMutex);
+	while (true)
+	{
+		mCv.wait(lock, [this] { return mJob || mExit; });
+		if (!mJob)
+		{
+			return;
+		}
+
+		lock.unlock();
+		try
+		{
+			mJob();
+		}
+		catch (...)
+		{
+			mException = std::current_exception();
+		}
+		lock.lock();
+
+		mJob = nullptr;
+		mCv.notify_all();
+	}
+}
+
+} // namespace skybolt
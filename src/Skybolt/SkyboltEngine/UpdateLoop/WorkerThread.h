@@ -0,0 +1,44 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#pragma once
+
+#include <condition_variable>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace skybolt {
+
+//! Runs one job at a time on a dedicated thread
+class WorkerThread
+{
+public:
+	//! @param name identifies the thread in profiles
+	explicit WorkerThread(const std::string& name);
+	~WorkerThread();
+
+	void start(std::function<void()> job);
+
+	//! Waits for the current job to complete, rethrowing any exception thrown by the job
+	void wait();
+
+private:
+	void run();
+
+private:
+	std::string mName;
+	std::mutex mMutex;
+	std::condition_variable mCv;
+	std::function<void()> mJob;
+	std::exception_ptr mException;
+	bool mExit = false;
+	std::thread mThread;
+};
+
+} // namespace skybolt
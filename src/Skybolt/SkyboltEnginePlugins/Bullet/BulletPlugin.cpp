@@ -126,25 +126,25 @@ public:
 	{
 		mComponentFactoryRegistry = valueOrThrowException(getExpectedRegistry<ComponentFactoryRegistry>(*config.engineRoot->factoryRegistries));
 
-		(*mComponentFactoryRegistry)[dynamicBodyComponentName] = std::make_shared<ComponentFactoryFunctionAdapter>([this](Entity* entity, const ComponentFactoryContext& context, const nlohmann::json& json) {
+		mComponentFactoryRegistry->replace(dynamicBodyComponentName, std::make_shared<ComponentFactoryFunctionAdapter>([this](Entity* entity, const ComponentFactoryContext& context, const nlohmann::json& json) {
 			return loadBulletDynamicBody(*mBulletWorld, entity, context, json);
-		});
+		}));
 
-		(*mComponentFactoryRegistry)[kinematicBodyComponentName] = std::make_shared<ComponentFactoryFunctionAdapter>([this](Entity* entity, const ComponentFactoryContext& context, const nlohmann::json& json) {
+		mComponentFactoryRegistry->replace(kinematicBodyComponentName, std::make_shared<ComponentFactoryFunctionAdapter>([this](Entity* entity, const ComponentFactoryContext& context, const nlohmann::json& json) {
 			auto node = entity->getFirstComponentRequired<Node>().get();
 			auto shape = std::make_shared<btBoxShape>(toBtVector3(readVector3(json.at("size")) * 0.5));
 			return std::make_shared<KinematicBody>(mBulletWorld.get(), entity->getId(), node, shape, CollisionGroupMasks::simBody);
-		});
+		}));
 
-		(*mComponentFactoryRegistry)[planetKinematicBodyComponentName] = std::make_shared<ComponentFactoryFunctionAdapter>([this](Entity* entity, const ComponentFactoryContext& context, const nlohmann::json& json) {
+		mComponentFactoryRegistry->replace(planetKinematicBodyComponentName, std::make_shared<ComponentFactoryFunctionAdapter>([this](Entity* entity, const ComponentFactoryContext& context, const nlohmann::json& json) {
 			auto node = entity->getFirstComponentRequired<Node>().get();
 			auto planet = entity->getFirstComponentRequired<PlanetComponent>().get();
 			auto ocean = entity->getFirstComponent<OceanComponent>().get();
 			btCollisionShapePtr shape = loadPlanetCollisionShape(*planet, ocean);
 			return std::make_shared<KinematicBody>(mBulletWorld.get(), entity->getId(), node, shape, CollisionGroupMasks::terrain);
-		});
+		}));
 
-		(*mComponentFactoryRegistry)[wheelsComponentName] = std::make_shared<ComponentFactoryFunctionAdapter>([this](Entity* entity, const ComponentFactoryContext& context, const nlohmann::json& json) {
+		mComponentFactoryRegistry->replace(wheelsComponentName, std::make_shared<ComponentFactoryFunctionAdapter>([this](Entity* entity, const ComponentFactoryContext& context, const nlohmann::json& json) {
 			auto body = entity->getFirstComponentRequired<BulletDynamicBodyComponent>().get();
 
 			BulletWheelsComponentConfig config;
@@ -181,15 +181,15 @@ public:
 			}
 
 			return std::make_shared<BulletWheelsComponent>(config);
-		});
+		}));
 
-		(*mComponentFactoryRegistry)[drivetrainComponentName] = std::make_shared<ComponentFactoryFunctionAdapter>([this](Entity* entity, const ComponentFactoryContext& context, const nlohmann::json& json) {
+		mComponentFactoryRegistry->replace(drivetrainComponentName, std::make_shared<ComponentFactoryFunctionAdapter>([this](Entity* entity, const ComponentFactoryContext& context, const nlohmann::json& json) {
 			auto inputsComponent = entity->getFirstComponentRequired<ControlInputsComponent>();
 			auto wheelsComponent = entity->getFirstComponentRequired<BulletWheelsComponent>();
 
 			auto throttle = inputsComponent->createOrGet("throttle", 0.0f, unitRange<float>());
 			return std::make_shared<DrivetrainComponent>(wheelsComponent, throttle, json.at("maxForce"));
-		});
+		}));
 
 		mBulletSystem = std::make_shared<BulletSystem>(mBulletWorld.get());
 		mSystemRegistry->push_back(mBulletSystem);
@@ -198,8 +198,8 @@ public:
 	~BulletPlugin()
 	{
 		eraseFirst(*mSystemRegistry, mBulletSystem);
-		mComponentFactoryRegistry->erase(dynamicBodyComponentName);
-		mComponentFactoryRegistry->erase(planetKinematicBodyComponentName);
+		mComponentFactoryRegistry->remove(dynamicBodyComponentName);
+		mComponentFactoryRegistry->remove(planetKinematicBodyComponentName);
 	}
 
 private:
@@ -53,6 +53,11 @@ void BulletSystem::performSubStep()
 	mDt = 0;
 };
 
+void BulletSystem::dispatchCollisionEvents()
+{
+	mCollisionEvents.dispatch();
+}
+
 void BulletSystem::processCollisionEvents()
 {
 	const auto& dynamicsWorld = mWorld->getDynamicsWorld();
@@ -76,7 +81,7 @@ void BulletSystem::processCollisionEvents()
 				event.normalB = toGlmDvec3(pt.m_normalWorldOnB);
 				if (event.entityA != nullEntityId() || event.entityB != nullEntityId())
 				{
-					mEventEmitter->emitEvent(event);
+					mCollisionEvents.publish(event);
 				}
 			}
 		}
@@ -21,6 +21,7 @@ public:
 
 	SKYBOLT_BEGIN_REGISTER_UPDATE_HANDLERS
 		SKYBOLT_REGISTER_UPDATE_HANDLER(sim::UpdateStage::DynamicsSubStep, performSubStep)
+		SKYBOLT_REGISTER_UPDATE_HANDLER(sim::UpdateStage::PostDynamicsSubStep, dispatchCollisionEvents)
 	SKYBOLT_END_REGISTER_UPDATE_HANDLERS
 
 	void advanceSimTime(SecondsD newTime, SecondsD dt) override;
@@ -28,6 +29,7 @@ public:
 	std::optional<RayIntersectionResult> intersectRay(const Vector3 &start, const Vector3 &end, int collisionFilterMask) const override;
 
 	void performSubStep();
+	void dispatchCollisionEvents();
 
 private:
 	void processCollisionEvents();
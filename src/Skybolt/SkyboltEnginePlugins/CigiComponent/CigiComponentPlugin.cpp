@@ -183,7 +183,7 @@ private:
 		auto metadata = std::make_shared<ScenarioMetadataComponent>();
 		metadata->serializable = false;
 		metadata->deletable = false;
-		metadata->directory = concatenate(getDefaultEntityScenarioObjectDirectory(), getName(*mCigiGatewayEntity));
+		metadata->setDirectory(concatenate(getDefaultEntityScenarioObjectDirectory(), getName(*mCigiGatewayEntity)));
 		return metadata;
 	}
 
@@ -253,12 +253,12 @@ CigiComponentPlugin::CigiComponentPlugin(const PluginConfig& config)
 		return std::make_shared<CigiComponent>(communicator);
 	});
 
-	mComponentFactoryRegistry->insert(std::make_pair(cigiComponentName, factory));
+	mComponentFactoryRegistry->add(cigiComponentName, factory);
 }
 
 CigiComponentPlugin::~CigiComponentPlugin()
 {
-	mComponentFactoryRegistry->erase(cigiComponentName);
+	mComponentFactoryRegistry->remove(cigiComponentName);
 }
 
 namespace plugins {
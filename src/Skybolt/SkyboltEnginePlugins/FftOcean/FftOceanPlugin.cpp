@@ -29,12 +29,12 @@ FftOceanPlugin::FftOceanPlugin(const PluginConfig& config)
 {
 	mVisFactoryRegistry = valueOrThrowException(getExpectedRegistry<vis::VisFactoryRegistry>(*config.engineRoot->factoryRegistries));
 
-	(*mVisFactoryRegistry)[vis::VisFactoryType::WaveHeightTextureGenerator] = std::make_shared<FftOceanWaveHeightTextureGeneratorFactory>();
+	mVisFactoryRegistry->replace(vis::VisFactoryType::WaveHeightTextureGenerator, std::make_shared<FftOceanWaveHeightTextureGeneratorFactory>());
 }
 
 FftOceanPlugin::~FftOceanPlugin()
 {
-	mVisFactoryRegistry->erase(vis::VisFactoryType::WaveHeightTextureGenerator);
+	mVisFactoryRegistry->remove(vis::VisFactoryType::WaveHeightTextureGenerator);
 }
 
 namespace plugins {
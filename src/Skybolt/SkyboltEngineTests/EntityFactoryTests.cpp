@@ -0,0 +1,231 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include <catch2/catch.hpp>
+#include <SkyboltEngine/ComponentFactory.h>
+#include <SkyboltEngine/EngineStats.h>
+#include <SkyboltEngine/EntityFactory.h>
+#include <SkyboltSim/Entity.h>
+#include <SkyboltSim/Components/NameComponent.h>
+#include <SkyboltSim/Components/Node.h>
+#include <SkyboltSim/World.h>
+#include <SkyboltVis/Renderable/Planet/Tile/TileSource/JsonTileSourceFactory.h>
+#include <SkyboltCommon/Json/ReadJsonFile.h>
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+using namespace skybolt;
+
+namespace fs = std::filesystem;
+
+namespace {
+
+struct EntityFactoryFixture
+{
+	EntityFactoryFixture(int threadCount)
+	{
+		px_sched::SchedulerParams params;
+		params.num_threads = threadCount;
+		params.max_running_threads = threadCount;
+		scheduler.init(params);
+
+		context.scheduler = &scheduler;
+		context.simWorld = &world;
+		context.julianDateProvider = [] { return 0.0; };
+		context.componentFactoryRegistry = std::make_shared<ComponentFactoryRegistry>();
+		addDefaultFactories(*context.componentFactoryRegistry);
+		context.tileSourceFactoryRegistry = std::make_shared<vis::JsonTileSourceFactoryRegistry>(vis::JsonTileSourceFactoryRegistryConfig());
+		context.stats = &stats;
+	}
+
+	px_sched::Scheduler scheduler;
+	sim::World world;
+	EngineStats stats;
+	EntityFactory::Context context;
+};
+
+fs::path getTemplateDirectory()
+{
+	return fs::temp_directory_path() / "SkyboltTests" / "Entities";
+}
+
+std::vector<fs::path> writeTemplates(int count)
+{
+	fs::path directory = getTemplateDirectory();
+	fs::create_directories(directory);
+
+	std::vector<fs::path> result;
+	for (int i = 0; i < count; ++i)
+	{
+		fs::path filename = directory / ("Template" + std::to_string(i) + ".json");
+		std::ofstream stream(filename);
+		stream << R"({"components": [{"scenarioMetadata": {"scenarioObjectDirectory": "Synthetic/Group)" << (i % 10) << R"("}}]})";
+		result.push_back(filename);
+	}
+	return result;
+}
+
+fs::path writeSpawnableTemplate()
+{
+	fs::path directory = getTemplateDirectory();
+	fs::create_directories(directory);
+
+	fs::path filename = directory / "Spawnable.json";
+	std::ofstream stream(filename);
+	stream << R"({"components": [{"node": {}}, {"motion": {}}, {"scenarioMetadata": {"scenarioObjectDirectory": "Synthetic"}}]})";
+	return filename;
+}
+
+} // namespace
+
+TEST_CASE("EntityFactory parses templates on demand")
+{
+	EntityFactoryFixture fixture(/* threadCount */ 2);
+	std::vector<fs::path> filenames = writeTemplates(100);
+
+	{
+		std::ofstream stream(getTemplateDirectory() / "Invalid.json");
+		stream << "{ not json";
+	}
+	filenames.push_back(getTemplateDirectory() / "Invalid.json");
+
+	EntityFactory factory(fixture.context, filenames);
+	CHECK(factory.getTemplateNames().size() == filenames.size());
+
+	CHECK(factory.getScenarioObjectDirectoryForTemplate("Template13") == ScenarioObjectPath({"Synthetic", "Group3"}));
+	CHECK(factory.getTemplateJson("Template13").contains("components"));
+
+	sim::EntityPtr entity = factory.createEntity("Template42");
+	REQUIRE(entity);
+	CHECK(getName(*entity) == "Template421");
+
+	// Parse errors are reported when the template is used
+	CHECK_THROWS(factory.createEntity("Invalid"));
+	CHECK_THROWS(factory.getTemplateJson("Invalid"));
+	CHECK(factory.getScenarioObjectDirectoryForTemplate("Invalid") == getDefaultEntityScenarioObjectDirectory());
+	CHECK_THROWS(factory.createEntity("Missing"));
+}
+
+TEST_CASE("Benchmark EntityFactory startup with thousands of templates", "[.benchmark]")
+{
+	const int templateCount = 5000;
+	std::vector<fs::path> filenames = writeTemplates(templateCount);
+
+	auto secondsSince = [] (std::chrono::steady_clock::time_point start) {
+		return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	};
+
+	// Eager serial parsing, as done before templates were parsed lazily
+	{
+		auto start = std::chrono::steady_clock::now();
+		for (const fs::path& filename : filenames)
+		{
+			readJsonFile(filename.string());
+		}
+		std::cout << "Serial parse of " << templateCount << " templates: " << secondsSince(start) * 1000.0 << " ms" << std::endl;
+	}
+
+	for (int threadCount : {1, 4})
+	{
+		EntityFactoryFixture fixture(threadCount);
+
+		auto start = std::chrono::steady_clock::now();
+		EntityFactory factory(fixture.context, filenames);
+		double constructionSeconds = secondsSince(start);
+
+		factory.createEntity("Template0");
+		double firstEntitySeconds = secondsSince(start);
+
+		factory.getTemplateJsonMap();
+		double allParsedSeconds = secondsSince(start);
+
+		std::cout << "EntityFactory with " << threadCount << " threads: construction " << constructionSeconds * 1000.0
+			<< " ms, first entity " << firstEntitySeconds * 1000.0
+			<< " ms, all templates parsed " << allParsedSeconds * 1000.0 << " ms" << std::endl;
+	}
+}
+
+TEST_CASE("EntityFactory creates entities in bulk")
+{
+	EntityFactoryFixture fixture(/* threadCount */ 1);
+	EntityFactory factory(fixture.context, {writeSpawnableTemplate()});
+
+	// Occupy the first generated name
+	fixture.world.addEntity(factory.createEntity("Spawnable"));
+
+	std::vector<EntityFactory::EntityInstance> instances(3);
+	instances[1].name = "Leader";
+	instances[2].position = sim::Vector3(1, 2, 3);
+
+	std::vector<sim::EntityPtr> entities = factory.createEntities("Spawnable", instances);
+	REQUIRE(entities.size() == 3);
+	CHECK(getName(*entities[0]) == "Spawnable2");
+	CHECK(getName(*entities[1]) == "Leader");
+	CHECK(getName(*entities[2]) == "Spawnable3");
+	CHECK(entities[0]->getId() != entities[2]->getId());
+
+	auto node = entities[2]->getFirstComponent<sim::Node>();
+	REQUIRE(node);
+	CHECK(node->getPosition() == sim::Vector3(1, 2, 3));
+
+	CHECK_THROWS(factory.createEntities("Missing", instances));
+}
+
+TEST_CASE("EntityFactory uses component factories replaced after first use")
+{
+	EntityFactoryFixture fixture(/* threadCount */ 1);
+	EntityFactory factory(fixture.context, {writeSpawnableTemplate()});
+	factory.createEntity("Spawnable");
+
+	// Replace a factory under an existing name, as a plugin overriding a built-in factory would
+	ComponentFactoryRegistry& registry = *fixture.context.componentFactoryRegistry;
+	ComponentFactoryPtr originalFactory = registry.at("motion");
+	int createCount = 0;
+	registry.replace("motion", std::make_shared<ComponentFactoryFunctionAdapter>([&] (sim::Entity* entity, const ComponentFactoryContext& context, const nlohmann::json& json) {
+		++createCount;
+		return originalFactory->create(entity, context, json);
+	}));
+
+	factory.createEntity("Spawnable");
+	CHECK(createCount == 1);
+}
+
+TEST_CASE("Benchmark EntityFactory spawn rate", "[.benchmark]")
+{
+	EntityFactoryFixture fixture(/* threadCount */ 1);
+	EntityFactory factory(fixture.context, {writeSpawnableTemplate()});
+
+	const int entityCount = 10000;
+	auto printRate = [&] (const std::string& method, std::chrono::steady_clock::time_point start) {
+		double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		std::cout << method << ": " << entityCount / seconds << " entities per second" << std::endl;
+	};
+
+	{
+		auto start = std::chrono::steady_clock::now();
+		for (int i = 0; i < entityCount; ++i)
+		{
+			factory.createEntityFromJson(factory.getTemplateJson("Spawnable"), "Spawnable", "Entity" + std::to_string(i), math::dvec3Zero(), math::dquatIdentity());
+		}
+		printRate("createEntityFromJson", start);
+	}
+	{
+		auto start = std::chrono::steady_clock::now();
+		for (int i = 0; i < entityCount; ++i)
+		{
+			factory.createEntity("Spawnable", "Entity" + std::to_string(i));
+		}
+		printRate("createEntity", start);
+	}
+	{
+		auto start = std::chrono::steady_clock::now();
+		factory.createEntities("Spawnable", std::vector<EntityFactory::EntityInstance>(entityCount));
+		printRate("createEntities", start);
+	}
+}
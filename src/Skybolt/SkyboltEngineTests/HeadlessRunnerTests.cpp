@@ -0,0 +1,69 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include <catch2/catch.hpp>
+#include <SkyboltEngine/TimeSource.h>
+#include <SkyboltEngine/UpdateLoop/HeadlessRunner.h>
+#include <SkyboltSim/System/System.h>
+
+using namespace skybolt;
+using namespace skybolt::sim;
+
+class StepCountingSystem : public System
+{
+public:
+	void advanceSimTime(SecondsD newTime, SecondsD dt) override
+	{
+		++dynamicsStepCount;
+		simTime = newTime;
+	}
+
+	void advanceWallTime(SecondsD newTime, SecondsD dt) override
+	{
+		wallTime = newTime + dt;
+	}
+
+	int dynamicsStepCount = 0;
+	SecondsD simTime = 0;
+	SecondsD wallTime = 0;
+};
+
+TEST_CASE("Headless run simulates every step to the end of the time range")
+{
+	auto system = std::make_shared<StepCountingSystem>();
+	auto systems = std::make_shared<SystemRegistry>(SystemRegistry({system}));
+	TimeSource timeSource(TimeRange(0, 100));
+
+	HeadlessRunConfig config;
+	config.timeStep = 0.5;
+	HeadlessRunSummary summary = runHeadless(systems, timeSource, config);
+
+	CHECK(summary.updateCount == 200);
+	CHECK(summary.simDuration == Approx(100));
+	CHECK(timeSource.getTime() == 100);
+
+	// No dynamics steps are dropped, regardless of wall clock time
+	constexpr double defaultDynamicsStepSize = 1.0 / 60.0;
+	CHECK(system->dynamicsStepCount == Approx(100 / defaultDynamicsStepSize).margin(1));
+	CHECK(system->simTime == Approx(100).margin(defaultDynamicsStepSize));
+
+	// Wall time follows sim time
+	CHECK(system->wallTime == Approx(100));
+}
+
+TEST_CASE("Headless run is paced to real time multiple")
+{
+	auto systems = std::make_shared<SystemRegistry>();
+	TimeSource timeSource(TimeRange(0, 0.2));
+
+	HeadlessRunConfig config;
+	config.timeStep = 0.01;
+	config.realTimeMultiple = 4.0;
+	HeadlessRunSummary summary = runHeadless(systems, timeSource, config);
+
+	CHECK(summary.simDuration == Approx(0.2));
+	CHECK(summary.wallDuration >= 0.05);
+}
@@ -0,0 +1,273 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include <catch2/catch.hpp>
+#include <SkyboltEngine/Lockstep/LockstepSystem.h>
+#include <SkyboltEngine/Lockstep/UdpLockstepTransport.h>
+#include <SkyboltSim/Entity.h>
+#include <SkyboltSim/World.h>
+#include <SkyboltSim/Components/Motion.h>
+#include <SkyboltSim/Components/Node.h>
+#include <SkyboltSim/System/EntitySystem.h>
+#include <SkyboltSim/System/SimStepper.h>
+
+#include <chrono>
+#include <future>
+#include <iostream>
+
+using namespace skybolt;
+using namespace skybolt::sim;
+
+namespace {
+
+//! Accelerates towards the position of a neighbouring entity, which may be owned by another node
+class NeighbourFollower : public Component
+{
+public:
+	NeighbourFollower(Node* node, Motion* motion, Node* neighbour, int syntheticLoad) :
+		mNode(node), mMotion(motion), mNeighbour(neighbour), mSyntheticLoad(syntheticLoad) {}
+
+	void advanceSimTime(SecondsD newTime, SecondsD dt) override
+	{
+		mDt = dt;
+	}
+
+	SKYBOLT_BEGIN_REGISTER_UPDATE_HANDLERS
+		SKYBOLT_REGISTER_UPDATE_HANDLER(UpdateStage::PreDynamicsSubStep, sampleNeighbour)
+		SKYBOLT_REGISTER_UPDATE_HANDLER(UpdateStage::DynamicsSubStep, integrate)
+	SKYBOLT_END_REGISTER_UPDATE_HANDLERS
+
+private:
+	void sampleNeighbour()
+	{
+		mNeighbourPosition = mNeighbour->getPosition();
+	}
+
+	void integrate()
+	{
+		double damping = 1.0;
+		for (int i = 0; i < mSyntheticLoad; ++i)
+		{
+			damping = std::sqrt(damping + 1e-9 * i) * 0.999999 + 1e-6;
+		}
+
+		mMotion->linearVelocity += (mNeighbourPosition - mNode->getPosition()) * mDt * damping;
+		mNode->setPosition(mNode->getPosition() + mMotion->linearVelocity * mDt);
+	}
+
+private:
+	Node* mNode;
+	Motion* mMotion;
+	Node* mNeighbour;
+	int mSyntheticLoad;
+	Vector3 mNeighbourPosition;
+	SecondsD mDt = 0;
+};
+
+struct NodeState
+{
+	Vector3 position;
+	Vector3 velocity;
+};
+
+//! Runs one node of a lockstep simulation of a ring of entities, each following the next.
+//! @param transport may be null to run the whole simulation without lockstep.
+std::vector<NodeState> runRing(const LockstepTransportPtr& transport, int entityCount, int stepCount, int syntheticLoad = 0, LockstepStats* stats = nullptr)
+{
+	World world;
+	std::vector<std::shared_ptr<Node>> nodes;
+	std::vector<std::shared_ptr<Motion>> motions;
+	std::vector<EntityPtr> entities;
+	for (int i = 0; i < entityCount; ++i)
+	{
+		auto entity = std::make_shared<Entity>(EntityId{1, std::uint32_t(i + 1)});
+		nodes.push_back(std::make_shared<Node>(Vector3(i, i * i % 7, -i)));
+		motions.push_back(std::make_shared<Motion>());
+		entity->addComponent(nodes.back());
+		entity->addComponent(motions.back());
+		entities.push_back(entity);
+	}
+
+	for (int i = 0; i < entityCount; ++i)
+	{
+		Node* neighbour = nodes[(i + 1) % entityCount].get();
+		entities[i]->addComponent(std::make_shared<NeighbourFollower>(nodes[i].get(), motions[i].get(), neighbour, syntheticLoad));
+		world.addEntity(entities[i]);
+	}
+
+	auto systems = std::make_shared<SystemRegistry>();
+	systems->push_back(std::make_shared<EntitySystem>(&world));
+
+	std::shared_ptr<LockstepSystem> lockstep;
+	if (transport)
+	{
+		lockstep = std::make_shared<LockstepSystem>(&world, transport);
+		systems->push_back(lockstep);
+	}
+
+	const double dt = 1.0 / 64.0;
+	SimStepper stepper(systems);
+	stepper.setDynamicsStepSize(dt);
+	for (int i = 0; i < stepCount; ++i)
+	{
+		stepper.update(dt);
+	}
+
+	if (stats && lockstep)
+	{
+		*stats = lockstep->getStats();
+	}
+
+	std::vector<NodeState> result;
+	for (int i = 0; i < entityCount; ++i)
+	{
+		result.push_back({nodes[i]->getPosition(), motions[i]->linearVelocity});
+	}
+	return result;
+}
+
+//! Runs each node on its own thread, as each node would be run by its own process
+std::vector<std::vector<NodeState>> runRingNodes(const std::vector<LockstepTransportPtr>& transports, int entityCount, int stepCount, int syntheticLoad = 0, std::vector<LockstepStats>* stats = nullptr)
+{
+	if (stats)
+	{
+		stats->resize(transports.size());
+	}
+
+	std::vector<std::future<std::vector<NodeState>>> futures;
+	for (size_t i = 0; i < transports.size(); ++i)
+	{
+		LockstepStats* nodeStats = stats ? &(*stats)[i] : nullptr;
+		futures.push_back(std::async(std::launch::async, [=] {
+			return runRing(transports[i], entityCount, stepCount, syntheticLoad, nodeStats);
+		}));
+	}
+
+	std::vector<std::vector<NodeState>> result;
+	for (auto& future : futures)
+	{
+		result.push_back(future.get());
+	}
+	return result;
+}
+
+//! Creates transports on free ports chosen by the OS, so that tests do not depend on particular ports being available
+std::vector<LockstepTransportPtr> createUdpTransports(int nodeCount)
+{
+	std::vector<std::shared_ptr<UdpLockstepTransport>> udpTransports;
+	for (int i = 0; i < nodeCount; ++i)
+	{
+		UdpLockstepTransportConfig config;
+		config.nodeIndex = i;
+		config.nodeEndpoints = std::vector<UdpLockstepEndpoint>(nodeCount, {"127.0.0.1", 0});
+		udpTransports.push_back(std::make_shared<UdpLockstepTransport>(config));
+	}
+
+	// Exchange the chosen ports
+	for (int i = 0; i < nodeCount; ++i)
+	{
+		for (int j = 0; j < nodeCount; ++j)
+		{
+			if (i != j)
+			{
+				udpTransports[i]->setNodeEndpoint(j, {"127.0.0.1", udpTransports[j]->getLocalPort()});
+			}
+		}
+	}
+	return std::vector<LockstepTransportPtr>(udpTransports.begin(), udpTransports.end());
+}
+
+void checkEqual(const std::vector<NodeState>& a, const std::vector<NodeState>& b)
+{
+	REQUIRE(a.size() == b.size());
+	for (size_t i = 0; i < a.size(); ++i)
+	{
+		CHECK(a[i].position == b[i].position);
+		CHECK(a[i].velocity == b[i].velocity);
+	}
+}
+
+} // namespace
+
+TEST_CASE("Lockstep nodes reproduce single node simulation exactly")
+{
+	const int entityCount = 10;
+	const int stepCount = 100;
+	std::vector<NodeState> reference = runRing(nullptr, entityCount, stepCount);
+
+	for (int nodeCount = 1; nodeCount <= 4; ++nodeCount)
+	{
+		std::vector<LockstepStats> stats;
+		auto results = runRingNodes(createLoopbackLockstepTransports(nodeCount), entityCount, stepCount, 0, &stats);
+		for (const auto& result : results)
+		{
+			checkEqual(reference, result);
+		}
+
+		// Every entity moves on every step, so each node receives updates for all the entities it does not own
+		for (int node = 0; node < nodeCount; ++node)
+		{
+			int ownedCount = 0;
+			for (int id = 1; id <= entityCount; ++id)
+			{
+				ownedCount += (id % nodeCount == node);
+			}
+			CHECK(stats[node].step == stepCount);
+			CHECK(stats[node].entityUpdatesReceived == std::uint64_t((entityCount - ownedCount) * stepCount));
+		}
+	}
+}
+
+TEST_CASE("Lockstep nodes exchange state over UDP")
+{
+	const int entityCount = 10;
+	const int stepCount = 20;
+	std::vector<NodeState> reference = runRing(nullptr, entityCount, stepCount);
+
+	auto results = runRingNodes(createUdpTransports(/* nodeCount */ 2), entityCount, stepCount);
+	for (const auto& result : results)
+	{
+		checkEqual(reference, result);
+	}
+}
+
+TEST_CASE("Lockstep transport times out if a node is missing")
+{
+	auto transports = createLoopbackLockstepTransports(2, /* receiveTimeout */ 0.01);
+	std::vector<std::uint8_t> message;
+	CHECK_THROWS(transports[0]->receive(message));
+}
+
+TEST_CASE("Benchmark lockstep scaling", "[.benchmark]")
+{
+	const int entityCount = 2000;
+	const int stepCount = 200;
+	const int syntheticLoad = 500;
+
+	double singleNodeSeconds = 0;
+	for (int nodeCount = 1; nodeCount <= 4; ++nodeCount)
+	{
+		std::vector<LockstepStats> stats;
+		auto start = std::chrono::steady_clock::now();
+		runRingNodes(createUdpTransports(nodeCount), entityCount, stepCount, syntheticLoad, &stats);
+		double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		if (nodeCount == 1)
+		{
+			singleNodeSeconds = seconds;
+		}
+
+		double barrierWaitDuration = 0;
+		std::uint64_t bytesSent = 0;
+		for (const LockstepStats& nodeStats : stats)
+		{
+			barrierWaitDuration = std::max(barrierWaitDuration, nodeStats.barrierWaitDuration);
+			bytesSent += nodeStats.bytesSent;
+		}
+
+		std::cout << nodeCount << " nodes: " << stepCount / seconds << " steps per second, speedup " << singleNodeSeconds / seconds
+			<< ", max barrier wait " << barrierWaitDuration * 1000.0 << " ms, " << bytesSent / stepCount << " bytes sent per step" << std::endl;
+	}
+}
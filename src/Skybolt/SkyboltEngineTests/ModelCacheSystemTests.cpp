@@ -0,0 +1,42 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include <catch2/catch.hpp>
+#include <SkyboltEngine/EngineStats.h>
+#include <SkyboltEngine/ModelCacheSystem.h>
+#include <SkyboltVis/Renderable/Model/ModelCache.h>
+
+using namespace skybolt;
+
+TEST_CASE("Model cache system periodically releases unreferenced models")
+{
+	auto modelCache = std::make_shared<vis::ModelCache>();
+	auto createNode = [] { return osg::ref_ptr<osg::Node>(new osg::Node); };
+	osg::ref_ptr<osg::Node> usedModel = modelCache->getOrLoad("used", createNode);
+	osg::ref_ptr<osg::Node> removedModel = modelCache->getOrLoad("removed", createNode);
+
+	EngineStats stats;
+	const int evictionInterval = 3;
+	ModelCacheSystem system(modelCache, nullptr, &stats, evictionInterval);
+
+	system.updateState();
+	CHECK(stats.cachedModelCount == 2);
+
+	// Simulate removal of the entity using the model
+	removedModel = nullptr;
+
+	// Model is released at the end of the eviction interval
+	system.updateState();
+	CHECK(modelCache->size() == 2);
+	system.updateState();
+	CHECK(modelCache->size() == 1);
+	CHECK(stats.cachedModelCount == 1);
+
+	// Referenced model remains cached
+	int loadCount = 0;
+	modelCache->getOrLoad("used", [&] { ++loadCount; return createNode(); });
+	CHECK(loadCount == 0);
+}
@@ -0,0 +1,44 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include <catch2/catch.hpp>
+#include <SkyboltEngine/Scenario/ScenarioMetadataComponent.h>
+
+using namespace skybolt;
+
+namespace {
+
+struct TestListener : public ScenarioMetadataComponentListener
+{
+	void directoryChanged(ScenarioMetadataComponent* component) override
+	{
+		directories.push_back(component->getDirectory());
+	}
+
+	std::vector<ScenarioObjectPath> directories;
+};
+
+} // namespace
+
+TEST_CASE("ScenarioMetadataComponent notifies listeners when directory changes")
+{
+	ScenarioMetadataComponent component;
+	TestListener listener;
+	component.addListener(&listener);
+
+	component.setDirectory({"Folder", "Subfolder"});
+	REQUIRE(listener.directories.size() == 1);
+	CHECK(listener.directories[0] == ScenarioObjectPath({"Folder", "Subfolder"}));
+
+	// Setting the same directory again does not notify
+	component.setDirectory({"Folder", "Subfolder"});
+	CHECK(listener.directories.size() == 1);
+
+	component.removeListener(&listener);
+	component.setDirectory({"Other"});
+	CHECK(listener.directories.size() == 1);
+	CHECK(component.getDirectory() == ScenarioObjectPath({"Other"}));
+}
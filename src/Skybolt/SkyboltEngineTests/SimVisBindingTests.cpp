@@ -0,0 +1,70 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include <catch2/catch.hpp>
+#include <SkyboltEngine/SimVisBinding/GeocentricToNedConverter.h>
+#include <SkyboltEngine/SimVisBinding/SimVisBinding.h>
+#include <SkyboltSim/Components/Node.h>
+#include <SkyboltSim/Entity.h>
+#include <SkyboltSim/World.h>
+
+using namespace skybolt;
+
+class CountingSimVisBinding : public SimVisBinding
+{
+public:
+	CountingSimVisBinding(bool drivenByEntityTransform) :
+		mDrivenByEntityTransform(drivenByEntityTransform)
+	{
+	}
+
+	void syncVis(const GeocentricToNedConverter& converter) override { ++syncCount; }
+
+	bool isDrivenByEntityTransform() const override { return mDrivenByEntityTransform; }
+
+	int syncCount = 0;
+
+private:
+	bool mDrivenByEntityTransform;
+};
+
+TEST_CASE("Transform driven bindings are only synced when transform changes")
+{
+	sim::World world;
+	auto entity = std::make_shared<sim::Entity>(sim::EntityId{1, 0});
+	auto node = std::make_shared<sim::Node>();
+	entity->addComponent(node);
+
+	auto transformDrivenBinding = std::make_shared<CountingSimVisBinding>(true);
+	auto animatedBinding = std::make_shared<CountingSimVisBinding>(false);
+	auto bindings = std::make_shared<SimVisBindingsComponent>();
+	bindings->bindings = { transformDrivenBinding, animatedBinding };
+	entity->addComponent(bindings);
+	world.addEntity(entity);
+
+	GeocentricToNedConverter converter;
+	converter.setOrigin(sim::Vector3(1, 2, 3), std::nullopt);
+
+	syncVis(world, converter);
+	syncVis(world, converter);
+	CHECK(transformDrivenBinding->syncCount == 1);
+	CHECK(animatedBinding->syncCount == 2);
+
+	node->setPosition(sim::Vector3(4, 5, 6));
+	syncVis(world, converter);
+	CHECK(transformDrivenBinding->syncCount == 2);
+
+	// Setting the same position is not a change
+	node->setPosition(sim::Vector3(4, 5, 6));
+	syncVis(world, converter);
+	CHECK(transformDrivenBinding->syncCount == 2);
+
+	// Moving the origin changes the vis transform of every entity
+	converter.setOrigin(sim::Vector3(7, 8, 9), std::nullopt);
+	syncVis(world, converter);
+	CHECK(transformDrivenBinding->syncCount == 3);
+	CHECK(animatedBinding->syncCount == 5);
+}
@@ -0,0 +1,173 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#define _SILENCE_CXX17_ALLOCATOR_VOID_DEPRECATION_WARNING // Ignore boost/asio warnings
+#include <catch2/catch.hpp>
+#include <SkyboltEngine/Lockstep/UdpLockstepTransport.h>
+
+#ifdef WIN32
+#define _WIN32_WINNT 0x0601 // Boost/asio requires the windows platform target to be set
+#endif
+#include <boost/asio.hpp>
+
+#include <algorithm>
+#include <cstring>
+
+using namespace skybolt;
+using boost::asio::ip::udp;
+
+namespace {
+
+//! Matches the wire format of UdpLockstepTransport fragments
+struct TestFragmentHeader
+{
+	std::uint32_t sender;
+	std::uint32_t messageId;
+	std::uint32_t messageSize;
+	std::uint16_t fragmentIndex;
+	std::uint16_t fragmentCount;
+};
+
+constexpr size_t maxFragmentPayloadSize = 60000;
+
+//! Sends hand crafted fragments to a transport, posing as node 1
+class FragmentSender
+{
+public:
+	FragmentSender(int port) :
+		mSocket(mService, udp::endpoint(udp::v4(), 0)),
+		mEndpoint(boost::asio::ip::make_address("127.0.0.1"), std::uint16_t(port))
+	{
+	}
+
+	void send(std::uint32_t messageId, std::uint32_t messageSize, std::uint16_t fragmentIndex, std::uint16_t fragmentCount, const std::vector<std::uint8_t>& payload)
+	{
+		TestFragmentHeader header{ 1, messageId, messageSize, fragmentIndex, fragmentCount };
+		std::vector<std::uint8_t> datagram(sizeof(header) + payload.size());
+		std::memcpy(datagram.data(), &header, sizeof(header));
+		std::memcpy(datagram.data() + sizeof(header), payload.data(), payload.size());
+		mSocket.send_to(boost::asio::buffer(datagram), mEndpoint);
+	}
+
+	//! Sends the fragment of a message containing a single repeated byte value
+	void sendFragment(std::uint32_t messageId, std::uint32_t messageSize, std::uint16_t fragmentIndex, std::uint8_t value)
+	{
+		std::uint16_t fragmentCount = std::uint16_t(std::max<size_t>(1, (messageSize + maxFragmentPayloadSize - 1) / maxFragmentPayloadSize));
+		size_t payloadSize = std::min(maxFragmentPayloadSize, messageSize - fragmentIndex * maxFragmentPayloadSize);
+		send(messageId, messageSize, fragmentIndex, fragmentCount, std::vector<std::uint8_t>(payloadSize, value));
+	}
+
+private:
+	boost::asio::io_service mService;
+	udp::socket mSocket;
+	udp::endpoint mEndpoint;
+};
+
+std::unique_ptr<UdpLockstepTransport> createReceiver()
+{
+	UdpLockstepTransportConfig config;
+	config.nodeIndex = 0;
+	config.nodeEndpoints = std::vector<UdpLockstepEndpoint>(2, {"127.0.0.1", 0});
+	config.receiveTimeout = 0.1;
+	return std::make_unique<UdpLockstepTransport>(config);
+}
+
+bool allEqual(const std::vector<std::uint8_t>& message, std::uint8_t value)
+{
+	return std::all_of(message.begin(), message.end(), [value] (std::uint8_t v) { return v == value; });
+}
+
+} // namespace
+
+TEST_CASE("UDP lockstep transport binds to a free port")
+{
+	auto transport = createReceiver();
+	CHECK(transport->getLocalPort() != 0);
+}
+
+TEST_CASE("UDP lockstep transport reassembles fragmented messages")
+{
+	auto transport = createReceiver();
+	FragmentSender sender(transport->getLocalPort());
+
+	const std::uint32_t messageSize = std::uint32_t(maxFragmentPayloadSize + 10);
+	sender.sendFragment(0, messageSize, 1, 7);
+	sender.sendFragment(0, messageSize, 0, 7);
+
+	std::vector<std::uint8_t> message;
+	CHECK(transport->receive(message) == 1);
+	CHECK(message.size() == messageSize);
+	CHECK(allEqual(message, 7));
+}
+
+TEST_CASE("UDP lockstep transport ignores invalid fragments")
+{
+	auto transport = createReceiver();
+	FragmentSender sender(transport->getLocalPort());
+	std::vector<std::uint8_t> message;
+
+	const std::uint32_t messageSize = std::uint32_t(maxFragmentPayloadSize + 10);
+
+	SECTION("Fragment index out of range")
+	{
+		sender.send(0, 10, 1, 1, std::vector<std::uint8_t>(10, 1));
+		CHECK_THROWS(transport->receive(message));
+	}
+
+	SECTION("Fragment count inconsistent with message size")
+	{
+		sender.send(0, 10, 0, 2, std::vector<std::uint8_t>(10, 1));
+		sender.send(0, 10, 1, 2, std::vector<std::uint8_t>(0));
+		CHECK_THROWS(transport->receive(message));
+	}
+
+	SECTION("Duplicate fragments do not complete a message with gaps")
+	{
+		sender.sendFragment(0, messageSize, 0, 1);
+		sender.sendFragment(0, messageSize, 0, 1);
+		CHECK_THROWS(transport->receive(message));
+
+		sender.sendFragment(0, messageSize, 1, 1);
+		CHECK(transport->receive(message) == 1);
+		CHECK(allEqual(message, 1));
+	}
+
+	SECTION("Fragments which disagree with earlier fragments of the same message")
+	{
+		sender.sendFragment(0, messageSize, 0, 1);
+		sender.sendFragment(0, messageSize + 1, 1, 2);
+		CHECK_THROWS(transport->receive(message));
+
+		sender.sendFragment(0, messageSize, 1, 1);
+		CHECK(transport->receive(message) == 1);
+		CHECK(message.size() == messageSize);
+		CHECK(allEqual(message, 1));
+	}
+}
+
+TEST_CASE("UDP lockstep transport drops messages older than the last completed message from the sender")
+{
+	auto transport = createReceiver();
+	FragmentSender sender(transport->getLocalPort());
+	std::vector<std::uint8_t> message;
+
+	// Message 0 loses its second fragment, then message 1 arrives complete
+	const std::uint32_t messageSize = std::uint32_t(maxFragmentPayloadSize + 10);
+	sender.sendFragment(0, messageSize, 0, 1);
+	sender.sendFragment(1, 10, 0, 2);
+	CHECK(transport->receive(message) == 1);
+	CHECK(allEqual(message, 2));
+
+	// The late fragment of message 0 and a repeat of message 1 are both ignored
+	sender.sendFragment(0, messageSize, 1, 1);
+	sender.sendFragment(1, 10, 0, 2);
+	CHECK_THROWS(transport->receive(message));
+
+	// Later messages are still received
+	sender.sendFragment(2, 10, 0, 3);
+	CHECK(transport->receive(message) == 1);
+	CHECK(allEqual(message, 3));
+}
@@ -0,0 +1,173 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include <catch2/catch.hpp>
+#include <SkyboltEngine/UpdateLoop/UpdateLoopUtility.h>
+#include <SkyboltSim/System/SimStepper.h>
+#include <SkyboltSim/System/System.h>
+
+#include <chrono>
+#include <iostream>
+#include <stdexcept>
+
+using namespace skybolt;
+using namespace skybolt::sim;
+
+static void busyWait(double seconds)
+{
+	auto end = std::chrono::steady_clock::now() + std::chrono::duration<double>(seconds);
+	while (std::chrono::steady_clock::now() < end) {}
+}
+
+class TestSystem : public System
+{
+public:
+	void advanceSimTime(SecondsD newTime, SecondsD dt) override
+	{
+		if (throwInDynamics && dynamicsStepCount >= dynamicsStepsBeforeThrow)
+		{
+			throw std::runtime_error("Test error");
+		}
+		busyWait(dynamicsCost);
+		++dynamicsStepCount;
+	}
+
+	void update(UpdateStage stage) override
+	{
+		if (stage == UpdateStage::Output)
+		{
+			publishedFrame = ++outputCount;
+		}
+	}
+
+	double dynamicsCost = 0;
+	bool throwInDynamics = false;
+	int dynamicsStepsBeforeThrow = 0;
+	int dynamicsStepCount = 0;
+	int outputCount = 0;
+	int publishedFrame = 0; //!< Represents state written to vis at the Output stage
+};
+
+struct TestLoop
+{
+	TestLoop()
+	{
+		systems->push_back(system);
+
+		// Perform exactly one dynamics step per frame
+		stepper.setDynamicsStepSize(0.0001);
+		stepper.setMaxDynamicsSubsteps(1);
+
+		config.minFrameDuration = 0.001f;
+	}
+
+	//! @returns frames seen by the renderer
+	std::vector<int> run(int frameCount, double renderCost = 0)
+	{
+		std::vector<int> renderedFrames;
+		runSimRenderLoop(stepper, *systems, [&] {
+			busyWait(renderCost);
+			if (throwInRender)
+			{
+				throw std::logic_error("Render error");
+			}
+			renderedFrames.push_back(system->publishedFrame);
+			return true;
+		}, [&] { return int(renderedFrames.size()) >= frameCount; }, [] { return false; }, config);
+		return renderedFrames;
+	}
+
+	std::shared_ptr<TestSystem> system = std::make_shared<TestSystem>();
+	SystemRegistryPtr systems = std::make_shared<SystemRegistry>();
+	SimStepper stepper{systems};
+	MainLoopConfig config;
+	bool throwInRender = false;
+};
+
+TEST_CASE("Sequential and pipelined loops render each published frame once in order")
+{
+	bool pipelined = GENERATE(false, true);
+
+	TestLoop loop;
+	loop.config.pipelined = pipelined;
+	std::vector<int> renderedFrames = loop.run(5);
+
+	CHECK(renderedFrames == std::vector<int>({1, 2, 3, 4, 5}));
+
+	// Pipelined loop updates the frame after the last rendered frame
+	int expectedUpdateCount = pipelined ? 6 : 5;
+	CHECK(loop.system->outputCount == expectedUpdateCount);
+	CHECK(loop.system->dynamicsStepCount == expectedUpdateCount);
+}
+
+TEST_CASE("Pipelined loop propagates exceptions thrown during dynamics")
+{
+	TestLoop loop;
+	loop.config.pipelined = true;
+	loop.system->throwInDynamics = true;
+
+	CHECK_THROWS_AS(loop.run(5), std::runtime_error);
+}
+
+TEST_CASE("Pipelined loop propagates render exception when dynamics also throws")
+{
+	TestLoop loop;
+	loop.config.pipelined = true;
+	loop.system->throwInDynamics = true;
+	loop.system->dynamicsStepsBeforeThrow = 1; // Throw in the dynamics running concurrently with the first render
+	loop.throwInRender = true;
+
+	CHECK_THROWS_AS(loop.run(5), std::logic_error);
+}
+
+TEST_CASE("UpdateLoop frame duration is a whole number of display refresh intervals")
+{
+	CHECK(UpdateLoop(0.01f).getTargetFrameDuration() == Approx(0.01));
+	CHECK(UpdateLoop(0.01f, 60.0).getTargetFrameDuration() == Approx(1.0 / 60.0));
+	CHECK(UpdateLoop(1.f / 60.f, 60.0).getTargetFrameDuration() == Approx(1.0 / 60.0));
+	CHECK(UpdateLoop(0.02f, 60.0).getTargetFrameDuration() == Approx(2.0 / 60.0));
+}
+
+TEST_CASE("UpdateLoop paces frames to the minimum frame duration")
+{
+	const float minFrameDuration = 0.01f;
+	UpdateLoop loop(minFrameDuration);
+
+	std::vector<float> frameDurations;
+	const int frameCount = 20;
+	loop.exec([&](float dt) {
+		frameDurations.push_back(dt);
+		return int(frameDurations.size()) < frameCount;
+	}, UpdateLoop::neverExit);
+
+	REQUIRE(frameDurations.size() == frameCount);
+	for (float dt : frameDurations)
+	{
+		CHECK(dt >= minFrameDuration * 0.99f);
+	}
+}
+
+TEST_CASE("Benchmark sequential and pipelined loops with loaded sim and render", "[.benchmark]")
+{
+	const int frameCount = 100;
+	const double dynamicsCost = 0.005;
+	const double renderCost = 0.005;
+
+	for (bool pipelined : {false, true})
+	{
+		TestLoop loop;
+		loop.config.pipelined = pipelined;
+		loop.system->dynamicsCost = dynamicsCost;
+
+		auto start = std::chrono::steady_clock::now();
+		loop.run(frameCount, renderCost);
+		double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+		std::cout << (pipelined ? "Pipelined" : "Sequential") << " loop: "
+			<< seconds * 1000.0 / frameCount << " ms per frame, "
+			<< frameCount / seconds << " frames per second" << std::endl;
+	}
+}
@@ -188,7 +188,7 @@ static void registerComponent(EngineRoot& engineRoot, const py::handle& pyClass)
 	});
 
 	std::string componentClassName = py::str(pyClass.attr("__name__"));
-	mComponentFactoryRegistry->insert(std::make_pair(componentClassName, factory));
+	mComponentFactoryRegistry->add(componentClassName, factory);
 }
 
 PYBIND11_MAKE_OPAQUE(std::vector<std::string>);
@@ -298,7 +298,7 @@ PYBIND11_MODULE(skybolt, m) {
 	py::class_<ScenarioMetadataComponent, std::shared_ptr<ScenarioMetadataComponent>, Component>(m, "ScenarioMetadataComponent")
 		.def_readwrite("serializable", &ScenarioMetadataComponent::serializable)
 		.def_readwrite("deletable", &ScenarioMetadataComponent::deletable)
-		.def_readwrite("directory", &ScenarioMetadataComponent::directory);
+		.def_property("directory", &ScenarioMetadataComponent::getDirectory, &ScenarioMetadataComponent::setDirectory);
 
 	py::class_<TemplateNameComponent, std::shared_ptr<TemplateNameComponent>, Component>(m, "TemplateNameComponent", "A component storing the name of the template which an `Entity` instantiates")
 		.def_readonly("name", &TemplateNameComponent::name);
@@ -350,9 +350,17 @@ PYBIND11_MODULE(skybolt, m) {
 		.def("removeAllEntities", &World::removeAllEntities)
 		.def("findObjectByName", &World::findObjectByName);
 
+	py::class_<EntityFactory::EntityInstance>(m, "EntityInstance", "Name and pose of an entity to create with `EntityFactory.createEntities`")
+		.def(py::init())
+		.def_readwrite("name", &EntityFactory::EntityInstance::name)
+		.def_readwrite("position", &EntityFactory::EntityInstance::position)
+		.def_readwrite("orientation", &EntityFactory::EntityInstance::orientation)
+		.def_readwrite("id", &EntityFactory::EntityInstance::id);
+
 	py::class_<EntityFactory>(m, "EntityFactory", "Class responsible for creating `Entity` instances based on a template name")
 		.def("createEntity", &EntityFactory::createEntity, py::return_value_policy::reference,
-			py::arg("templateName"), py::arg("name") = "", py::arg("position") = math::dvec3Zero(), py::arg("orientation") = math::dquatIdentity(), py::arg("id") = sim::nullEntityId());
+			py::arg("templateName"), py::arg("name") = "", py::arg("position") = math::dvec3Zero(), py::arg("orientation") = math::dquatIdentity(), py::arg("id") = sim::nullEntityId())
+		.def("createEntities", &EntityFactory::createEntities, py::arg("templateName"), py::arg("instances"));
 
 	py::class_<Scenario>(m, "Scenario")
 		.def_readwrite("startJulianDate", &Scenario::startJulianDate)
@@ -0,0 +1,51 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "RenderRequestEventFilter.h"
+
+#include <QEvent>
+#include <QMouseEvent>
+
+#include <assert.h>
+
+RenderRequestEventFilter::RenderRequestEventFilter(std::function<void()> requestRender, QObject* parent) :
+	QObject(parent),
+	mRequestRender(std::move(requestRender))
+{
+	assert(mRequestRender);
+}
+
+bool RenderRequestEventFilter::eventFilter(QObject* object, QEvent* event)
+{
+	switch (event->type())
+	{
+	case QEvent::MouseMove:
+		// Hovering does not change the scene, but dragging may
+		if (static_cast<QMouseEvent*>(event)->buttons() != Qt::NoButton)
+		{
+			mRequestRender();
+		}
+		break;
+	case QEvent::MouseButtonPress:
+	case QEvent::MouseButtonRelease:
+	case QEvent::MouseButtonDblClick:
+	case QEvent::Wheel:
+	case QEvent::KeyPress:
+	case QEvent::KeyRelease:
+	case QEvent::TouchBegin:
+	case QEvent::TouchUpdate:
+	case QEvent::TouchEnd:
+	case QEvent::Resize:
+	case QEvent::Expose:
+	case QEvent::Show:
+	case QEvent::WindowStateChange:
+		mRequestRender();
+		break;
+	default:
+		break;
+	}
+	return QObject::eventFilter(object, event);
+}
@@ -0,0 +1,23 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#pragma once
+
+#include <QObject>
+#include <functional>
+
+//! Calls a render request function on events which may change what a viewport shows,
+//! such as user input, window resizes and exposure. Install on the QApplication to observe all windows.
+class RenderRequestEventFilter : public QObject
+{
+public:
+	RenderRequestEventFilter(std::function<void()> requestRender, QObject* parent = nullptr);
+
+	bool eventFilter(QObject* object, QEvent* event) override;
+
+private:
+	std::function<void()> mRequestRender;
+};
@@ -0,0 +1,139 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "RenderScheduler.h"
+#include <SkyboltCommon/Json/JsonHelpers.h>
+#include <SkyboltEngine/EngineRoot.h>
+#include <SkyboltEngine/SimVisBinding/GeocentricToNedConverter.h>
+#include <SkyboltEngine/SimVisBinding/SimVisSystem.h>
+#include <SkyboltSim/World.h>
+#include <SkyboltSim/Components/Node.h>
+#include <SkyboltSim/System/SystemRegistry.h>
+
+#include <algorithm>
+#include <cstring>
+
+using namespace skybolt;
+using namespace skybolt::sim;
+
+RenderSchedulerConfig getRenderSchedulerConfig(const nlohmann::json& engineSettings)
+{
+	RenderSchedulerConfig config;
+
+	auto i = engineSettings.find("mainLoop");
+	if (i != engineSettings.end())
+	{
+		config.renderOnDemand = readOptionalOrDefault<bool>(i.value(), "renderOnDemand", config.renderOnDemand);
+		if (auto interval = readOptional<double>(i.value(), "maxFrameInterval"); interval)
+		{
+			config.maxFrameInterval = (*interval > 0) ? interval : std::nullopt;
+		}
+	}
+	return config;
+}
+
+RenderScheduler::RenderScheduler(const RenderSchedulerConfig& config) :
+	mConfig(config)
+{
+}
+
+bool RenderScheduler::shouldRender(SecondsD wallTime, uint64_t stateVersion, bool loading)
+{
+	// Render one more frame after loading finishes so that the last loaded content appears
+	bool render = !mConfig.renderOnDemand
+		|| mRenderRequested
+		|| loading
+		|| mWasLoading
+		|| mLastStateVersion != stateVersion
+		|| (mConfig.maxFrameInterval && wallTime - mLastRenderTime >= *mConfig.maxFrameInterval);
+
+	mWasLoading = loading;
+
+	if (render)
+	{
+		mRenderRequested = false;
+		mLastStateVersion = stateVersion;
+		mLastRenderTime = wallTime;
+		++mStats.renderedFrameCount;
+		++mIntervalFrameCount;
+	}
+	else
+	{
+		++mStats.skippedFrameCount;
+	}
+	return render;
+}
+
+void RenderScheduler::addBusyTime(SecondsD wallTime, SecondsD duration)
+{
+	mIntervalBusyTime += duration;
+	updateStats(wallTime);
+}
+
+void RenderScheduler::updateStats(SecondsD wallTime)
+{
+	if (!mStatsIntervalStartTime)
+	{
+		// Start measuring from the end of the first update
+		mStatsIntervalStartTime = wallTime;
+		mIntervalFrameCount = 0;
+		mIntervalBusyTime = 0;
+		return;
+	}
+
+	SecondsD elapsed = wallTime - *mStatsIntervalStartTime;
+	if (elapsed >= mConfig.statsInterval && elapsed > 0)
+	{
+		mStats.renderedFramesPerSecond = double(mIntervalFrameCount) / elapsed;
+		mStats.busyFraction = std::min(1.0, mIntervalBusyTime / elapsed);
+
+		mStatsIntervalStartTime = wallTime;
+		mIntervalFrameCount = 0;
+		mIntervalBusyTime = 0;
+	}
+}
+
+static void combineVersion(uint64_t& version, uint64_t value)
+{
+	version = (version ^ value) * 1099511628211ull; // FNV-1a prime
+}
+
+uint64_t calcWorldTransformVersion(const World& world)
+{
+	uint64_t version = world.getEntities().size();
+	for (const EntityPtr& entity : world.getEntities())
+	{
+		if (auto node = entity->getFirstComponent<Node>(); node)
+		{
+			const EntityId& id = entity->getId();
+			combineVersion(version, (uint64_t(id.applicationId) << 32) | id.entityId);
+			combineVersion(version, node->getTransformVersion());
+		}
+	}
+	return version;
+}
+
+uint64_t calcSceneStateVersion(const EngineRoot& engineRoot)
+{
+	uint64_t version = calcWorldTransformVersion(engineRoot.scenario->world);
+
+	// Time affects state without an entity transform, such as the sun position
+	double time = engineRoot.scenario->timeSource.getTime();
+	uint64_t timeBits;
+	std::memcpy(&timeBits, &time, sizeof(timeBits));
+	combineVersion(version, timeBits);
+
+	if (auto simVisSystem = findSystem<SimVisSystem>(*engineRoot.systemRegistry); simVisSystem)
+	{
+		combineVersion(version, simVisSystem->getCoordinateConverter().getVersion());
+	}
+	return version;
+}
+
+bool isSceneLoading(const EngineRoot& engineRoot)
+{
+	return engineRoot.stats.terrainTileLoadQueueSize > 0 || engineRoot.stats.featureTileLoadQueueSize > 0;
+}
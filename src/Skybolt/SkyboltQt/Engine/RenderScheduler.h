@@ -0,0 +1,84 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#pragma once
+
+#include <SkyboltEngine/SkyboltEngineFwd.h>
+#include <SkyboltSim/Chrono.h>
+#include <SkyboltSim/SkyboltSimFwd.h>
+
+#include <nlohmann/json.hpp>
+#include <optional>
+
+struct RenderSchedulerConfig
+{
+	//! If true, frames are only rendered when the state version changes, a render is requested or content is loading.
+	//! Otherwise a frame is rendered on every update.
+	bool renderOnDemand = false;
+
+	//! Maximum seconds between frames in render-on-demand mode.
+	//! Picks up changes which are neither versioned nor requested, such as vis state modified directly by scripts.
+	std::optional<skybolt::sim::SecondsD> maxFrameInterval = 1.0;
+
+	//! Seconds of wall time over which the rate stats are measured
+	skybolt::sim::SecondsD statsInterval = 1.0;
+};
+
+//! Reads the "renderOnDemand" and "maxFrameInterval" values of the engine settings' "mainLoop" object
+RenderSchedulerConfig getRenderSchedulerConfig(const nlohmann::json& engineSettings);
+
+struct RenderSchedulerStats
+{
+	int64_t renderedFrameCount = 0;
+	int64_t skippedFrameCount = 0;
+	double renderedFramesPerSecond = 0; //!< Over the last stats interval
+	double busyFraction = 0; //!< Fraction of wall time spent updating and rendering over the last stats interval. The remainder is idle.
+};
+
+//! Decides whether each update of an interactive application should render a frame
+class RenderScheduler
+{
+public:
+	RenderScheduler(const RenderSchedulerConfig& config = {});
+
+	//! Requests a frame on the next update, e.g. in response to user input or a viewport resize
+	void requestRender() { mRenderRequested = true; }
+
+	//! @param wallTime is the current wall clock time in seconds
+	//! @param stateVersion is a value which changes whenever state affecting the rendered image changes
+	//! @param loading is true while content is loading, in which case frames are rendered so that the content appears
+	//! @returns true if a frame should be rendered
+	bool shouldRender(skybolt::sim::SecondsD wallTime, uint64_t stateVersion, bool loading);
+
+	//! Records wall time spent on one update, including any rendering
+	void addBusyTime(skybolt::sim::SecondsD wallTime, skybolt::sim::SecondsD duration);
+
+	const RenderSchedulerStats& getStats() const { return mStats; }
+
+private:
+	void updateStats(skybolt::sim::SecondsD wallTime);
+
+private:
+	const RenderSchedulerConfig mConfig;
+	bool mRenderRequested = true;
+	bool mWasLoading = false;
+	std::optional<uint64_t> mLastStateVersion;
+	skybolt::sim::SecondsD mLastRenderTime = 0;
+
+	RenderSchedulerStats mStats;
+	std::optional<skybolt::sim::SecondsD> mStatsIntervalStartTime;
+	int64_t mIntervalFrameCount = 0;
+	skybolt::sim::SecondsD mIntervalBusyTime = 0;
+};
+
+//! @returns a value which changes when entities are added or removed, or an entity's transform changes
+uint64_t calcWorldTransformVersion(const skybolt::sim::World& world);
+
+//! @returns a value which changes when the scenario time, entity transforms or scene origin change
+uint64_t calcSceneStateVersion(const skybolt::EngineRoot& engineRoot);
+
+//! @returns true if any terrain or feature tiles are loading
+bool isSceneLoading(const skybolt::EngineRoot& engineRoot);
@@ -6,6 +6,7 @@
 
 #include "SimUpdater.h"
 #include <SkyboltEngine/EngineRoot.h>
+#include <SkyboltEngine/UpdateLoop/WorkerThread.h>
 #include <SkyboltSim/System/SimStepper.h>
 
 using namespace skybolt;
@@ -23,10 +24,23 @@ SimUpdater::SimUpdater(const std::shared_ptr<skybolt::EngineRoot>& engineRoot) :
 
 SimUpdater::~SimUpdater() = default;
 
-void SimUpdater::update(SecondsD wallDt)
+void SimUpdater::setPipelined(bool pipelined)
+{
+	if (pipelined && !mWorker)
+	{
+		mWorker = std::make_unique<WorkerThread>("Dynamics");
+	}
+	else if (!pipelined)
+	{
+		mWorker.reset();
+	}
+}
+
+void SimUpdater::update(SecondsD wallDt, const std::function<void()>& render)
 {
 	if (wallDt <= 0)
 	{
+		render();
 		return;
 	}
 
@@ -56,7 +70,7 @@ void SimUpdater::update(SecondsD wallDt)
 	}
 
 	// Advance time
-	simulate(timeSource, simDt);
+	simulate(timeSource, simDt, render);
 
 	for (const SystemPtr& system : *mEngineRoot->systemRegistry)
 	{
@@ -64,13 +78,41 @@ void SimUpdater::update(SecondsD wallDt)
 	}
 
 	mWallTime += wallDt;
+
+	if (!mWorker)
+	{
+		render();
+	}
 }
 
-void SimUpdater::simulate(TimeSource& timeSource, float dt)
+void SimUpdater::simulate(TimeSource& timeSource, float dt, const std::function<void()>& render)
 {
 	SecondsD prevSimTime = timeSource.getTime();
 	timeSource.advanceTime(dt);
 	
 	double dtSim = std::max(0.0, timeSource.getTime() - prevSimTime);
-	mSimStepper->update(dtSim);
+	if (!mWorker)
+	{
+		mSimStepper->update(dtSim);
+		return;
+	}
+
+	// The vis state rendered here was published by the Output stage of the previous update
+	mSimStepper->beginUpdate();
+	mWorker->start([this, dtSim] {
+		mSimStepper->updateDynamics(dtSim);
+	});
+
+	try
+	{
+		render();
+	}
+	catch (...)
+	{
+		// Don't let the worker outlive the render's view of the state
+		mWorker->wait();
+		throw;
+	}
+	mWorker->wait();
+	mSimStepper->endUpdate();
 }
@@ -11,13 +11,20 @@
 #include <SkyboltSim/SkyboltSimFwd.h>
 #include <SkyboltSim/Chrono.h>
 
+#include <functional>
+
+namespace skybolt { class WorkerThread; }
+
 class SimUpdater
 {
 public:
 	SimUpdater(const std::shared_ptr<skybolt::EngineRoot>& engineRoot);
 	~SimUpdater();
 
-	void update(skybolt::sim::SecondsD wallDt);
+	//! @param render is called once per update, when the vis state published by the previous update
+	//! may be rendered. In pipelined mode it runs while the dynamics of this update run on the worker thread,
+	//! otherwise it runs after the update.
+	void update(skybolt::sim::SecondsD wallDt, const std::function<void()>& render = [] {});
 
 	double getRequestedTimeRate() const { return mRequestedTimeRate; }
 	void setRequestedTimeRate(double rate) { mRequestedTimeRate = rate; }
@@ -26,12 +33,19 @@ public:
 
 	void setMaxSimTimeStep(double dt) { mMaxSimDt = dt; }
 
+	//! If true, the simulation dynamics run on a worker thread while the previous update is rendered.
+	//! Time advancement, input and vis sync stay on the calling thread, so the dynamics never run while the
+	//! Qt event loop handles events which may access the simulation.
+	void setPipelined(bool pipelined);
+	bool isPipelined() const { return mWorker != nullptr; }
+
 protected:
-	void simulate(skybolt::TimeSource& timeSource, float dt);
+	void simulate(skybolt::TimeSource& timeSource, float dt, const std::function<void()>& render);
 
 	std::shared_ptr<skybolt::EngineRoot> mEngineRoot;
 	std::unique_ptr<skybolt::sim::SimStepper> mSimStepper;
 	std::unique_ptr<skybolt::UniformAveragedBuffer> mAverageWallDt;
+	std::unique_ptr<skybolt::WorkerThread> mWorker; //!< Set in pipelined mode
 	double mMaxSimDt = 10;
 
 	skybolt::sim::SecondsD mWallTime = 0;
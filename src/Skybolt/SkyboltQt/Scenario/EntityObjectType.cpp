@@ -68,34 +68,48 @@ private:
 EntityObject::EntityObject(EntityObjectRegistry* registry, sim::World* world, const sim::Entity& entity) :
 	ScenarioObjectT<skybolt::sim::EntityId>(sim::getName(entity), getSkyboltIcon(SkyboltIcon::Node), entity.getId()),
 	mRegistry(registry),
-	mWorld(world)
+	mWorld(world),
+	mMetadata(entity.getFirstComponent<ScenarioMetadataComponent>())
 {
 	assert(mRegistry);
 	assert(mWorld);
+
+	if (mMetadata)
+	{
+		mMetadata->addListener(this);
+	}
 }
 
-const ScenarioObjectPath& EntityObject::getDirectory() const
+EntityObject::~EntityObject()
 {
-	if (sim::Entity* entity = mWorld->getEntityById(data).get(); entity)
+	if (mMetadata)
 	{
-		if (auto component = entity->getFirstComponent<ScenarioMetadataComponent>().get(); component)
-		{
-			return component->directory;
-		}
+		mMetadata->removeListener(this);
 	}
-	return mDirectory;
+}
+
+const ScenarioObjectPath& EntityObject::getDirectory() const
+{
+	return mMetadata ? mMetadata->getDirectory() : mDirectory;
 }
 
 void EntityObject::setDirectory(const ScenarioObjectPath& path)
 {
-	if (sim::Entity* entity = mWorld->getEntityById(data).get(); entity)
+	if (mMetadata)
 	{
-		if (auto component = entity->getFirstComponent<ScenarioMetadataComponent>().get(); component)
-		{
-			component->directory = path;
-		}
+		// Notifies the registry through directoryChanged()
+		mMetadata->setDirectory(path);
 	}
-	mDirectory = path;
+	else if (path != mDirectory)
+	{
+		mDirectory = path;
+		mRegistry->notifyItemChanged(this);
+	}
+}
+
+void EntityObject::directoryChanged(ScenarioMetadataComponent* component)
+{
+	mRegistry->notifyItemChanged(this);
 }
 
 std::optional<skybolt::sim::Vector3> EntityObject::getWorldPosition() const
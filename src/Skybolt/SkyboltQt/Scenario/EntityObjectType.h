@@ -10,13 +10,16 @@
 #include <SkyboltSim/EntityId.h>
 #include <SkyboltSim/SkyboltSimFwd.h>
 #include <SkyboltEngine/SkyboltEngineFwd.h>
+#include <SkyboltEngine/Scenario/ScenarioMetadataComponent.h>
 
 class EntityObjectRegistry;
 
-class EntityObject : public ScenarioObjectT<skybolt::sim::EntityId>
+//! Notifies the registry when the entity's scenario directory changes, so that views can update without polling
+class EntityObject : public ScenarioObjectT<skybolt::sim::EntityId>, public skybolt::ScenarioMetadataComponentListener
 {
 public:
 	EntityObject(EntityObjectRegistry* registry, skybolt::sim::World* world, const skybolt::sim::Entity& entity);
+	~EntityObject() override;
 	
 	const skybolt::ScenarioObjectPath& getDirectory() const override;
 	void setDirectory(const skybolt::ScenarioObjectPath& path) override;
@@ -26,9 +29,13 @@ public:
 
 	std::optional<skybolt::sim::Vector3> intersectRay(const skybolt::sim::Vector3& origin, const skybolt::sim::Vector3& dir, const glm::dmat4& viewProjTransform) const override;
 
+private:
+	void directoryChanged(skybolt::ScenarioMetadataComponent* component) override;
+
 private:
 	EntityObjectRegistry* mRegistry;
 	skybolt::sim::World* mWorld;
+	std::shared_ptr<skybolt::ScenarioMetadataComponent> mMetadata; //!< May be null
 };
 
 using EntityObjectFactory = std::function<EntityObjectPtr(EntityObjectRegistry* registry, skybolt::sim::World* world, const skybolt::sim::Entity& entity)>;
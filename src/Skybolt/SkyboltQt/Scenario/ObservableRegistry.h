@@ -21,6 +21,7 @@ struct RegistryListener
 	virtual void itemAdded(const std::shared_ptr<T>& item) {};
 	virtual void itemAboutToBeRemoved(const std::shared_ptr<T>& item) {};
 	virtual void itemRemoved(const std::string& name) {}
+	virtual void itemChanged(const std::shared_ptr<T>& item) {} //!< Called when properties of an item, such as its directory, have changed
 };
 
 template <typename T>
@@ -50,6 +51,17 @@ public:
 		CALL_LISTENERS(itemRemoved(name));
 	}
 
+	void notifyItemChanged(const T* item)
+	{
+		auto it = std::find_if(mItems.begin(), mItems.end(),
+			[item](const ItemPtr& i) { return i.get() == item; });
+
+		if (it != mItems.end())
+		{
+			CALL_LISTENERS(itemChanged(*it));
+		}
+	}
+
 	void clear()
 	{
 		std::vector<std::string> names;
@@ -7,7 +7,6 @@
 #include "ScenarioTreeWidget.h"
 #include "TreeItemModel.h"
 #include "Icon/SkyboltIcons.h"
-#include "QtUtil/QtTimerUtil.h"
 #include "Scenario/EntityObjectType.h"
 #include "Scenario/ObservableRegistry.h"
 #include "Scenario/ScenarioObject.h"
@@ -18,6 +17,7 @@
 
 #include <QLayout>
 #include <QMenu>
+#include <QTimer>
 #include <QTreeView>
 
 using namespace skybolt;
@@ -31,6 +31,18 @@ struct ScenarioObjectTreeItem : public SimpleTreeItem
 	{}
 
 	ScenarioObjectPtr object;
+	ScenarioObjectPath directory; //!< Directory of the folder containing the item
+};
+
+struct ScenarioObjectRegistryListener : public RegistryListener<ScenarioObject>
+{
+	ScenarioObjectRegistryListener(ScenarioTreeWidget* widget) : widget(widget) {}
+
+	void itemAdded(const ScenarioObjectPtr& item) override { widget->objectAdded(item); }
+	void itemAboutToBeRemoved(const ScenarioObjectPtr& item) override { widget->objectRemoved(item); }
+	void itemChanged(const ScenarioObjectPtr& item) override { widget->objectChanged(item); }
+
+	ScenarioTreeWidget* widget;
 };
 
 ScenarioTreeWidget::ScenarioTreeWidget(const ScenarioTreeWidgetConfig& config) :
@@ -43,6 +55,7 @@ ScenarioTreeWidget::ScenarioTreeWidget(const ScenarioTreeWidgetConfig& config) :
 	mRootItem = std::make_shared<SimpleTreeItem>("", getSkyboltIcon(SkyboltIcon::Folder));
 	mModel = new TreeItemModel(mRootItem, this);
 	mView = new QTreeView(this);
+	mView->setUniformRowHeights(true); // Allows the view to lay out large numbers of rows without measuring each one
 	mView->setModel(mModel);
 	mView->setContextMenuPolicy(Qt::CustomContextMenu);
 	mView->setSelectionMode(QAbstractItemView::ExtendedSelection);
@@ -87,83 +100,156 @@ ScenarioTreeWidget::ScenarioTreeWidget(const ScenarioTreeWidgetConfig& config) :
 		selectionModel->setSelectedItems(objects);
 	});
 
-	addOrRemoveObjects();
-	updateTreeItemParents();
-
-	mView->expandAll();
-
-	createAndStartIntervalTimer(100, this, [this] {
-		addOrRemoveObjects();
-		updateTreeItemParents();
-		updateItemDisplayNames();
-	});
+	// Existing objects are added once the widget is fully constructed, so that derived classes can filter them with shouldDisplayItem()
+	mRegistryListener = std::make_unique<ScenarioObjectRegistryListener>(this);
+	for (const auto& [id, type] : mScenarioObjectTypes)
+	{
+		type->objectRegistry->addListener(mRegistryListener.get());
+		for (const ScenarioObjectPtr& object : type->objectRegistry->getItems())
+		{
+			objectAdded(object);
+		}
+	}
 }
 
-ScenarioTreeWidget::~ScenarioTreeWidget() = default;
+ScenarioTreeWidget::~ScenarioTreeWidget()
+{
+	for (const auto& [id, type] : mScenarioObjectTypes)
+	{
+		type->objectRegistry->removeListener(mRegistryListener.get());
+	}
+}
 
 bool ScenarioTreeWidget::shouldDisplayItem(const ScenarioObject& object) const
 {
 	return true;
 }
 
-void ScenarioTreeWidget::addOrRemoveObjects()
+void ScenarioTreeWidget::objectAdded(const ScenarioObjectPtr& object)
+{
+	mPendingRemovedObjects.erase(object);
+	mPendingAddedObjects.insert(object);
+	schedulePendingChanges();
+}
+
+void ScenarioTreeWidget::objectRemoved(const ScenarioObjectPtr& object)
+{
+	mPendingAddedObjects.erase(object);
+	mPendingChangedObjects.erase(object);
+	mPendingRemovedObjects.insert(object);
+	schedulePendingChanges();
+}
+
+void ScenarioTreeWidget::objectChanged(const ScenarioObjectPtr& object)
+{
+	mPendingChangedObjects.insert(object);
+	schedulePendingChanges();
+}
+
+void ScenarioTreeWidget::schedulePendingChanges()
 {
-	std::set<ScenarioObjectPtr> objectsToAdd;
-	std::set<ScenarioObjectPtr> objectsToRemove;
+	if (!mPendingChangesScheduled)
 	{
-		// Make a set of all the items to display in the widget, and add any new items to objectsToAdd
-		std::set<ScenarioObjectPtr> includeObjects;
-		for (const auto& [id, type] : mScenarioObjectTypes)
-		{
-			for (const ScenarioObjectPtr& object : type->objectRegistry->getItems())
-			{
-				if (shouldDisplayItem(*object))
-				{
-					includeObjects.insert(object);
-					if (mItemsMap.find(object) == mItemsMap.end())
-					{
-						objectsToAdd.insert(object);
-					}
-				}
-			}
-		}
+		mPendingChangesScheduled = true;
+		QTimer::singleShot(0, this, [this] { applyPendingChanges(); });
+	}
+}
+
+void ScenarioTreeWidget::applyPendingChanges()
+{
+	mPendingChangesScheduled = false;
+
+	removeObjects(mPendingRemovedObjects);
+	mPendingRemovedObjects.clear();
+
+	addObjects(mPendingAddedObjects);
+	mPendingAddedObjects.clear();
 
-		// Make a set of objects to remove from the widget
-		for (const auto& [object, treeitem] : mItemsMap)
+	std::vector<TreeItem*> selection = getCurrentSelection();
+	bool moved = false;
+	for (const ScenarioObjectPtr& object : mPendingChangedObjects)
+	{
+		if (auto item = findOptional(mItemsMap, object); item)
 		{
-			if (includeObjects.find(object) == includeObjects.end())
-			{
-				objectsToRemove.insert(object);
-			}
+			moved |= updateItem(**item);
 		}
 	}
+	mPendingChangedObjects.clear();
 
-	removeObjects(objectsToRemove);
-	addObjects(objectsToAdd);
+	if (moved)
+	{
+		setCurrentSelection(selection); // Selection can change after removing item, so we need to restore it here.
+	}
 }
 
 void ScenarioTreeWidget::addObjects(const std::set<ScenarioObjectPtr>& objects)
 {
-	std::vector<TreeItemPtr> children;
+	// Group new items by folder so that each folder's items are inserted together
+	std::map<TreeItem*, std::vector<TreeItemPtr>> folderChildren;
 	for (const auto& object : objects)
 	{
+		if (mItemsMap.find(object) != mItemsMap.end() || !shouldDisplayItem(*object))
+		{
+			continue;
+		}
+
 		auto item = std::make_shared<ScenarioObjectTreeItem>(object);
+		item->directory = object->getDirectory();
 		mItemsMap[object] = item;
-		children.push_back(item);
+		folderChildren[getOrCreateFolder(item->directory).get()].push_back(item);
+	}
+
+	for (const auto& [folder, children] : folderChildren)
+	{
+		mModel->addChildren(*folder, children);
 	}
-	mModel->addChildren(*mRootItem, children);
 }
 
 void ScenarioTreeWidget::removeObjects(const std::set<ScenarioObjectPtr>& objects)
 {
+	// Group removed items by folder so that runs of adjacent items are removed together
+	std::map<TreeItem*, std::set<const TreeItem*>> folderChildren;
 	for (const auto& object : objects)
 	{
 		if (auto i = mItemsMap.find(object); i != mItemsMap.end())
 		{
-			mModel->removeItem(*i->second);
+			if (TreeItem* folder = mModel->getParent(*i->second); folder)
+			{
+				folderChildren[folder].insert(i->second.get());
+			}
 			mItemsMap.erase(i);
 		}
 	}
+
+	for (const auto& [folder, children] : folderChildren)
+	{
+		mModel->removeChildren(*folder, children);
+	}
+}
+
+bool ScenarioTreeWidget::updateItem(ScenarioObjectTreeItem& item)
+{
+	bool moved = false;
+	if (const ScenarioObjectPath& directory = item.object->getDirectory(); directory != item.directory)
+	{
+		TreeItemPtr itemPtr = mItemsMap[item.object];
+		TreeItemPtr newParent = getOrCreateFolder(directory);
+		if (TreeItem* currentParent = mModel->getParent(item); currentParent)
+		{
+			mModel->removeChild(*currentParent, item);
+		}
+		mModel->addChildren(*newParent, {itemPtr});
+		mView->expand(mModel->index(newParent.get()));
+		item.directory = directory;
+		moved = true;
+	}
+
+	const QString& displayName = QString::fromStdString(item.object->getDisplayName());
+	if (item.getLabel() != displayName)
+	{
+		item.setLabel(displayName);
+	}
+	return moved;
 }
 
 std::vector<TreeItem*> ScenarioTreeWidget::getCurrentSelection() const
@@ -202,55 +288,23 @@ TreeItemPtr ScenarioTreeWidget::createFolder(TreeItem& parent, const std::string
 	return item;
 }
 
-TreeItemPtr ScenarioTreeWidget::getParent(const ScenarioObject& object)
+TreeItemPtr ScenarioTreeWidget::getOrCreateFolder(const ScenarioObjectPath& path)
 {
-	ScenarioObjectPath directory = object.getDirectory();
-
-	TreeItemPtr parent = mRootItem;
-	for (const std::string& folder : directory)
+	if (path.empty())
 	{
-		TreeItemPtr child = mModel->findChildByLabel(*parent, QString::fromStdString(folder));
-
-		if (!child)
-		{
-			child = createFolder(*parent, folder);
-		}
-		parent = child;
+		return mRootItem;
 	}
-	return parent;
-}
 
-void ScenarioTreeWidget::updateTreeItemParents()
-{
-	std::vector<TreeItem*> selection = getCurrentSelection();
-
-	for (const auto& [object, item] : mItemsMap)
+	if (auto i = mFolders.find(path); i != mFolders.end())
 	{
-		if (TreeItemPtr newParent = getParent(*object); newParent)
-		{
-			TreeItem* currentParent = mModel->getParent(*item);
-			if (currentParent != newParent.get())
-			{
-				mModel->removeChild(*currentParent, *item);
-				mModel->addChildren(*newParent, {item});
-				mView->expand(mModel->index(newParent.get()));
-			}
-		}
+		return i->second;
 	}
 
-	setCurrentSelection(selection); // Selection can change after removing item, so we need to restore it here.
-}
-
-void ScenarioTreeWidget::updateItemDisplayNames()
-{
-	for (const auto& [object, item] : mItemsMap)
-	{
-		const QString& displayName = QString::fromStdString(object->getDisplayName());
-		if (item->getLabel() != displayName)
-		{
-			item->setLabel(displayName);
-		}
-	}
+	TreeItemPtr parent = getOrCreateFolder(ScenarioObjectPath(path.begin(), path.end() - 1));
+	TreeItemPtr folder = createFolder(*parent, path.back());
+	mFolders[path] = folder;
+	mView->expand(mModel->index(folder.get()));
+	return folder;
 }
 
 ScenarioObjectPtr ScenarioTreeWidget::findScenarioObject(const TreeItem& item) const
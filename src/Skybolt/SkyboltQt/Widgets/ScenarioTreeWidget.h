@@ -25,7 +25,10 @@ struct ScenarioTreeWidgetConfig
 };
 
 struct ScenarioObjectTreeItem;
+struct ScenarioObjectRegistryListener;
 
+//! Displays scenario objects in a tree of folders given by each object's directory.
+//! The tree is updated incrementally from scenario object registry notifications. Changes from one event loop iteration are applied together.
 class ScenarioTreeWidget : public QWidget
 {
 	Q_OBJECT
@@ -37,22 +40,30 @@ public:
 	~ScenarioTreeWidget();
 
 protected:
+	//! Evaluated when the object is added to the widget
 	virtual bool shouldDisplayItem(const ScenarioObject& object) const;
 
 private:
-	void addOrRemoveObjects();
+	void objectAdded(const ScenarioObjectPtr& object);
+	void objectRemoved(const ScenarioObjectPtr& object);
+	void objectChanged(const ScenarioObjectPtr& object);
+	void schedulePendingChanges();
+	void applyPendingChanges();
+
 	void addObjects(const std::set<ScenarioObjectPtr>& objects);
 	void removeObjects(const std::set<ScenarioObjectPtr>& objects);
 
+	//! Updates the item's parent and label if the object's directory or display name have changed
+	//! @return true if the item was moved to a different parent
+	bool updateItem(ScenarioObjectTreeItem& item);
+
 	ScenarioObjectPtr findScenarioObject(const TreeItem& item) const; //!< Returns nullptr if item has no scenario object
 	ActionContext toActionContext(const skybolt::sim::World& world, const TreeItem& item) const;
 	void showContextMenu(TreeItem& item, const QPoint& point);
 
 	TreeItemPtr createFolder(TreeItem& parent, const std::string& name);
 
-	TreeItemPtr getParent(const ScenarioObject& object); //!< Never returns null
-	void updateTreeItemParents();
-	void updateItemDisplayNames();
+	TreeItemPtr getOrCreateFolder(const skybolt::ScenarioObjectPath& path); //!< Never returns null
 
 	std::vector<TreeItem*> getCurrentSelection() const;
 	void setCurrentSelection(const std::vector<TreeItem*>& items);
@@ -68,4 +79,11 @@ private:
 
 	TreeItemPtr mRootItem;
 	std::map<ScenarioObjectPtr, std::shared_ptr<ScenarioObjectTreeItem>> mItemsMap;
+	std::map<skybolt::ScenarioObjectPath, TreeItemPtr> mFolders;
+
+	std::unique_ptr<ScenarioObjectRegistryListener> mRegistryListener;
+	std::set<ScenarioObjectPtr> mPendingAddedObjects;
+	std::set<ScenarioObjectPtr> mPendingRemovedObjects;
+	std::set<ScenarioObjectPtr> mPendingChangedObjects;
+	bool mPendingChangesScheduled = false;
 };
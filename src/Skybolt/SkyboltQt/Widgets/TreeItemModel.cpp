@@ -23,12 +23,10 @@ TreeItemModel::TreeItemModel(const TreeItemPtr& root, QObject *parent)
 
 TreeItemPtr TreeItemModel::getTreeItem(const QModelIndex &index) const
 {
-	TreeItem* item = static_cast<TreeItem*>(index.internalPointer());
-	auto i = std::find_if(mItems.begin(), mItems.end(), [&] (const TreeItemPtr& itemPtr) {
-		return itemPtr.get() == item;
-	});
+	const TreeItem* item = static_cast<const TreeItem*>(index.internalPointer());
+	auto i = mItems.find(item);
 	if (i != mItems.end())
-		return *i;
+		return i->second;
 	return nullptr;
 }
 
@@ -44,7 +42,7 @@ void TreeItemModel::insertChildren(TreeItem& item, int position, const std::vect
 
 	for (const TreeItemPtr& child : children)
 	{
-		mItems.insert(child);
+		mItems[child.get()] = child;
 		connect(child.get(), &TreeItem::labelChanged, this, [this, child] {
 			QModelIndex childIndex = index(child.get());
 			dataChanged(childIndex, childIndex, { Qt::DisplayRole });
@@ -73,7 +71,7 @@ void TreeItemModel::removeChildren(TreeItem& item, int position, int count)
 	{
 		TreeItemPtr child = item.mChildren[i];
 		child->mParent = nullptr;
-		mItems.erase(child);
+		mItems.erase(child.get());
 
 		disconnect(child.get(), nullptr, nullptr, nullptr);
 	}
@@ -82,6 +80,28 @@ void TreeItemModel::removeChildren(TreeItem& item, int position, int count)
 	endRemoveRows();
 }
 
+void TreeItemModel::removeChildren(TreeItem& item, const std::set<const TreeItem*>& children)
+{
+	// Remove runs from last to first so that the positions of runs not yet removed are unchanged
+	int end = (int)item.mChildren.size();
+	while (end > 0)
+	{
+		while (end > 0 && children.find(item.mChildren[end - 1].get()) == children.end())
+		{
+			--end;
+		}
+
+		int begin = end;
+		while (begin > 0 && children.find(item.mChildren[begin - 1].get()) != children.end())
+		{
+			--begin;
+		}
+
+		removeChildren(item, begin, end - begin);
+		end = begin;
+	}
+}
+
 void TreeItemModel::removeChild(TreeItem& item, const TreeItem& child)
 {
 	if (int i = getChildPosition(item, child); i >= 0)
@@ -13,6 +13,9 @@
 #include <QAbstractItemModel>
 #include <QIcon>
 
+#include <set>
+#include <unordered_map>
+
 class TreeItem : public QObject
 {
 	Q_OBJECT
@@ -61,6 +64,9 @@ public:
 	void addChildren(TreeItem& item, const std::vector<TreeItemPtr>& children);
 	void insertChildren(TreeItem& item, int position, const std::vector<TreeItemPtr>& children);
 	void removeChildren(TreeItem& item, int position, int count);
+
+	//! Removes the given children of item. Contiguous runs of children are removed together.
+	void removeChildren(TreeItem& item, const std::set<const TreeItem*>& children);
 	void removeChild(TreeItem& item, const TreeItem& child);
 	void clearChildren(TreeItem& item);
 	const std::vector<TreeItemPtr>& getChildren(TreeItem& item) const;
@@ -85,5 +91,5 @@ public:
 
 private:
 	TreeItemPtr mRootItem;
-	std::set<TreeItemPtr> mItems;
+	std::unordered_map<const TreeItem*, TreeItemPtr> mItems; //!< Maps each item in the model, excluding the root, to its owning pointer
 };
@@ -0,0 +1,146 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include <catch2/catch.hpp>
+#include <SkyboltQt/Engine/RenderScheduler.h>
+#include <SkyboltSim/Entity.h>
+#include <SkyboltSim/World.h>
+#include <SkyboltSim/Components/Node.h>
+
+#include <chrono>
+#include <iostream>
+
+using namespace skybolt;
+using namespace skybolt::sim;
+
+static RenderSchedulerConfig createOnDemandConfig()
+{
+	RenderSchedulerConfig config;
+	config.renderOnDemand = true;
+	config.maxFrameInterval = std::nullopt;
+	return config;
+}
+
+TEST_CASE("Render scheduler renders every update when not rendering on demand")
+{
+	RenderScheduler scheduler;
+	for (int i = 0; i < 3; ++i)
+	{
+		CHECK(scheduler.shouldRender(i, 0, false));
+	}
+	CHECK(scheduler.getStats().renderedFrameCount == 3);
+}
+
+TEST_CASE("Render scheduler renders on demand")
+{
+	RenderScheduler scheduler(createOnDemandConfig());
+
+	// First frame is always rendered
+	CHECK(scheduler.shouldRender(0, 1, false));
+	CHECK(!scheduler.shouldRender(1, 1, false));
+
+	SECTION("State change renders")
+	{
+		CHECK(scheduler.shouldRender(2, 2, false));
+		CHECK(!scheduler.shouldRender(3, 2, false));
+	}
+
+	SECTION("Request renders once")
+	{
+		scheduler.requestRender();
+		CHECK(scheduler.shouldRender(2, 1, false));
+		CHECK(!scheduler.shouldRender(3, 1, false));
+	}
+
+	SECTION("Loading renders until one frame after loading finishes")
+	{
+		CHECK(scheduler.shouldRender(2, 1, true));
+		CHECK(scheduler.shouldRender(3, 1, true));
+		CHECK(scheduler.shouldRender(4, 1, false));
+		CHECK(!scheduler.shouldRender(5, 1, false));
+	}
+
+	CHECK(scheduler.getStats().skippedFrameCount == 2);
+}
+
+TEST_CASE("Render scheduler renders after max frame interval when idle")
+{
+	RenderSchedulerConfig config = createOnDemandConfig();
+	config.maxFrameInterval = 1.0;
+	RenderScheduler scheduler(config);
+
+	CHECK(scheduler.shouldRender(0, 1, false));
+	CHECK(!scheduler.shouldRender(0.5, 1, false));
+	CHECK(scheduler.shouldRender(1.0, 1, false));
+	CHECK(!scheduler.shouldRender(1.5, 1, false));
+}
+
+TEST_CASE("Render scheduler measures frame rate and busy fraction")
+{
+	RenderSchedulerConfig config = createOnDemandConfig();
+	config.statsInterval = 1.0;
+	RenderScheduler scheduler(config);
+
+	// 10 updates per second, each taking 10ms, of which 2 render after the first update starts the stats interval
+	for (int i = 0; i <= 10; ++i)
+	{
+		double wallTime = i * 0.1;
+		scheduler.shouldRender(wallTime, (i < 3) ? i : 2, false);
+		scheduler.addBusyTime(wallTime, 0.01);
+	}
+
+	const RenderSchedulerStats& stats = scheduler.getStats();
+	CHECK(stats.renderedFramesPerSecond == Approx(2.0));
+	CHECK(stats.busyFraction == Approx(0.1));
+	CHECK(stats.renderedFrameCount == 3);
+	CHECK(stats.skippedFrameCount == 8);
+}
+
+TEST_CASE("World transform version changes when entities move or are added")
+{
+	World world;
+	auto addEntity = [&] (std::uint32_t id) {
+		auto entity = std::make_shared<Entity>(EntityId{1, id});
+		auto node = std::make_shared<Node>();
+		entity->addComponent(node);
+		world.addEntity(entity);
+		return node;
+	};
+
+	std::shared_ptr<Node> node = addEntity(1);
+	uint64_t version = calcWorldTransformVersion(world);
+	CHECK(calcWorldTransformVersion(world) == version);
+
+	node->setPosition(Vector3(1, 2, 3));
+	uint64_t movedVersion = calcWorldTransformVersion(world);
+	CHECK(movedVersion != version);
+
+	addEntity(2);
+	CHECK(calcWorldTransformVersion(world) != movedVersion);
+}
+
+TEST_CASE("Benchmark world transform version with many entities", "[.benchmark]")
+{
+	World world;
+	const int entityCount = 10000;
+	for (int i = 0; i < entityCount; ++i)
+	{
+		auto entity = std::make_shared<Entity>(EntityId{1, std::uint32_t(i + 1)});
+		entity->addComponent(std::make_shared<Node>());
+		world.addEntity(entity);
+	}
+
+	const int iterations = 100;
+	uint64_t result = 0;
+	auto start = std::chrono::steady_clock::now();
+	for (int i = 0; i < iterations; ++i)
+	{
+		result += calcWorldTransformVersion(world);
+	}
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	std::cout << "World transform version of " << entityCount << " entities: " << seconds / iterations * 1000 << "ms (" << result % 2 << ")" << std::endl;
+}
@@ -0,0 +1,188 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include <catch2/catch.hpp>
+#include <SkyboltQt/Scenario/ScenarioSelectionModel.h>
+#include <SkyboltQt/Widgets/ScenarioTreeWidget.h>
+
+#include <QApplication>
+#include <QEventLoop>
+#include <QTimer>
+#include <QTreeView>
+
+#include <chrono>
+#include <ctime>
+#include <functional>
+#include <iostream>
+
+using namespace skybolt;
+
+namespace {
+
+QApplication& getApplication()
+{
+	static int argc = 1;
+	static char name[] = "SkyboltQtTests";
+	static char* argv[] = { name };
+	qputenv("QT_QPA_PLATFORM", "offscreen");
+	static QApplication application(argc, argv);
+	return application;
+}
+
+using TestObject = ScenarioObjectT<int>;
+
+std::shared_ptr<TestObject> createObject(const std::string& name, const ScenarioObjectPath& directory = {})
+{
+	auto object = std::make_shared<TestObject>(name, QIcon(), 0);
+	object->setDirectory(directory);
+	return object;
+}
+
+struct TestScenario
+{
+	TestScenario()
+	{
+		auto type = std::make_shared<ScenarioObjectType>();
+		type->name = "Test";
+		type->objectRegistry = registry;
+		types[typeid(TestObject)] = type;
+	}
+
+	std::unique_ptr<ScenarioTreeWidget> createWidget()
+	{
+		ScenarioTreeWidgetConfig config;
+		config.selectionModel = &selectionModel;
+		config.world = nullptr;
+		config.scenarioObjectTypes = types;
+		return std::make_unique<ScenarioTreeWidget>(config);
+	}
+
+	ScenarioObjectRegistryPtr registry = std::make_shared<ScenarioObjectRegistry>();
+	ScenarioObjectTypeMap types;
+	ScenarioSelectionModel selectionModel;
+};
+
+QAbstractItemModel& getModel(const ScenarioTreeWidget& widget)
+{
+	return *widget.findChild<QTreeView*>()->model();
+}
+
+//! @return index of the item at the given path of labels, or an invalid index if not found
+QModelIndex findIndex(const QAbstractItemModel& model, const std::vector<QString>& labels)
+{
+	QModelIndex parent;
+	for (const QString& label : labels)
+	{
+		QModelIndex child;
+		for (int row = 0; row < model.rowCount(parent); ++row)
+		{
+			QModelIndex index = model.index(row, 0, parent);
+			if (model.data(index, Qt::DisplayRole).toString() == label)
+			{
+				child = index;
+				break;
+			}
+		}
+		if (!child.isValid())
+		{
+			return QModelIndex();
+		}
+		parent = child;
+	}
+	return parent;
+}
+
+} // namespace
+
+TEST_CASE("Scenario tree widget shows objects in folders")
+{
+	getApplication();
+	TestScenario scenario;
+	scenario.registry->add(createObject("existing"));
+
+	auto widget = scenario.createWidget();
+	QApplication::processEvents();
+
+	const QAbstractItemModel& model = getModel(*widget);
+	CHECK(findIndex(model, {"existing"}).isValid());
+
+	// Objects are added to their folders
+	auto objectA = createObject("a", {"Folder", "Subfolder"});
+	auto objectB = createObject("b", {"Folder"});
+	scenario.registry->add(objectA);
+	scenario.registry->add(objectB);
+	QApplication::processEvents();
+
+	CHECK(findIndex(model, {"Folder", "Subfolder", "a"}).isValid());
+	CHECK(findIndex(model, {"Folder", "b"}).isValid());
+	CHECK(model.rowCount(findIndex(model, {"Folder"})) == 2);
+
+	// Objects are moved when their directory changes
+	objectB->setDirectory({"Other"});
+	scenario.registry->notifyItemChanged(objectB.get());
+	QApplication::processEvents();
+
+	CHECK(!findIndex(model, {"Folder", "b"}).isValid());
+	CHECK(findIndex(model, {"Other", "b"}).isValid());
+
+	// Objects are removed
+	scenario.registry->remove(objectA.get());
+	QApplication::processEvents();
+
+	CHECK(!findIndex(model, {"Folder", "Subfolder", "a"}).isValid());
+	CHECK(findIndex(model, {"Other", "b"}).isValid());
+}
+
+TEST_CASE("Benchmark scenario tree widget with many objects", "[.benchmark]")
+{
+	getApplication();
+	TestScenario scenario;
+	auto widget = scenario.createWidget();
+	widget->show();
+
+	const int objectCount = 10000;
+	std::vector<std::shared_ptr<TestObject>> objects;
+	for (int i = 0; i < objectCount; ++i)
+	{
+		objects.push_back(createObject("object" + std::to_string(i), {"Entities", "Group" + std::to_string(i % 10)}));
+	}
+
+	auto measureUiThreadSeconds = [] (const std::function<void()>& action) {
+		auto start = std::chrono::steady_clock::now();
+		action();
+		QApplication::processEvents();
+		return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	};
+
+	double addSeconds = measureUiThreadSeconds([&] {
+		for (const auto& object : objects)
+		{
+			scenario.registry->add(object);
+		}
+	});
+
+	// The widget only does work in response to registry notifications, so it should be close to zero while idle.
+	// Measure the fraction of time the UI thread is busy by comparing CPU time to wall time.
+	const double idleWallSeconds = 2.0;
+	std::clock_t idleStartClock = std::clock();
+	{
+		QEventLoop loop;
+		QTimer::singleShot(int(idleWallSeconds * 1000), &loop, &QEventLoop::quit);
+		loop.exec();
+	}
+	double idleCpuSeconds = double(std::clock() - idleStartClock) / CLOCKS_PER_SEC;
+
+	double removeSeconds = measureUiThreadSeconds([&] {
+		for (const auto& object : objects)
+		{
+			scenario.registry->remove(object.get());
+		}
+	});
+
+	std::cout << "Add " << objectCount << " objects: " << addSeconds * 1000 << "ms" << std::endl;
+	std::cout << "Remove " << objectCount << " objects: " << removeSeconds * 1000 << "ms" << std::endl;
+	std::cout << "Idle: UI thread busy " << idleCpuSeconds / idleWallSeconds * 100 << "% of the time" << std::endl;
+}
@@ -8,7 +8,7 @@
 #include "SkyboltSim/Components/DynamicBodyComponent.h"
 #include "SkyboltSim/Components/Node.h"
 #include "SkyboltSim/Components/Motion.h"
-#include "SkyboltSim/Physics/Atmosphere.h"
+#include "SkyboltSim/Physics/AtmosphereTable.h"
 #include "SkyboltSim/Spatial/GreatCircle.h"
 
 #include <algorithm>
@@ -36,7 +36,7 @@ static double calcAltitude(const sim::Vector3& position)
 
 static double calcAirDensity(double altitude)
 {
-	static Atmosphere atmosphere = createEarthAtmosphere();
+	static AtmosphereTable atmosphere(createEarthAtmosphere());
 	return atmosphere.getDensity(altitude);
 }
 
@@ -32,12 +32,20 @@ Node::~Node()
 
 void Node::setPosition(const Vector3 &position)
 {
-	mPosition = position;
+	if (position != mPosition)
+	{
+		mPosition = position;
+		++mTransformVersion;
+	}
 }
 
 void Node::setOrientation(const Quaternion &orientation)
 {
-	mOrientation = orientation;
+	if (orientation != mOrientation)
+	{
+		mOrientation = orientation;
+		++mTransformVersion;
+	}
 }
 
 } // namespace skybolt::sim
\ No newline at end of file
@@ -28,9 +28,13 @@ public:
 	Vector3 getPosition() const override {return mPosition;}
 	Quaternion getOrientation() const override {return mOrientation;}
 
+	//! @returns a number which is incremented each time the position or orientation changes
+	uint64_t getTransformVersion() const { return mTransformVersion; }
+
 private:
 	Vector3 mPosition;
 	Quaternion mOrientation;
+	uint64_t mTransformVersion = 0;
 };
 
 SKYBOLT_REFLECT_EXTERN(Node)
@@ -8,7 +8,7 @@
 
 #include "SkyboltSim/Component.h"
 #include "SkyboltSim/PlanetAltitudeProvider.h"
-#include <SkyboltSim/Physics/Atmosphere.h>
+#include <SkyboltSim/Physics/AtmosphereTable.h>
 #include "SkyboltSim/SkyboltSimFwd.h"
 
 #include <variant>
@@ -27,7 +27,7 @@ public:
 	const double radius;
 
 	std::shared_ptr<PlanetAltitudeProvider> altitudeProvider; //!< Null if the planet has no terrain
-	std::optional<Atmosphere> atmosphere;
+	std::optional<AtmosphereTable> atmosphere;
 };
 
 } // namespace sim
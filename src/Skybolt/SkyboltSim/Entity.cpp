@@ -10,6 +10,7 @@
 #include "World.h"
 #include "Components/Motion.h"
 #include "Components/Node.h"
+#include <SkyboltCommon/Profiling/Profiler.h>
 
 namespace skybolt {
 namespace sim {
@@ -70,6 +71,7 @@ void Entity::advanceSimTime(SecondsD newTime, SecondsD dt)
 {
 	for (const ComponentPtr& c : mComponents.getAllItems())
 	{
+		SKYBOLT_PROFILE_ZONE(typeid(*c).name());
 		c->advanceSimTime(newTime, dt);
 	}
 }
@@ -80,6 +82,7 @@ void Entity::update(UpdateStage stage)
 
 	for (const ComponentPtr& c : mComponents.getAllItems())
 	{
+		SKYBOLT_PROFILE_ZONE(typeid(*c).name());
 		c->update(stage);
 	}
 }
@@ -36,6 +36,7 @@ void ParticleEmitter::update(float dt, std::vector<Particle>& particles)
 	if (particleCount > 0)
 	{
 		mParticlesToEmit -= particleCount;
+		mAtmosphericDensity = getAtmosphericDensity(); // Evaluate once for all particles emitted in this update
 		float dtSubstep = dt / particleCount;
 		float timeOffset = 0;
 
@@ -47,12 +48,11 @@ void ParticleEmitter::update(float dt, std::vector<Particle>& particles)
 	}
 }
 
-int ParticleEmitter::mNextParticleId = 0;
+std::atomic<int> ParticleEmitter::mNextParticleId = 0;
 
 Particle ParticleEmitter::createParticle(const Vector3& emitterVelocity, float timeOffset) const
 {
-	float density = getAtmosphericDensity();
-	float alpha = glm::mix(mParams.zeroAtmosphericDensityAlpha, mParams.earthSeaLevelAtmosphericDensityAlpha, density / 1.225);
+	float alpha = glm::mix(mParams.zeroAtmosphericDensityAlpha, mParams.earthSeaLevelAtmosphericDensityAlpha, mAtmosphericDensity / 1.225);
 
 	Vector3 velocityRelEmitter = calculateParticleVelocityRelEmitter();
 	Particle particle;
@@ -84,25 +84,16 @@ Vector3 ParticleEmitter::calculateParticleVelocityRelEmitter() const
 	return mParams.positionable->getOrientation() * (mOrientation * velocity);
 }
 
-sim::Entity* ParticleEmitter::getNearestPlanet() const
+static double getAltitude(const PlanetFrame& planetFrame, const sim::Vector3& position)
 {
-	sim::Vector3 position = mParams.positionable->getPosition();
-	return mParams.nearestPlanetProvider(position);
-}
-
-static double getAltitude(const sim::Entity& planet, const sim::Vector3& position)
-{
-	glm::dmat4 planetTransform = getTransform(planet).value_or(math::dmat4Identity());
-	glm::dmat4 invPlanetTransform = glm::inverse(planetTransform);
-	glm::dvec4 positionInPlanetSpace = invPlanetTransform * glm::dvec4(position, 1.0);
-	positionInPlanetSpace.w = 0.0;
-	return glm::length(positionInPlanetSpace) - planet.getFirstComponent<sim::PlanetComponent>()->radius;
+	// Distance from the planet center is unaffected by the planet's rotation, so there is no need to transform into planet space
+	return glm::length(position - planetFrame.position) - planetFrame.radius;
 }
 
-static double getAtmosphericDensity(const sim::Entity& planet, const sim::Vector3& position)
+static double getAtmosphericDensity(const PlanetFrame& planetFrame, const sim::Vector3& position)
 {
-	auto altitude = getAltitude(planet, position);
-	const std::optional<Atmosphere>& atmosphere = planet.getFirstComponent<sim::PlanetComponent>()->atmosphere;
+	auto altitude = getAltitude(planetFrame, position);
+	const std::optional<AtmosphereTable>& atmosphere = planetFrame.planet->getFirstComponent<sim::PlanetComponent>()->atmosphere;
 	if (atmosphere)
 	{
 		return float(atmosphere->getDensity(altitude));
@@ -112,9 +103,9 @@ static double getAtmosphericDensity(const sim::Entity& planet, const sim::Vector
 
 float ParticleEmitter::getAtmosphericDensity() const
 {
-	sim::Entity* planet = getNearestPlanet();
 	sim::Vector3 position = mParams.positionable->getPosition();
-	return planet ? float(sim::getAtmosphericDensity(*planet, position)) : 0.0f;
+	std::optional<PlanetFrame> planetFrame = mParams.nearestPlanetProvider(position);
+	return planetFrame ? float(sim::getAtmosphericDensity(*planetFrame, position)) : 0.0f;
 }
 
 void ParticleKiller::update(float dt, std::vector<Particle>& particles)
@@ -155,14 +146,12 @@ void ParticleIntegrator::update(float dt, std::vector<Particle>& particles)
 	double velocityDamping = 0;
 	{
 		sim::Vector3 position = particles.front().position;
-		sim::Entity* planet = mParams.nearestPlanetProvider(position);
-		if (planet)
+		std::optional<PlanetFrame> planetFrame = mParams.nearestPlanetProvider(position);
+		if (planetFrame)
 		{
-			glm::dmat4 planetTransform = getTransform(*planet).value_or(math::dmat4Identity());
-			glm::dmat4 invPlanetTransform = glm::inverse(planetTransform);
 			sim::Vector3 firstParticlePosition = particles.front().position;
 
-			sim::Vector3 particlePositionPlanetSpace = invPlanetTransform * glm::dvec4(firstParticlePosition, 1.0);
+			sim::Vector3 particlePositionPlanetSpace = planetFrame->inverseTransform * glm::dvec4(firstParticlePosition, 1.0);
 			if (mPrevPlanetTransform)
 			{
 				sim::Vector3 particlePrevPositionWorldSpace = *mPrevPlanetTransform * glm::dvec4(particlePositionPlanetSpace, 1.0);
@@ -170,9 +159,9 @@ void ParticleIntegrator::update(float dt, std::vector<Particle>& particles)
 				windVelocity = (firstParticlePosition - particlePrevPositionWorldSpace) / dtD;
 			}
 
-			mPrevPlanetTransform = planetTransform;
+			mPrevPlanetTransform = planetFrame->transform;
 
-			double density = getAtmosphericDensity(*planet, position);
+			double density = getAtmosphericDensity(*planetFrame, position);
 			velocityDamping = std::exp(-mParams.atmosphericSlowdownFactor * density * dt);
 		}
 	}
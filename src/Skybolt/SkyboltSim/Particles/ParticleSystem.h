@@ -8,8 +8,10 @@
 
 #include "SkyboltSim/SimMath.h"
 #include "SkyboltSim/SkyboltSimFwd.h"
+#include "SkyboltSim/System/PlanetFrameSystem.h"
 #include <SkyboltCommon/Range.h>
 
+#include <atomic>
 #include <functional>
 #include <memory>
 #include <optional>
@@ -40,7 +42,8 @@ public:
 	virtual void update(float dt, std::vector<Particle>& particles) = 0;
 };
 
-using NearestPlanetProvider = std::function<sim::Entity*(const sim::Vector3& position)>;
+//! @returns the frame of the planet nearest to the position, or nullopt if there are no planets
+using NearestPlanetProvider = std::function<std::optional<PlanetFrame>(const sim::Vector3& position)>;
 
 class ParticleEmitter : public ParticleSystemOperation
 {
@@ -79,7 +82,6 @@ public:
 	virtual Particle createParticle(const Vector3& emitterVelocity, float timeOffset) const;
 
 private:
-	sim::Entity* getNearestPlanet() const;
 	float getAtmosphericDensity() const; // kg / m^3
 
 	Vector3 calculateParticleVelocityRelEmitter() const;
@@ -90,8 +92,9 @@ private:
 	float mParticlesToEmit = 0;
 	float mEmissionRateMultiplier = 1.0;
 	float mEmissionAlphaMultiplier = 1.0;
+	float mAtmosphericDensity = 0; //!< Atmospheric density at the emitter, updated before particles are created
 	std::optional<Vector3> mPrevPosition;
-	static int mNextParticleId;
+	static std::atomic<int> mNextParticleId; //!< Shared by all emitters, which may be updated concurrently by independent worlds
 };
 
 class ParticleKiller : public ParticleSystemOperation
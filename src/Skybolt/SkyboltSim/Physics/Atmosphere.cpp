@@ -33,6 +33,24 @@ double Atmosphere::getDensity(double altitude) const
     return std::max(0.0, p * m_molarMass / (m_universalGasConst * T));
 }
 
+double Atmosphere::getPressure(double altitude) const
+{
+	double safeAltitude = std::max(0.0, altitude);
+	return m_pressureSeaLevel * (pow(std::max(double(0.0), double(1.0) - m_lapseRateOnTemp * safeAltitude), m_exponent));
+}
+
+double Atmosphere::getTemperature(double altitude) const
+{
+	double safeAltitude = std::max(0.0, altitude);
+	return std::max(0.0, m_tempSeaLevel - m_tempLapsRate * safeAltitude);
+}
+
+double Atmosphere::getSpeedOfSound(double altitude) const
+{
+	const double heatCapacityRatio = 1.4; // Diatomic gas
+	return std::sqrt(heatCapacityRatio * m_universalGasConst * getTemperature(altitude) / m_molarMass);
+}
+
 Atmosphere createEarthAtmosphere()
 {
 	return Atmosphere(288.15, 101300, 0.0065, 9.8, 0.0289644);
@@ -19,6 +19,12 @@ public:
 		double g, double molarMass);
 
 	double getDensity(double altitude) const;
+	double getPressure(double altitude) const;
+	double getTemperature(double altitude) const; //!< Kelvin
+	double getSpeedOfSound(double altitude) const;
+
+	//! @returns altitude at and above which pressure and density are zero
+	double getMaxAltitude() const { return 1.0 / m_lapseRateOnTemp; }
 
 private:
 	double m_lapseRateOnTemp; // L / T0
@@ -0,0 +1,69 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+
+#include "AtmosphereTable.h"
+#include <assert.h>
+#include <cmath>
+
+namespace skybolt {
+namespace sim {
+
+AtmosphereTable::AtmosphereTable(const Atmosphere& atmosphere, double altitudeStep) :
+	mAtmosphere(atmosphere),
+	mInvAltitudeStep(1.0 / altitudeStep)
+{
+	assert(altitudeStep > 0);
+
+	// Sample up to the altitude at which the atmosphere ends. Queries above this are clamped to the last sample.
+	size_t sampleCount = std::max(size_t(2), size_t(std::ceil(atmosphere.getMaxAltitude() * mInvAltitudeStep)) + 1);
+	mMaxSamplePosition = double(sampleCount - 1);
+	mLastIntervalIndex = sampleCount - 2;
+
+	mDensity.resize(sampleCount);
+	mPressure.resize(sampleCount);
+	mTemperature.resize(sampleCount);
+	mSpeedOfSound.resize(sampleCount);
+
+	for (size_t i = 0; i < sampleCount; ++i)
+	{
+		double altitude = double(i) * altitudeStep;
+		mDensity[i] = atmosphere.getDensity(altitude);
+		mPressure[i] = atmosphere.getPressure(altitude);
+		mTemperature[i] = atmosphere.getTemperature(altitude);
+		mSpeedOfSound[i] = atmosphere.getSpeedOfSound(altitude);
+	}
+}
+
+AtmosphereState AtmosphereTable::getState(double altitude) const
+{
+	Sample sample = getSample(altitude);
+	AtmosphereState state;
+	state.density = interpolate(mDensity, sample);
+	state.pressure = interpolate(mPressure, sample);
+	state.temperature = interpolate(mTemperature, sample);
+	state.speedOfSound = interpolate(mSpeedOfSound, sample);
+	return state;
+}
+
+void AtmosphereTable::getDensities(const double* altitudes, double* densities, size_t count) const
+{
+	for (size_t i = 0; i < count; ++i)
+	{
+		densities[i] = interpolate(mDensity, getSample(altitudes[i]));
+	}
+}
+
+void AtmosphereTable::getStates(const double* altitudes, AtmosphereState* states, size_t count) const
+{
+	for (size_t i = 0; i < count; ++i)
+	{
+		states[i] = getState(altitudes[i]);
+	}
+}
+
+} // namespace sim
+} // namespace skybolt
@@ -0,0 +1,84 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+
+#pragma once
+
+#include "Atmosphere.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace skybolt {
+namespace sim {
+
+struct AtmosphereState
+{
+	double density;
+	double pressure;
+	double temperature; //!< Kelvin
+	double speedOfSound;
+};
+
+//! Altitude-indexed table of an Atmosphere's properties, precomputed to avoid evaluating the barometric formula per query.
+//! Values are linearly interpolated between samples. Each property is stored in its own contiguous array
+//! so that batched queries touch only the data they need.
+class AtmosphereTable
+{
+public:
+	//! @param altitudeStep is the spacing between samples in meters
+	explicit AtmosphereTable(const Atmosphere& atmosphere, double altitudeStep = 25.0);
+
+	const Atmosphere& getAtmosphere() const { return mAtmosphere; }
+
+	double getDensity(double altitude) const { return interpolate(mDensity, getSample(altitude)); }
+	double getPressure(double altitude) const { return interpolate(mPressure, getSample(altitude)); }
+	double getTemperature(double altitude) const { return interpolate(mTemperature, getSample(altitude)); }
+	double getSpeedOfSound(double altitude) const { return interpolate(mSpeedOfSound, getSample(altitude)); }
+	AtmosphereState getState(double altitude) const;
+
+	//! Batched queries. Output arrays must have at least count elements.
+	//! @{
+	void getDensities(const double* altitudes, double* densities, size_t count) const;
+	void getStates(const double* altitudes, AtmosphereState* states, size_t count) const;
+	//! @}
+
+private:
+	struct Sample
+	{
+		size_t index; //!< Index of sample at or below the altitude
+		double weight; //!< Interpolation weight of the sample above
+	};
+
+	Sample getSample(double altitude) const
+	{
+		// Written so that NaN maps to the first sample, because converting NaN to an index is undefined
+		double x = altitude * mInvAltitudeStep;
+		x = (x >= 0.0) ? std::min(x, mMaxSamplePosition) : 0.0;
+		size_t index = std::min(size_t(x), mLastIntervalIndex);
+		return {index, x - double(index)};
+	}
+
+	static double interpolate(const std::vector<double>& values, const Sample& sample)
+	{
+		double lower = values[sample.index];
+		return lower + (values[sample.index + 1] - lower) * sample.weight;
+	}
+
+private:
+	Atmosphere mAtmosphere;
+	double mInvAltitudeStep;
+	double mMaxSamplePosition;
+	size_t mLastIntervalIndex;
+
+	std::vector<double> mDensity;
+	std::vector<double> mPressure;
+	std::vector<double> mTemperature;
+	std::vector<double> mSpeedOfSound;
+};
+
+} // namespace sim
+} // namespace skybolt
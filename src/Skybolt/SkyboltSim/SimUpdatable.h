@@ -20,6 +20,7 @@ enum class UpdateStage
 	PostDynamicsSubStep,
 	EndStateUpdate,
 	Attachments,
+	PlanetFrames, //!< Entities are in their final positions for the step
 	Output
 };
 
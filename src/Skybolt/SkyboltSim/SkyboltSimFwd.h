@@ -35,6 +35,7 @@ struct Particle;
 class ParticleEmitter;
 class ParticleSystem;
 struct PlanetComponent;
+class PlanetFrameSystem;
 struct Position;
 class Positionable;
 class PropellerComponent;
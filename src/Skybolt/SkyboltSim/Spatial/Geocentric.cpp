@@ -8,9 +8,183 @@
 #include "SimMath.h"
 #include <SkyboltCommon/Math/MathUtility.h>
 
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
 namespace skybolt {
 namespace sim {
 
+namespace {
+
+//! Number of positions converted together by the batched conversion functions.
+//! Each block is copied into arrays of components so that the conversion loops can be vectorized.
+constexpr size_t batchBlockSize = 32;
+
+const double piOnTwo = 1.57079632679489661923;
+const double piOnFour = 0.78539816339744830962;
+
+//! @returns a if condition is true, otherwise b.
+//! Selects with a bit mask rather than a branch. Unlike the ternary operator, this stops the compiler from moving the
+//! calculation of a and b into branches, which would prevent the calling loop from being vectorized.
+inline double select(bool condition, double a, double b)
+{
+	uint64_t aBits, bBits;
+	std::memcpy(&aBits, &a, sizeof(double));
+	std::memcpy(&bBits, &b, sizeof(double));
+	uint64_t mask = condition ? ~uint64_t(0) : uint64_t(0);
+	uint64_t resultBits = (aBits & mask) | (bBits & ~mask);
+	double result;
+	std::memcpy(&result, &resultBits, sizeof(double));
+	return result;
+}
+
+//! Branch free sine and cosine using the Cephes polynomial approximations, accurate to within a few ulp for |x| < 1e5
+inline void sinCosKernel(double x, double& sinX, double& cosX)
+{
+	const double fourOnPi = 1.27323954473516268615;
+	// Extended precision pi/4 for range reduction
+	const double dp1 = 7.85398125648498535156E-1;
+	const double dp2 = 3.77489470793079817668E-8;
+	const double dp3 = 2.69515142907905952645E-15;
+
+	double ax = std::abs(x);
+
+	// Find the even octant j nearest ax, and reduce ax to z in [-pi/4, pi/4]
+	int j = int(ax * fourOnPi);
+	j += j & 1;
+	double y = double(j);
+	j &= 7;
+	double z = ((ax - y * dp1) - y * dp2) - y * dp3;
+	double zz = z * z;
+
+	double sinPoly = z + z * zz * (((((1.58962301576546568060E-10 * zz - 2.50507477628578072866E-8) * zz + 2.75573136213857245213E-6) * zz
+		- 1.98412698295895385996E-4) * zz + 8.33333333332211858878E-3) * zz - 1.66666666666666307295E-1);
+	double cosPoly = 1.0 - 0.5 * zz + zz * zz * (((((-1.13585365213876817300E-11 * zz + 2.08757008419747316778E-9) * zz - 2.75573141792967388112E-7) * zz
+		+ 2.48015872888517045348E-5) * zz - 1.38888888888730564116E-3) * zz + 4.16666666666665929218E-2);
+
+	// Select the polynomials and signs for the octant
+	bool swap = (j & 2) != 0;
+	double sinSign = 1.0 - 0.5 * double(j & 4);
+	double cosSign = 1.0 - 0.5 * double((j + 2) & 4);
+	sinX = std::copysign(1.0, x) * sinSign * select(swap, cosPoly, sinPoly);
+	cosX = cosSign * select(swap, sinPoly, cosPoly);
+}
+
+//! Branch free arctangent using the Cephes rational approximation, accurate to within a few ulp
+inline double atanKernel(double x)
+{
+	const double tan3PiOnEight = 2.41421356237309504880;
+	const double moreBits = 6.123233995736765886130E-17;
+
+	double ax = std::abs(x);
+	bool large = ax > tan3PiOnEight;
+	bool medium = ax > 0.66;
+
+	// Reduce the argument to [-0.414, 0.66] with a single division
+	double offset = select(large, piOnTwo, select(medium, piOnFour, 0.0));
+	double offsetMoreBits = select(large, moreBits, select(medium, 0.5 * moreBits, 0.0));
+	double numerator = select(large, -1.0, select(medium, ax - 1.0, ax));
+	double denominator = select(large, ax, select(medium, ax + 1.0, 1.0));
+	double r = numerator / denominator;
+
+	double z = r * r;
+	double p = (((-8.750608600031904122785E-1 * z - 1.615753718733365076637E1) * z - 7.500855792314704667340E1) * z
+		- 1.228866684490136173410E2) * z - 6.485021904942025371773E1;
+	double q = ((((z + 2.485846490142306297962E1) * z + 1.650270098316988542046E2) * z + 4.328810604912902668951E2) * z
+		+ 4.853903996359136964868E2) * z + 1.945506571482613964425E2;
+
+	double result = offset + (r * z * p / q + r + offsetMoreBits);
+	return std::copysign(result, x);
+}
+
+//! Branch free equivalent of std::atan2
+inline double atan2Kernel(double y, double x)
+{
+	double ax = std::abs(x);
+	double ay = std::abs(y);
+	double maxComponent = std::max(ax, ay);
+	double minComponent = std::min(ax, ay);
+
+	double a = atanKernel(minComponent / std::max(maxComponent, std::numeric_limits<double>::min()));
+	a = select(ay > ax, piOnTwo - a, a);
+	a = select(x < 0.0, 2.0 * piOnTwo - a, a);
+	return std::copysign(a, y);
+}
+
+//! Ellipsoid constants used by conversions
+struct EllipsoidParams
+{
+	EllipsoidParams(const Ellipsoid& ellipsoid) :
+		a(ellipsoid.equatorialRadius),
+		b(ellipsoid.polarRadius),
+		e2((a * a - b * b) / (a * a)),
+		ep2((a * a - b * b) / (b * b))
+	{
+	}
+
+	double a; //!< Equatorial radius
+	double b; //!< Polar radius
+	double e2; //!< First eccentricity squared
+	double ep2; //!< Second eccentricity squared
+};
+
+//! Heikkinen's closed form solution for geodetic latitude and altitude.
+//! The cube root is supplied by the caller so that batched conversions can evaluate it separately from the vectorizable arithmetic.
+struct HeikkinenTerms
+{
+	HeikkinenTerms(const EllipsoidParams& e, double p, double z)
+	{
+		double z2 = z * z;
+		f = 54.0 * e.b * e.b * z2;
+		g = p * p + (1.0 - e.e2) * z2 - e.e2 * (e.a * e.a - e.b * e.b);
+		double c = e.e2 * e.e2 * f * p * p / (g * g * g);
+		cubeRootArg = 1.0 + c + std::sqrt(c * c + 2.0 * c);
+	}
+
+	void calcLatAlt(const EllipsoidParams& e, double p, double z, double cubeRoot, double& lat, double& alt) const
+	{
+		double z2 = z * z;
+		double k = cubeRoot + 1.0 + 1.0 / cubeRoot;
+		double bigP = f / (3.0 * k * k * g * g);
+		double q = std::sqrt(1.0 + 2.0 * e.e2 * e.e2 * bigP);
+		double r0 = -(bigP * e.e2 * p) / (1.0 + q)
+			+ std::sqrt(std::max(0.0, 0.5 * e.a * e.a * (1.0 + 1.0 / q) - bigP * (1.0 - e.e2) * z2 / (q * (1.0 + q)) - 0.5 * bigP * p * p));
+		double pMinusE2R0 = p - e.e2 * r0;
+		double u = std::sqrt(pMinusE2R0 * pMinusE2R0 + z2);
+		double v = std::sqrt(pMinusE2R0 * pMinusE2R0 + (1.0 - e.e2) * z2);
+		double z0 = e.b * e.b * z / (e.a * v);
+		alt = u * (1.0 - e.b * e.b / (e.a * v));
+		lat = atan2Kernel(z + e.ep2 * z0, p);
+	}
+
+	double f;
+	double g;
+	double cubeRootArg;
+};
+
+//! Structure of arrays for a block of batched conversions
+struct ComponentBlock
+{
+	double c0[batchBlockSize];
+	double c1[batchBlockSize];
+	double c2[batchBlockSize];
+};
+
+//! Calls function for each block of up to batchBlockSize elements
+template <typename Function>
+void forEachBlock(size_t count, Function function)
+{
+	for (size_t begin = 0; begin < count; begin += batchBlockSize)
+	{
+		function(begin, std::min(batchBlockSize, count - begin));
+	}
+}
+
+} // namespace
+
 sim::Vector3 llaToGeocentric(const sim::LatLonAlt& lla, double planetRadius)
 {
 	double cosLat = cos(lla.lat);
@@ -36,6 +210,162 @@ sim::LatLon geocentricToLatLon(const sim::Vector3& pos)
 	return ll;
 }
 
+sim::Vector3 llaToGeocentric(const sim::LatLonAlt& lla, const Ellipsoid& ellipsoid)
+{
+	EllipsoidParams e(ellipsoid);
+	double sinLat = sin(lla.lat);
+	double cosLat = cos(lla.lat);
+	double n = e.a / sqrt(1.0 - e.e2 * sinLat * sinLat); // Prime vertical radius of curvature
+	double r = (n + lla.alt) * cosLat;
+	return sim::Vector3(r * cos(lla.lon), r * sin(lla.lon), (n * (1.0 - e.e2) + lla.alt) * sinLat);
+}
+
+sim::LatLonAlt geocentricToLla(const sim::Vector3& pos, const Ellipsoid& ellipsoid)
+{
+	EllipsoidParams e(ellipsoid);
+	double p = sqrt(pos.x * pos.x + pos.y * pos.y);
+	HeikkinenTerms terms(e, p, pos.z);
+
+	sim::LatLonAlt lla;
+	terms.calcLatAlt(e, p, pos.z, std::cbrt(terms.cubeRootArg), lla.lat, lla.alt);
+	lla.lon = atan2(pos.y, pos.x);
+	return lla;
+}
+
+void llaToGeocentric(const sim::LatLonAlt* lla, sim::Vector3* positions, size_t count, double planetRadius)
+{
+	forEachBlock(count, [&] (size_t begin, size_t size) {
+		ComponentBlock in;
+		for (size_t i = 0; i < size; ++i)
+		{
+			const sim::LatLonAlt& v = lla[begin + i];
+			in.c0[i] = v.lat;
+			in.c1[i] = v.lon;
+			in.c2[i] = v.alt;
+		}
+
+		ComponentBlock out;
+		for (size_t i = 0; i < size; ++i)
+		{
+			double sinLat, cosLat, sinLon, cosLon;
+			sinCosKernel(in.c0[i], sinLat, cosLat);
+			sinCosKernel(in.c1[i], sinLon, cosLon);
+			double r = planetRadius + in.c2[i];
+			out.c0[i] = cosLon * cosLat * r;
+			out.c1[i] = sinLon * cosLat * r;
+			out.c2[i] = sinLat * r;
+		}
+
+		for (size_t i = 0; i < size; ++i)
+		{
+			positions[begin + i] = sim::Vector3(out.c0[i], out.c1[i], out.c2[i]);
+		}
+	});
+}
+
+void geocentricToLla(const sim::Vector3* positions, sim::LatLonAlt* lla, size_t count, double planetRadius)
+{
+	forEachBlock(count, [&] (size_t begin, size_t size) {
+		ComponentBlock in;
+		for (size_t i = 0; i < size; ++i)
+		{
+			const sim::Vector3& v = positions[begin + i];
+			in.c0[i] = v.x;
+			in.c1[i] = v.y;
+			in.c2[i] = v.z;
+		}
+
+		ComponentBlock out;
+		for (size_t i = 0; i < size; ++i)
+		{
+			double x = in.c0[i], y = in.c1[i], z = in.c2[i];
+			double p2 = x * x + y * y;
+			out.c0[i] = atan2Kernel(z, std::sqrt(p2));
+			out.c1[i] = atan2Kernel(y, x);
+			out.c2[i] = std::sqrt(p2 + z * z) - planetRadius;
+		}
+
+		for (size_t i = 0; i < size; ++i)
+		{
+			lla[begin + i] = sim::LatLonAlt(out.c0[i], out.c1[i], out.c2[i]);
+		}
+	});
+}
+
+void llaToGeocentric(const sim::LatLonAlt* lla, sim::Vector3* positions, size_t count, const Ellipsoid& ellipsoid)
+{
+	EllipsoidParams e(ellipsoid);
+	forEachBlock(count, [&] (size_t begin, size_t size) {
+		ComponentBlock in;
+		for (size_t i = 0; i < size; ++i)
+		{
+			const sim::LatLonAlt& v = lla[begin + i];
+			in.c0[i] = v.lat;
+			in.c1[i] = v.lon;
+			in.c2[i] = v.alt;
+		}
+
+		ComponentBlock out;
+		for (size_t i = 0; i < size; ++i)
+		{
+			double sinLat, cosLat, sinLon, cosLon;
+			sinCosKernel(in.c0[i], sinLat, cosLat);
+			sinCosKernel(in.c1[i], sinLon, cosLon);
+			double n = e.a / std::sqrt(1.0 - e.e2 * sinLat * sinLat);
+			double r = (n + in.c2[i]) * cosLat;
+			out.c0[i] = r * cosLon;
+			out.c1[i] = r * sinLon;
+			out.c2[i] = (n * (1.0 - e.e2) + in.c2[i]) * sinLat;
+		}
+
+		for (size_t i = 0; i < size; ++i)
+		{
+			positions[begin + i] = sim::Vector3(out.c0[i], out.c1[i], out.c2[i]);
+		}
+	});
+}
+
+void geocentricToLla(const sim::Vector3* positions, sim::LatLonAlt* lla, size_t count, const Ellipsoid& ellipsoid)
+{
+	EllipsoidParams e(ellipsoid);
+	forEachBlock(count, [&] (size_t begin, size_t size) {
+		ComponentBlock in;
+		for (size_t i = 0; i < size; ++i)
+		{
+			const sim::Vector3& v = positions[begin + i];
+			in.c0[i] = v.x;
+			in.c1[i] = v.y;
+			in.c2[i] = v.z;
+		}
+
+		double p[batchBlockSize];
+		double cubeRoots[batchBlockSize];
+		for (size_t i = 0; i < size; ++i)
+		{
+			p[i] = std::sqrt(in.c0[i] * in.c0[i] + in.c1[i] * in.c1[i]);
+			cubeRoots[i] = HeikkinenTerms(e, p[i], in.c2[i]).cubeRootArg;
+		}
+
+		// The cube root is not vectorizable on all platforms, so is evaluated in a separate loop
+		for (size_t i = 0; i < size; ++i)
+		{
+			cubeRoots[i] = std::cbrt(cubeRoots[i]);
+		}
+
+		ComponentBlock out;
+		for (size_t i = 0; i < size; ++i)
+		{
+			HeikkinenTerms(e, p[i], in.c2[i]).calcLatAlt(e, p[i], in.c2[i], cubeRoots[i], out.c0[i], out.c2[i]);
+			out.c1[i] = atan2Kernel(in.c1[i], in.c0[i]);
+		}
+
+		for (size_t i = 0; i < size; ++i)
+		{
+			lla[begin + i] = sim::LatLonAlt(out.c0[i], out.c1[i], out.c2[i]);
+		}
+	});
+}
+
 sim::Quaternion latLonToGeocentricLtpOrientation(const sim::LatLon& latLon)
 {
 	return glm::angleAxis(latLon.lon, sim::Vector3(0, 0, 1)) * glm::angleAxis(latLon.lat + skybolt::math::halfPiD(), sim::Vector3(0, -1, 0)); // Note: sim::Quaternion rotation order is different to OSG::Quat
@@ -10,9 +10,24 @@
 #include "SkyboltSim/Spatial/LatLon.h"
 #include "SkyboltSim/Spatial/LatLonAlt.h"
 
+#include <stddef.h>
+
 namespace skybolt {
 namespace sim {
 
+//! Oblate ellipsoid of revolution about the Z axis
+struct Ellipsoid
+{
+	double equatorialRadius;
+	double polarRadius;
+};
+
+inline const Ellipsoid& wgs84Ellipsoid()
+{
+	static Ellipsoid e{6378137.0, 6356752.314245};
+	return e;
+}
+
 //! Convert Lat-Long-Altitude to Earth-Centred-Earth-Fixed (ECEF) coordinates.
 //! Right handed coordinate system where +X is through 0 latitude and 0 longitude, +ve Z is through the north pole.
 Vector3 llaToGeocentric(const LatLonAlt& lla, double planetRadius);
@@ -21,6 +36,28 @@ LatLonAlt geocentricToLla(const Vector3& pos, double planetRadius);
 
 LatLon geocentricToLatLon(const Vector3& pos);
 
+//! Convert geodetic Lat-Long-Altitude on an ellipsoid to Earth-Centred-Earth-Fixed (ECEF) coordinates.
+//! Altitude is measured along the ellipsoid normal.
+Vector3 llaToGeocentric(const LatLonAlt& lla, const Ellipsoid& ellipsoid);
+
+//! Convert ECEF coordinates to geodetic Lat-Long-Altitude on an ellipsoid, using Heikkinen's closed form solution.
+//! Accurate to within 1e-9 radians and 1e-6 meters for points between the center of the earth and beyond geostationary orbit,
+//! excluding points within 100 km of the center.
+LatLonAlt geocentricToLla(const Vector3& pos, const Ellipsoid& ellipsoid);
+
+//! Batched conversions between Lat-Long-Altitude and ECEF coordinates.
+//! These are faster than converting positions individually, and are intended for converting positions of many entities each frame.
+//! Positions are converted in blocks with branch free trigonometric approximations which compilers can vectorize.
+//! Results are within 1e-7 meters and 1e-14 radians of the individual conversion functions, except at the poles where
+//! geocentricToLla() gives a latitude of +/- pi/2 rather than 0.
+//! @param count is the number of elements in the input and output arrays
+//! @{
+void llaToGeocentric(const LatLonAlt* lla, Vector3* positions, size_t count, double planetRadius);
+void geocentricToLla(const Vector3* positions, LatLonAlt* lla, size_t count, double planetRadius);
+void llaToGeocentric(const LatLonAlt* lla, Vector3* positions, size_t count, const Ellipsoid& ellipsoid);
+void geocentricToLla(const Vector3* positions, LatLonAlt* lla, size_t count, const Ellipsoid& ellipsoid);
+//! @}
+
 //! Returns the orientation of the north-east-down local-tangent-plane relative to geocentric axes
 Quaternion latLonToGeocentricLtpOrientation(const LatLon& latLon);
 
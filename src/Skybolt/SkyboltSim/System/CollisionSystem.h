@@ -6,8 +6,7 @@
 
 #pragma once
 
-#include <SkyboltCommon/Event.h>
-#include <SkyboltCommon/SkyboltCommonFwd.h>
+#include <SkyboltCommon/EventChannel.h>
 #include <SkyboltSim/EntityId.h>
 #include <SkyboltSim/System/System.h>
 
@@ -15,7 +14,7 @@
 
 namespace skybolt::sim {
 
-struct CollisionEvent : public Event
+struct CollisionEvent
 {
 	EntityId entityA;
 	EntityId entityB;
@@ -35,7 +34,8 @@ class CollisionSystem : public System
 {
 public:
 	~CollisionSystem() override = default;
-	EventEmitterPtr getEventEmitter() const { return mEventEmitter; }
+	//! Collision events are published during each dynamics substep and dispatched to listeners at UpdateStage::PostDynamicsSubStep
+	EventChannel<CollisionEvent>& getCollisionEvents() { return mCollisionEvents; }
 
 	virtual std::optional<RayIntersectionResult> intersectRay(const Vector3 &position, const Vector3 &direction, double length, int collisionFilterMask) const
 	{
@@ -46,7 +46,7 @@ public:
 	virtual std::optional<RayIntersectionResult> intersectRay(const Vector3 &start, const Vector3 &end, int collisionFilterMask) const { return std::nullopt; };
 
 protected:
-	EventEmitterPtr mEventEmitter = std::make_shared<EventEmitter>();
+	EventChannel<CollisionEvent> mCollisionEvents;
 };
 
 } // namespace skybolt::sim
\ No newline at end of file
@@ -0,0 +1,120 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+
+#include "PlanetFrameSystem.h"
+#include "SkyboltSim/Components/PlanetComponent.h"
+#include "SkyboltSim/Spatial/Geocentric.h"
+#include <SkyboltCommon/Math/MathUtility.h>
+#include <SkyboltCommon/Profiling/Profiler.h>
+
+#include <algorithm>
+#include <assert.h>
+
+namespace skybolt {
+namespace sim {
+
+PlanetFrame createPlanetFrame(Entity* planet)
+{
+	PlanetFrame frame;
+	frame.planet = planet;
+	frame.radius = planet->getFirstComponent<PlanetComponent>()->radius;
+	frame.position = getPosition(*planet).value_or(math::dvec3Zero());
+	frame.orientation = getOrientation(*planet).value_or(math::dquatIdentity());
+	frame.transform = getTransform(*planet).value_or(math::dmat4Identity());
+	frame.inverseTransform = glm::inverse(frame.transform);
+	return frame;
+}
+
+PlanetFrameSystem::PlanetFrameSystem(World* world) :
+	mWorld(world)
+{
+	assert(mWorld);
+	for (const EntityPtr& entity : mWorld->getEntities())
+	{
+		entityAdded(entity);
+	}
+	mWorld->addListener(this);
+}
+
+PlanetFrameSystem::~PlanetFrameSystem()
+{
+	mWorld->removeListener(this);
+}
+
+void PlanetFrameSystem::updateFrames()
+{
+	SKYBOLT_PROFILE_ZONE("PlanetFrameSystem::updateFrames");
+	updatePlanetFrames();
+}
+
+const PlanetFrame* PlanetFrameSystem::findNearestPlanetFrame(const Vector3& position) const
+{
+	const PlanetFrame* result = nullptr;
+	double resultDistanceSq = 0;
+	for (const PlanetFrame& frame : mPlanetFrames)
+	{
+		Vector3 diff = position - frame.position;
+		double distanceSq = glm::dot(diff, diff);
+		if (!result || distanceSq < resultDistanceSq)
+		{
+			result = &frame;
+			resultDistanceSq = distanceSq;
+		}
+	}
+	return result;
+}
+
+std::optional<PlanetRelativeState> PlanetFrameSystem::getPlanetRelativeState(const Vector3& position) const
+{
+	const PlanetFrame* frame = findNearestPlanetFrame(position);
+	if (!frame)
+	{
+		return std::nullopt;
+	}
+
+	PlanetRelativeState state;
+	state.planetFrameIndex = int(frame - mPlanetFrames.data());
+	state.position = frame->inverseTransform * glm::dvec4(position, 1.0);
+	state.latLonAlt = geocentricToLla(state.position, frame->radius);
+	return state;
+}
+
+std::optional<PlanetRelativeState> PlanetFrameSystem::getPlanetRelativeState(const Entity& entity) const
+{
+	std::optional<Vector3> position = getPosition(entity);
+	return position ? getPlanetRelativeState(*position) : std::nullopt;
+}
+
+void PlanetFrameSystem::entityAdded(const EntityPtr& entity)
+{
+	if (entity->getFirstComponent<PlanetComponent>())
+	{
+		mPlanets.push_back(entity.get());
+		updatePlanetFrames(); // Make the planet available to consumers before the next update
+	}
+}
+
+void PlanetFrameSystem::entityAboutToBeRemoved(const EntityPtr& entity)
+{
+	if (auto i = std::find(mPlanets.begin(), mPlanets.end(), entity.get()); i != mPlanets.end())
+	{
+		mPlanets.erase(i);
+		updatePlanetFrames();
+	}
+}
+
+void PlanetFrameSystem::updatePlanetFrames()
+{
+	mPlanetFrames.clear();
+	for (Entity* planet : mPlanets)
+	{
+		mPlanetFrames.push_back(createPlanetFrame(planet));
+	}
+}
+
+} // namespace sim
+} // namespace skybolt
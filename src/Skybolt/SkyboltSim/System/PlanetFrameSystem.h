@@ -0,0 +1,82 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+
+#pragma once
+
+#include "SkyboltSim/SkyboltSimFwd.h"
+#include "SkyboltSim/World.h"
+#include "SkyboltSim/Spatial/LatLonAlt.h"
+#include "System.h"
+
+#include <optional>
+#include <vector>
+
+namespace skybolt {
+namespace sim {
+
+struct PlanetFrame
+{
+	Entity* planet;
+	double radius;
+	Vector3 position;
+	Quaternion orientation;
+	Matrix4 transform; //!< Planet space to world space
+	Matrix4 inverseTransform; //!< World space to planet space
+};
+
+//! @param planet must have a PlanetComponent
+PlanetFrame createPlanetFrame(Entity* planet);
+
+struct PlanetRelativeState
+{
+	int planetFrameIndex; //!< Index of the nearest planet in PlanetFrameSystem::getPlanetFrames()
+	Vector3 position; //!< Position in the planet's frame
+	LatLonAlt latLonAlt; //!< Altitude is above the planet's radius
+};
+
+//! Caches the frame of each planet so that consumers do not need to search the world for planets or invert planet transforms.
+//! The cache is updated at UpdateStage::PlanetFrames, once entities are in their final positions for the step.
+//! Consumers that update before this stage see the previous step's planet frames.
+//! Entity states relative to planets are calculated on request, so that entities nobody queries cost nothing.
+class PlanetFrameSystem : public System, public WorldListener
+{
+public:
+	PlanetFrameSystem(World* world);
+	~PlanetFrameSystem() override;
+
+	SKYBOLT_BEGIN_REGISTER_UPDATE_HANDLERS
+		SKYBOLT_REGISTER_UPDATE_HANDLER(UpdateStage::PlanetFrames, updateFrames)
+	SKYBOLT_END_REGISTER_UPDATE_HANDLERS
+
+	void updateFrames();
+
+	const std::vector<PlanetFrame>& getPlanetFrames() const { return mPlanetFrames; }
+
+	//! @returns null if there are no planets
+	const PlanetFrame* findNearestPlanetFrame(const Vector3& position) const;
+
+	//! @returns nullopt if there are no planets
+	std::optional<PlanetRelativeState> getPlanetRelativeState(const Vector3& position) const;
+
+	//! @returns nullopt if the entity has no position or there are no planets
+	std::optional<PlanetRelativeState> getPlanetRelativeState(const Entity& entity) const;
+
+public: // WorldListener interface
+	void entityAdded(const EntityPtr& entity) override;
+	void entityAboutToBeRemoved(const EntityPtr& entity) override;
+
+private:
+	void updatePlanetFrames();
+
+private:
+	World* mWorld;
+	std::vector<Entity*> mPlanets;
+	std::vector<PlanetFrame> mPlanetFrames;
+};
+
+} // namespace sim
+} // namespace skybolt
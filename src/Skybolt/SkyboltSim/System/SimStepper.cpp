@@ -6,7 +6,12 @@
 
 #include "SimStepper.h"
 #include "SkyboltSim/System/System.h"
+#include <SkyboltCommon/Profiling/Profiler.h>
 #include <assert.h>
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <typeinfo>
 
 namespace skybolt {
 namespace sim {
@@ -31,21 +36,72 @@ void SimStepper::setTime(SecondsD t)
 	}
 }
 
+static const char* getProfileZoneName(UpdateStage stage)
+{
+	switch (stage)
+	{
+	case UpdateStage::Input: return "UpdateStage::Input";
+	case UpdateStage::BeginStateUpdate: return "UpdateStage::BeginStateUpdate";
+	case UpdateStage::PreDynamicsSubStep: return "UpdateStage::PreDynamicsSubStep";
+	case UpdateStage::DynamicsSubStep: return "UpdateStage::DynamicsSubStep";
+	case UpdateStage::PostDynamicsSubStep: return "UpdateStage::PostDynamicsSubStep";
+	case UpdateStage::EndStateUpdate: return "UpdateStage::EndStateUpdate";
+	case UpdateStage::Attachments: return "UpdateStage::Attachments";
+	case UpdateStage::PlanetFrames: return "UpdateStage::PlanetFrames";
+	case UpdateStage::Output: return "UpdateStage::Output";
+	}
+	return "UpdateStage";
+}
+
 void SimStepper::update(SecondsD dt)
+{
+	SKYBOLT_PROFILE_ZONE("SimStepper::update");
+	beginUpdate();
+	updateDynamics(dt);
+	endUpdate();
+}
+
+void SimStepper::beginUpdate()
 {
 	auto systems = *mSystems; // Take copy in case a system adds/removes another system during step
 
 	updateSystem(systems, UpdateStage::Input);
 	updateSystem(systems, UpdateStage::BeginStateUpdate);
+}
+
+void SimStepper::updateDynamics(SecondsD dt)
+{
+	mStats.substepCount = 0;
+	mStats.droppedTime = 0;
 
 	if (mDynamicsEnabled && dt > 0)
 	{
+		auto systems = *mSystems;
 		updateDynamicsStep(systems, dt);
 	}
+}
+
+void SimStepper::endUpdate()
+{
+	auto systems = *mSystems;
 
 	updateSystem(systems, UpdateStage::EndStateUpdate);
 	updateSystem(systems, UpdateStage::Attachments);
+	updateSystem(systems, UpdateStage::PlanetFrames);
 	updateSystem(systems, UpdateStage::Output);
+
+	mPublishedStats = mStats;
+}
+
+int SimStepper::getMaxSubsteps() const
+{
+	int maxSteps = mMaxDynamicsSubsteps.value_or(INT_MAX);
+	if (mMaxDynamicsDuration && mStats.averageSubstepCost > 0)
+	{
+		double budgetSteps = *mMaxDynamicsDuration / mStats.averageSubstepCost;
+		maxSteps = std::min(maxSteps, std::max(1, int(std::min(budgetSteps, double(INT_MAX)))));
+	}
+	return maxSteps;
 }
 
 void SimStepper::updateDynamicsStep(const std::vector<SystemPtr>& systems, SecondsD dt)
@@ -53,38 +109,75 @@ void SimStepper::updateDynamicsStep(const std::vector<SystemPtr>& systems, Secon
 	assert(mDynamicsEnabled);
 
 	// Calculate required number of substeps
-	double newStepTimer = mStepTimer + dt;
-
-	int requiredSteps = int(newStepTimer / mDynamicsStepSize);
-	if (mMaxDynamicsSubsteps && requiredSteps > *mMaxDynamicsSubsteps)
+	SecondsD pendingTime = mStepTimer + dt;
+	int requiredSteps = int(pendingTime / mDynamicsStepSize);
+	int steps = requiredSteps;
+	SecondsD stepSize = mDynamicsStepSize;
+	mStepTimer = pendingTime - requiredSteps * mDynamicsStepSize;
+
+	int maxSteps = getMaxSubsteps();
+	if (requiredSteps > maxSteps)
 	{
-		requiredSteps = *mMaxDynamicsSubsteps;
-		double dt = (double)*mMaxDynamicsSubsteps * mDynamicsStepSize;
-		newStepTimer = mStepTimer + dt;
+		steps = maxSteps;
+		SecondsD excessTime = (requiredSteps - steps) * mDynamicsStepSize;
+
+		switch (mOverloadPolicy)
+		{
+		case DynamicsOverloadPolicy::Drop:
+			mStats.droppedTime = excessTime;
+			break;
+		case DynamicsOverloadPolicy::Stretch:
+			stepSize = std::min(requiredSteps * mDynamicsStepSize / steps, mDynamicsStepSize * mMaxStretchFactor);
+			mStats.droppedTime = requiredSteps * mDynamicsStepSize - steps * stepSize;
+			break;
+		case DynamicsOverloadPolicy::CatchUp:
+		{
+			SecondsD carriedTime = std::min(excessTime, mMaxBacklog);
+			mStepTimer += carriedTime;
+			mStats.droppedTime = excessTime - carriedTime;
+			break;
+		}
+		}
 	}
 
-	mStepTimer = newStepTimer - requiredSteps * mDynamicsStepSize;
+	mStats.substepCount = steps;
+	mStats.substepSize = stepSize;
+	mStats.totalDroppedTime += mStats.droppedTime;
+	mStats.backlog = mStepTimer;
 
 	// Perform substeps
-	for (int i = 0; i < requiredSteps; i++)
+	for (int i = 0; i < steps; i++)
 	{
-		mCurrentTime += mDynamicsStepSize;
+		auto startTime = std::chrono::steady_clock::now();
+
+		mCurrentTime += stepSize;
 
 		updateSystem(systems, UpdateStage::PreDynamicsSubStep);
 
-		for (const SystemPtr& system : *mSystems)
 		{
-			system->advanceSimTime(mCurrentTime, mDynamicsStepSize);
+			SKYBOLT_PROFILE_ZONE("advanceSimTime");
+			for (const SystemPtr& system : *mSystems)
+			{
+				SKYBOLT_PROFILE_ZONE(typeid(*system).name());
+				system->advanceSimTime(mCurrentTime, stepSize);
+			}
 		}
 		updateSystem(systems, UpdateStage::DynamicsSubStep);
 		updateSystem(systems, UpdateStage::PostDynamicsSubStep);
+
+		// Update the moving average of substep cost, used to budget substeps
+		double cost = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+		constexpr double smoothing = 0.1;
+		mStats.averageSubstepCost = (mStats.averageSubstepCost > 0) ? mStats.averageSubstepCost + (cost - mStats.averageSubstepCost) * smoothing : cost;
 	}
 }
 
 void SimStepper::updateSystem(const std::vector<SystemPtr>& systems, UpdateStage stage)
 {
+	SKYBOLT_PROFILE_ZONE(getProfileZoneName(stage));
 	for (const SystemPtr& system : systems)
 	{
+		SKYBOLT_PROFILE_ZONE(typeid(*system).name());
 		system->update(stage);
 	}
 }
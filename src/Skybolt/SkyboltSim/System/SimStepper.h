@@ -16,6 +16,24 @@
 namespace skybolt {
 namespace sim {
 
+//! Determines what happens to sim time which cannot be simulated within an update's substep limit
+enum class DynamicsOverloadPolicy
+{
+	Drop, //!< Discard the excess time. The simulation runs slower than real time while overloaded.
+	Stretch, //!< Lengthen substeps, up to a maximum factor, to cover the excess time at the cost of accuracy
+	CatchUp //!< Carry the excess time into later updates, up to a maximum backlog, then drop the remainder
+};
+
+struct SimStepperStats
+{
+	int substepCount = 0; //!< Number of substeps performed in the last update
+	SecondsD substepSize = 0; //!< Size of substeps performed in the last update
+	double averageSubstepCost = 0; //!< Moving average of wall clock seconds taken per substep
+	SecondsD droppedTime = 0; //!< Sim time dropped in the last update
+	SecondsD totalDroppedTime = 0; //!< Sim time dropped since the SimStepper was created
+	SecondsD backlog = 0; //!< Sim time carried over to the next update
+};
+
 class SimStepper
 {
 public:
@@ -27,13 +45,34 @@ public:
 
 	void update(SecondsD dt);
 
+	//! The phases of update(), which may be called separately to run the dynamics concurrently with other work.
+	//! Calling beginUpdate(), updateDynamics() and endUpdate() in sequence is equivalent to calling update().
+	//! @{
+	void beginUpdate();
+	void updateDynamics(SecondsD dt);
+	void endUpdate();
+	//! @}
+
 	void setDynamicsEnabled(bool enabled) { mDynamicsEnabled = enabled; }
 
 	void setDynamicsStepSize(double stepSize) { mDynamicsStepSize = stepSize; }
 	void setMaxDynamicsSubsteps(const std::optional<int>& substeps) { mMaxDynamicsSubsteps = substeps; }
 
+	//! Limits the wall clock seconds spent on dynamics per update.
+	//! The substep limit is derived from the measured cost of recent substeps.
+	void setMaxDynamicsDuration(const std::optional<double>& seconds) { mMaxDynamicsDuration = seconds; }
+
+	void setOverloadPolicy(DynamicsOverloadPolicy policy) { mOverloadPolicy = policy; }
+	void setMaxStretchFactor(double factor) { mMaxStretchFactor = factor; } //!< Used by DynamicsOverloadPolicy::Stretch
+	void setMaxBacklog(SecondsD backlog) { mMaxBacklog = backlog; } //!< Used by DynamicsOverloadPolicy::CatchUp
+
+	//! @returns stats of the last completed update. Stats are published by endUpdate(),
+	//! so may be read on the calling thread while updateDynamics() runs on another thread.
+	const SimStepperStats& getStats() const { return mPublishedStats; }
+
 private:
 	void updateDynamicsStep(const std::vector<SystemPtr>& systems, SecondsD dt);
+	int getMaxSubsteps() const;
 
 	void updateSystem(const std::vector<SystemPtr>& systems, UpdateStage stage);
 
@@ -45,6 +84,13 @@ private:
 
 	double mDynamicsStepSize = 1.0 / 60.0;
 	std::optional<int> mMaxDynamicsSubsteps = 10;
+	std::optional<double> mMaxDynamicsDuration;
+	DynamicsOverloadPolicy mOverloadPolicy = DynamicsOverloadPolicy::Drop;
+	double mMaxStretchFactor = 4;
+	SecondsD mMaxBacklog = 0.25;
+
+	SimStepperStats mStats;
+	SimStepperStats mPublishedStats;
 };
 
 } // namespace sim
@@ -6,10 +6,14 @@
 
 
 #include <SkyboltSim/Physics/Atmosphere.h>
+#include <SkyboltSim/Physics/AtmosphereTable.h>
 #include <SkyboltCommon/NumericComparison.h>
 #include <catch2/catch.hpp>
 
 #include <assert.h>
+#include <chrono>
+#include <iostream>
+#include <limits>
 
 using namespace skybolt;
 using namespace skybolt::sim;
@@ -21,3 +25,80 @@ TEST_CASE("Atmosphere density matches reference data")
 	CHECK(almostEqualFracEpsilon(0.909122, atm.getDensity(3000), 0.001));
 	CHECK(almostEqualFracEpsilon(0.525168, atm.getDensity(8000), 0.001));
 }
+
+TEST_CASE("Atmosphere table matches analytic atmosphere")
+{
+	Atmosphere atm = createEarthAtmosphere();
+	AtmosphereTable table(atm);
+
+	for (double altitude = -100; altitude < 40000; altitude += 7.3)
+	{
+		AtmosphereState state = table.getState(altitude);
+		CHECK(std::abs(state.density - atm.getDensity(altitude)) < 1e-5 * 1.225);
+		CHECK(std::abs(state.pressure - atm.getPressure(altitude)) < 1e-5 * 101300);
+		CHECK(std::abs(state.temperature - atm.getTemperature(altitude)) < 1e-6);
+		CHECK(std::abs(state.speedOfSound - atm.getSpeedOfSound(altitude)) < 0.5);
+		CHECK(table.getDensity(altitude) == state.density);
+	}
+
+	CHECK(almostEqualFracEpsilon(340.3, table.getSpeedOfSound(0), 0.001));
+	CHECK(table.getDensity(atm.getMaxAltitude() + 1000) == 0);
+}
+
+TEST_CASE("Atmosphere table treats NaN altitude as lowest altitude")
+{
+	AtmosphereTable table(createEarthAtmosphere());
+	double altitude = std::numeric_limits<double>::quiet_NaN();
+	CHECK(table.getDensity(altitude) == table.getDensity(0));
+
+	double densities[2];
+	double altitudes[2] = {altitude, 1000};
+	table.getDensities(altitudes, densities, 2);
+	CHECK(densities[0] == table.getDensity(0));
+}
+
+TEST_CASE("Benchmark atmosphere density queries", "[.benchmark]")
+{
+	Atmosphere atm = createEarthAtmosphere();
+	AtmosphereTable table(atm);
+
+	const size_t queryCount = 1000000;
+	std::vector<double> altitudes(queryCount);
+	for (size_t i = 0; i < queryCount; ++i)
+	{
+		altitudes[i] = double((i * 7919) % 20000);
+	}
+	std::vector<double> densities(queryCount);
+
+	auto printRate = [&] (const std::string& method, std::chrono::steady_clock::time_point start) {
+		double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		double sum = 0;
+		for (double density : densities)
+		{
+			sum += density;
+		}
+		std::cout << method << ": " << queryCount / seconds / 1e6 << " million queries per second (checksum " << sum << ")" << std::endl;
+	};
+
+	{
+		auto start = std::chrono::steady_clock::now();
+		for (size_t i = 0; i < queryCount; ++i)
+		{
+			densities[i] = atm.getDensity(altitudes[i]);
+		}
+		printRate("Atmosphere::getDensity", start);
+	}
+	{
+		auto start = std::chrono::steady_clock::now();
+		for (size_t i = 0; i < queryCount; ++i)
+		{
+			densities[i] = table.getDensity(altitudes[i]);
+		}
+		printRate("AtmosphereTable::getDensity", start);
+	}
+	{
+		auto start = std::chrono::steady_clock::now();
+		table.getDensities(altitudes.data(), densities.data(), queryCount);
+		printRate("AtmosphereTable::getDensities", start);
+	}
+}
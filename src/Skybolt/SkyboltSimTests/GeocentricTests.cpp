@@ -11,12 +11,33 @@
 #include <SkyboltCommon/Math/MathUtility.h>
 #include <SkyboltCommon/NumericComparison.h>
 
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <vector>
+
 using namespace skybolt;
 using namespace skybolt::sim;
 
 constexpr double epsilon = 1e-8f;
 constexpr double altitude = 123;
 
+static std::vector<LatLonAlt> createRandomLlas(size_t count, double minAltitude, double maxAltitude)
+{
+	std::mt19937 generator(0);
+	// Exclude the poles, where longitude is undefined
+	std::uniform_real_distribution<double> latDistribution(-math::halfPiD() * 0.9999, math::halfPiD() * 0.9999);
+	std::uniform_real_distribution<double> lonDistribution(-math::piD(), math::piD());
+	std::uniform_real_distribution<double> altDistribution(minAltitude, maxAltitude);
+
+	std::vector<LatLonAlt> llas(count);
+	for (LatLonAlt& lla : llas)
+	{
+		lla = LatLonAlt(latDistribution(generator), lonDistribution(generator), altDistribution(generator));
+	}
+	return llas;
+}
+
 TEST_CASE("Zero lat, zero long converts to +X")
 {
 	LatLonAlt lla(0, 0, altitude);
@@ -51,6 +72,129 @@ TEST_CASE("Geocentric to LLA is reciprocal of LLA to Geocentric")
 	CHECK(almostEqual(lla, lla2, epsilon));
 }
 
+TEST_CASE("Batched spherical conversions match individual conversions")
+{
+	// Use a count which is not a multiple of the batch block size
+	std::vector<LatLonAlt> llas = createRandomLlas(1001, -10000, 40000000);
+
+	std::vector<Vector3> positions(llas.size());
+	llaToGeocentric(llas.data(), positions.data(), llas.size(), earthRadius());
+
+	std::vector<LatLonAlt> llas2(llas.size());
+	geocentricToLla(positions.data(), llas2.data(), llas.size(), earthRadius());
+
+	for (size_t i = 0; i < llas.size(); ++i)
+	{
+		REQUIRE(almostEqual(llaToGeocentric(llas[i], earthRadius()), positions[i], 1e-6));
+		REQUIRE(almostEqual(geocentricToLla(positions[i], earthRadius()), llas2[i], 1e-9));
+	}
+}
+
+TEST_CASE("WGS-84 LLA converts to Geocentric")
+{
+	const Ellipsoid& wgs84 = wgs84Ellipsoid();
+	CHECK(almostEqual(Vector3(wgs84.equatorialRadius + altitude, 0, 0), llaToGeocentric(LatLonAlt(0, 0, altitude), wgs84), epsilon));
+	CHECK(almostEqual(Vector3(0, 0, wgs84.polarRadius + altitude), llaToGeocentric(LatLonAlt(math::halfPiD(), 0, altitude), wgs84), epsilon));
+
+	// Reference position from GeographicLib's CartConvert
+	Vector3 pos = llaToGeocentric(LatLonAlt(0.5 * math::halfPiD(), 0, 0), wgs84);
+	CHECK(almostEqual(Vector3(4517590.878849, 0, 4487348.408866), pos, 1e-6));
+}
+
+TEST_CASE("Geocentric to WGS-84 LLA is reciprocal of WGS-84 LLA to Geocentric")
+{
+	const Ellipsoid& wgs84 = wgs84Ellipsoid();
+	std::vector<LatLonAlt> llas = createRandomLlas(1001, -10000, 40000000);
+
+	std::vector<Vector3> positions(llas.size());
+	llaToGeocentric(llas.data(), positions.data(), llas.size(), wgs84);
+
+	std::vector<LatLonAlt> llas2(llas.size());
+	geocentricToLla(positions.data(), llas2.data(), llas.size(), wgs84);
+
+	for (size_t i = 0; i < llas.size(); ++i)
+	{
+		REQUIRE(almostEqual(llaToGeocentric(llas[i], wgs84), positions[i], 1e-6));
+		REQUIRE(almostEqual(geocentricToLla(positions[i], wgs84), llas2[i], 1e-9));
+
+		REQUIRE(skybolt::almostEqual(llas[i].lat, llas2[i].lat, 1e-9));
+		REQUIRE(skybolt::almostEqual(llas[i].lon, llas2[i].lon, 1e-9));
+		REQUIRE(skybolt::almostEqual(llas[i].alt, llas2[i].alt, 1e-6));
+	}
+}
+
+TEST_CASE("Benchmark geocentric conversions", "[.benchmark]")
+{
+	const size_t count = 1000000;
+	std::vector<LatLonAlt> llas = createRandomLlas(count, -10000, 40000000);
+	std::vector<Vector3> positions(count);
+
+	auto printRate = [&] (const std::string& method, std::chrono::steady_clock::time_point start) {
+		double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		double sum = 0;
+		for (size_t i = 0; i < count; ++i)
+		{
+			sum += positions[i].x + llas[i].alt;
+		}
+		std::cout << method << ": " << count / seconds / 1e6 << " million conversions per second (checksum " << sum << ")" << std::endl;
+	};
+
+	{
+		auto start = std::chrono::steady_clock::now();
+		for (size_t i = 0; i < count; ++i)
+		{
+			positions[i] = llaToGeocentric(llas[i], earthRadius());
+		}
+		printRate("llaToGeocentric", start);
+	}
+	{
+		auto start = std::chrono::steady_clock::now();
+		llaToGeocentric(llas.data(), positions.data(), count, earthRadius());
+		printRate("Batched llaToGeocentric", start);
+	}
+	{
+		auto start = std::chrono::steady_clock::now();
+		for (size_t i = 0; i < count; ++i)
+		{
+			llas[i] = geocentricToLla(positions[i], earthRadius());
+		}
+		printRate("geocentricToLla", start);
+	}
+	{
+		auto start = std::chrono::steady_clock::now();
+		geocentricToLla(positions.data(), llas.data(), count, earthRadius());
+		printRate("Batched geocentricToLla", start);
+	}
+
+	const Ellipsoid& wgs84 = wgs84Ellipsoid();
+	{
+		auto start = std::chrono::steady_clock::now();
+		for (size_t i = 0; i < count; ++i)
+		{
+			positions[i] = llaToGeocentric(llas[i], wgs84);
+		}
+		printRate("WGS-84 llaToGeocentric", start);
+	}
+	{
+		auto start = std::chrono::steady_clock::now();
+		llaToGeocentric(llas.data(), positions.data(), count, wgs84);
+		printRate("Batched WGS-84 llaToGeocentric", start);
+	}
+	{
+		auto start = std::chrono::steady_clock::now();
+		for (size_t i = 0; i < count; ++i)
+		{
+			llas[i] = geocentricToLla(positions[i], wgs84);
+		}
+		printRate("WGS-84 geocentricToLla", start);
+	}
+	{
+		auto start = std::chrono::steady_clock::now();
+		geocentricToLla(positions.data(), llas.data(), count, wgs84);
+		printRate("Batched WGS-84 geocentricToLla", start);
+	}
+}
+
 TEST_CASE("LLA to Geocentric LTP Orientation")
 {
 	LatLonAlt lla(0.1, 0.2, altitude);
@@ -0,0 +1,123 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+
+#include "TestHelpers.h"
+#include <SkyboltSim/Entity.h>
+#include <SkyboltSim/World.h>
+#include <SkyboltSim/Components/Node.h>
+#include <SkyboltSim/Components/PlanetComponent.h>
+#include <SkyboltSim/Spatial/Geocentric.h>
+#include <SkyboltSim/System/PlanetFrameSystem.h>
+#include <SkyboltCommon/Math/MathUtility.h>
+#include <catch2/catch.hpp>
+
+#include <chrono>
+#include <iostream>
+
+using namespace skybolt;
+using namespace skybolt::sim;
+
+constexpr double epsilon = 1e-9;
+
+static EntityPtr createEntity(std::uint32_t id, const Vector3& position, const Quaternion& orientation = math::dquatIdentity())
+{
+	auto entity = std::make_shared<Entity>(EntityId({1, id}));
+	entity->addComponent(std::make_shared<Node>(position, orientation));
+	return entity;
+}
+
+static EntityPtr createPlanet(std::uint32_t id, const Vector3& position, const Quaternion& orientation, double radius)
+{
+	EntityPtr planet = createEntity(id, position, orientation);
+	planet->addComponent(std::make_shared<PlanetComponent>(radius));
+	return planet;
+}
+
+TEST_CASE("PlanetFrameSystem calculates entity states relative to nearest planet")
+{
+	World world;
+	EntityPtr planetA = createPlanet(1, Vector3(0, 0, 0), glm::angleAxis(math::halfPiD(), Vector3(0, 0, 1)), 10);
+	world.addEntity(planetA);
+
+	PlanetFrameSystem system(&world);
+
+	// Planets added after the system is created are tracked
+	EntityPtr planetB = createPlanet(2, Vector3(1000, 0, 0), math::dquatIdentity(), 20);
+	world.addEntity(planetB);
+	REQUIRE(system.getPlanetFrames().size() == 2);
+
+	EntityPtr nearA = createEntity(3, Vector3(15, 0, 0));
+	EntityPtr nearB = createEntity(4, Vector3(1030, 0, 0));
+	world.addEntity(nearA);
+	world.addEntity(nearB);
+	system.updateFrames();
+
+	const PlanetFrame* frame = system.findNearestPlanetFrame(Vector3(900, 0, 0));
+	REQUIRE(frame);
+	CHECK(frame->planet == planetB.get());
+
+	std::optional<PlanetRelativeState> stateA = system.getPlanetRelativeState(*nearA);
+	REQUIRE(stateA);
+	CHECK(system.getPlanetFrames()[stateA->planetFrameIndex].planet == planetA.get());
+	CHECK(almostEqual(stateA->position, Vector3(0, -15, 0), epsilon)); // Planet A is rotated 90 degrees about z
+	CHECK(almostEqual(stateA->latLonAlt, geocentricToLla(Vector3(0, -15, 0), 10), epsilon));
+	CHECK(stateA->latLonAlt.alt == Approx(5));
+
+	std::optional<PlanetRelativeState> stateB = system.getPlanetRelativeState(*nearB);
+	REQUIRE(stateB);
+	CHECK(system.getPlanetFrames()[stateB->planetFrameIndex].planet == planetB.get());
+	CHECK(almostEqual(stateB->position, Vector3(30, 0, 0), epsilon));
+	CHECK(stateB->latLonAlt.alt == Approx(10));
+
+	// States follow planets that move after the update
+	planetB->getFirstComponentRequired<Node>()->setPosition(Vector3(1010, 0, 0));
+	system.updateFrames();
+	stateB = system.getPlanetRelativeState(*nearB);
+	REQUIRE(stateB);
+	CHECK(stateB->latLonAlt.alt == Approx(0));
+
+	// Entities without a position have no state
+	auto unpositioned = std::make_shared<Entity>(EntityId({1, 5}));
+	CHECK(!system.getPlanetRelativeState(*unpositioned));
+
+	// Removing a planet removes its frame
+	world.removeEntity(planetB.get());
+	CHECK(system.getPlanetFrames().size() == 1);
+	stateB = system.getPlanetRelativeState(*nearB);
+	REQUIRE(stateB);
+	CHECK(system.getPlanetFrames()[stateB->planetFrameIndex].planet == planetA.get());
+}
+
+TEST_CASE("Benchmark PlanetFrameSystem queries", "[.benchmark]")
+{
+	World world;
+	world.addEntity(createPlanet(1, Vector3(0, 0, 0), math::dquatIdentity(), 6371000));
+
+	const int entityCount = 10000;
+	std::vector<EntityPtr> entities;
+	for (int i = 0; i < entityCount; ++i)
+	{
+		entities.push_back(createEntity(i + 2, llaToGeocentric(LatLonAlt(i * 1e-4, i * 2e-4, 1000), 6371000)));
+		world.addEntity(entities.back());
+	}
+
+	PlanetFrameSystem system(&world);
+
+	const int updateCount = 100;
+	double altitudeSum = 0;
+	auto start = std::chrono::steady_clock::now();
+	for (int i = 0; i < updateCount; ++i)
+	{
+		system.updateFrames();
+		for (const EntityPtr& entity : entities)
+		{
+			altitudeSum += system.getPlanetRelativeState(*entity)->latLonAlt.alt;
+		}
+	}
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	std::cout << "PlanetFrameSystem query: " << seconds * 1e9 / (double(updateCount) * entityCount) << " ns per entity (checksum " << altitudeSum << ")" << std::endl;
+}
@@ -0,0 +1,124 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+
+#include <SkyboltSim/System/SimStepper.h>
+#include <SkyboltSim/System/System.h>
+#include <catch2/catch.hpp>
+
+#include <chrono>
+
+using namespace skybolt;
+using namespace skybolt::sim;
+
+namespace {
+
+//! Injects synthetic load into each dynamics substep
+class LoadSystem : public System
+{
+public:
+	void advanceSimTime(SecondsD newTime, SecondsD dt) override
+	{
+		auto end = std::chrono::steady_clock::now() + std::chrono::duration<double>(substepCost);
+		while (std::chrono::steady_clock::now() < end) {}
+
+		simTime = newTime;
+		lastSubstepSize = dt;
+	}
+
+	double substepCost = 0;
+	SecondsD simTime = 0;
+	SecondsD lastSubstepSize = 0;
+};
+
+struct StepperFixture
+{
+	StepperFixture()
+	{
+		systems->push_back(system);
+
+		// Binary fractions keep the expected times exact
+		stepper.setDynamicsStepSize(0.125);
+		stepper.setMaxDynamicsSubsteps(2);
+	}
+
+	std::shared_ptr<LoadSystem> system = std::make_shared<LoadSystem>();
+	SystemRegistryPtr systems = std::make_shared<SystemRegistry>();
+	SimStepper stepper{systems};
+};
+
+} // namespace
+
+TEST_CASE("SimStepper drops excess time when overloaded")
+{
+	StepperFixture f;
+	f.stepper.setOverloadPolicy(DynamicsOverloadPolicy::Drop);
+	f.stepper.update(0.5);
+
+	CHECK(f.stepper.getStats().substepCount == 2);
+	CHECK(f.stepper.getStats().droppedTime == 0.25);
+	CHECK(f.stepper.getTime() == 0.25);
+
+	f.stepper.update(0.5);
+	CHECK(f.stepper.getStats().totalDroppedTime == 0.5);
+}
+
+TEST_CASE("SimStepper stretches substeps when overloaded")
+{
+	StepperFixture f;
+	f.stepper.setOverloadPolicy(DynamicsOverloadPolicy::Stretch);
+	f.stepper.setMaxStretchFactor(4);
+	f.stepper.update(0.5);
+
+	CHECK(f.stepper.getStats().substepCount == 2);
+	CHECK(f.stepper.getStats().substepSize == 0.25);
+	CHECK(f.stepper.getStats().droppedTime == 0);
+	CHECK(f.stepper.getTime() == 0.5);
+	CHECK(f.system->lastSubstepSize == 0.25);
+
+	// Time beyond the maximum stretch is dropped
+	f.stepper.update(2.0);
+	CHECK(f.stepper.getStats().substepSize == 0.5);
+	CHECK(f.stepper.getStats().droppedTime == 1.0);
+	CHECK(f.stepper.getTime() == 1.5);
+}
+
+TEST_CASE("SimStepper catches up on excess time in later updates")
+{
+	StepperFixture f;
+	f.stepper.setOverloadPolicy(DynamicsOverloadPolicy::CatchUp);
+	f.stepper.setMaxBacklog(0.125);
+	f.stepper.update(0.5);
+
+	CHECK(f.stepper.getStats().substepCount == 2);
+	CHECK(f.stepper.getStats().droppedTime == 0.125);
+	CHECK(f.stepper.getStats().backlog == 0.125);
+	CHECK(f.stepper.getTime() == 0.25);
+
+	f.stepper.update(0.125);
+	CHECK(f.stepper.getStats().substepCount == 2);
+	CHECK(f.stepper.getStats().backlog == 0);
+	CHECK(f.stepper.getTime() == 0.5);
+}
+
+TEST_CASE("SimStepper limits substeps to the dynamics time budget")
+{
+	StepperFixture f;
+	f.stepper.setDynamicsStepSize(0.001);
+	f.stepper.setMaxDynamicsSubsteps(std::nullopt);
+	f.system->substepCost = 0.001;
+
+	// The first update measures the substep cost
+	f.stepper.update(0.01);
+	CHECK(f.stepper.getStats().substepCount == 10);
+	CHECK(f.stepper.getStats().averageSubstepCost >= 0.001);
+
+	f.stepper.setMaxDynamicsDuration(0.003);
+	f.stepper.update(0.01);
+	CHECK(f.stepper.getStats().substepCount >= 1);
+	CHECK(f.stepper.getStats().substepCount <= 3);
+	CHECK(f.stepper.getStats().droppedTime > 0);
+}
@@ -50,3 +50,10 @@ bool DefaultRootNode::isVisible() const
 {
 	return mSwitch->getChildValue(mTransform);
 }
+
+std::optional<osg::BoundingSphere> DefaultRootNode::getWorldBound() const
+{
+	// The transform's bound is in the coordinate frame of its parent, which is world space
+	const osg::BoundingSphere& bound = mTransform->getBound();
+	return bound.valid() ? std::optional<osg::BoundingSphere>(bound) : std::nullopt;
+}
@@ -33,6 +33,8 @@ public:
 	void setVisible(bool visible) override;
 	bool isVisible() const override;
 
+	std::optional<osg::BoundingSphere> getWorldBound() const override;
+
 protected:
 	osg::ref_ptr<osg::Switch> mSwitch;
 	osg::ref_ptr<osg::MatrixTransform> mTransform;
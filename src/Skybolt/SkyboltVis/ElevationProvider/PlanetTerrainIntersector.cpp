@@ -0,0 +1,472 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "PlanetTerrainIntersector.h"
+#include "SkyboltVis/Renderable/Planet/Tile/HeightMapElevationPyramid.h"
+#include <SkyboltCommon/Math/MathUtility.h>
+
+#include <px_sched/px_sched.h>
+
+#include <algorithm>
+#include <cmath>
+#include <mutex>
+
+namespace skybolt {
+namespace vis {
+
+namespace {
+
+//! Step length in meters used in regions without a height map when the ray is close to a region with a height map
+const double noDataMinStep = 1.0;
+
+//! Minimum scale of longitude texel size near the poles, which limits the number of steps taken by rays crossing a pole
+const double minPolarTexelScale = 0.01;
+
+//! Minimum scale of the sampling step when the ray is close to the terrain
+const double minGrazingStepScale = 0.125;
+
+//! Number of bisection iterations used to refine an intersection between two steps.
+//! Refines the intersection to within 1/4096 of the sampling step.
+const int refinementIterationCount = 12;
+
+//! Number of rays intersected by each task in a batch
+const size_t raysPerTask = 64;
+
+//! @returns a lower bound of sin(x) for x in [0, pi/2], which is cheaper than sin(x)
+double sinLowerBound(double x)
+{
+	return x - x * x * x * (1.0 / 6.0);
+}
+
+//! @returns a lower bound of sin(a), where a is the angle from a point inside a lon lat region to the nearest point on the region's boundary.
+//! The distance from a point at radius r to any point outside the region and above radius r is at least r times this value.
+double calcSinAngularDistanceToBoundary(const osg::Vec2d& lonLat, double cosLat, const Box2d& region)
+{
+	// Angular distance to a circle of latitude is the difference in latitude
+	double latDistance = std::min(lonLat.y() - region.minimum.y(), region.maximum.y() - lonLat.y());
+
+	// Angular distance to a meridian is measured to the meridian's great circle, which has sine cos(lat) * sin(lonDifference),
+	// or to the nearest pole if the meridian is more than 90 degrees away
+	double lonDifference = std::min(lonLat.x() - region.minimum.x(), region.maximum.x() - lonLat.x());
+
+	return std::max(0.0, std::min(
+		sinLowerBound(std::min(latDistance, math::halfPiD())),
+		cosLat * sinLowerBound(std::min(lonDifference, math::halfPiD()))));
+}
+
+QuadTreeTileKey getKeyContainingLonLat(int level, const osg::Vec2d& lonLat)
+{
+	QuadTreeTileKey key = getKeyAtLevelIntersectingLonLatPoint(level, lonLat);
+	key.x = std::clamp(key.x, 0, (2 << level) - 1);
+	key.y = std::clamp(key.y, 0, (1 << level) - 1);
+	return key;
+}
+
+bool isEmpty(const HeightMapElevationBounds& bounds)
+{
+	return bounds.x() > bounds.y();
+}
+
+//! @returns height map texel coordinate of a lon lat
+osg::Vec2d calcUv(const osg::Vec2d& lonLat, const osg::Vec2d& imageLonLatOrigin, const osg::Vec2d& texelsPerRadian)
+{
+	return osg::componentMultiply(lonLat - imageLonLatOrigin, texelsPerRadian);
+}
+
+float sampleElevation(const HeightMapElevationPyramid& pyramid, const osg::Vec2d& uv)
+{
+	return pyramid.getElevation(uv.x(), uv.y());
+}
+
+osg::Vec2d geocentricToLonLat(const osg::Vec3d& position, double radius)
+{
+	return osg::Vec2d(std::atan2(position.y(), position.x()), std::asin(math::clamp(position.z() / radius, -1.0, 1.0)));
+}
+
+} // namespace
+
+PlanetTerrainIntersector::PlanetTerrainIntersector(double planetRadius, int pyramidBlockSize) :
+	mPlanetRadius(planetRadius),
+	mPyramidBlockSize(pyramidBlockSize)
+{
+}
+
+PlanetTerrainIntersector::~PlanetTerrainIntersector() = default;
+
+void PlanetTerrainIntersector::addTile(const QuadTreeTileKey& key, const TileImage& heightMap)
+{
+	std::unique_lock<std::shared_mutex> lock(mMutex);
+
+	auto leaf = std::make_shared<Leaf>();
+	leaf->pyramid = getPyramid(heightMap.image);
+	leaf->lonLatBounds = getKeyLonLatBounds<osg::Vec2d>(key);
+
+	Box2d imageBounds = getKeyLonLatBounds<osg::Vec2d>(heightMap.key);
+	osg::Vec2d imageSize = imageBounds.size();
+	leaf->imageLonLatOrigin = imageBounds.minimum;
+	leaf->texelsPerRadian = osg::Vec2d(leaf->pyramid->getWidth() / imageSize.x(), leaf->pyramid->getHeight() / imageSize.y());
+	leaf->texelSize = osg::Vec2d(mPlanetRadius / leaf->texelsPerRadian.x(), mPlanetRadius / leaf->texelsPerRadian.y());
+
+	leaf->bounds = leaf->pyramid->getBounds(
+		calcUv(leaf->lonLatBounds.minimum, leaf->imageLonLatOrigin, leaf->texelsPerRadian),
+		calcUv(leaf->lonLatBounds.maximum, leaf->imageLonLatOrigin, leaf->texelsPerRadian));
+
+	mNodes[key].leaf = leaf;
+	updateNodeBounds(key);
+	updateAncestorBounds(key);
+}
+
+void PlanetTerrainIntersector::removeTile(const QuadTreeTileKey& key)
+{
+	std::unique_lock<std::shared_mutex> lock(mMutex);
+
+	auto it = mNodes.find(key);
+	if (it == mNodes.end())
+	{
+		return;
+	}
+	it->second.leaf = nullptr;
+	updateNodeBounds(key);
+	updateAncestorBounds(key);
+
+	for (auto i = mPyramids.begin(); i != mPyramids.end();)
+	{
+		i = i->second.expired() ? mPyramids.erase(i) : std::next(i);
+	}
+}
+
+void PlanetTerrainIntersector::clear()
+{
+	std::unique_lock<std::shared_mutex> lock(mMutex);
+	mNodes.clear();
+	mPyramids.clear();
+}
+
+std::shared_ptr<const HeightMapElevationPyramid> PlanetTerrainIntersector::getPyramid(const osg::ref_ptr<osg::Image>& image)
+{
+	// Descendant tiles often share their ancestor's height map, so pyramids are shared between tiles with the same image
+	std::weak_ptr<const HeightMapElevationPyramid>& weakPyramid = mPyramids[image.get()];
+	std::shared_ptr<const HeightMapElevationPyramid> pyramid = weakPyramid.lock();
+	if (!pyramid)
+	{
+		pyramid = std::make_shared<HeightMapElevationPyramid>(image, mPyramidBlockSize);
+		weakPyramid = pyramid;
+	}
+	return pyramid;
+}
+
+void PlanetTerrainIntersector::updateNodeBounds(const QuadTreeTileKey& key)
+{
+	auto it = mNodes.find(key);
+	if (it == mNodes.end())
+	{
+		return;
+	}
+
+	Node& node = it->second;
+	node.bounds = node.leaf ? node.leaf->bounds : emptyHeightMapElevationBounds();
+
+	for (int y = 0; y < 2; ++y)
+	{
+		for (int x = 0; x < 2; ++x)
+		{
+			auto child = mNodes.find(QuadTreeTileKey(key.level + 1, key.x * 2 + x, key.y * 2 + y));
+			if (child != mNodes.end())
+			{
+				expand(node.bounds, child->second.bounds);
+			}
+		}
+	}
+
+	if (!node.leaf && isEmpty(node.bounds))
+	{
+		mNodes.erase(it);
+	}
+}
+
+void PlanetTerrainIntersector::updateAncestorBounds(const QuadTreeTileKey& key)
+{
+	for (int level = key.level - 1; level >= 0; --level)
+	{
+		QuadTreeTileKey ancestorKey = createAncestorKey(key, level);
+		mNodes.try_emplace(ancestorKey, Node{emptyHeightMapElevationBounds(), nullptr});
+		updateNodeBounds(ancestorKey);
+	}
+}
+
+HeightMapElevationBounds PlanetTerrainIntersector::getGlobalBounds() const
+{
+	HeightMapElevationBounds bounds = emptyHeightMapElevationBounds();
+	for (int x = 0; x < 2; ++x)
+	{
+		auto it = mNodes.find(QuadTreeTileKey(0, x, 0));
+		if (it != mNodes.end())
+		{
+			expand(bounds, it->second.bounds);
+		}
+	}
+	return bounds;
+}
+
+const PlanetTerrainIntersector::Node* PlanetTerrainIntersector::findNode(const QuadTreeTileKey& key, NodePath& path) const
+{
+	size_t level = size_t(key.level);
+	if (level < path.size() && path[level].first == key)
+	{
+		return path[level].second;
+	}
+
+	auto it = mNodes.find(key);
+	const Node* node = (it == mNodes.end()) ? nullptr : &it->second;
+	if (level <= path.size())
+	{
+		path.resize(level);
+		path.emplace_back(key, node);
+	}
+	return node;
+}
+
+const PlanetTerrainIntersector::Leaf* PlanetTerrainIntersector::findLeaf(const osg::Vec2d& lonLat, NodePath& path) const
+{
+	for (int level = 0;; ++level)
+	{
+		const Node* node = findNode(getKeyContainingLonLat(level, lonLat), path);
+		if (!node)
+		{
+			return nullptr;
+		}
+		if (node->leaf)
+		{
+			return node->leaf.get();
+		}
+	}
+}
+
+std::optional<float> PlanetTerrainIntersector::getElevation(const sim::LatLon& position) const
+{
+	std::shared_lock<std::shared_mutex> lock(mMutex);
+
+	osg::Vec2d lonLat(position.lon, position.lat);
+	NodePath path;
+	const Leaf* leaf = findLeaf(lonLat, path);
+	if (!leaf)
+	{
+		return std::nullopt;
+	}
+	return sampleElevation(*leaf->pyramid, calcUv(lonLat, leaf->imageLonLatOrigin, leaf->texelsPerRadian));
+}
+
+double PlanetTerrainIntersector::calcSafeStep(const osg::Vec2d& lonLat, double altitude, double innerRadius, NodePath& path, double& minStep, const Leaf*& leaf) const
+{
+	// A region whose terrain is below the ray can be crossed safely. Each region gives a safe step which is the shorter of
+	// the distance to the region's boundary and the height of the ray above the region's maximum elevation.
+	// The longest of these steps over all regions containing the ray is used.
+	double bestStep = 0;
+	const double cosLat = std::cos(lonLat.y());
+	auto addRegion = [&] (const Box2d& region, const HeightMapElevationBounds* bounds) {
+		if (bounds && altitude - bounds->y() <= bestStep)
+		{
+			return; // Region can not give a longer step
+		}
+		// Rays are only marched above the inner radius, so points outside the region are at least this far away
+		double step = innerRadius * calcSinAngularDistanceToBoundary(lonLat, cosLat, region);
+		if (bounds)
+		{
+			step = std::min(step, altitude - bounds->y());
+		}
+		bestStep = std::max(bestStep, step);
+	};
+
+	leaf = nullptr;
+	minStep = noDataMinStep;
+
+	// Find bounds in the tile quad tree
+	for (int level = 0; !leaf; ++level)
+	{
+		QuadTreeTileKey key = getKeyContainingLonLat(level, lonLat);
+		Box2d region = getKeyLonLatBounds<osg::Vec2d>(key);
+		const Node* node = findNode(key, path);
+		if (!node)
+		{
+			// Region has no terrain
+			addRegion(region, nullptr);
+			return bestStep;
+		}
+		addRegion(region, &node->bounds);
+		leaf = node->leaf.get();
+	}
+
+	// Find bounds in the leaf's height map pyramid
+	const HeightMapElevationPyramid& pyramid = *leaf->pyramid;
+	osg::Vec2d uv = calcUv(lonLat, leaf->imageLonLatOrigin, leaf->texelsPerRadian);
+	for (int level = pyramid.getLevelCount() - 1; level >= 0; --level)
+	{
+		int x = pyramid.getBlockIndexX(level, uv.x());
+		int y = pyramid.getBlockIndexY(level, uv.y());
+		const HeightMapElevationBounds& bounds = pyramid.getBlockBounds(level, x, y);
+		if (altitude - bounds.y() <= bestStep)
+		{
+			continue; // Block can not give a longer step
+		}
+
+		std::pair<double, double> rangeX = pyramid.getBlockRangeX(level, x);
+		std::pair<double, double> rangeY = pyramid.getBlockRangeY(level, y);
+
+		// Clip block to the leaf, since the height map may cover more than the leaf
+		Box2d region(
+			osg::Vec2d(
+				std::max(leaf->lonLatBounds.minimum.x(), leaf->imageLonLatOrigin.x() + rangeX.first / leaf->texelsPerRadian.x()),
+				std::max(leaf->lonLatBounds.minimum.y(), leaf->imageLonLatOrigin.y() + rangeY.first / leaf->texelsPerRadian.y())),
+			osg::Vec2d(
+				std::min(leaf->lonLatBounds.maximum.x(), leaf->imageLonLatOrigin.x() + rangeX.second / leaf->texelsPerRadian.x()),
+				std::min(leaf->lonLatBounds.maximum.y(), leaf->imageLonLatOrigin.y() + rangeY.second / leaf->texelsPerRadian.y())));
+
+		addRegion(region, &bounds);
+	}
+
+	// Sample the height map at half-texel intervals. Longitude texels narrow towards the poles.
+	double lonTexelSize = leaf->texelSize.x() * std::max(minPolarTexelScale, cosLat);
+	minStep = 0.5 * std::min(lonTexelSize, leaf->texelSize.y());
+	return bestStep;
+}
+
+std::optional<TerrainRayIntersection> PlanetTerrainIntersector::intersectRay(const TerrainRay& ray) const
+{
+	std::shared_lock<std::shared_mutex> lock(mMutex);
+	return intersectRayUnlocked(ray);
+}
+
+std::vector<std::optional<TerrainRayIntersection>> PlanetTerrainIntersector::intersectRays(const std::vector<TerrainRay>& rays, px_sched::Scheduler* scheduler) const
+{
+	std::shared_lock<std::shared_mutex> lock(mMutex);
+
+	std::vector<std::optional<TerrainRayIntersection>> results(rays.size());
+	auto intersectRange = [this, &rays, &results] (size_t begin, size_t end) {
+		for (size_t i = begin; i < end; ++i)
+		{
+			results[i] = intersectRayUnlocked(rays[i]);
+		}
+	};
+
+	if (!scheduler || rays.size() <= raysPerTask)
+	{
+		intersectRange(0, rays.size());
+		return results;
+	}
+
+	px_sched::Sync sync;
+	for (size_t begin = 0; begin < rays.size(); begin += raysPerTask)
+	{
+		size_t end = std::min(rays.size(), begin + raysPerTask);
+		scheduler->run([&intersectRange, begin, end] {
+			intersectRange(begin, end);
+		}, &sync);
+	}
+	scheduler->waitFor(sync);
+	return results;
+}
+
+std::optional<TerrainRayIntersection> PlanetTerrainIntersector::intersectRayUnlocked(const TerrainRay& ray) const
+{
+	HeightMapElevationBounds globalBounds = getGlobalBounds();
+	if (isEmpty(globalBounds))
+	{
+		return std::nullopt;
+	}
+
+	const double innerRadius = std::max(0.0, mPlanetRadius + globalBounds.x());
+	const double outerRadius = mPlanetRadius + globalBounds.y();
+
+	// Clip the ray to the part which is inside the outer sphere and not beyond the inner sphere
+	double b = ray.origin * ray.direction;
+	double c = ray.origin.length2() - outerRadius * outerRadius;
+	double discriminant = b * b - c;
+	if (discriminant < 0)
+	{
+		return std::nullopt;
+	}
+	double sqrtDiscriminant = std::sqrt(discriminant);
+	double tBegin = std::max(0.0, -b - sqrtDiscriminant);
+	double tEnd = std::min(ray.maxDistance, -b + sqrtDiscriminant);
+
+	double innerDiscriminant = b * b - (ray.origin.length2() - innerRadius * innerRadius);
+	if (innerDiscriminant > 0)
+	{
+		double tInner = -b - std::sqrt(innerDiscriminant);
+		if (tInner >= 0)
+		{
+			tEnd = std::min(tEnd, tInner);
+		}
+	}
+
+	if (tBegin > tEnd)
+	{
+		return std::nullopt;
+	}
+
+	NodePath path;
+
+	// @returns altitude of the ray above the terrain at distance t, or nullopt if there is no terrain
+	auto calcHeightAboveTerrain = [&] (double t) -> std::optional<double> {
+		osg::Vec3d position = ray.origin + ray.direction * t;
+		double radius = position.length();
+		osg::Vec2d lonLat = geocentricToLonLat(position, radius);
+		const Leaf* leaf = findLeaf(lonLat, path);
+		if (!leaf)
+		{
+			return std::nullopt;
+		}
+		return radius - mPlanetRadius - sampleElevation(*leaf->pyramid, calcUv(lonLat, leaf->imageLonLatOrigin, leaf->texelsPerRadian));
+	};
+
+	double tPrev = tBegin;
+	double t = tBegin;
+	for (;;)
+	{
+		osg::Vec3d position = ray.origin + ray.direction * t;
+		double radius = position.length();
+		osg::Vec2d lonLat = geocentricToLonLat(position, radius);
+		double altitude = radius - mPlanetRadius;
+
+		double minStep;
+		const Leaf* leaf;
+		double step = calcSafeStep(lonLat, altitude, innerRadius, path, minStep, leaf);
+
+		// The ray can not be intersecting the terrain if a safe step exists, so the height map only needs to be sampled when close to the terrain
+		if (step < minStep && leaf)
+		{
+			float elevation = sampleElevation(*leaf->pyramid, calcUv(lonLat, leaf->imageLonLatOrigin, leaf->texelsPerRadian));
+			if (altitude > elevation)
+			{
+				// Shorten the step when skimming the terrain to reduce the chance of stepping over a grazing intersection
+				minStep = math::clamp(altitude - elevation, minStep * minGrazingStepScale, minStep);
+			}
+			else
+			{
+				// Refine the intersection between the previous step, which was above the terrain, and this step
+				double tAbove = tPrev;
+				double tBelow = t;
+				for (int i = 0; i < refinementIterationCount && tBelow - tAbove > 0; ++i)
+				{
+					double tMid = (tAbove + tBelow) * 0.5;
+					std::optional<double> height = calcHeightAboveTerrain(tMid);
+					(height && *height <= 0 ? tBelow : tAbove) = tMid;
+				}
+				return TerrainRayIntersection{tBelow, ray.origin + ray.direction * tBelow};
+			}
+		}
+
+		if (t >= tEnd)
+		{
+			return std::nullopt;
+		}
+		tPrev = t;
+		t = std::min(tEnd, t + std::max(step, minStep));
+	}
+}
+
+} // namespace vis
+} // namespace skybolt
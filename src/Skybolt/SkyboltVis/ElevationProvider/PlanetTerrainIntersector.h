@@ -0,0 +1,127 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#pragma once
+
+#include "SkyboltVis/OsgBox2.h"
+#include "SkyboltVis/Renderable/Planet/Tile/HeightMapElevationBounds.h"
+#include "SkyboltVis/Renderable/Planet/Tile/TileImage.h"
+#include <SkyboltCommon/Math/QuadTree.h>
+#include <SkyboltSim/Spatial/LatLon.h>
+
+#include <osg/Vec3d>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <shared_mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace px_sched {
+class Scheduler;
+}
+
+namespace skybolt {
+namespace vis {
+
+class HeightMapElevationPyramid;
+
+//! Ray in planet-fixed geocentric coordinates, with origin at the planet's center
+struct TerrainRay
+{
+	osg::Vec3d origin;
+	osg::Vec3d direction; //!< Must be unit length
+	double maxDistance = std::numeric_limits<double>::infinity();
+};
+
+struct TerrainRayIntersection
+{
+	double distance; //!< Distance along the ray from its origin
+	osg::Vec3d position; //!< Planet-fixed geocentric position
+};
+
+//! Intersects rays with terrain height maps on a spherical planet.
+//! Height maps are added per quad tree tile, typically the leaf tiles currently loaded by a PlanetSurface.
+//! Each height map is summarized by a HeightMapElevationPyramid, and the tile quad tree stores the elevation bounds of each tile's descendants.
+//! Rays are marched in steps which are guaranteed to stay above the terrain, using the coarsest bounds which allow the largest step,
+//! so that rays far above the terrain cross large regions in few steps. Near the terrain, the height map is sampled at half-texel intervals.
+//! Regions without a height map are treated as having no terrain.
+//! @ThreadSafe
+class PlanetTerrainIntersector
+{
+public:
+	//! @param pyramidBlockSize is the number of texel intervals spanned by each block at the finest level of the height map pyramids
+	PlanetTerrainIntersector(double planetRadius, int pyramidBlockSize = 4);
+	~PlanetTerrainIntersector();
+
+	//! Adds a leaf tile. Replaces any existing leaf tile with the same key.
+	//! @param heightMap is a 16 bit height map with HeightMapElevationRerange user data. It may be a height map for an ancestor of the key,
+	//! in which case the part of the height map covering the key is used.
+	void addTile(const QuadTreeTileKey& key, const TileImage& heightMap);
+
+	void removeTile(const QuadTreeTileKey& key);
+
+	void clear();
+
+	//! @returns elevation at the position, or nullopt if no tile covers the position
+	std::optional<float> getElevation(const sim::LatLon& position) const;
+
+	//! @returns the first intersection of the ray with the terrain within the ray's max distance, or nullopt if there is none
+	std::optional<TerrainRayIntersection> intersectRay(const TerrainRay& ray) const;
+
+	//! Intersects a batch of rays.
+	//! @param scheduler is used to intersect the rays in parallel. If null, the rays are intersected on the calling thread.
+	//! @returns intersections in the same order as the rays
+	std::vector<std::optional<TerrainRayIntersection>> intersectRays(const std::vector<TerrainRay>& rays, px_sched::Scheduler* scheduler = nullptr) const;
+
+private:
+	struct Leaf
+	{
+		std::shared_ptr<const HeightMapElevationPyramid> pyramid;
+		Box2d lonLatBounds; //!< Bounds of the tile
+		osg::Vec2d imageLonLatOrigin; //!< Lon lat of the height map's first texel
+		osg::Vec2d texelsPerRadian; //!< Height map texels per radian of longitude and latitude
+		osg::Vec2d texelSize; //!< Height map texel size in meters along longitude at the equator, and along latitude
+		HeightMapElevationBounds bounds; //!< Bounds of the part of the height map covering the tile
+	};
+
+	struct Node
+	{
+		HeightMapElevationBounds bounds; //!< Bounds of the leaf, if any, and all descendants
+		std::shared_ptr<const Leaf> leaf;
+	};
+
+	std::shared_ptr<const HeightMapElevationPyramid> getPyramid(const osg::ref_ptr<osg::Image>& image);
+	void updateAncestorBounds(const QuadTreeTileKey& key);
+	void updateNodeBounds(const QuadTreeTileKey& key);
+	HeightMapElevationBounds getGlobalBounds() const;
+
+	//! Keys and nodes, indexed by level, of the tiles containing the most recently queried position.
+	//! Successive positions along a ray are usually in the same tiles, so the path avoids repeating node lookups.
+	using NodePath = std::vector<std::pair<QuadTreeTileKey, const Node*>>;
+
+	//! @returns node with the given key, or null if there is none
+	const Node* findNode(const QuadTreeTileKey& key, NodePath& path) const;
+
+	const Leaf* findLeaf(const osg::Vec2d& lonLat, NodePath& path) const;
+
+	//! @param[out] minStep is the step length to use if the returned step is too small
+	//! @returns the longest step length in meters which is guaranteed not to intersect the terrain
+	double calcSafeStep(const osg::Vec2d& lonLat, double altitude, double innerRadius, NodePath& path, double& minStep, const Leaf*& leaf) const;
+
+	std::optional<TerrainRayIntersection> intersectRayUnlocked(const TerrainRay& ray) const;
+
+private:
+	const double mPlanetRadius;
+	const int mPyramidBlockSize;
+
+	mutable std::shared_mutex mMutex;
+	std::unordered_map<QuadTreeTileKey, Node> mNodes;
+	std::unordered_map<const osg::Image*, std::weak_ptr<const HeightMapElevationPyramid>> mPyramids;
+};
+
+} // namespace vis
+} // namespace skybolt
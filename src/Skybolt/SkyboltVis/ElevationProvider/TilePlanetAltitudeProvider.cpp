@@ -22,7 +22,7 @@ static vis::Box2f toBox2f(const BlockingTilePlanetAltitudeProvider::LatLonBounds
 BlockingTilePlanetAltitudeProvider::BlockingTilePlanetAltitudeProvider(const TileSourcePtr& tileSource, int maxLod) :
 	mTileSource(tileSource),
 	mMaxLod(maxLod),
-	mTileImageCache(1024)
+	mTileImageCache(tileImageCacheCapacityBytes, [] (const TileImage& image) { return size_t(image.image->getTotalSizeInBytes()); })
 {
 	assert(mTileSource);
 }
@@ -62,7 +62,6 @@ BlockingTilePlanetAltitudeProvider::AltitudeResult BlockingTilePlanetAltitudePro
 std::optional<BlockingTilePlanetAltitudeProvider::TileImage> BlockingTilePlanetAltitudeProvider::findTile(const QuadTreeTileKey& key) const
 {
 	TileImage result;
-	std::scoped_lock<std::mutex> lock(mTileImageCacheMutex);
 	if (mTileImageCache.get(key, result))
 	{
 		return result;
@@ -88,7 +87,6 @@ std::optional<BlockingTilePlanetAltitudeProvider::TileImage> BlockingTilePlanetA
 
 void BlockingTilePlanetAltitudeProvider::addTileToCache(const TileImage& image, const QuadTreeTileKey& key) const
 {
-	std::scoped_lock<std::mutex> lock(mTileImageCacheMutex);
 	mTileImageCache.putSafe(key, image);
 }
 
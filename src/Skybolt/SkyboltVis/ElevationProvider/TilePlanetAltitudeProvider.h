@@ -8,7 +8,7 @@
 
 #include "SkyboltVis/SkyboltVisFwd.h"
 #include <SkyboltSim/PlanetAltitudeProvider.h>
-#include <SkyboltCommon/LruCacheMap.h>
+#include <SkyboltCommon/ConcurrentLruCacheMap.h>
 #include <SkyboltCommon/LruCacheSet.h>
 #include <SkyboltCommon/Math/QuadTree.h>
 
@@ -101,8 +101,8 @@ protected:
 	const TileSourcePtr mTileSource;
 	const int mMaxLod;
 
-	mutable LruCacheMap<QuadTreeTileKey, TileImage> mTileImageCache;
-	mutable std::mutex mTileImageCacheMutex;
+	static constexpr size_t tileImageCacheCapacityBytes = 256 * 1024 * 1024;
+	mutable ConcurrentLruCacheMap<QuadTreeTileKey, TileImage> mTileImageCache;
 };
 
 //! Immediately returns result from an already loaded tile at the highest available LOD, and schedules a background task to load higher LOD levels if requred
@@ -14,6 +14,7 @@
 #include <boost/algorithm/string.hpp>
 #include <assert.h>
 #include <fstream>
+#include <sstream>
 
 namespace skybolt {
 namespace vis {
@@ -119,6 +120,20 @@ osg::ref_ptr<osg::Image> readImageWithoutWarnings(const std::string& filename, c
 	return nullptr;
 }
 
+osg::ref_ptr<osg::Image> readImageFromMemory(const std::string& data, const std::string& extension)
+{
+	osg::ref_ptr<osgDB::ReaderWriter> reader = osgDB::Registry::instance()->getReaderWriterForExtension(extension);
+	if (!reader)
+	{
+		return nullptr;
+	}
+
+	std::istringstream s(data);
+	osgDB::ReaderWriter::ReadResult result = reader->readImage(s);
+	if (result.validImage()) return osg::ref_ptr<osg::Image>(result.getImage());
+	return nullptr;
+}
+
 osg::ref_ptr<osg::Image> readImageWithUserData(std::istream& s, const std::string& extension)
 {
 	osg::ref_ptr<osg::Image> image;
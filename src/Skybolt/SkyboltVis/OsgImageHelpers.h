@@ -64,6 +64,11 @@ osg::Image* readImageWithCorrectOrientation(const std::string& filename);
 
 osg::ref_ptr<osg::Image> readImageWithoutWarnings(const std::string& filename, const osgDB::Options* options = osgDB::Registry::instance()->getOptions());
 
+//! Decodes an encoded image held in memory, e.g. a PNG file received over the network
+//! @param extension is the file extension of the encoded format, e.g. "png"
+//! @return the image, or null if the image could not be decoded
+osg::ref_ptr<osg::Image> readImageFromMemory(const std::string& data, const std::string& extension);
+
 //! Reads an image from stream including the image's user data stored in osg::UserDataContainer
 osg::ref_ptr<osg::Image> readImageWithUserData(std::istream& s, const std::string& extension);
 //! Write an image to a stream including the image's user data stored in osg::UserDataContainer.
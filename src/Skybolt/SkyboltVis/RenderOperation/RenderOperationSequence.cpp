@@ -6,6 +6,7 @@
 
 
 #include "RenderOperationSequence.h"
+#include <SkyboltCommon/Profiling/Profiler.h>
 
 #include <osg/Texture>
 
@@ -42,6 +43,7 @@ void RenderOperationSequence::updatePreRender(const RenderContext& context)
 {
 	for (const auto& [priority, operation] : mOperations)
 	{
+		SKYBOLT_PROFILE_ZONE(typeid(*operation).name());
 		operation->updatePreRender(context);
 	}
 }
@@ -25,7 +25,8 @@ public:
 	void setUpDirection(const osg::Vec3f& dir);
 
 protected:
-	void updatePreRender(const CameraRenderContext& context);
+	UpdatePolicy getUpdatePolicy() const override { return UpdatePolicy::WhenInView; }
+	void updatePreRender(const CameraRenderContext& context) override;
 
 private:
 	osg::Vec3f mUpDirection;
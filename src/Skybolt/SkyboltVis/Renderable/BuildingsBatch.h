@@ -32,6 +32,7 @@ public:
 	BuildingsBatch(const Buildings& buildings, const osg::ref_ptr<osg::Program>& program, const BuildingTypesPtr& buildingTypes);
 
 protected:
+	UpdatePolicy getUpdatePolicy() const override { return UpdatePolicy::Always; }
 	void updatePreRender(const CameraRenderContext& context) override;
 
 private:
@@ -21,7 +21,8 @@ public:
 	virtual void setPosition(const osg::Vec3d &position) override {} // has no effect
 
 protected:
-	void updatePreRender(const CameraRenderContext& context);
+	UpdatePolicy getUpdatePolicy() const override { return UpdatePolicy::Always; }
+	void updatePreRender(const CameraRenderContext& context) override;
 
 private:
 	float mDistance;
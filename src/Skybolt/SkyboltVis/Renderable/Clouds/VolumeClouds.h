@@ -39,6 +39,7 @@ public:
 		osg::Uniform* jitterOffset;
 	};
 
+	UpdatePolicy getUpdatePolicy() const override { return UpdatePolicy::Always; }
 	void updatePreRender(const CameraRenderContext& context) override;
 
 	osg::Matrix getModelMatrix() const;
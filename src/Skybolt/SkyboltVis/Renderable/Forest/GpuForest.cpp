@@ -105,7 +105,7 @@ void removeTilesBelowLodLevel(TileKeyImagesMap& images, int minLodLevel)
 	}
 }
 
-void GpuForest::updateFromTree(const QuadTreeTileLoader::LoadedTileTree& tree)
+void GpuForest::updateFromTree(const QuadTreeTileLoader::FlatLoadedTileTree& tree)
 {
 	// Get required tile images
 	TileKeyImagesMap requiredTileImages;
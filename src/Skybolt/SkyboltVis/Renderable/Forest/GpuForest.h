@@ -46,7 +46,7 @@ public:
 	GpuForest(const GpuForestConfig& config);
 	~GpuForest();
 
-	void updateFromTree(const QuadTreeTileLoader::LoadedTileTree& tree);
+	void updateFromTree(const QuadTreeTileLoader::FlatLoadedTileTree& tree);
 
 	void updatePreRender(const CameraRenderContext& context);
 
@@ -24,6 +24,7 @@ class GpuForestTile : public DefaultRootNode
 public:
 	GpuForestTile(const osg::ref_ptr<osg::Texture2D>& heightMap, const osg::ref_ptr<osg::Texture2D>& attributeMap, const std::shared_ptr<BillboardForest>& forest, const osg::Vec2f& tileWorldSizeMeters);
 
+	UpdatePolicy getUpdatePolicy() const override { return UpdatePolicy::Always; }
 	void updatePreRender(const CameraRenderContext& context) override;
 
 private:
@@ -30,6 +30,7 @@ public:
 
 	void update(const osg::Vec2f& cameraPosition);
 
+	UpdatePolicy getUpdatePolicy() const override { return UpdatePolicy::Always; }
 	void updatePreRender(const CameraRenderContext& context) override;
 
 private:
@@ -0,0 +1,244 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+
+#include "InstancedModel.h"
+#include "SkyboltVis/Camera.h"
+#include "SkyboltVis/OsgStateSetHelpers.h"
+#include "SkyboltVis/RenderContext.h"
+#include "SkyboltVis/VisibilityCategory.h"
+
+#include <osg/Geometry>
+#include <osg/Polytope>
+#include <osgUtil/Optimizer>
+
+#include <algorithm>
+#include <assert.h>
+
+using namespace skybolt::vis;
+
+// Unit used by the instance transform texture buffer.
+// Units below GlobalSamplerUnit are used by per-model textures, which in practice only occupy the lowest few units.
+static const int instanceTransformsTextureUnit = 11;
+
+static const int texelsPerTransform = 4;
+
+// Prepares a copy of a model for instanced drawing
+class InstancedDrawablesPreparer : public osg::NodeVisitor
+{
+public:
+	InstancedDrawablesPreparer() :
+		NodeVisitor(NodeVisitor::TRAVERSE_ALL_CHILDREN)
+	{
+	}
+
+	void apply(osg::Node& node) override
+	{
+		// Instances are culled on the CPU by InstancedModel, so OSG must not cull using the bounds of the un-instanced model
+		node.setCullingActive(false);
+		traverse(node);
+	}
+
+	void apply(osg::Drawable& drawable) override
+	{
+		drawable.setCullingActive(false);
+		if (osg::Geometry* geometry = drawable.asGeometry())
+		{
+			for (unsigned int i = 0; i < geometry->getNumPrimitiveSets(); ++i)
+			{
+				primitiveSets.push_back(geometry->getPrimitiveSet(i));
+			}
+		}
+	}
+
+	std::vector<osg::ref_ptr<osg::PrimitiveSet>> primitiveSets;
+};
+
+static osg::ref_ptr<osg::Node> createInstancedNode(const osg::Node& model)
+{
+	// Geometry is copied because instancing modifies primitive sets, and flattening transforms modifies vertex arrays.
+	// State sets and textures are shared with the original model.
+	const osg::CopyOp copyOp(osg::CopyOp::DEEP_COPY_NODES | osg::CopyOp::DEEP_COPY_DRAWABLES | osg::CopyOp::DEEP_COPY_ARRAYS | osg::CopyOp::DEEP_COPY_PRIMITIVES);
+	osg::ref_ptr<osg::Node> node = static_cast<osg::Node*>(model.clone(copyOp));
+
+	// The instanced vertex shader uses the per-instance transform in place of the OSG model view matrix,
+	// so transforms within the model must be baked into the geometry.
+	osgUtil::Optimizer optimizer;
+	optimizer.optimize(node, osgUtil::Optimizer::FLATTEN_STATIC_TRANSFORMS_DUPLICATING_SHARED_SUBGRAPHS);
+	return node;
+}
+
+InstancedModel::InstancedModel(const InstancedModelConfig& config) :
+	mFrustumCulling(config.frustumCulling),
+	mVisibilityCategoryMask(VisibilityCategory::defaultCategories | VisibilityCategory::shadowCaster)
+{
+	assert(config.node);
+	mModelBound = config.node->getBound();
+	mNode = createInstancedNode(*config.node);
+
+	InstancedDrawablesPreparer preparer;
+	mNode->accept(preparer);
+	mPrimitiveSets = std::move(preparer.primitiveSets);
+
+	mTransform->setNodeMask(0); // Hidden until there are visible instances
+	mTransform->addChild(mNode);
+
+	osg::StateSet* ss = mTransform->getOrCreateStateSet();
+	ss->setDefine("ENABLE_INSTANCING");
+
+	mInstanceTransformsImage = new osg::Image;
+	mInstanceTransformsTexture = new osg::TextureBuffer;
+	mInstanceTransformsTexture->setImage(mInstanceTransformsImage);
+	mInstanceTransformsTexture->setInternalFormat(GL_RGBA32F_ARB);
+	reserveInstanceTransforms(1);
+
+	ss->setTextureAttribute(instanceTransformsTextureUnit, mInstanceTransformsTexture, osg::StateAttribute::ON);
+	ss->addUniform(createUniformSamplerTbo("instanceTransformSampler", instanceTransformsTextureUnit));
+}
+
+InstancedModel::~InstancedModel()
+{
+	mTransform->removeChild(mNode);
+}
+
+ModelInstancePtr InstancedModel::createInstance()
+{
+	int slot;
+	if (mFreeSlots.empty())
+	{
+		slot = int(mSlots.size());
+		mSlots.push_back(Slot());
+	}
+	else
+	{
+		slot = mFreeSlots.back();
+		mFreeSlots.pop_back();
+		mSlots[slot] = Slot();
+	}
+	mSlots[slot].allocated = true;
+	++mInstanceCount;
+
+	return std::make_shared<ModelInstance>(shared_from_this(), slot);
+}
+
+void InstancedModel::setVisibilityCategoryMask(uint32_t mask)
+{
+	mVisibilityCategoryMask = mask;
+}
+
+void InstancedModel::_setInstanceTransform(int slot, const osg::Matrix& transform)
+{
+	mSlots[slot].transform = transform;
+}
+
+void InstancedModel::_releaseInstance(int slot)
+{
+	assert(mSlots[slot].allocated);
+	mSlots[slot].allocated = false;
+	mFreeSlots.push_back(slot);
+	--mInstanceCount;
+}
+
+void InstancedModel::reserveInstanceTransforms(int instanceCount)
+{
+	int requiredWidth = instanceCount * texelsPerTransform;
+	if (mInstanceTransformsImage->s() < requiredWidth)
+	{
+		// Grow geometrically to avoid reallocating the texture buffer as instances are added one at a time
+		int width = std::max(requiredWidth, mInstanceTransformsImage->s() * 2);
+		mInstanceTransformsImage->allocateImage(width, 1, 1, GL_RGBA, GL_FLOAT);
+		mInstanceTransformsTexture->dirtyTextureObject(); // Buffer size has changed
+	}
+}
+
+void InstancedModel::updatePreRender(const CameraRenderContext& context)
+{
+	osg::Polytope frustum;
+	if (mFrustumCulling)
+	{
+		// Side planes only. The near and far planes are omitted because the projection may use a reversed or infinite depth range.
+		frustum.setToUnitFrustum(/* withNear */ false, /* withFar */ false);
+		frustum.transformProvidingInverse(context.camera.getViewMatrix() * context.camera.getProjectionMatrix());
+	}
+
+	reserveInstanceTransforms(int(mSlots.size()));
+	osg::Matrixf* transforms = reinterpret_cast<osg::Matrixf*>(mInstanceTransformsImage->data());
+
+	InstancedModelStats stats;
+	stats.instanceCount = mInstanceCount;
+
+	for (const Slot& slot : mSlots)
+	{
+		if (!slot.allocated || !slot.visible)
+		{
+			continue;
+		}
+
+		if (mFrustumCulling)
+		{
+			osg::BoundingSphere bound(mModelBound.center() * slot.transform, mModelBound.radius());
+			if (!frustum.contains(bound))
+			{
+				++stats.culledInstanceCount;
+				continue;
+			}
+		}
+
+		transforms[stats.visibleInstanceCount] = osg::Matrixf(slot.transform);
+		++stats.visibleInstanceCount;
+	}
+
+	for (const osg::ref_ptr<osg::PrimitiveSet>& primitiveSet : mPrimitiveSets)
+	{
+		primitiveSet->setNumInstances(stats.visibleInstanceCount);
+	}
+
+	if (stats.visibleInstanceCount > 0)
+	{
+		mInstanceTransformsImage->dirty();
+		stats.drawCallCount = int(mPrimitiveSets.size());
+	}
+
+	mTransform->setNodeMask(stats.visibleInstanceCount > 0 ? mVisibilityCategoryMask : 0);
+
+	// Disable atmospheric shading if atmospheric density is too low, consistent with Model
+	bool inAtmosphere = context.atmosphericDensity > 0.3;
+	mTransform->getOrCreateStateSet()->setDefine("ENABLE_ATMOSPHERE", inAtmosphere);
+
+	mStats = stats;
+}
+
+ModelInstance::ModelInstance(const InstancedModelPtr& model, int slot) :
+	mModel(model),
+	mSlot(slot),
+	mNode(new osg::Group)
+{
+	assert(mModel);
+}
+
+ModelInstance::~ModelInstance()
+{
+	mModel->_releaseInstance(mSlot);
+}
+
+void ModelInstance::setPosition(const osg::Vec3d& position)
+{
+	osg::Matrix m = getTransform();
+	m.setTrans(position);
+	setTransform(m);
+}
+
+void ModelInstance::setOrientation(const osg::Quat& orientation)
+{
+	osg::Matrix m = getTransform();
+	m.setRotate(orientation);
+	setTransform(m);
+}
+
+void ModelInstance::setTransform(const osg::Matrix& m)
+{
+	mModel->_setInstanceTransform(mSlot, m);
+}
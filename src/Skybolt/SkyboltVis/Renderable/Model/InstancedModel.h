@@ -0,0 +1,120 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+
+#pragma once
+
+#include "SkyboltVis/DefaultRootNode.h"
+#include "SkyboltVis/SkyboltVisFwd.h"
+#include <osg/Image>
+#include <osg/PrimitiveSet>
+#include <osg/TextureBuffer>
+
+#include <memory>
+#include <vector>
+
+namespace skybolt {
+namespace vis {
+
+struct InstancedModelConfig
+{
+	osg::ref_ptr<osg::Node> node; //!< Model to instance. The node is not modified, so it may be shared with a model cache.
+	bool frustumCulling = true; //!< If true, instances outside the camera frustum are not submitted for drawing
+};
+
+struct InstancedModelStats
+{
+	int instanceCount = 0;
+	int visibleInstanceCount = 0; //!< Number of instances submitted for drawing
+	int culledInstanceCount = 0; //!< Number of visible instances rejected by frustum culling
+	int drawCallCount = 0; //!< Number of draw calls used to draw all submitted instances
+};
+
+//! Draws all instances of a model with one draw call per primitive set, regardless of instance count.
+//! Per-instance transforms are uploaded to a texture buffer each frame, and read by shaders compiled with ENABLE_INSTANCING.
+//! Instances are expected to have rigid transforms, i.e. no scaling.
+class InstancedModel : public DefaultRootNode, public std::enable_shared_from_this<InstancedModel>
+{
+public:
+	InstancedModel(const InstancedModelConfig& config);
+	~InstancedModel() override;
+
+	//! The instance is removed from the model when the returned object is destroyed
+	ModelInstancePtr createInstance();
+
+	//! @returns stats from the most recent updatePreRender()
+	const InstancedModelStats& getStats() const { return mStats; }
+
+	void setVisibilityCategoryMask(uint32_t mask) override;
+
+public:
+	// ModelInstance interface
+	void _setInstanceTransform(int slot, const osg::Matrix& transform);
+	const osg::Matrix& _getInstanceTransform(int slot) const { return mSlots[slot].transform; }
+	void _setInstanceVisible(int slot, bool visible) { mSlots[slot].visible = visible; }
+	bool _isInstanceVisible(int slot) const { return mSlots[slot].visible; }
+	void _releaseInstance(int slot);
+
+private:
+	UpdatePolicy getUpdatePolicy() const override { return UpdatePolicy::Always; }
+	void updatePreRender(const CameraRenderContext& context) override;
+
+	void reserveInstanceTransforms(int instanceCount);
+
+private:
+	struct Slot
+	{
+		osg::Matrix transform;
+		bool allocated = false;
+		bool visible = true;
+	};
+
+	std::vector<Slot> mSlots;
+	std::vector<int> mFreeSlots;
+	int mInstanceCount = 0;
+
+	osg::ref_ptr<osg::Node> mNode;
+	std::vector<osg::ref_ptr<osg::PrimitiveSet>> mPrimitiveSets;
+	osg::BoundingSphere mModelBound;
+	bool mFrustumCulling;
+	uint32_t mVisibilityCategoryMask;
+
+	osg::ref_ptr<osg::Image> mInstanceTransformsImage;
+	osg::ref_ptr<osg::TextureBuffer> mInstanceTransformsTexture;
+	InstancedModelStats mStats;
+};
+
+//! Handle to an instance of an InstancedModel, positioned in the same way as a stand-alone Model.
+//! The instance is drawn by its InstancedModel, so the instance itself does not need to be added to a Scene.
+class ModelInstance : public RootNode
+{
+public:
+	ModelInstance(const InstancedModelPtr& model, int slot);
+	~ModelInstance() override;
+
+	void setPosition(const osg::Vec3d& position) override;
+	void setOrientation(const osg::Quat& orientation) override;
+	void setTransform(const osg::Matrix& m) override;
+
+	osg::Vec3d getPosition() const override { return getTransform().getTrans(); }
+	osg::Quat getOrientation() const override { return getTransform().getRotate(); }
+	osg::Matrix getTransform() const override { return mModel->_getInstanceTransform(mSlot); }
+
+	void setVisible(bool visible) override { mModel->_setInstanceVisible(mSlot, visible); }
+	bool isVisible() const override { return mModel->_isInstanceVisible(mSlot); }
+
+	osg::Node* _getNode() const override { return mNode; }
+
+	const InstancedModelPtr& getModel() const { return mModel; }
+
+private:
+	InstancedModelPtr mModel;
+	int mSlot;
+	osg::ref_ptr<osg::Group> mNode; //!< Empty node, for interface compatibility with other VisObjects
+};
+
+} // namespace vis
+} // namespace skybolt
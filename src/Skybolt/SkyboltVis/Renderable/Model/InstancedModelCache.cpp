@@ -0,0 +1,36 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "InstancedModelCache.h"
+#include "InstancedModel.h"
+
+namespace skybolt {
+namespace vis {
+
+InstancedModelPtr InstancedModelCache::getOrCreateInstancedModel(const std::string& key, const InstancedModelFactory& factory)
+{
+	std::scoped_lock<std::mutex> lock(mMutex);
+	auto i = mCache.find(key);
+	if (i != mCache.end())
+	{
+		return i->second;
+	}
+	auto model = factory();
+	mCache[key] = model;
+	return model;
+}
+
+void InstancedModelCache::forEachModel(const std::function<void(const InstancedModel&)>& visitor) const
+{
+	std::scoped_lock<std::mutex> lock(mMutex);
+	for (const auto& [key, model] : mCache)
+	{
+		visitor(*model);
+	}
+}
+
+} // namespace vis
+} // namespace skybolt
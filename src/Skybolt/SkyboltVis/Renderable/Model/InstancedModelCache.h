@@ -0,0 +1,39 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#pragma once
+
+#include "SkyboltVis/SkyboltVisFwd.h"
+
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+
+namespace skybolt {
+namespace vis {
+
+//! Shares one InstancedModel between all users of the same model, so that all instances are drawn in one batch.
+//! Thread safe.
+class InstancedModelCache
+{
+public:
+	using InstancedModelFactory = std::function<InstancedModelPtr()>;
+
+	//! If the model does not exist in cache, it is created with factory and added to cache
+	//! @param key identifies the model, e.g. from ModelFactory::getModelKey()
+	InstancedModelPtr getOrCreateInstancedModel(const std::string& key, const InstancedModelFactory& factory);
+
+	//! Calls the visitor for each cached model, for example to gather rendering stats
+	void forEachModel(const std::function<void(const InstancedModel&)>& visitor) const;
+
+private:
+	mutable std::mutex mMutex;
+	std::map<std::string, InstancedModelPtr> mCache;
+};
+
+} // namespace vis
+} // namespace skybolt
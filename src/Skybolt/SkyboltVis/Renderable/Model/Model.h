@@ -40,6 +40,7 @@ public:
 	bool isVisible() const override { return mVisible; }
 
 private:
+	UpdatePolicy getUpdatePolicy() const override { return UpdatePolicy::WhenInView; }
 	void updatePreRender(const CameraRenderContext& context) override;
 
 protected:
@@ -0,0 +1,81 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+
+#include "ModelCache.h"
+
+#include <assert.h>
+
+using namespace skybolt::vis;
+
+osg::ref_ptr<osg::Node> ModelCache::getOrLoad(const std::string& key, const Loader& loader)
+{
+	std::promise<osg::ref_ptr<osg::Node>> promise;
+	ModelFuture existingModel;
+	{
+		std::scoped_lock<std::mutex> lock(mMutex);
+		auto it = mModels.find(key);
+		if (it != mModels.end())
+		{
+			existingModel = it->second;
+		}
+		else
+		{
+			mModels[key] = promise.get_future().share();
+		}
+	}
+
+	if (existingModel.valid())
+	{
+		// Another caller has loaded, or is loading, the model
+		return existingModel.get();
+	}
+
+	// Load without holding the lock so that other models can load concurrently
+	try
+	{
+		osg::ref_ptr<osg::Node> model = loader();
+		assert(model);
+		promise.set_value(model);
+		return model;
+	}
+	catch (...)
+	{
+		{
+			std::scoped_lock<std::mutex> lock(mMutex);
+			mModels.erase(key);
+		}
+		promise.set_exception(std::current_exception());
+		throw;
+	}
+}
+
+size_t ModelCache::evictUnused()
+{
+	std::scoped_lock<std::mutex> lock(mMutex);
+	size_t evictedCount = 0;
+	for (auto it = mModels.begin(); it != mModels.end();)
+	{
+		const ModelFuture& future = it->second;
+		bool loaded = future.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+		if (loaded && future.get()->referenceCount() == 1)
+		{
+			it = mModels.erase(it);
+			++evictedCount;
+		}
+		else
+		{
+			++it;
+		}
+	}
+	return evictedCount;
+}
+
+size_t ModelCache::size() const
+{
+	std::scoped_lock<std::mutex> lock(mMutex);
+	return mModels.size();
+}
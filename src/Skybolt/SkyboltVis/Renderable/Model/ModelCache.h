@@ -0,0 +1,45 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+
+#pragma once
+
+#include <osg/Node>
+#include <functional>
+#include <future>
+#include <map>
+#include <mutex>
+#include <string>
+
+namespace skybolt {
+namespace vis {
+
+//! Thread-safe cache of loaded model nodes.
+//! Concurrent requests for the same model share a single load, while different models load in parallel.
+class ModelCache
+{
+public:
+	using Loader = std::function<osg::ref_ptr<osg::Node>()>;
+
+	//! Returns the cached model for the key, calling the loader if the model is not cached.
+	//! Exceptions thrown by the loader are propagated to all callers waiting on the load, and the failed load is not cached.
+	osg::ref_ptr<osg::Node> getOrLoad(const std::string& key, const Loader& loader);
+
+	//! Removes models that are not referenced outside of the cache.
+	//! @returns number of models removed
+	size_t evictUnused();
+
+	size_t size() const;
+
+private:
+	using ModelFuture = std::shared_future<osg::ref_ptr<osg::Node>>;
+
+	mutable std::mutex mMutex;
+	std::map<std::string, ModelFuture> mModels;
+};
+
+} // namespace vis
+} // namespace skybolt
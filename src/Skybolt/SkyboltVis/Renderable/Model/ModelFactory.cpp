@@ -6,6 +6,7 @@
 
 
 #include "ModelFactory.h"
+#include "InstancedModel.h"
 #include "ModelPreparer.h"
 #include "OsgImageHelpers.h"
 #include "OsgStateSetHelpers.h"
@@ -176,45 +177,59 @@ private:
 
 ModelFactory::ModelFactory(const ModelFactoryConfig &config) :
 	mStateSetModifiers(config.stateSetModifiers),
-	mDefaultProgram(config.defaultProgram)
+	mDefaultProgram(config.defaultProgram),
+	mModelCache(std::make_shared<ModelCache>())
 {
 	assert(mDefaultProgram);
 }
 
-osg::ref_ptr<osg::Node> ModelFactory::createModel(const std::string& filename, const std::vector<TextureRole>& textureRoles)
+std::string ModelFactory::getModelKey(const std::string& filename, const std::vector<TextureRole>& textureRoles)
 {
-	static std::map<std::string, osg::ref_ptr<osg::Node>> modelCache;
-	auto it = modelCache.find(filename);
-	if (it == modelCache.end())
+	std::string key = filename + "?";
+	for (TextureRole role : textureRoles)
 	{
-		osg::ref_ptr<osg::Node> model = osgDB::readNodeFile(filename);
-		if (!model)
-		{
-			throw skybolt::Exception("Could not load OSG model: " + filename);
-		}
+		key += std::to_string(int(role));
+	}
+	return key;
+}
 
-		TexturePreparer modifier(textureRoles);
-		model->accept(modifier);
+osg::ref_ptr<osg::Node> ModelFactory::createModel(const std::string& filename, const std::vector<TextureRole>& textureRoles)
+{
+	return mModelCache->getOrLoad(getModelKey(filename, textureRoles), [&] {
+		return loadModel(filename, textureRoles);
+	});
+}
 
-		{
-			ModelPreparerConfig config;
-			config.generateTangents = modifier.hasNormalMap;
-			ModelPreparer preparer(config);
-			model->accept(preparer);
-		}
+InstancedModelPtr ModelFactory::createInstancedModel(const std::string& filename, const std::vector<TextureRole>& textureRoles)
+{
+	InstancedModelConfig config;
+	config.node = createModel(filename, textureRoles);
+	return std::make_shared<InstancedModel>(config);
+}
 
-		{
-			MaterialShaderAssignmentsModifier modifier(mStateSetModifiers);
-			model->accept(modifier);
-		}
+osg::ref_ptr<osg::Node> ModelFactory::loadModel(const std::string& filename, const std::vector<TextureRole>& textureRoles) const
+{
+	osg::ref_ptr<osg::Node> model = osgDB::readNodeFile(filename);
+	if (!model)
+	{
+		throw skybolt::Exception("Could not load OSG model: " + filename);
+	}
 
-		model->getOrCreateStateSet()->setAttribute(mDefaultProgram); // set default program at top level
+	TexturePreparer modifier(textureRoles);
+	model->accept(modifier);
 
-		modelCache[filename] = model;
-		return model;
+	{
+		ModelPreparerConfig config;
+		config.generateTangents = modifier.hasNormalMap;
+		ModelPreparer preparer(config);
+		model->accept(preparer);
 	}
-	else
+
 	{
-		return it->second;
+		MaterialShaderAssignmentsModifier modifier(mStateSetModifiers);
+		model->accept(modifier);
 	}
-}
\ No newline at end of file
+
+	model->getOrCreateStateSet()->setAttribute(mDefaultProgram); // set default program at top level
+	return model;
+}
@@ -7,7 +7,9 @@
 
 #pragma once
 
+#include "ModelCache.h"
 #include "SkyboltVis/DefaultRootNode.h"
+#include "SkyboltVis/SkyboltVisFwd.h"
 #include <osg/Material>
 #include <osg/Program>
 #include <functional>
@@ -36,11 +38,27 @@ public:
 	OcclusionRoughnessMetalness
 };
 
+	//! Returns a model which may be shared with other callers requesting the same model.
+	//! Thread safe.
 	osg::ref_ptr<osg::Node> createModel(const std::string& filename, const std::vector<TextureRole>& textureRoles);
 
+	//! Creates a model which draws all of its instances in a single batch.
+	//! Thread safe.
+	InstancedModelPtr createInstancedModel(const std::string& filename, const std::vector<TextureRole>& textureRoles);
+
+	//! @returns a key identifying the model created for the given arguments. Texture roles affect model preparation, so they form part of the key.
+	static std::string getModelKey(const std::string& filename, const std::vector<TextureRole>& textureRoles);
+
+	//! @returns the cache of models created by the factory. Call ModelCache::evictUnused() to release models that are no longer used.
+	const ModelCachePtr& getModelCache() const { return mModelCache; }
+
+private:
+	osg::ref_ptr<osg::Node> loadModel(const std::string& filename, const std::vector<TextureRole>& textureRoles) const;
+
 private:
 	NamedStateSetModifiers mStateSetModifiers;
 	osg::ref_ptr<osg::Program> mDefaultProgram;
+	ModelCachePtr mModelCache;
 };
 
 } // namespace vis
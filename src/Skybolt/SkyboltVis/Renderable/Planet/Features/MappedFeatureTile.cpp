@@ -0,0 +1,266 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "MappedFeatureTile.h"
+#include <SkyboltCommon/Exception.h>
+
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+namespace skybolt {
+namespace mapfeatures {
+
+using namespace mappedfeaturetile;
+namespace bip = boost::interprocess;
+
+MappedFeatureTile::MappedFeatureTile(const std::string& filename) :
+	mFilename(filename)
+{
+	try
+	{
+		mFile = bip::file_mapping(filename.c_str(), bip::read_only);
+		mRegion = bip::mapped_region(mFile, bip::read_only);
+	}
+	catch (const bip::interprocess_exception& e)
+	{
+		throw Exception("Could not map file: " + filename + ". Reason: " + e.what());
+	}
+
+	if (mRegion.get_size() < sizeof(Header))
+	{
+		throw Exception("Invalid feature tile: " + filename);
+	}
+
+	mHeader = static_cast<const Header*>(mRegion.get_address());
+	if (std::memcmp(mHeader->magic, magic, sizeof(magic)) != 0)
+	{
+		throw Exception("Invalid feature tile: " + filename);
+	}
+	if (mHeader->version != version)
+	{
+		throw Exception("Invalid file version: " + std::to_string(mHeader->version) + ". Expected: " + std::to_string(version));
+	}
+
+	// Validate table bounds up front so that corrupt files are rejected when opened
+	getRoads();
+	getBuildings();
+	getWaters();
+	getArray<sim::LatLonAlt>(mHeader->pointsOffset, mHeader->pointCount);
+	getArray<char>(mHeader->airportsOffset, mHeader->airportsSize);
+}
+
+bool MappedFeatureTile::isMappedFormat(const std::string& filename)
+{
+	std::ifstream f(filename, std::ios::binary);
+	char fileMagic[sizeof(magic)];
+	f.read(fileMagic, sizeof(fileMagic));
+	return f && std::memcmp(fileMagic, magic, sizeof(magic)) == 0;
+}
+
+template <typename T>
+ArrayView<T> MappedFeatureTile::getArray(uint64_t offset, uint64_t count) const
+{
+	if (offset % alignof(T) != 0 || offset > mRegion.get_size() || count > (mRegion.get_size() - offset) / sizeof(T))
+	{
+		throw Exception("Corrupt feature tile: " + mFilename);
+	}
+
+	return ArrayView<T>(reinterpret_cast<const T*>(static_cast<const char*>(mRegion.get_address()) + offset), size_t(count));
+}
+
+ArrayView<RoadRecord> MappedFeatureTile::getRoads() const
+{
+	return getArray<RoadRecord>(mHeader->roadsOffset, mHeader->roadCount);
+}
+
+ArrayView<BuildingRecord> MappedFeatureTile::getBuildings() const
+{
+	return getArray<BuildingRecord>(mHeader->buildingsOffset, mHeader->buildingCount);
+}
+
+ArrayView<WaterRecord> MappedFeatureTile::getWaters() const
+{
+	return getArray<WaterRecord>(mHeader->watersOffset, mHeader->waterCount);
+}
+
+ArrayView<sim::LatLonAlt> MappedFeatureTile::getPoints(const PointRange& range) const
+{
+	if (uint64_t(range.first) + range.count > mHeader->pointCount)
+	{
+		throw Exception("Corrupt feature tile: " + mFilename);
+	}
+	return ArrayView<sim::LatLonAlt>(reinterpret_cast<const sim::LatLonAlt*>(static_cast<const char*>(mRegion.get_address()) + mHeader->pointsOffset) + range.first, range.count);
+}
+
+std::vector<AirportPtr> MappedFeatureTile::loadAirports() const
+{
+	std::vector<AirportPtr> airports;
+	if (mHeader->airportCount == 0)
+	{
+		return airports;
+	}
+
+	ArrayView<char> data = getArray<char>(mHeader->airportsOffset, mHeader->airportsSize);
+	std::istringstream stream(std::string(data.data(), data.size()), std::ios::binary);
+	for (uint32_t i = 0; i < mHeader->airportCount; ++i)
+	{
+		auto airport = std::make_shared<Airport>();
+		airport->load(stream);
+		airports.push_back(airport);
+	}
+	return airports;
+}
+
+static LatLonAltPoints toPoints(const ArrayView<sim::LatLonAlt>& points)
+{
+	return LatLonAltPoints(points.begin(), points.end());
+}
+
+void MappedFeatureTile::createFeatures(std::vector<FeaturePtr>& features) const
+{
+	for (const RoadRecord& record : getRoads())
+	{
+		auto road = std::make_shared<Road>();
+		road->width = record.width;
+		road->laneCount = record.laneCount;
+		for (int i = 0; i < 2; ++i)
+		{
+			road->endControlPoints[i] = record.endControlPoints[i];
+			road->endLaneCounts[i] = record.endLaneCounts[i];
+		}
+		road->points = toPoints(getPoints(record.points));
+		features.push_back(road);
+	}
+
+	for (const BuildingRecord& record : getBuildings())
+	{
+		auto building = std::make_shared<Building>();
+		building->height = record.height;
+		building->points = toPoints(getPoints(record.points));
+		features.push_back(building);
+	}
+
+	for (const WaterRecord& record : getWaters())
+	{
+		auto water = std::make_shared<Water>();
+		water->points = toPoints(getPoints(record.points));
+		features.push_back(water);
+	}
+
+	for (const AirportPtr& airport : loadAirports())
+	{
+		features.push_back(airport);
+	}
+}
+
+static PointRange appendPoints(std::vector<sim::LatLonAlt>& allPoints, const LatLonAltPoints& points)
+{
+	PointRange range;
+	range.first = uint32_t(allPoints.size());
+	range.count = uint32_t(points.size());
+	allPoints.insert(allPoints.end(), points.begin(), points.end());
+	return range;
+}
+
+template <typename T>
+static void writeArray(std::ofstream& f, const std::vector<T>& values)
+{
+	f.write(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(T));
+}
+
+void saveMappedFeatureTile(const std::vector<FeaturePtr>& features, const std::string& filename)
+{
+	std::vector<RoadRecord> roads;
+	std::vector<BuildingRecord> buildings;
+	std::vector<WaterRecord> waters;
+	std::vector<sim::LatLonAlt> points;
+	std::ostringstream airports(std::ios::binary);
+	uint32_t airportCount = 0;
+
+	for (const FeaturePtr& feature : features)
+	{
+		switch (feature->type())
+		{
+		case FeatureRoad:
+		{
+			const Road& road = static_cast<const Road&>(*feature);
+			RoadRecord record;
+			for (int i = 0; i < 2; ++i)
+			{
+				record.endControlPoints[i] = road.endControlPoints[i];
+				record.endLaneCounts[i] = road.endLaneCounts[i];
+			}
+			record.width = road.width;
+			record.laneCount = road.laneCount;
+			record.points = appendPoints(points, road.points);
+			roads.push_back(record);
+			break;
+		}
+		case FeatureBuilding:
+		{
+			const Building& building = static_cast<const Building&>(*feature);
+			BuildingRecord record;
+			record.height = building.height;
+			record.padding = 0;
+			record.points = appendPoints(points, building.points);
+			buildings.push_back(record);
+			break;
+		}
+		case FeatureWater:
+		{
+			WaterRecord record;
+			record.points = appendPoints(points, static_cast<const Water&>(*feature).points);
+			waters.push_back(record);
+			break;
+		}
+		case FeatureAirport:
+			feature->save(airports);
+			++airportCount;
+			break;
+		default:
+			assert(!"Not implemented");
+		}
+	}
+
+	const std::string airportsData = airports.str();
+
+	Header header;
+	std::memcpy(header.magic, magic, sizeof(magic));
+	header.version = version;
+	header.roadCount = uint32_t(roads.size());
+	header.buildingCount = uint32_t(buildings.size());
+	header.waterCount = uint32_t(waters.size());
+	header.airportCount = airportCount;
+	header.pointCount = points.size();
+	header.roadsOffset = sizeof(Header);
+	header.buildingsOffset = header.roadsOffset + roads.size() * sizeof(RoadRecord);
+	header.watersOffset = header.buildingsOffset + buildings.size() * sizeof(BuildingRecord);
+	header.pointsOffset = header.watersOffset + waters.size() * sizeof(WaterRecord);
+	header.airportsOffset = header.pointsOffset + points.size() * sizeof(sim::LatLonAlt);
+	header.airportsSize = airportsData.size();
+
+	std::ofstream f(filename, std::ios::binary);
+	if (!f.is_open())
+	{
+		throw Exception("Could not open file for writing: " + filename);
+	}
+	f.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	writeArray(f, roads);
+	writeArray(f, buildings);
+	writeArray(f, waters);
+	writeArray(f, points);
+	f.write(airportsData.data(), airportsData.size());
+	f.close();
+
+	if (f.fail())
+	{
+		throw Exception("Error writing file: " + filename);
+	}
+}
+
+} // namespace mapfeatures
+} // namespace skybolt
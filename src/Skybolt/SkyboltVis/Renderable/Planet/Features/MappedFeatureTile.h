@@ -0,0 +1,141 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#pragma once
+
+#include "PlanetFeaturesSource.h"
+
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <cassert>
+#include <cstdint>
+
+namespace skybolt {
+namespace mapfeatures {
+
+//! Read-only view of a contiguous array
+template <typename T>
+class ArrayView
+{
+public:
+	ArrayView() = default;
+	ArrayView(const T* data, size_t size) : mData(data), mSize(size) {}
+
+	const T* data() const { return mData; }
+	size_t size() const { return mSize; }
+	bool empty() const { return mSize == 0; }
+
+	const T* begin() const { return mData; }
+	const T* end() const { return mData + mSize; }
+	const T& operator[](size_t i) const { assert(i < mSize); return mData[i]; }
+
+private:
+	const T* mData = nullptr;
+	size_t mSize = 0;
+};
+
+//! Memory-mappable feature tile format.
+//! Features are stored in one table per feature type, with all points in a single contiguous array shared by the tables,
+//! so a tile can be consumed directly from the mapped file without per-feature allocation or parsing.
+//! File layout, all integers little endian and all sections 8 byte aligned:
+//!   MappedFeatureTileHeader
+//!   RoadRecord[roadCount]
+//!   BuildingRecord[buildingCount]
+//!   WaterRecord[waterCount]
+//!   sim::LatLonAlt[pointCount]
+//!   Airports, in the stream format written by Airport::save(). Airports are rare and variable length so are not tabulated.
+namespace mappedfeaturetile {
+
+constexpr char magic[4] = {'S', 'B', 'F', 'T'};
+constexpr uint32_t version = 2;
+
+struct Header
+{
+	char magic[4];
+	uint32_t version;
+	uint32_t roadCount;
+	uint32_t buildingCount;
+	uint32_t waterCount;
+	uint32_t airportCount;
+	uint64_t pointCount;
+	uint64_t roadsOffset;
+	uint64_t buildingsOffset;
+	uint64_t watersOffset;
+	uint64_t pointsOffset;
+	uint64_t airportsOffset;
+	uint64_t airportsSize;
+};
+
+struct PointRange
+{
+	uint32_t first;
+	uint32_t count;
+};
+
+struct RoadRecord
+{
+	sim::LatLonAlt endControlPoints[2];
+	int32_t endLaneCounts[2];
+	float width;
+	int32_t laneCount;
+	PointRange points;
+};
+
+struct BuildingRecord
+{
+	float height;
+	uint32_t padding;
+	PointRange points;
+};
+
+struct WaterRecord
+{
+	PointRange points;
+};
+
+static_assert(sizeof(Header) == 80);
+static_assert(sizeof(RoadRecord) == 72);
+static_assert(sizeof(BuildingRecord) == 16);
+static_assert(sizeof(WaterRecord) == 8);
+static_assert(sizeof(sim::LatLonAlt) == 24);
+
+} // namespace mappedfeaturetile
+
+//! Read-only memory mapped feature tile
+class MappedFeatureTile
+{
+public:
+	//! @throws skybolt::Exception if the file can not be opened or is not a valid mapped feature tile
+	explicit MappedFeatureTile(const std::string& filename);
+
+	//! @returns true if the file is in the mapped feature tile format
+	static bool isMappedFormat(const std::string& filename);
+
+	ArrayView<mappedfeaturetile::RoadRecord> getRoads() const;
+	ArrayView<mappedfeaturetile::BuildingRecord> getBuildings() const;
+	ArrayView<mappedfeaturetile::WaterRecord> getWaters() const;
+	ArrayView<sim::LatLonAlt> getPoints(const mappedfeaturetile::PointRange& range) const;
+
+	std::vector<AirportPtr> loadAirports() const;
+
+	//! Creates a Feature object for each feature, for consumers that require them
+	void createFeatures(std::vector<FeaturePtr>& features) const;
+
+private:
+	template <typename T>
+	ArrayView<T> getArray(uint64_t offset, uint64_t count) const;
+
+private:
+	std::string mFilename;
+	boost::interprocess::file_mapping mFile;
+	boost::interprocess::mapped_region mRegion;
+	const mappedfeaturetile::Header* mHeader;
+};
+
+void saveMappedFeatureTile(const std::vector<FeaturePtr>& features, const std::string& filename);
+
+} // namespace mapfeatures
+} // namespace skybolt
@@ -5,6 +5,7 @@
  * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
 
 #include "PlanetFeatures.h"
+#include "MappedFeatureTile.h"
 #include "SkyboltSim/Spatial/GreatCircle.h"
 #include "SkyboltVis/LlaToNedConverter.h"
 #include "SkyboltVis/OsgGeocentric.h"
@@ -18,8 +19,8 @@
 
 #include <SkyboltCommon/Math/MathUtility.h>
 #include <SkyboltCommon/Math/QuadTreeUtility.h>
+#include <SkyboltCommon/Profiling/Profiler.h>
 
-#include <cxxtimer/cxxtimer.hpp>
 #include <boost/algorithm/string.hpp>
 #include <mutex>
 
@@ -50,18 +51,7 @@ public:
 	//! May be called on multiple threads concurrently
 	std::unique_ptr<LoadedVisObjects> loadVisObjects(const std::vector<mapfeatures::FeaturePtr>& features, const sim::LatLon& latLonOrigin, double planetRadius) const
 	{
-		std::unique_ptr<LoadedVisObjects> objectsPtr = std::make_unique<LoadedVisObjects>();
-		LoadedVisObjects& objects = *objectsPtr;
-		objects.latLonOrigin = latLonOrigin;
-
-		LlaToNedConverterPtr nedConverter(new LlaToNedConverter(latLonOrigin, planetRadius));
-		const LlaToNedConverter& converter = *nedConverter;
-
-		Roads roads;
-		Runways runways;
-		Buildings buildings;
-		Lakes lakes;
-		PolyRegions polyRegions;
+		VisFeatures visFeatures(latLonOrigin, planetRadius);
 
 		for (const mapfeatures::FeaturePtr& feature : features)
 		{
@@ -70,91 +60,171 @@ public:
 			case mapfeatures::FeatureRoad:
 			{
 				const mapfeatures::Road& srcRoad = static_cast<const mapfeatures::Road&>(*feature);
-
-				Road road;
-				for (int j = 0; j < srcRoad.points.size(); ++j)
-				{
-					osg::Vec3f pos = converter.latLonAltToCartesianNed(srcRoad.points[j]);
-					road.points.push_back(pos);
-				}
-				road.width = srcRoad.width;
-				road.laneCount = srcRoad.laneCount;
-				
-				for (int i = 0; i < 2; ++i)
-				{
-					road.endLaneCounts[i] = srcRoad.endLaneCounts[i];
-					if (road.endLaneCounts[i] != -1)
-					{
-						road.endControlPoints[i] = converter.latLonAltToCartesianNed(srcRoad.endControlPoints[i]);
-					}
-				}
-				roads.push_back(road);
+				visFeatures.addRoad(srcRoad.points, srcRoad.width, srcRoad.laneCount, srcRoad.endControlPoints, srcRoad.endLaneCounts);
 			}
 			break;
 			case mapfeatures::FeatureBuilding:
 			{
-				Building building;
 				const mapfeatures::Building& srcBuilding = static_cast<const mapfeatures::Building&>(*feature);
-				for (int j = 0; j < srcBuilding.points.size(); ++j)
-				{
-					osg::Vec3f pos = converter.latLonAltToCartesianNed(srcBuilding.points[j]);
-					building.points.push_back(pos);
-				}
-				building.height = srcBuilding.height;
-				buildings.push_back(building);
+				visFeatures.addBuilding(srcBuilding.points, srcBuilding.height);
 			}
 			break;
 			case mapfeatures::FeatureWater:
 			{
-				Lake lake;
 				const mapfeatures::Water& srcWater = static_cast<const mapfeatures::Water&>(*feature);
-				for (int j = 0; j < srcWater.points.size(); ++j)
-				{
-					osg::Vec3f pos = converter.latLonAltToCartesianNed(srcWater.points[j]);
-					lake.points.push_back(pos);
-				}
-
-				lakes.push_back(lake);
+				visFeatures.addLake(srcWater.points);
 			}
 			break;
 			case mapfeatures::FeatureAirport:
+				visFeatures.addAirport(static_cast<const mapfeatures::Airport&>(*feature));
+			break;
+			assert(!"Not implemented");
+			}
+		}
+
+		return createVisObjects(visFeatures);
+	}
+
+	//! Loads directly from the memory mapped tile without creating intermediate Feature objects.
+	//! May be called on multiple threads concurrently
+	std::unique_ptr<LoadedVisObjects> loadVisObjects(const mapfeatures::MappedFeatureTile& tile, const sim::LatLon& latLonOrigin, double planetRadius) const
+	{
+		VisFeatures visFeatures(latLonOrigin, planetRadius);
+
+		for (const mapfeatures::mappedfeaturetile::RoadRecord& record : tile.getRoads())
+		{
+			visFeatures.addRoad(tile.getPoints(record.points), record.width, record.laneCount, record.endControlPoints, record.endLaneCounts);
+		}
+
+		for (const mapfeatures::mappedfeaturetile::BuildingRecord& record : tile.getBuildings())
+		{
+			visFeatures.addBuilding(tile.getPoints(record.points), record.height);
+		}
+
+		for (const mapfeatures::mappedfeaturetile::WaterRecord& record : tile.getWaters())
+		{
+			visFeatures.addLake(tile.getPoints(record.points));
+		}
+
+		for (const mapfeatures::AirportPtr& airport : tile.loadAirports())
+		{
+			visFeatures.addAirport(*airport);
+		}
+
+		return createVisObjects(visFeatures);
+	}
+
+private:
+	//! Features converted to local NED coordinates, ready for creating batches
+	struct VisFeatures
+	{
+		VisFeatures(const sim::LatLon& latLonOrigin, double planetRadius) :
+			latLonOrigin(latLonOrigin),
+			converter(latLonOrigin, planetRadius)
+		{
+		}
+
+		template <typename Points>
+		void toNed(const Points& srcPoints, std::vector<osg::Vec3f>& points) const
+		{
+			points.reserve(srcPoints.size());
+			for (const sim::LatLonAlt& point : srcPoints)
+			{
+				points.push_back(converter.latLonAltToCartesianNed(point));
+			}
+		}
+
+		template <typename Points, typename LaneCount>
+		void addRoad(const Points& srcPoints, float width, int laneCount, const sim::LatLonAlt* endControlPoints, const LaneCount* endLaneCounts)
+		{
+			Road road;
+			toNed(srcPoints, road.points);
+			road.width = width;
+			road.laneCount = laneCount;
+
+			for (int i = 0; i < 2; ++i)
 			{
-				const mapfeatures::Airport& srcAirport = static_cast<const mapfeatures::Airport&>(*feature);
-				for (const mapfeatures::Airport::Runway& srcRunway : srcAirport.runways)
+				road.endLaneCounts[i] = endLaneCounts[i];
+				if (road.endLaneCounts[i] != -1)
 				{
-					Runway runway;
-					runway.startPoint = converter.latLonAltToCartesianNed(toLatLonAlt(srcRunway.start, srcAirport.altitude));
-					runway.endPoint = converter.latLonAltToCartesianNed(toLatLonAlt(srcRunway.end, srcAirport.altitude));
+					road.endControlPoints[i] = converter.latLonAltToCartesianNed(endControlPoints[i]);
+				}
+			}
+			roads.push_back(std::move(road));
+		}
 
-					std::vector<std::string> strs;
-					boost::split(strs, srcRunway.name, boost::is_any_of("\\/"));
-					if (strs.size() == 2)
-					{
-						runway.startMarking = strs.front();
-						runway.endMarking = strs.back();
-					}
+		template <typename Points>
+		void addBuilding(const Points& srcPoints, float height)
+		{
+			Building building;
+			toNed(srcPoints, building.points);
+			building.height = height;
+			buildings.push_back(std::move(building));
+		}
+
+		template <typename Points>
+		void addLake(const Points& srcPoints)
+		{
+			Lake lake;
+			toNed(srcPoints, lake.points);
+			lakes.push_back(std::move(lake));
+		}
 
-					runway.width = srcRunway.width;
-					runways.push_back(runway);
+		void addAirport(const mapfeatures::Airport& srcAirport)
+		{
+			for (const mapfeatures::Airport::Runway& srcRunway : srcAirport.runways)
+			{
+				Runway runway;
+				runway.startPoint = converter.latLonAltToCartesianNed(toLatLonAlt(srcRunway.start, srcAirport.altitude));
+				runway.endPoint = converter.latLonAltToCartesianNed(toLatLonAlt(srcRunway.end, srcAirport.altitude));
+
+				std::vector<std::string> strs;
+				boost::split(strs, srcRunway.name, boost::is_any_of("\\/"));
+				if (strs.size() == 2)
+				{
+					runway.startMarking = strs.front();
+					runway.endMarking = strs.back();
 				}
-				if (0)
+
+				runway.width = srcRunway.width;
+				runways.push_back(runway);
+			}
+			if (0)
+			{
+				for (const LatLonPoints& polygon : srcAirport.areaPolygons)
 				{
-					for (const LatLonPoints& polygon : srcAirport.areaPolygons)
+					PolyRegion region;
+					for (int j = 0; j < polygon.size(); ++j)
 					{
-						PolyRegion region;
-						for (int j = 0; j < polygon.size(); ++j)
-						{
-							region.points.push_back(converter.latLonAltToCartesianNed(toLatLonAlt(polygon[j], srcAirport.altitude)));
-						}
-						polyRegions.push_back(region);
+						region.points.push_back(converter.latLonAltToCartesianNed(toLatLonAlt(polygon[j], srcAirport.altitude)));
 					}
+					polyRegions.push_back(region);
 				}
 			}
-			break;
-			assert(!"Not implemented");
-			}
 		}
 
+		const sim::LatLon latLonOrigin;
+		const LlaToNedConverter converter;
+
+		Roads roads;
+		Runways runways;
+		Buildings buildings;
+		Lakes lakes;
+		PolyRegions polyRegions;
+	};
+
+	std::unique_ptr<LoadedVisObjects> createVisObjects(const VisFeatures& visFeatures) const
+	{
+		std::unique_ptr<LoadedVisObjects> objectsPtr = std::make_unique<LoadedVisObjects>();
+		LoadedVisObjects& objects = *objectsPtr;
+		objects.latLonOrigin = visFeatures.latLonOrigin;
+
+		const Roads& roads = visFeatures.roads;
+		const Runways& runways = visFeatures.runways;
+		const Buildings& buildings = visFeatures.buildings;
+		const Lakes& lakes = visFeatures.lakes;
+		const PolyRegions& polyRegions = visFeatures.polyRegions;
+
 		osg::ref_ptr<osg::Program> modelProgram = mPrograms->getRequiredProgram("model");
 
 		// Create roads
@@ -200,7 +270,6 @@ public:
 		return objectsPtr;
 	}
 
-private:
 	const ElevationProviderPtr mLatLonElevationProvider;
 	std::shared_mutex* mElevationProviderMutex;
 	const ShaderPrograms* mPrograms;
@@ -330,10 +399,18 @@ void PlanetFeatures::loadTile(VisFeatureTile& tile)
 			{
 				if (!loadingItem->cancel) // if Tile hasn't been canceled by the time the scheduled task runs
 				{
-					std::vector<mapfeatures::FeaturePtr> features;
-					mapfeatures::loadTile(filename, features);
-
-					loadingItem->objects = mVisObjectsLoadTask->loadVisObjects(features, origin, mPlanetRadius);
+					SKYBOLT_PROFILE_ZONE("PlanetFeatures load tile");
+					if (mapfeatures::MappedFeatureTile::isMappedFormat(filename))
+					{
+						mapfeatures::MappedFeatureTile tile(filename);
+						loadingItem->objects = mVisObjectsLoadTask->loadVisObjects(tile, origin, mPlanetRadius);
+					}
+					else
+					{
+						std::vector<mapfeatures::FeaturePtr> features;
+						mapfeatures::loadTile(filename, features);
+						loadingItem->objects = mVisObjectsLoadTask->loadVisObjects(features, origin, mPlanetRadius);
+					}
 				}
 			}, &mLoadingTaskSync);
 		}
@@ -377,11 +454,7 @@ void PlanetFeatures::processLoadingQueue()
 			std::unique_ptr<LoadedVisObjects>& objects = item.objects;
 			if (objects)
 			{
-#ifdef DEBUG_PLANET_FREATURES_LOAD_TIMES
-				cxxtimer::Timer timer;
-				timer.start();
-#endif
-
+				SKYBOLT_PROFILE_ZONE("PlanetFeatures add loaded tile");
 				for (int i = 0; i < PlanetFeaturesParams::featureGroupsSize; ++i)
 				{
 					for (const RootNodePtr& node : objects->nodes[i])
@@ -399,11 +472,6 @@ void PlanetFeatures::processLoadingQueue()
 				mLoadedVisObjects.push_back(item.tile->visObjects.get());
 				erase = true;
 				++loadedItems;
-
-#ifdef DEBUG_PLANET_FREATURES_LOAD_TIMES
-				printf("Feature %lli\n", timer.count());
-				timer.reset();
-#endif
 			}
 		}
 
@@ -5,6 +5,7 @@
  * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
 
 #include "PlanetFeaturesSource.h"
+#include "MappedFeatureTile.h"
 #include <SkyboltCommon/Exception.h>
 #include <SkyboltCommon/Math/MathUtility.h>
 #include <nlohmann/json.hpp>
@@ -50,44 +51,44 @@ static LatLonBounds calcPointBounds(const std::vector<sim::LatLonAlt>& points)
 }
 
 template <typename T>
-void readValue(std::ifstream& f, T& value)
+void readValue(std::istream& f, T& value)
 {
 	f.read((char*)&value, sizeof(value));
 }
 
 template <typename T>
-void writeValue(std::ofstream& f, const T& value)
+void writeValue(std::ostream& f, const T& value)
 {
 	f.write((const char*)&value, sizeof(value));
 }
 
-static void readLatLon(std::ifstream& f, sim::LatLon& latLon)
+static void readLatLon(std::istream& f, sim::LatLon& latLon)
 {
 	readValue(f, latLon.lat);
 	readValue(f, latLon.lon);
 }
 
-static void writeLatLon(std::ofstream& f, const sim::LatLon& latLon)
+static void writeLatLon(std::ostream& f, const sim::LatLon& latLon)
 {
 	writeValue(f, latLon.lat);
 	writeValue(f, latLon.lon); 
 }
 
-static void readLatLonAlt(std::ifstream& f, sim::LatLonAlt& latLonAlt)
+static void readLatLonAlt(std::istream& f, sim::LatLonAlt& latLonAlt)
 {
 	readValue(f, latLonAlt.lat);
 	readValue(f, latLonAlt.lon);
 	readValue(f, latLonAlt.alt);
 }
 
-static void writeLatLonAlt(std::ofstream& f, const sim::LatLonAlt& latLonAlt)
+static void writeLatLonAlt(std::ostream& f, const sim::LatLonAlt& latLonAlt)
 {
 	writeValue(f, latLonAlt.lat);
 	writeValue(f, latLonAlt.lon);
 	writeValue(f, latLonAlt.alt);
 }
 
-static void readPoints(std::ifstream& f, LatLonPoints& points)
+static void readPoints(std::istream& f, LatLonPoints& points)
 {
 	int pointCount;
 	readValue(f, pointCount);
@@ -102,7 +103,7 @@ static void readPoints(std::ifstream& f, LatLonPoints& points)
 	}
 }
 
-static void writePoints(std::ofstream& f, const LatLonPoints& points)
+static void writePoints(std::ostream& f, const LatLonPoints& points)
 {
 	int pointCount = (int)points.size();
 	writeValue(f, pointCount);
@@ -112,7 +113,7 @@ static void writePoints(std::ofstream& f, const LatLonPoints& points)
 	}
 }
 
-static void readPoints(std::ifstream& f, LatLonAltPoints& points)
+static void readPoints(std::istream& f, LatLonAltPoints& points)
 {
 	int pointCount;
 	readValue(f, pointCount);
@@ -127,7 +128,7 @@ static void readPoints(std::ifstream& f, LatLonAltPoints& points)
 	}
 }
 
-static void writePoints(std::ofstream& f, const LatLonAltPoints& points)
+static void writePoints(std::ostream& f, const LatLonAltPoints& points)
 {
 	int pointCount = (int)points.size();
 	writeValue(f, pointCount);
@@ -137,12 +138,12 @@ static void writePoints(std::ofstream& f, const LatLonAltPoints& points)
 	}
 }
 
-void PolyFeature::load(std::ifstream& f)
+void PolyFeature::load(std::istream& f)
 {
 	readPoints(f, points);
 }
 
-void PolyFeature::save(std::ofstream& f) const
+void PolyFeature::save(std::ostream& f) const
 {
 	writePoints(f, points);
 }
@@ -152,7 +153,7 @@ LatLonBounds PolyFeature::calcBounds() const
 	return calcPointBounds(points);
 }
 
-void Road::load(std::ifstream& f)
+void Road::load(std::istream& f)
 {
 	readValue(f, width);
 	readValue(f, laneCount);
@@ -163,7 +164,7 @@ void Road::load(std::ifstream& f)
 	PolyFeature::load(f);
 }
 
-void Road::save(std::ofstream& f) const
+void Road::save(std::ostream& f) const
 {
 	writeValue(f, width);
 	writeValue(f, laneCount);
@@ -174,19 +175,19 @@ void Road::save(std::ofstream& f) const
 	PolyFeature::save(f);
 }
 
-void Building::load(std::ifstream& f)
+void Building::load(std::istream& f)
 {
 	readValue(f, height);
 	PolyFeature::load(f);
 }
 
-void Building::save(std::ofstream& f) const
+void Building::save(std::ostream& f) const
 {
 	writeValue(f, height);
 	PolyFeature::save(f);
 }
 
-static std::string readString(std::ifstream& f)
+static std::string readString(std::istream& f)
 {
 	std::string str;
 	uint16_t size;
@@ -196,14 +197,14 @@ static std::string readString(std::ifstream& f)
 	return str;
 }
 
-static void writeString(std::ofstream& f, const std::string& str)
+static void writeString(std::ostream& f, const std::string& str)
 {
 	uint16_t size = str.size();
 	writeValue(f, size);
 	f.write(&str[0], size);
 }
 
-static void readRunway(std::ifstream& f, Airport::Runway& runway)
+static void readRunway(std::istream& f, Airport::Runway& runway)
 {
 	runway.name = readString(f);
 	readLatLon(f, runway.start);
@@ -211,7 +212,7 @@ static void readRunway(std::ifstream& f, Airport::Runway& runway)
 	readValue(f, runway.width);
 }
 
-static void writeRunway(std::ofstream& f, const Airport::Runway& runway)
+static void writeRunway(std::ostream& f, const Airport::Runway& runway)
 {
 	writeString(f, runway.name);
 	writeLatLon(f, runway.start);
@@ -219,7 +220,7 @@ static void writeRunway(std::ofstream& f, const Airport::Runway& runway)
 	writeValue(f, runway.width);
 }
 
-static void readPolygons(std::ifstream& f, std::vector<LatLonPoints>& polygons)
+static void readPolygons(std::istream& f, std::vector<LatLonPoints>& polygons)
 {
 	uint16_t areaPolygonCount;
 	readValue(f, areaPolygonCount);
@@ -230,7 +231,7 @@ static void readPolygons(std::ifstream& f, std::vector<LatLonPoints>& polygons)
 	}
 }
 
-static void writePolygons(std::ofstream& f, const std::vector<LatLonPoints>& polygons)
+static void writePolygons(std::ostream& f, const std::vector<LatLonPoints>& polygons)
 {
 	uint16_t areaPolygonCount = polygons.size();
 	writeValue(f, areaPolygonCount);
@@ -240,7 +241,7 @@ static void writePolygons(std::ofstream& f, const std::vector<LatLonPoints>& pol
 	}
 }
 
-void Airport::load(std::ifstream& f)
+void Airport::load(std::istream& f)
 {
 	{
 		uint16_t runwayCount;
@@ -255,7 +256,7 @@ void Airport::load(std::ifstream& f)
 	readValue(f, altitude);
 }
 
-void Airport::save(std::ofstream& f) const
+void Airport::save(std::ostream& f) const
 {
 	uint16_t runwayCount = runways.size();
 	writeValue(f, runwayCount);
@@ -303,7 +304,7 @@ static FeaturePtr createFeature(FeatureType type)
 	return nullptr;
 }
 
-static void load(std::ifstream& f, std::vector<FeaturePtr>& features)
+static void load(std::istream& f, std::vector<FeaturePtr>& features)
 {
 	uint32_t typeCount;
 	readValue(f, typeCount);
@@ -324,45 +325,16 @@ static void load(std::ifstream& f, std::vector<FeaturePtr>& features)
 	}
 }
 
-typedef std::map<FeatureType, size_t> FeatureTypeCounts;
+static const uint32_t legacyFileVersion = 1;
 
-static FeatureTypeCounts countFeatureTypes(const std::vector<FeaturePtr>& features)
-{
-	FeatureTypeCounts counts;
-	for (const FeaturePtr& feature : features)
-	{
-		++counts[feature->type()];
-	}
-	return counts;
-}
-
-static void save(std::ofstream& f, const std::vector<FeaturePtr>& features)
+void loadTile(const std::string& filename, std::vector<FeaturePtr>& features)
 {
-	FeatureTypeCounts counts = countFeatureTypes(features);
-	uint32_t countsSize = counts.size();
-
-	writeValue(f, countsSize);
-
-	for (const auto& entry : counts)
+	if (MappedFeatureTile::isMappedFormat(filename))
 	{
-		uint32_t type = entry.first;
-		writeValue(f, type);
-		writeValue(f, entry.second);
-		
-		for (const FeaturePtr& feature : features)
-		{
-			if (feature->type() == type)
-			{
-				feature->save(f);
-			}
-		}
+		MappedFeatureTile(filename).createFeatures(features);
+		return;
 	}
-}
-
-static const uint32_t fileVersion = 1;
 
-void loadTile(const std::string& filename, std::vector<FeaturePtr>& features)
-{
 	std::ifstream f(filename, std::ios::binary);
 
 	if (!f.is_open())
@@ -373,9 +345,9 @@ void loadTile(const std::string& filename, std::vector<FeaturePtr>& features)
 	uint32_t version;
 	f.read((char*)&version, sizeof(uint32_t));
 
-	if (version != fileVersion)
+	if (version != legacyFileVersion)
 	{
-		throw Exception("Invalid file version: " + std::to_string(version) + ". Expected: " + std::to_string(fileVersion));
+		throw Exception("Invalid file version: " + std::to_string(version) + ". Expected: " + std::to_string(legacyFileVersion));
 	}
 
 	load(f, features);
@@ -383,16 +355,7 @@ void loadTile(const std::string& filename, std::vector<FeaturePtr>& features)
 
 void saveTile(const FeatureTile& tile, const std::string& filename)
 {
-	std::ofstream f(filename, std::ios::binary);
-
-	// Write file version
-	int version = fileVersion;
-	writeValue(f, version);
-
-	// Write features
-	save(f, tile.features);
-
-	f.close();
+	saveMappedFeatureTile(tile.features, filename);
 }
 
 static nlohmann::json tileToJsonRecursive(const FeatureTile& tile)
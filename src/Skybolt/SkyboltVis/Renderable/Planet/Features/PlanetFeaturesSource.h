@@ -14,6 +14,7 @@
 
 #include <assert.h>
 #include <algorithm>
+#include <iosfwd>
 #include <map>
 #include <memory>
 #include <string>
@@ -40,8 +41,8 @@ struct Feature
 	virtual ~Feature() {}
 	virtual FeatureType type() const = 0;
 
-	virtual void load(std::ifstream& f) = 0;
-	virtual void save(std::ofstream& f) const = 0;
+	virtual void load(std::istream& f) = 0;
+	virtual void save(std::ostream& f) const = 0;
 	virtual LatLonBounds calcBounds() const = 0;
 };
 
@@ -49,8 +50,8 @@ struct PolyFeature : public Feature
 {
 	std::vector<sim::LatLonAlt> points;
 
-	void load(std::ifstream& f) override;
-	void save(std::ofstream& f) const override;
+	void load(std::istream& f) override;
+	void save(std::ostream& f) const override;
 	LatLonBounds calcBounds() const override;
 };
 
@@ -79,8 +80,8 @@ struct Road : public PolyFeature
 	//! Set to Road::noJunction if the road doesn't join.
 	int endLaneCounts[2];
 
-	void load(std::ifstream& f) override;
-	void save(std::ofstream& f) const override;
+	void load(std::istream& f) override;
+	void save(std::ostream& f) const override;
 };
 
 struct Building : public PolyFeature
@@ -89,8 +90,8 @@ struct Building : public PolyFeature
 
 	float height;
 	
-	void load(std::ifstream& f) override;
-	void save(std::ofstream& f) const override;
+	void load(std::istream& f) override;
+	void save(std::ostream& f) const override;
 };
 
 struct Water : public PolyFeature
@@ -117,8 +118,8 @@ struct Airport : public Feature
 	std::vector<LatLonPoints> areaPolygons; //!< Polygons that define the airport area
 	double altitude = 0;
 
-	void load(std::ifstream& f) override;
-	void save(std::ofstream& f) const override;
+	void load(std::istream& f) override;
+	void save(std::ostream& f) const override;
 	LatLonBounds calcBounds() const override;
 };
 
@@ -150,7 +151,10 @@ struct TreeCreatorParams
 
 WorldFeatures createWorldFeatures(const TreeCreatorParams& params, const std::vector<FeaturePtr>& features);
 
+//! Saves tile in the memory mappable format. @see MappedFeatureTile
 void saveTile(const FeatureTile& tile, const std::string& filename);
+
+//! Loads tile in either the memory mappable format or the legacy stream format
 void loadTile(const std::string& filename, std::vector<FeaturePtr>& features);
 
 void save(const WorldFeatures::DiQuadTree& tree, const std::string& directory);
@@ -117,6 +117,7 @@ public:
 
 	osg::Node* _getNode() const override;
 
+	UpdatePolicy getUpdatePolicy() const override { return UpdatePolicy::Always; }
 	void updatePreRender(const CameraRenderContext& context) override;
 
 private:
@@ -15,6 +15,7 @@
 #include "SkyboltVis/Camera.h"
 #include "SkyboltVis/Scene.h"
 #include "SkyboltVis/VisibilityCategory.h"
+#include "SkyboltVis/ElevationProvider/PlanetTerrainIntersector.h"
 #include "SkyboltVis/Renderable/Forest/GpuForestTile.h"
 #include "SkyboltVis/Renderable/Forest/PagedForest.h"
 #include "SkyboltVis/Renderable/Planet/Tile/ConcurrentAsyncTileLoader.h"
@@ -63,7 +64,8 @@ PlanetSurface::PlanetSurface(const PlanetSurfaceConfig& config) :
 	mOsgTileFactory(config.osgTileFactory),
 	mTileTexturesProvider(config.tileTexturesProvider),
 	mGpuForest(config.gpuForest),
-	mGroup(new osg::Group)
+	mGroup(new osg::Group),
+	mRadius(config.radius)
 {
 	mGroup->setNodeMask(vis::VisibilityCategory::defaultCategories);
 
@@ -116,11 +118,11 @@ bool PlanetSurface::updateGeometry()
 	// Get added and removed tile images
 	TileKeyImagesMap addedTiles;
 	std::set<QuadTreeTileKey> removedTiles;
-	QuadTreeTileLoader::LoadedTileTreePtr tree = mTileSource->getLoadedTree();
+	const QuadTreeTileLoader::FlatLoadedTileTree& tree = mTileSource->getFlatLoadedTree();
 
 	{
 		TileKeyImagesMap currentLeafTileImages;
-		findLeafTiles(*tree, currentLeafTileImages);
+		findLeafTiles(tree, currentLeafTileImages);
 		findAddedAndRemovedTiles(mLeafTileImages, currentLeafTileImages, addedTiles, removedTiles);
 		std::swap(mLeafTileImages, currentLeafTileImages);
 	}
@@ -135,6 +137,10 @@ bool PlanetSurface::updateGeometry()
 			mGroup->removeChild(tile.transform);
 			mTileNodes.erase(it);
 		}
+		if (mTerrainIntersector)
+		{
+			mTerrainIntersector->removeTile(key);
+		}
 		CALL_LISTENERS(tileRemovedFromSceneGraph(key));
 	}
 
@@ -151,13 +157,17 @@ bool PlanetSurface::updateGeometry()
 
 		mGroup->addChild(osgTile.transform);
 		mTileNodes[key] = osgTile;
+		if (mTerrainIntersector)
+		{
+			mTerrainIntersector->addTile(key, images.heightMapImage);
+		}
 
 		CALL_LISTENERS(tileAddedToSceneGraph(key));
 	}
 
 	if (mGpuForest)
 	{
-		mGpuForest->updateFromTree(*tree);
+		mGpuForest->updateFromTree(tree);
 	}
 
 	// Iif tiles were added this update, we might need to load their children next update.
@@ -166,6 +176,20 @@ bool PlanetSurface::updateGeometry()
 	return !mightNeedToLoadNextUpdate && !mTileSource->isLoading();
 }
 
+const PlanetTerrainIntersectorPtr& PlanetSurface::getTerrainIntersector() const
+{
+	if (!mTerrainIntersector)
+	{
+		mTerrainIntersector = std::make_shared<PlanetTerrainIntersector>(mRadius);
+		for (const auto& [key, tile] : mLeafTileImages)
+		{
+			const PlanetTileImages& images = static_cast<const PlanetTileImages&>(*tile);
+			mTerrainIntersector->addTile(key, images.heightMapImage);
+		}
+	}
+	return mTerrainIntersector;
+}
+
 static sim::LatLon toLatLon(const osg::Vec2d& latLon)
 {
 	return sim::LatLon(latLon.x(), latLon.y());
@@ -71,6 +71,11 @@ public:
 
 	const osg::ref_ptr<osg::Group>& getGroup() const { return mGroup; }
 
+	//! @returns intersector for the height maps of the currently loaded leaf tiles, in planet-fixed coordinates. Never null.
+	//! The intersector is created on the first call, and is only kept up to date with loaded tiles from then on,
+	//! so that surfaces which are never intersected do not pay for it. Must be called from the thread which updates the surface.
+	const PlanetTerrainIntersectorPtr& getTerrainIntersector() const;
+
 private:
 	bool updateGeometry(); //!< @returns true if all geometry loading has completed
 
@@ -83,8 +88,10 @@ private:
 
 	osg::ref_ptr<osg::MatrixTransform> mParentTransform;
 	osg::ref_ptr<osg::Group> mGroup;
+	float mRadius;
 
 	TileKeyImagesMap mLeafTileImages;
+	mutable PlanetTerrainIntersectorPtr mTerrainIntersector; //!< Null until requested
 	typedef std::map<skybolt::QuadTreeTileKey, OsgTile> TileNodeMap;
 	TileNodeMap mTileNodes;
 };
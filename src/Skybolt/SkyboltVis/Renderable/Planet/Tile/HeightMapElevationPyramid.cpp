@@ -0,0 +1,148 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "HeightMapElevationPyramid.h"
+#include <SkyboltCommon/Math/MathUtility.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace skybolt {
+namespace vis {
+
+HeightMapElevationPyramid::HeightMapElevationPyramid(const osg::ref_ptr<const osg::Image>& heightMap, int blockSize) :
+	mHeightMap(heightMap),
+	mData(reinterpret_cast<const uint16_t*>(heightMap->data())),
+	mRerange(getRequiredHeightMapElevationRerange(*heightMap)),
+	mWidth(heightMap->s()),
+	mHeight(heightMap->t()),
+	mBlockSize(std::max(1, blockSize))
+{
+	if (mWidth < 1 || mHeight < 1)
+	{
+		throw std::runtime_error("Height map has no texels");
+	}
+
+	// Level 0 blocks span mBlockSize texel intervals, and include the texels on both ends of the intervals
+	// so that each block bounds all elevations interpolated within it.
+	const int intervalCountX = std::max(1, mWidth - 1);
+	const int intervalCountY = std::max(1, mHeight - 1);
+
+	Level level;
+	level.countX = (intervalCountX + mBlockSize - 1) / mBlockSize;
+	level.countY = (intervalCountY + mBlockSize - 1) / mBlockSize;
+	level.bounds.resize(level.countX * level.countY);
+
+	for (int by = 0; by < level.countY; ++by)
+	{
+		int yEnd = std::min((by + 1) * mBlockSize, mHeight - 1);
+		for (int bx = 0; bx < level.countX; ++bx)
+		{
+			int xEnd = std::min((bx + 1) * mBlockSize, mWidth - 1);
+
+			uint16_t minValue = std::numeric_limits<uint16_t>::max();
+			uint16_t maxValue = 0;
+			for (int y = by * mBlockSize; y <= yEnd; ++y)
+			{
+				const uint16_t* row = mData + y * mWidth;
+				for (int x = bx * mBlockSize; x <= xEnd; ++x)
+				{
+					minValue = std::min(minValue, row[x]);
+					maxValue = std::max(maxValue, row[x]);
+				}
+			}
+
+			// The rerange may have a negative scale, so sort the converted values
+			float e0 = getElevationForColorValue(mRerange, minValue);
+			float e1 = getElevationForColorValue(mRerange, maxValue);
+			level.bounds[bx + by * level.countX] = HeightMapElevationBounds(std::min(e0, e1), std::max(e0, e1));
+		}
+	}
+	mLevels.push_back(std::move(level));
+
+	// Merge 2x2 blocks of each level to create the next level
+	while (mLevels.back().countX > 1 || mLevels.back().countY > 1)
+	{
+		const Level& prev = mLevels.back();
+		Level next;
+		next.countX = (prev.countX + 1) / 2;
+		next.countY = (prev.countY + 1) / 2;
+		next.bounds.resize(next.countX * next.countY, emptyHeightMapElevationBounds());
+
+		for (int y = 0; y < prev.countY; ++y)
+		{
+			for (int x = 0; x < prev.countX; ++x)
+			{
+				expand(next.bounds[x / 2 + (y / 2) * next.countX], prev.bounds[x + y * prev.countX]);
+			}
+		}
+		mLevels.push_back(std::move(next));
+	}
+}
+
+HeightMapElevationBounds HeightMapElevationPyramid::getBounds(const osg::Vec2d& minUv, const osg::Vec2d& maxUv) const
+{
+	int x0 = getBlockIndexX(0, minUv.x());
+	int x1 = getBlockIndexX(0, maxUv.x());
+	int y0 = getBlockIndexY(0, minUv.y());
+	int y1 = getBlockIndexY(0, maxUv.y());
+
+	HeightMapElevationBounds bounds = emptyHeightMapElevationBounds();
+	for (int y = y0; y <= y1; ++y)
+	{
+		for (int x = x0; x <= x1; ++x)
+		{
+			expand(bounds, getBlockBounds(0, x, y));
+		}
+	}
+	return bounds;
+}
+
+int HeightMapElevationPyramid::getBlockIndex(int level, double coord, int count) const
+{
+	int span = mBlockSize << level;
+	return std::clamp(int(std::floor(coord / span)), 0, count - 1);
+}
+
+std::pair<double, double> HeightMapElevationPyramid::getBlockRange(int level, int index, int count, int texelCount) const
+{
+	int span = mBlockSize << level;
+	double first = double(index * span);
+	double second = (index == count - 1) ? double(texelCount) : double((index + 1) * span);
+	return { first, second };
+}
+
+float HeightMapElevationPyramid::getElevation(double u, double v) const
+{
+	int sMax = mWidth - 1;
+	int tMax = mHeight - 1;
+
+	u = math::clamp(u, 0.0, double(sMax));
+	v = math::clamp(v, 0.0, double(tMax));
+
+	int u0 = int(u);
+	int u1 = std::min(u0 + 1, sMax);
+	int v0 = int(v);
+	int v1 = std::min(v0 + 1, tMax);
+
+	float fracU = float(u - u0);
+	float fracV = float(v - v0);
+
+	float d00 = float(mData[u0 + mWidth * v0]);
+	float d10 = float(mData[u1 + mWidth * v0]);
+	float d01 = float(mData[u0 + mWidth * v1]);
+	float d11 = float(mData[u1 + mWidth * v1]);
+
+	float d0 = math::lerp(d00, d10, fracU);
+	float d1 = math::lerp(d01, d11, fracU);
+
+	return getElevationForColorValue(mRerange, math::lerp(d0, d1, fracV));
+}
+
+} // namespace vis
+} // namespace skybolt
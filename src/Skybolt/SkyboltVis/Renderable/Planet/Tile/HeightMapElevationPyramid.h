@@ -0,0 +1,85 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#pragma once
+
+#include "HeightMapElevationBounds.h"
+#include "HeightMapElevationRerange.h"
+
+#include <osg/Image>
+#include <osg/Vec2d>
+#include <vector>
+
+namespace skybolt {
+namespace vis {
+
+//! Pyramid of HeightMapElevationBounds over square blocks of a height map, used to quickly reject regions of the
+//! height map which a query can not intersect. Level 0 is the finest level. Each level halves the resolution of the
+//! previous level, and the last level has one block covering the whole height map.
+//! Texel coordinates (u, v) range from (0, 0) at the first texel to (width, height) at the far edge of the height map,
+//! matching the mapping used by HeightMapElevationProvider. Elevations between texels are bilinearly interpolated,
+//! and coordinates beyond the last texel are clamped to it.
+class HeightMapElevationPyramid
+{
+public:
+	//! @param heightMap is a 16 bit luminance image with HeightMapElevationRerange user data
+	//! @param blockSize is the number of texel intervals spanned by each block at level 0
+	HeightMapElevationPyramid(const osg::ref_ptr<const osg::Image>& heightMap, int blockSize = 4);
+
+	int getWidth() const { return mWidth; } //!< @returns width of the height map in texels
+	int getHeight() const { return mHeight; } //!< @returns height of the height map in texels
+
+	int getLevelCount() const { return int(mLevels.size()); }
+	int getBlockCountX(int level) const { return mLevels[level].countX; }
+	int getBlockCountY(int level) const { return mLevels[level].countY; }
+
+	//! @returns bounds of all interpolated elevations within the block
+	const HeightMapElevationBounds& getBlockBounds(int level, int x, int y) const
+	{
+		const Level& l = mLevels[level];
+		return l.bounds[x + y * l.countX];
+	}
+
+	//! @returns bounds of all elevations in the height map
+	const HeightMapElevationBounds& getBounds() const { return mLevels.back().bounds.front(); }
+
+	//! @returns conservative bounds of the elevations within a texel coordinate rectangle
+	HeightMapElevationBounds getBounds(const osg::Vec2d& minUv, const osg::Vec2d& maxUv) const;
+
+	//! @returns index of the block at the given level containing the texel coordinate, clamped to the height map
+	int getBlockIndexX(int level, double u) const { return getBlockIndex(level, u, mLevels[level].countX); }
+	int getBlockIndexY(int level, double v) const { return getBlockIndex(level, v, mLevels[level].countY); }
+
+	//! @returns texel coordinate range [first, second] of a block. Blocks on the far edges extend to the edges of the height map.
+	std::pair<double, double> getBlockRangeX(int level, int x) const { return getBlockRange(level, x, mLevels[level].countX, mWidth); }
+	std::pair<double, double> getBlockRangeY(int level, int y) const { return getBlockRange(level, y, mLevels[level].countY, mHeight); }
+
+	//! @returns bilinearly interpolated elevation at the texel coordinate
+	float getElevation(double u, double v) const;
+
+private:
+	int getBlockIndex(int level, double coord, int count) const;
+	std::pair<double, double> getBlockRange(int level, int index, int count, int texelCount) const;
+
+private:
+	osg::ref_ptr<const osg::Image> mHeightMap;
+	const uint16_t* mData;
+	HeightMapElevationRerange mRerange;
+	int mWidth;
+	int mHeight;
+	int mBlockSize;
+
+	struct Level
+	{
+		int countX;
+		int countY;
+		std::vector<HeightMapElevationBounds> bounds;
+	};
+	std::vector<Level> mLevels;
+};
+
+} // namespace vis
+} // namespace skybolt
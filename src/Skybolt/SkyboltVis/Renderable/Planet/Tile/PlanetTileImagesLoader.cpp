@@ -11,15 +11,10 @@
 #include "SkyboltVis/Renderable/Planet/Tile/NormalMapHelpers.h"
 #include "SkyboltVis/OsgImageHelpers.h"
 #include "SkyboltVis/OsgTextureHelpers.h"
+#include <SkyboltCommon/Profiling/Profiler.h>
 #include <algorithm>
 #include <osg/Texture>
 
-//#define ENABLE_TILE_IMAGE_LOADER_PROFILING
-#ifdef ENABLE_TILE_IMAGE_LOADER_PROFILING
-#include <cxxtimer/cxxtimer.hpp>
-#include <iostream>
-#endif
-
 using namespace skybolt;
 
 namespace skybolt {
@@ -80,10 +75,7 @@ TileImagesPtr PlanetTileImagesLoader::load(const QuadTreeTileKey& key, std::func
 		return nullptr;
 	}
 
-#ifdef ENABLE_TILE_IMAGE_LOADER_PROFILING
-	cxxtimer::Timer timer;
-	timer.start();
-#endif
+	SKYBOLT_PROFILE_ZONE("PlanetTileImagesLoader::load");
 	auto images = std::make_shared<PlanetTileImages>();
 
 	static HeightMapElevationRerange defaultRerange = {1, 0};
@@ -93,6 +85,7 @@ TileImagesPtr PlanetTileImagesLoader::load(const QuadTreeTileKey& key, std::func
 
 	// Height map
 	{
+		SKYBOLT_PROFILE_ZONE("Load height map");
 		std::optional<QuadTreeTileKey> elevationKey = elevationLayer->getHighestAvailableLevel(key);
 		if (elevationKey)
 		{
@@ -118,16 +111,11 @@ TileImagesPtr PlanetTileImagesLoader::load(const QuadTreeTileKey& key, std::func
 			images->heightMapImage.image = defaultHeightImage;
 			images->normalMapImage = defaultNormalMap;
 		}
-
-#ifdef ENABLE_TILE_IMAGE_LOADER_PROFILING
-		std::cout << "Height@" << key.level << ": " << timer.count() << std::endl;
-		timer.reset();
-		timer.start();
-#endif
 	}
 
 	// Land mask
 	{
+		SKYBOLT_PROFILE_ZONE("Load land mask");
 		osg::ref_ptr<osg::Image> heightImage = images->heightMapImage.image;
 		images->landMaskImage = getOrCreateImage(images->heightMapImage.key, size_t(CacheIndex::LandMask), [this, heightImage, cancelSupplier](const QuadTreeTileKey& key) {
 			if (landMaskLayer)
@@ -149,16 +137,11 @@ TileImagesPtr PlanetTileImagesLoader::load(const QuadTreeTileKey& key, std::func
 		{
 			images->landMaskImage = defaultLandMask;
 		}
-
-#ifdef ENABLE_TILE_IMAGE_LOADER_PROFILING
-		std::cout << "Land@" << key.level << ": " << timer.count() << std::endl;
-		timer.reset();
-		timer.start();
-#endif
 	}
 
 	// Albedo map
 	{
+		SKYBOLT_PROFILE_ZONE("Load albedo map");
 		static osg::ref_ptr<osg::Image> defaultAlbedoImage = createDefaultAlbedoImage();
 
 		std::optional<QuadTreeTileKey> albedoKey = albedoLayer->getHighestAvailableLevel(key);
@@ -174,16 +157,11 @@ TileImagesPtr PlanetTileImagesLoader::load(const QuadTreeTileKey& key, std::func
 		{
 			images->albedoMapImage.image = defaultAlbedoImage;
 		}
-
-	#ifdef ENABLE_TILE_IMAGE_LOADER_PROFILING
-		std::cout << "Albedo@" << key.level << ": " << timer.count() << std::endl;
-		timer.reset();
-		timer.start();
-	#endif
 	}
 
 	// Attribute map
 	{
+		SKYBOLT_PROFILE_ZONE("Load attribute map");
 		if (attributeLayer)
 		{
 			std::optional<QuadTreeTileKey> attributeKey = attributeLayer->getHighestAvailableLevel(key);
@@ -209,17 +187,8 @@ TileImagesPtr PlanetTileImagesLoader::load(const QuadTreeTileKey& key, std::func
 				return convertToAttributeMap(*albedo);
 			});
 		}
-
-#ifdef ENABLE_TILE_IMAGE_LOADER_PROFILING
-		std::cout << "Attribute@" << key.level << ": " << timer.count();
-		timer.reset();
-		timer.start();
-#endif
 	}
 
-#ifdef ENABLE_TILE_IMAGE_LOADER_PROFILING
-	std::cout << "Total TileImage load time: " << timer.count() << std::endl;
-#endif
 	if (cancelSupplier())
 	{
 		return nullptr;
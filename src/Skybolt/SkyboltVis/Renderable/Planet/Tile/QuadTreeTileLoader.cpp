@@ -111,6 +111,7 @@ QuadTreeTileLoader::QuadTreeTileLoader(const AsyncTileLoaderPtr& asyncTileLoader
 	Box2d rightBounds(osg::Vec2d(0, -math::halfPiD()), osg::Vec2d(math::piD(), math::halfPiD()));
 	mAsyncTree = std::make_shared<AsyncQuadTree>(createTileT<AsyncQuadTreeTile, AsyncQuadTreeTile::VectorType>, QuadTreeTileKey(0, 0, 0), leftBounds, QuadTreeTileKey(0, 1, 0), rightBounds);
 	mLoadedTree = std::make_shared<LoadedTileTree>(createTileT<LoadedTile, LoadedTile::VectorType>, QuadTreeTileKey(0, 0, 0), leftBounds, QuadTreeTileKey(0, 1, 0), rightBounds);
+	mFlatLoadedTree = createFlatQuadTree(*mLoadedTree);
 }
 
 QuadTreeTileLoader::~QuadTreeTileLoader()
@@ -164,8 +165,15 @@ void QuadTreeTileLoader::update()
 
 	// Copy loaded tiles from the async tree to the loaded tree
 	{
-		populateLoadedTree(mAsyncTree->leftTree.getRoot(), mLoadedTree->leftTree, mLoadedTree->leftTree.getRoot());
-		populateLoadedTree(mAsyncTree->rightTree.getRoot(), mLoadedTree->rightTree, mLoadedTree->rightTree.getRoot());
+		bool structureChanged = false;
+		populateLoadedTree(mAsyncTree->leftTree.getRoot(), mLoadedTree->leftTree, mLoadedTree->leftTree.getRoot(), structureChanged);
+		populateLoadedTree(mAsyncTree->rightTree.getRoot(), mLoadedTree->rightTree, mLoadedTree->rightTree.getRoot(), structureChanged);
+
+		// The snapshot references the loaded tiles, so it only needs recreating when tiles are created or destroyed
+		if (structureChanged)
+		{
+			mFlatLoadedTree = createFlatQuadTree(*mLoadedTree);
+		}
 	}
 }
 
@@ -214,7 +222,7 @@ void QuadTreeTileLoader::traveseToLoadAndUnload(QuadTree<AsyncQuadTreeTile>& tre
 	}
 }
 
-void QuadTreeTileLoader::populateLoadedTree(AsyncQuadTreeTile& srcTile, skybolt::QuadTree<LoadedTile>& dstTree, LoadedTile& dstTile) const
+void QuadTreeTileLoader::populateLoadedTree(AsyncQuadTreeTile& srcTile, skybolt::QuadTree<LoadedTile>& dstTree, LoadedTile& dstTile, bool& structureChanged) const
 {
 	if (srcTile.getData())
 	{
@@ -237,17 +245,19 @@ void QuadTreeTileLoader::populateLoadedTree(AsyncQuadTreeTile& srcTile, skybolt:
 				if (!dstTile.hasChildren())
 				{
 					dstTree.subdivide(dstTile);
+					structureChanged = true;
 				}
 
 				for (int i = 0; i < 4; ++i)
 				{
-					populateLoadedTree(*srcTile.children[i], dstTree, *dstTile.children[i]);
+					populateLoadedTree(*srcTile.children[i], dstTree, *dstTile.children[i], structureChanged);
 				}
 			}
 		}
 		else if (dstTile.hasChildren())
 		{
 			dstTree.merge(dstTile);
+			structureChanged = true;
 		}
 	}
 	else
@@ -293,6 +303,21 @@ void findLeafTiles(const QuadTreeTileLoader::LoadedTileTree& tree, TileKeyImages
 	findLeafTiles(tree.rightTree.getRoot(), result, maxLevel);
 }
 
+void findLeafTiles(const QuadTreeTileLoader::FlatLoadedTileTree& tree, TileKeyImagesMap& result, std::optional<int> maxLevel)
+{
+	tree.traverse([&] (const QuadTreeTileLoader::LoadedTile& tile) {
+		if ((maxLevel && tile.key.level == *maxLevel) || !tile.hasChildren())
+		{
+			if (tile.images)
+			{
+				result[tile.key] = tile.images;
+			}
+			return false;
+		}
+		return true;
+	});
+}
+
 void findAddedAndRemovedTiles(const TileKeyImagesMap& previousTiles, const TileKeyImagesMap& currentTiles,
 	TileKeyImagesMap& addedTiles, std::set<QuadTreeTileKey>& removedTiles)
 {
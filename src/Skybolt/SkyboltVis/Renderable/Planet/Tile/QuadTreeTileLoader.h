@@ -9,11 +9,13 @@
 #include "SkyboltVis/OsgBox2.h"
 #include "SkyboltVis/SkyboltVisFwd.h"
 #include <SkyboltCommon/Listenable.h>
+#include <SkyboltCommon/Math/FlatQuadTree.h>
 #include <SkyboltCommon/Math/QuadTree.h>
 
 #include <osg/Vec2d>
 
 #include <assert.h>
+#include <optional>
 #include <set>
 #include <vector>
 
@@ -68,10 +70,17 @@ public:
 
 	LoadedTileTreePtr getLoadedTree() const { return mLoadedTree; }
 
+	typedef skybolt::FlatQuadTree<LoadedTile> FlatLoadedTileTree;
+
+	//! @returns snapshot of the loaded tree for fast traversal. Recreated by update() when tiles are subdivided or merged,
+	//! so references are only valid until the next update.
+	const FlatLoadedTileTree& getFlatLoadedTree() const { return *mFlatLoadedTree; }
+
 private:
 	void traveseToLoadAndUnload(skybolt::QuadTree<AsyncQuadTreeTile>& tree, AsyncQuadTreeTile& tile);
 	
-	void populateLoadedTree(AsyncQuadTreeTile& srcTile, skybolt::QuadTree<LoadedTile>& destTree, LoadedTile& destTile) const;
+	//! @param structureChanged is set to true if any tile was subdivided or merged
+	void populateLoadedTree(AsyncQuadTreeTile& srcTile, skybolt::QuadTree<LoadedTile>& destTree, LoadedTile& destTile, bool& structureChanged) const;
 
 	void loadTile(AsyncQuadTreeTile& tile);
 
@@ -83,6 +92,7 @@ private:
 	QuadTreeSubdivisionPredicatePtr mSubdivisionPredicate;
 	AsyncTileTreePtr mAsyncTree;
 	LoadedTileTreePtr mLoadedTree;
+	std::optional<FlatLoadedTileTree> mFlatLoadedTree;
 
 	struct LoadRequest
 	{
@@ -96,6 +106,7 @@ using TileKeyImagesMap = std::map<QuadTreeTileKey, TileImagesPtr>;
 
 void findLeafTiles(const QuadTreeTileLoader::LoadedTile& tile, TileKeyImagesMap& result, std::optional<int> maxLevel = std::nullopt);
 void findLeafTiles(const QuadTreeTileLoader::LoadedTileTree& tree, TileKeyImagesMap& result, std::optional<int> maxLevel = std::nullopt);
+void findLeafTiles(const QuadTreeTileLoader::FlatLoadedTileTree& tree, TileKeyImagesMap& result, std::optional<int> maxLevel = std::nullopt);
 
 void findAddedAndRemovedTiles(const TileKeyImagesMap& previousTiles, const TileKeyImagesMap& currentTiles,
 	TileKeyImagesMap& addedTiles, std::set<QuadTreeTileKey>& removedTiles);
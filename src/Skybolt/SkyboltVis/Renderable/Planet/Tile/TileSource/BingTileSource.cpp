@@ -5,6 +5,7 @@
  * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
 
 #include "BingTileSource.h"
+#include "HttpTileFetcher.h"
 #include "SkyboltVis/OsgBox2.h"
 #include "SkyboltVis/OsgImageHelpers.h"
 #include <SkyboltCommon/Math/MathUtility.h>
@@ -52,7 +53,8 @@ static std::string tileXYToQuadKey(int tileX, int tileY, int levelOfDetail)
 
 BingTileSource::BingTileSource(const BingTileSourceConfig& config) :
 	TileSourceWithMinMaxLevel(config.levelRange),
-	mCacheSha(skybolt::calcSha1(config.url))
+	mCacheSha(skybolt::calcSha1(config.url)),
+	mHttpTileFetcher(config.httpTileFetcher)
 {
 
 	httplib::Client cli(config.url.c_str());
@@ -89,6 +91,10 @@ osg::ref_ptr<osg::Image> BingTileSource::createImage(const QuadTreeTileKey& key,
 	}
 
 	std::string url = mUrlPartBeforeTileKey + tileXYToQuadKey(key.x, key.y, key.level) + mUrlPartAfterTileKey;
+	if (mHttpTileFetcher && HttpTileFetcher::supportsUrl(url))
+	{
+		return fetchImage(*mHttpTileFetcher, url, cancelSupplier);
+	}
 	return readImageWithoutWarnings(url);
 }
 
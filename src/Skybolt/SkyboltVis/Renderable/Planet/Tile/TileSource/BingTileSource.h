@@ -6,6 +6,7 @@
 
 #pragma once
 #include "TileSourceWithMinMaxLevel.h"
+#include "SkyboltVis/SkyboltVisFwd.h"
 
 namespace skybolt {
 namespace vis {
@@ -15,6 +16,7 @@ struct BingTileSourceConfig
 	std::string url;
 	std::string apiKey;
 	IntRangeInclusive levelRange;
+	HttpTileFetcherPtr httpTileFetcher; //!< If provided, used to fetch images from http URLs
 };
 
 class BingTileSource : public TileSourceWithMinMaxLevel
@@ -29,6 +31,7 @@ private:
 	const std::string mCacheSha;
 	std::string mUrlPartBeforeTileKey;
 	std::string mUrlPartAfterTileKey;
+	const HttpTileFetcherPtr mHttpTileFetcher;
 };
 
 } // namespace vis
@@ -11,6 +11,9 @@
 #include <osgDB/WriteFile>
 
 #include <filesystem>
+#include <fstream>
+#include <functional>
+#include <thread>
 
 namespace skybolt {
 namespace vis {
@@ -22,10 +25,19 @@ CachedTileSource::CachedTileSource(const TileSourcePtr& tileSource, const std::s
 	assert(mTileSource);
 }
 
+std::string CachedTileSource::getCacheFilename(const skybolt::QuadTreeTileKey& key) const
+{
+	return mCacheDirectory + "/" + std::to_string(key.level) + "/" + std::to_string(key.x) + "/" + std::to_string(key.y) + "." + mTileSource->getCacheFileFormat();
+}
+
+bool CachedTileSource::isCached(const skybolt::QuadTreeTileKey& key) const
+{
+	return std::filesystem::exists(getCacheFilename(key));
+}
+
 osg::ref_ptr<osg::Image> CachedTileSource::createImage(const skybolt::QuadTreeTileKey& key, std::function<bool()> cancelSupplier) const
 {
-	std::string imageDirectory = mCacheDirectory + "/" + std::to_string(key.level) + "/" + std::to_string(key.x) + "/";
-	std::string filename = imageDirectory + std::to_string(key.y) + "." + mTileSource->getCacheFileFormat();
+	std::string filename = getCacheFilename(key);
 
 	const bool supportUserData = (mTileSource->getCacheFileFormat() == "pngx");
 
@@ -53,28 +65,46 @@ osg::ref_ptr<osg::Image> CachedTileSource::createImage(const skybolt::QuadTreeTi
 		osg::ref_ptr<osg::Image> image = mTileSource->createImage(key, cancelSupplier);
 		if (image)
 		{
-			std::filesystem::create_directories(imageDirectory);
-
-			if (supportUserData)
-			{
-				std::ofstream f(filename.c_str(), std::ios::binary);
-				if (!writeImageWithUserData(*image, f, "png"))
-				{
-					throw std::runtime_error("Could not write cached tile image to: " + filename);
-				}
-				f.close();
-			}
-			else
-			{
-				if (!osgDB::writeImageFile(*image, filename))
-				{
-					throw std::runtime_error("Could not write cached tile image to: " + filename);
-				}
-			}
+			writeToCache(*image, filename);
 		}
 		return image;
 	}
 }
 
+void CachedTileSource::writeToCache(const osg::Image& image, const std::string& filename) const
+{
+	std::filesystem::path path(filename);
+	std::filesystem::create_directories(path.parent_path());
+
+	// Write to a temporary file first and then rename it, so that an interrupted write never leaves a partial tile in the cache.
+	// The temporary filename keeps the format extension so that osgDB can choose a writer.
+	std::filesystem::path tempPath = path;
+	tempPath.replace_filename(path.stem().string() + ".partial" + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id())) + path.extension().string());
+
+	bool written;
+	if (mTileSource->getCacheFileFormat() == "pngx")
+	{
+		std::ofstream f(tempPath, std::ios::binary);
+		written = writeImageWithUserData(image, f, "png");
+		f.close();
+		written = written && f.good();
+	}
+	else
+	{
+		written = osgDB::writeImageFile(image, tempPath.string());
+	}
+
+	std::error_code error;
+	if (written)
+	{
+		std::filesystem::rename(tempPath, path, error);
+	}
+	if (!written || error)
+	{
+		std::filesystem::remove(tempPath, error);
+		throw std::runtime_error("Could not write cached tile image to: " + filename);
+	}
+}
+
 } // namespace vis
 } // namespace skybolt
@@ -31,6 +31,14 @@ public:
 
 	const std::string& getCacheSha() const override { throw std::runtime_error("Cached tile source cann't be cached"); }
 
+	std::string getCacheFilename(const skybolt::QuadTreeTileKey& key) const;
+
+	//! @return true if the tile with the given key has been written to the cache
+	bool isCached(const skybolt::QuadTreeTileKey& key) const;
+
+private:
+	void writeToCache(const osg::Image& image, const std::string& filename) const;
+
 private:
 	TileSourcePtr mTileSource;
 	std::string mCacheDirectory;
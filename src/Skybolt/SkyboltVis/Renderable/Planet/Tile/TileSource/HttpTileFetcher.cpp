@@ -0,0 +1,393 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "HttpTileFetcher.h"
+#include "SkyboltVis/OsgImageHelpers.h"
+
+#include <httplib/httplib.h>
+#include <osgDB/FileNameUtils>
+
+#include <boost/algorithm/string/predicate.hpp>
+
+#include <cassert>
+#include <chrono>
+#include <optional>
+#include <thread>
+
+namespace skybolt {
+namespace vis {
+
+struct HttpTileFetcher::Connection
+{
+	std::string schemeHostPort;
+	std::unique_ptr<httplib::Client> client;
+};
+
+namespace {
+
+const auto pollInterval = std::chrono::milliseconds(10);
+
+struct UrlParts
+{
+	std::string schemeHostPort; //!< e.g. "http://test.com:8080"
+	std::string path; //!< Path including query, e.g. "/tiles/1/2/3.png?key=abc"
+};
+
+std::optional<UrlParts> splitUrl(const std::string& url)
+{
+	size_t schemeEnd = url.find("://");
+	if (schemeEnd == std::string::npos)
+	{
+		return std::nullopt;
+	}
+
+	size_t pathBegin = url.find_first_of("/?", schemeEnd + 3);
+	if (pathBegin == std::string::npos)
+	{
+		return UrlParts{url, "/"};
+	}
+
+	std::string path = url.substr(pathBegin);
+	if (path.front() == '?')
+	{
+		path = "/" + path;
+	}
+	return UrlParts{url.substr(0, pathBegin), path};
+}
+
+bool isRetryableStatus(int status)
+{
+	return status == 429 || status >= 500;
+}
+
+void splitSeconds(double seconds, time_t& wholeSeconds, time_t& microseconds)
+{
+	wholeSeconds = time_t(seconds);
+	microseconds = time_t((seconds - double(wholeSeconds)) * 1e6);
+}
+
+std::unique_ptr<httplib::Client> createClient(const std::string& schemeHostPort, const HttpTileFetcherConfig& config)
+{
+	auto client = std::make_unique<httplib::Client>(schemeHostPort);
+	client->set_keep_alive(true);
+	client->set_follow_location(true);
+
+	time_t seconds, microseconds;
+	splitSeconds(config.connectionTimeout, seconds, microseconds);
+	client->set_connection_timeout(seconds, microseconds);
+	splitSeconds(config.readTimeout, seconds, microseconds);
+	client->set_read_timeout(seconds, microseconds);
+
+#ifdef CPPHTTPLIB_OPENSSL_SUPPORT
+	client->enable_server_certificate_verification(config.verifyServerCertificate);
+#endif
+	return client;
+}
+
+//! @return false if aborted before the delay elapsed
+bool sleepUnlessAborted(double seconds, const std::function<bool()>& shouldAbort)
+{
+	auto end = std::chrono::steady_clock::now() + std::chrono::duration<double>(seconds);
+	while (std::chrono::steady_clock::now() < end)
+	{
+		if (shouldAbort())
+		{
+			return false;
+		}
+		std::this_thread::sleep_for(pollInterval);
+	}
+	return true;
+}
+
+} // namespace
+
+HttpTileFetcher::HttpTileFetcher(const HttpTileFetcherConfig& config) :
+	mConfig(config)
+{
+	assert(mConfig.maxConcurrentRequests > 0);
+	assert(mConfig.maxConnectionsPerHost > 0);
+	assert(mConfig.maxAttempts > 0);
+}
+
+HttpTileFetcher::~HttpTileFetcher() = default;
+
+bool HttpTileFetcher::supportsUrl(const std::string& url)
+{
+#ifdef CPPHTTPLIB_OPENSSL_SUPPORT
+	if (boost::istarts_with(url, "https://"))
+	{
+		return true;
+	}
+#endif
+	return boost::istarts_with(url, "http://");
+}
+
+HttpTileResponsePtr HttpTileFetcher::fetch(const std::string& url, const std::function<bool()>& cancelSupplier)
+{
+	++mRequestCount;
+
+	std::promise<HttpTileResponsePtr> promise;
+	InFlightRequestPtr request;
+	bool isLeader = false;
+	{
+		std::scoped_lock<std::mutex> lock(mInFlightMutex);
+		auto i = mInFlightRequests.find(url);
+		if (i != mInFlightRequests.end())
+		{
+			request = i->second;
+			++request->waiterCount;
+		}
+		else
+		{
+			request = std::make_shared<InFlightRequest>();
+			request->response = promise.get_future().share();
+			mInFlightRequests[url] = request;
+			isLeader = true;
+		}
+	}
+
+	if (!isLeader)
+	{
+		++mCoalescedCount;
+		return waitForInFlightRequest(url, request, cancelSupplier);
+	}
+
+	auto removeRequest = [&] {
+		std::scoped_lock<std::mutex> lock(mInFlightMutex);
+		auto i = mInFlightRequests.find(url);
+		if (i != mInFlightRequests.end() && i->second == request)
+		{
+			mInFlightRequests.erase(i);
+		}
+	};
+
+	// The leader performs the request on behalf of all waiters, and only aborts once every waiter has cancelled
+	bool cancelled = false;
+	auto shouldAbort = [&] {
+		if (!cancelled && cancelSupplier())
+		{
+			cancelled = true;
+			removeWaiter(url, request);
+		}
+		if (cancelled)
+		{
+			std::scoped_lock<std::mutex> lock(mInFlightMutex);
+			return request->waiterCount == 0;
+		}
+		return false;
+	};
+
+	HttpTileResponsePtr response;
+	try
+	{
+		response = fetchWithRetries(url, shouldAbort);
+	}
+	catch (...)
+	{
+		removeRequest();
+		promise.set_exception(std::current_exception());
+		throw;
+	}
+
+	removeRequest();
+	promise.set_value(response);
+
+	if (cancelled)
+	{
+		++mCancelledCount;
+	}
+	return response;
+}
+
+void HttpTileFetcher::removeWaiter(const std::string& url, const InFlightRequestPtr& request)
+{
+	std::scoped_lock<std::mutex> lock(mInFlightMutex);
+	--request->waiterCount;
+	if (request->waiterCount == 0)
+	{
+		// Remove the abandoned request so that later callers start a new one
+		auto i = mInFlightRequests.find(url);
+		if (i != mInFlightRequests.end() && i->second == request)
+		{
+			mInFlightRequests.erase(i);
+		}
+	}
+}
+
+HttpTileResponsePtr HttpTileFetcher::waitForInFlightRequest(const std::string& url, const InFlightRequestPtr& request, const std::function<bool()>& cancelSupplier)
+{
+	while (request->response.wait_for(pollInterval) != std::future_status::ready)
+	{
+		if (cancelSupplier())
+		{
+			removeWaiter(url, request);
+			++mCancelledCount;
+			return nullptr;
+		}
+	}
+	return request->response.get();
+}
+
+HttpTileResponsePtr HttpTileFetcher::fetchWithRetries(const std::string& url, const std::function<bool()>& shouldAbort)
+{
+	std::optional<UrlParts> parts = splitUrl(url);
+	if (!parts)
+	{
+		++mFailureCount;
+		return nullptr;
+	}
+
+	double retryDelay = mConfig.initialRetryDelay;
+	for (int attempt = 0; attempt < mConfig.maxAttempts; ++attempt)
+	{
+		if (attempt > 0)
+		{
+			++mRetryCount;
+			if (!sleepUnlessAborted(retryDelay, shouldAbort))
+			{
+				return nullptr;
+			}
+			retryDelay *= 2;
+		}
+		else if (shouldAbort())
+		{
+			return nullptr;
+		}
+
+		std::unique_ptr<Connection> connection = acquireConnection(parts->schemeHostPort, shouldAbort);
+		if (!connection)
+		{
+			return nullptr;
+		}
+
+		++mAttemptCount;
+		httplib::Result result = connection->client->Get(parts->path.c_str(), [&] (uint64_t current, uint64_t total) {
+			return !shouldAbort();
+		});
+
+		// Connections which failed or were aborted part way through a response are not reused
+		releaseConnection(std::move(connection), bool(result));
+
+		if (!result)
+		{
+			if (result.error() == httplib::Error::Canceled)
+			{
+				return nullptr;
+			}
+			continue;
+		}
+
+		if (result->status == 200)
+		{
+			mBytesReceived += result->body.size();
+
+			auto response = std::make_shared<HttpTileResponse>();
+			response->contentType = result->get_header_value("Content-Type");
+			response->body = std::move(result->body);
+			return response;
+		}
+
+		if (!isRetryableStatus(result->status))
+		{
+			break;
+		}
+	}
+
+	++mFailureCount;
+	return nullptr;
+}
+
+std::unique_ptr<HttpTileFetcher::Connection> HttpTileFetcher::acquireConnection(const std::string& schemeHostPort, const std::function<bool()>& shouldAbort)
+{
+	{
+		std::unique_lock<std::mutex> lock(mConnectionMutex);
+		while (mActiveRequestCount >= mConfig.maxConcurrentRequests
+			|| mActiveConnectionCounts[schemeHostPort] >= mConfig.maxConnectionsPerHost)
+		{
+			mConnectionReleased.wait_for(lock, pollInterval);
+
+			lock.unlock();
+			bool abort = shouldAbort();
+			lock.lock();
+			if (abort)
+			{
+				return nullptr;
+			}
+		}
+
+		++mActiveRequestCount;
+		++mActiveConnectionCounts[schemeHostPort];
+
+		std::vector<std::unique_ptr<Connection>>& idleConnections = mIdleConnections[schemeHostPort];
+		if (!idleConnections.empty())
+		{
+			std::unique_ptr<Connection> connection = std::move(idleConnections.back());
+			idleConnections.pop_back();
+			return connection;
+		}
+	}
+
+	++mConnectionCount;
+	auto connection = std::make_unique<Connection>();
+	connection->schemeHostPort = schemeHostPort;
+	connection->client = createClient(schemeHostPort, mConfig);
+	return connection;
+}
+
+void HttpTileFetcher::releaseConnection(std::unique_ptr<Connection> connection, bool reusable)
+{
+	{
+		std::scoped_lock<std::mutex> lock(mConnectionMutex);
+		--mActiveRequestCount;
+		--mActiveConnectionCounts[connection->schemeHostPort];
+
+		if (reusable)
+		{
+			mIdleConnections[connection->schemeHostPort].push_back(std::move(connection));
+		}
+	}
+	mConnectionReleased.notify_all();
+}
+
+HttpTileFetcherStats HttpTileFetcher::getStats() const
+{
+	HttpTileFetcherStats stats;
+	stats.requestCount = mRequestCount;
+	stats.coalescedCount = mCoalescedCount;
+	stats.attemptCount = mAttemptCount;
+	stats.retryCount = mRetryCount;
+	stats.failureCount = mFailureCount;
+	stats.cancelledCount = mCancelledCount;
+	stats.connectionCount = mConnectionCount;
+	stats.bytesReceived = mBytesReceived;
+	return stats;
+}
+
+std::string getImageFileExtension(const HttpTileResponse& response, const std::string& url)
+{
+	std::string contentType = response.contentType.substr(0, response.contentType.find(';'));
+	if (boost::iequals(contentType, "image/png")) { return "png"; }
+	if (boost::iequals(contentType, "image/jpeg")) { return "jpg"; }
+	if (boost::iequals(contentType, "image/webp")) { return "webp"; }
+	if (boost::iequals(contentType, "image/tiff")) { return "tif"; }
+	if (boost::iequals(contentType, "image/gif")) { return "gif"; }
+
+	std::string path = url.substr(0, url.find_first_of("?#"));
+	return osgDB::getLowerCaseFileExtension(path);
+}
+
+osg::ref_ptr<osg::Image> fetchImage(HttpTileFetcher& fetcher, const std::string& url, const std::function<bool()>& cancelSupplier)
+{
+	HttpTileResponsePtr response = fetcher.fetch(url, cancelSupplier);
+	if (!response)
+	{
+		return nullptr;
+	}
+	return readImageFromMemory(response->body, getImageFileExtension(*response, url));
+}
+
+} // namespace vis
+} // namespace skybolt
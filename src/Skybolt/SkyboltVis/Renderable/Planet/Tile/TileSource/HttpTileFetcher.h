@@ -0,0 +1,136 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#pragma once
+
+#include "SkyboltVis/SkyboltVisFwd.h"
+
+#include <osg/Image>
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace httplib {
+class Client;
+} // namespace httplib
+
+namespace skybolt {
+namespace vis {
+
+struct HttpTileFetcherConfig
+{
+	int maxConcurrentRequests = 16; //!< Maximum number of requests in flight across all hosts
+	int maxConnectionsPerHost = 6; //!< Maximum number of pooled keep-alive connections per host
+	int maxAttempts = 3; //!< Maximum number of attempts per request, including the first
+	double initialRetryDelay = 0.2; //!< Delay in seconds before the first retry. Doubles for each further retry.
+	double connectionTimeout = 10; //!< Seconds
+	double readTimeout = 20; //!< Seconds
+	//! If false, HTTPS servers are accepted without verifying their certificate.
+	//! Only disable this for trusted servers whose certificates can't be verified, e.g. behind an intercepting proxy.
+	bool verifyServerCertificate = true;
+};
+
+struct HttpTileFetcherStats
+{
+	int64_t requestCount = 0; //!< Number of fetch() calls
+	int64_t coalescedCount = 0; //!< Number of fetch() calls which joined an in-flight request for the same URL
+	int64_t attemptCount = 0; //!< Number of HTTP requests sent, including retries
+	int64_t retryCount = 0;
+	int64_t failureCount = 0;
+	int64_t cancelledCount = 0;
+	int64_t connectionCount = 0; //!< Number of connections created
+	int64_t bytesReceived = 0;
+};
+
+struct HttpTileResponse
+{
+	std::string body;
+	std::string contentType;
+};
+
+using HttpTileResponsePtr = std::shared_ptr<const HttpTileResponse>;
+
+//! Fetches tiles over HTTP from many threads at once.
+//! Connections are kept alive and pooled per host, the total number of requests in flight is bounded,
+//! concurrent requests for the same URL are coalesced into a single request,
+//! and transient failures (network errors, 5xx and 429 responses) are retried with exponential backoff.
+//! This class is thread safe.
+class HttpTileFetcher
+{
+public:
+	HttpTileFetcher(const HttpTileFetcherConfig& config = HttpTileFetcherConfig());
+	~HttpTileFetcher();
+
+	//! @return true if the URL's scheme is supported. HTTPS is only supported if httplib was built with OpenSSL.
+	static bool supportsUrl(const std::string& url);
+
+	//! Blocks until the response is received, the request fails, or the request is cancelled.
+	//! A request shared by several callers is only aborted once all callers have cancelled.
+	//! Cancellation is checked before each attempt and while the response body is being received.
+	//! @param cancelSupplier returns true if the caller no longer needs the response.
+	//! @return the response, or null if the request failed or was cancelled.
+	HttpTileResponsePtr fetch(const std::string& url, const std::function<bool()>& cancelSupplier = [] { return false; });
+
+	HttpTileFetcherStats getStats() const;
+
+private:
+	struct InFlightRequest
+	{
+		std::shared_future<HttpTileResponsePtr> response;
+		int waiterCount = 1; //!< Guarded by mInFlightMutex
+	};
+	using InFlightRequestPtr = std::shared_ptr<InFlightRequest>;
+
+	HttpTileResponsePtr waitForInFlightRequest(const std::string& url, const InFlightRequestPtr& request, const std::function<bool()>& cancelSupplier);
+
+	//! Removes a waiter from an in-flight request, and forgets the request if no waiters remain
+	void removeWaiter(const std::string& url, const InFlightRequestPtr& request);
+
+	//! @param shouldAbort returns true if the request should be abandoned
+	HttpTileResponsePtr fetchWithRetries(const std::string& url, const std::function<bool()>& shouldAbort);
+
+	struct Connection;
+	std::unique_ptr<Connection> acquireConnection(const std::string& schemeHostPort, const std::function<bool()>& shouldAbort);
+	void releaseConnection(std::unique_ptr<Connection> connection, bool reusable);
+
+private:
+	const HttpTileFetcherConfig mConfig;
+
+	std::mutex mInFlightMutex;
+	std::map<std::string, InFlightRequestPtr> mInFlightRequests;
+
+	std::mutex mConnectionMutex;
+	std::condition_variable mConnectionReleased;
+	std::map<std::string, std::vector<std::unique_ptr<Connection>>> mIdleConnections;
+	std::map<std::string, int> mActiveConnectionCounts;
+	int mActiveRequestCount = 0;
+
+	std::atomic<int64_t> mRequestCount{0};
+	std::atomic<int64_t> mCoalescedCount{0};
+	std::atomic<int64_t> mAttemptCount{0};
+	std::atomic<int64_t> mRetryCount{0};
+	std::atomic<int64_t> mFailureCount{0};
+	std::atomic<int64_t> mCancelledCount{0};
+	std::atomic<int64_t> mConnectionCount{0};
+	std::atomic<int64_t> mBytesReceived{0};
+};
+
+//! @return file extension of the image format, determined from the response's content type if known, otherwise from the URL
+std::string getImageFileExtension(const HttpTileResponse& response, const std::string& url);
+
+//! Fetches and decodes an image
+//! @return the image, or null if the image could not be fetched or decoded
+osg::ref_ptr<osg::Image> fetchImage(HttpTileFetcher& fetcher, const std::string& url, const std::function<bool()>& cancelSupplier);
+
+} // namespace vis
+} // namespace skybolt
@@ -13,12 +13,17 @@
 #include "SkyboltVis/Renderable/Planet/Tile/TileSource/XyzTileSource.h"
 #include <SkyboltCommon/Json/JsonHelpers.h>
 
+#include <px_sched/px_sched.h>
+
 namespace skybolt {
 namespace vis {
 
 JsonTileSourceFactoryRegistry::JsonTileSourceFactoryRegistry(const JsonTileSourceFactoryRegistryConfig& config) :
 	mCacheDirectory(config.cacheDirectory),
-	mApiKeys(config.apiKeys)
+	mApiKeys(config.apiKeys),
+	mHttpTileFetcher(std::make_shared<HttpTileFetcher>(config.httpTileFetcher)),
+	// Fetch threads spend most of their time waiting on the network, so use as many as there can be requests in flight
+	mSourceTileFetchThreadCount(std::max(1, config.httpTileFetcher.maxConcurrentRequests))
 {
 }
 
@@ -62,12 +67,25 @@ JsonTileSourceFactory JsonTileSourceFactoryRegistry::wrapWithProjectionSupport(J
 		auto tileSource = factory(json);
 		if (json.at("projection") == "sphericalMercator")
 		{
-			return std::make_shared<SphericalMercatorToPlateCarreeTileSource>(tileSource);
+			return std::make_shared<SphericalMercatorToPlateCarreeTileSource>(tileSource, getSourceTileFetchScheduler());
 		}
 		return tileSource;
 	};
 }
 
+std::shared_ptr<px_sched::Scheduler> JsonTileSourceFactoryRegistry::getSourceTileFetchScheduler() const
+{
+	std::scoped_lock<std::mutex> lock(mSourceTileFetchSchedulerMutex);
+	if (!mSourceTileFetchScheduler)
+	{
+		px_sched::SchedulerParams schedulerParams;
+		schedulerParams.num_threads = uint16_t(mSourceTileFetchThreadCount);
+		mSourceTileFetchScheduler = std::make_shared<px_sched::Scheduler>();
+		mSourceTileFetchScheduler->init(schedulerParams);
+	}
+	return mSourceTileFetchScheduler;
+}
+
 const std::string& getApiKey(const ApiKeys& keys, const std::string& name)
 {
 	auto i = keys.find(name);
@@ -100,10 +118,25 @@ static HeightMapElevationRerange readElevationRerange(const nlohmann::json& json
 	return rerangeElevationFromUInt16WithElevationBounds(json[0], json[1]);
 }
 
+static TileImageDecoderType readDecoderType(const nlohmann::json& json)
+{
+	std::string type = readOptionalOrDefault<std::string>(json, "decoder", "fused");
+	if (type == "fused")
+	{
+		return TileImageDecoderType::Fused;
+	}
+	else if (type == "osg")
+	{
+		return TileImageDecoderType::Osg;
+	}
+	throw std::runtime_error("Unsupported tile image decoder: " + type);
+}
+
 void addDefaultFactories(JsonTileSourceFactoryRegistry& registry)
 {
 	ApiKeys keys = registry.getApiKeys();
-	registry.addFactory("xyz", wrapAll(registry, [keys] (const nlohmann::json& json) {
+	HttpTileFetcherPtr fetcher = registry.getHttpTileFetcher();
+	registry.addFactory("xyz", wrapAll(registry, [keys, fetcher] (const nlohmann::json& json) {
 		std::string apiKey;
 		auto i = json.find("apiKeyName");
 		if (i != json.end())
@@ -116,6 +149,8 @@ void addDefaultFactories(JsonTileSourceFactoryRegistry& registry)
 		xyzConfig.yOrigin = readOptionalOrDefault(json, "yTileOriginAtBottom", false) ? XyzTileSourceConfig::YOrigin::Bottom : XyzTileSourceConfig::YOrigin::Top;
 		xyzConfig.apiKey = apiKey;
 		xyzConfig.levelRange = readLevelRange(json);
+		xyzConfig.httpTileFetcher = fetcher;
+		xyzConfig.decoderType = readDecoderType(json);
 
 		ifChildExists(json, "elevationBounds", [&] (const nlohmann::json& v) {
 			xyzConfig.elevationRerange = readElevationRerange(v);
@@ -126,19 +161,22 @@ void addDefaultFactories(JsonTileSourceFactoryRegistry& registry)
 		return source;
 	}));
 
-	registry.addFactory("bing", wrapAll(registry, [keys] (const nlohmann::json& json) {
+	registry.addFactory("bing", wrapAll(registry, [keys, fetcher] (const nlohmann::json& json) {
 		BingTileSourceConfig bingConfig;
 		bingConfig.url = json.at("url");
 		bingConfig.apiKey = getApiKey(keys, "bing");
 		bingConfig.levelRange = readLevelRange(json);
+		bingConfig.httpTileFetcher = fetcher;
 		return std::make_shared<BingTileSource>(bingConfig);
 	}));
 
-	registry.addFactory("mapboxElevation", wrapAll(registry, [keys] (const nlohmann::json& json) {
+	registry.addFactory("mapboxElevation", wrapAll(registry, [keys, fetcher] (const nlohmann::json& json) {
 		MapboxElevationTileSourceConfig config;
 		config.urlTemplate = json.at("url");
 		config.apiKey = getApiKey(keys, "mapbox");
 		config.levelRange = readLevelRange(json);
+		config.httpTileFetcher = fetcher;
+		config.decoderType = readDecoderType(json);
 		return std::make_shared<MapboxElevationTileSource>(config);
 	}));
 }
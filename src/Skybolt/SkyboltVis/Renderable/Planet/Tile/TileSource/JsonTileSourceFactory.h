@@ -7,8 +7,10 @@
 #pragma once
 
 #include "SkyboltVis/SkyboltVisFwd.h"
+#include "SkyboltVis/Renderable/Planet/Tile/TileSource/HttpTileFetcher.h"
 
 #include <nlohmann/json.hpp>
+#include <mutex>
 #include <string>
 
 namespace skybolt {
@@ -18,6 +20,7 @@ struct JsonTileSourceFactoryRegistryConfig
 {
 	std::string cacheDirectory;
 	std::map<std::string, std::string> apiKeys;
+	HttpTileFetcherConfig httpTileFetcher;
 };
 
 using JsonTileSourceFactory = std::function<TileSourcePtr(const nlohmann::json& json)>;
@@ -39,9 +42,20 @@ public:
 	const std::string& getCacheDirectory() const { return mCacheDirectory; }
 	ApiKeys getApiKeys() const { return mApiKeys; }
 
+	//! @return fetcher shared by all tile sources created by this registry
+	const HttpTileFetcherPtr& getHttpTileFetcher() const { return mHttpTileFetcher; }
+
+private:
+	//! Creates the scheduler on first use so that registries which never create such tile sources don't start any threads
+	std::shared_ptr<px_sched::Scheduler> getSourceTileFetchScheduler() const;
+
 private:
 	const std::string mCacheDirectory;
 	ApiKeys mApiKeys;
+	HttpTileFetcherPtr mHttpTileFetcher;
+	const int mSourceTileFetchThreadCount;
+	mutable std::mutex mSourceTileFetchSchedulerMutex;
+	mutable std::shared_ptr<px_sched::Scheduler> mSourceTileFetchScheduler; //!< Shared by tile sources which fetch several source tiles per tile
 	std::map<std::string, JsonTileSourceFactory> mFactories;
 };
 
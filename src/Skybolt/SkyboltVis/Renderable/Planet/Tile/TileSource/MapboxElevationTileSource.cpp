@@ -6,15 +6,8 @@
 
 #include "MapboxElevationTileSource.h"
 
-#include "SkyboltVis/OsgImageHelpers.h"
-#include "SkyboltVis/OsgTextureHelpers.h"
-#include "SkyboltVis/Renderable/Planet/Tile/HeightMapElevationBounds.h"
-#include "SkyboltVis/Renderable/Planet/Tile/HeightMapElevationRerange.h"
 #include <SkyboltCommon/ShaUtility.h>
 
-#include <boost/algorithm/string/replace.hpp>
-#include <osg/Texture>
-
 using namespace skybolt;
 
 namespace skybolt {
@@ -29,50 +22,17 @@ MapboxElevationTileSource::MapboxElevationTileSource(const MapboxElevationTileSo
 	xyzConfig.urlTemplate = config.urlTemplate;
 	xyzConfig.yOrigin = XyzTileSourceConfig::YOrigin::Top;
 	xyzConfig.apiKey = config.apiKey;
+	xyzConfig.httpTileFetcher = config.httpTileFetcher;
+	xyzConfig.terrainRgb = true;
+	xyzConfig.decoderType = config.decoderType;
 	mSource = std::make_unique<XyzTileSource>(xyzConfig);
 	mSource->validate();
 }
 
 osg::ref_ptr<osg::Image> MapboxElevationTileSource::createImage(const QuadTreeTileKey& key, std::function<bool()> cancelSupplier) const
 {
-	osg::ref_ptr<osg::Image> image = mSource->createImage(key, cancelSupplier);
-
-	if (image)
-	{
-		osg::ref_ptr<osg::Image> dest = new osg::Image();
-		dest->allocateImage(image->s(), image->t(), 1, GL_LUMINANCE, GL_UNSIGNED_SHORT);
-		dest->setInternalTextureFormat(getHeightMapInternalTextureFormat());
-
-		const HeightMapElevationRerange& earthElevationRerange = getDefaultEarthRerange();
-		setHeightMapElevationRerange(*dest, earthElevationRerange);
-
-		const uint8_t* s = reinterpret_cast<uint8_t*>(image->data());
-		uint16_t* d = reinterpret_cast<uint16_t*>(dest->data());
-
-		HeightMapElevationBounds bounds = emptyHeightMapElevationBounds();
-
-		size_t size = image->s() * image->t();
-		for (size_t i = 0; i < size; ++i)
-		{
-			int r = *s++;
-			int g = *s++;
-			int b = *s++;
-			s++; // a
-
-			// Read mapbox elevation in meters. See https://docs.mapbox.com/data/tilesets/guides/access-elevation-data/
-			float elevation = -10000.f + float(r * 256 * 256 + g * 256 + b) * 0.1f;
-
-			// Store elevation as height map color value
-			*d++ = getColorValueForElevation(earthElevationRerange, elevation);
-
-			// Expand elevation bounds
-			expand(bounds, elevation);
-		}
-		setHeightMapElevationBounds(*dest, bounds);
-
-		return dest;
-	}
-	return nullptr;
+	// The source decodes terrain-RGB images directly into height maps
+	return mSource->createImage(key, cancelSupplier);
 }
 
 } // namespace vis
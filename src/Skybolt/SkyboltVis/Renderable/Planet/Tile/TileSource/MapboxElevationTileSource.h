@@ -17,6 +17,8 @@ struct MapboxElevationTileSourceConfig
 	std::string urlTemplate;
 	std::string apiKey;
 	IntRangeInclusive levelRange;
+	HttpTileFetcherPtr httpTileFetcher; //!< If provided, used to fetch images from http URLs
+	TileImageDecoderType decoderType = TileImageDecoderType::Fused;
 };
 
 class MapboxElevationTileSource : public TileSourceWithMinMaxLevel
@@ -15,10 +15,17 @@
 
 #include <httplib/httplib.h>
 #include <osg/Vec2i>
+#include <px_sched/px_sched.h>
 
 #include <boost/algorithm/string/replace.hpp>
 #include <boost/log/trivial.hpp>
 
+#include <algorithm>
+#include <cstring>
+#include <exception>
+#include <mutex>
+#include <type_traits>
+
 using namespace skybolt;
 
 namespace skybolt {
@@ -36,23 +43,33 @@ static int calcMapSize(int levelOfDetail)
 	return 256 << levelOfDetail;
 }
 
-//! Converts a point from latitude/longitude WGS-84 coordinates (in degrees)  
-//! into pixel XY in spherical mercator coordinates at a specified level of detail.  
-static osg::Vec2f latLongToPixelXY(double latitude, double longitude, int levelOfDetail)
-{
-	static const double MinLatitude = -85.05112878 * math::degToRadD();
-	static const double MaxLatitude = 85.05112878 * math::degToRadD();
-	latitude = math::clamp(latitude, MinLatitude, MaxLatitude);
+static const double minMercatorLatitude = -85.05112878 * math::degToRadD();
+static const double maxMercatorLatitude = 85.05112878 * math::degToRadD();
 
+//! Converts a longitude in radians into a pixel X in spherical mercator coordinates at a specified level of detail
+static float longitudeToPixelX(double longitude, int levelOfDetail)
+{
 	double x = (longitude + math::piD()) / math::twoPiD();
+	float mapSize = (float)calcMapSize(levelOfDetail);
+	return math::clamp(float(x * mapSize), 0.f, mapSize);
+}
+
+//! Converts a latitude in radians into a pixel Y in spherical mercator coordinates at a specified level of detail
+static float latitudeToPixelY(double latitude, int levelOfDetail)
+{
+	latitude = math::clamp(latitude, minMercatorLatitude, maxMercatorLatitude);
 	double sinLatitude = std::sin(latitude);
 	double y = 0.5 - std::log((1 + sinLatitude) / (1 - sinLatitude)) / (4 * math::piD());
 
 	float mapSize = (float)calcMapSize(levelOfDetail);
+	return math::clamp(float(y * mapSize), 0.f, mapSize);
+}
 
-	return osg::Vec2f(
-		math::clamp(float(x * mapSize), 0.f, mapSize),
-		math::clamp(float(y * mapSize), 0.f, mapSize));
+//! Converts a point from latitude/longitude WGS-84 coordinates (in radians)
+//! into pixel XY in spherical mercator coordinates at a specified level of detail.
+static osg::Vec2f latLongToPixelXY(double latitude, double longitude, int levelOfDetail)
+{
+	return osg::Vec2f(longitudeToPixelX(longitude, levelOfDetail), latitudeToPixelY(latitude, levelOfDetail));
 }
 
 static osg::Vec2i pixelXYToTileXY(const osg::Vec2i& pixelXy)
@@ -71,12 +88,239 @@ static Box2i convertPlateCarreeToSphericalMercator(const QuadTreeTileKey& key, c
 }
 
 
-SphericalMercatorToPlateCarreeTileSource::SphericalMercatorToPlateCarreeTileSource(const TileSourcePtr& source) :
-	mTileSource(source)
+static const int tileSize = 256;
+
+//! Location of an output row or column in the source tiles, with the two texels to interpolate between
+struct SourceCoordinate
+{
+	int tile; //!< Index of source tile relative to the first intersecting tile, or -1 if outside the intersecting tiles
+	float texel; //!< Continuous texel coordinate within the source tile
+	int texel0;
+	int texel1;
+	float weight; //!< Interpolation weight of texel1
+};
+
+static SourceCoordinate toSourceCoordinate(float pixel, int firstTile, int tileCount, bool flip)
+{
+	SourceCoordinate c;
+	c.tile = int(pixel) / tileSize - firstTile;
+	if (c.tile < 0 || c.tile >= tileCount)
+	{
+		c.tile = -1;
+	}
+
+	float texel = fmodf(pixel, float(tileSize));
+	if (flip)
+	{
+		texel = float(tileSize - 1) - texel;
+	}
+	c.texel = math::clamp(texel, 0.f, float(tileSize - 1));
+	c.texel0 = int(c.texel);
+	c.texel1 = std::min(c.texel0 + 1, tileSize - 1);
+	c.weight = c.texel - float(c.texel0);
+	return c;
+}
+
+//! Run of output columns which sample the same source tile column
+struct ColumnRun
+{
+	int begin;
+	int end;
+	int tile;
+};
+
+static std::vector<ColumnRun> toColumnRuns(const std::vector<SourceCoordinate>& columns)
+{
+	std::vector<ColumnRun> runs;
+	for (int x = 0; x < int(columns.size()); ++x)
+	{
+		if (runs.empty() || runs.back().tile != columns[x].tile)
+		{
+			runs.push_back({x, x + 1, columns[x].tile});
+		}
+		else
+		{
+			runs.back().end = x + 1;
+		}
+	}
+	return runs;
+}
+
+template <typename T>
+static T toComponent(float value)
+{
+	if constexpr (std::is_floating_point_v<T>)
+	{
+		return T(value);
+	}
+	else
+	{
+		return T(value + 0.5f);
+	}
+}
+
+//! Bilinearly resamples source tiles into the composite using precomputed source rows and columns.
+//! Source tiles must be tileSize x tileSize with the same format as the composite.
+template <typename T>
+static void reprojectRows(const std::vector<const osg::Image*>& sourceGrid, int gridWidth,
+	const std::vector<SourceCoordinate>& rows, const std::vector<SourceCoordinate>& columns, const std::vector<ColumnRun>& columnRuns,
+	osg::Image& composite)
+{
+	const int componentCount = osg::Image::computeNumComponents(composite.getPixelFormat());
+
+	for (int y = 0; y < int(rows.size()); ++y)
+	{
+		const SourceCoordinate& row = rows[y];
+		if (row.tile < 0)
+		{
+			continue;
+		}
+
+		T* out = reinterpret_cast<T*>(composite.data(0, y));
+		for (const ColumnRun& run : columnRuns)
+		{
+			const osg::Image* source = (run.tile >= 0) ? sourceGrid[row.tile * gridWidth + run.tile] : nullptr;
+			if (!source)
+			{
+				continue;
+			}
+
+			const T* row0 = reinterpret_cast<const T*>(source->data(0, row.texel0));
+			const T* row1 = reinterpret_cast<const T*>(source->data(0, row.texel1));
+			const float rowWeight = row.weight;
+
+			for (int x = run.begin; x < run.end; ++x)
+			{
+				const SourceCoordinate& column = columns[x];
+				const int i0 = column.texel0 * componentCount;
+				const int i1 = column.texel1 * componentCount;
+				const float columnWeight = column.weight;
+
+				T* outPixel = out + x * componentCount;
+				for (int c = 0; c < componentCount; ++c)
+				{
+					float v0 = float(row0[i0 + c]) + (float(row0[i1 + c]) - float(row0[i0 + c])) * columnWeight;
+					float v1 = float(row1[i0 + c]) + (float(row1[i1 + c]) - float(row1[i0 + c])) * columnWeight;
+					outPixel[c] = toComponent<T>(v0 + (v1 - v0) * rowWeight);
+				}
+			}
+		}
+	}
+}
+
+//! Slow path for source tiles which reprojectRows() does not support
+static void reprojectPixels(const std::vector<const osg::Image*>& sourceGrid, int gridWidth,
+	const std::vector<SourceCoordinate>& rows, const std::vector<SourceCoordinate>& columns,
+	osg::Image& composite)
+{
+	for (int y = 0; y < int(rows.size()); ++y)
+	{
+		const SourceCoordinate& row = rows[y];
+		for (int x = 0; x < int(columns.size()); ++x)
+		{
+			const SourceCoordinate& column = columns[x];
+			if (row.tile >= 0 && column.tile >= 0)
+			{
+				const osg::Image& src = *sourceGrid[row.tile * gridWidth + column.tile];
+				composite.setColor(getColorBilinear(src, osg::Vec2f(column.texel, row.texel)), x, y);
+			}
+		}
+	}
+}
+
+static bool canReprojectRows(const osg::Image& source, const osg::Image& composite)
+{
+	return source.s() == tileSize && source.t() == tileSize
+		&& source.getPixelFormat() == composite.getPixelFormat()
+		&& source.getDataType() == composite.getDataType()
+		&& source.getRowStepInBytes() == source.getRowSizeInBytes();
+}
+
+static size_t getImageSizeInBytes(const osg::ref_ptr<osg::Image>& image)
+{
+	return image->getTotalSizeInBytes();
+}
+
+SphericalMercatorToPlateCarreeTileSource::SphericalMercatorToPlateCarreeTileSource(const TileSourcePtr& source, const std::shared_ptr<px_sched::Scheduler>& fetchScheduler,
+	size_t sourceTileCacheCapacityBytes) :
+	mTileSource(source),
+	mFetchScheduler(fetchScheduler),
+	mSourceTileCache(sourceTileCacheCapacityBytes, &getImageSizeInBytes)
 {
 	assert(mTileSource);
 }
 
+std::vector<osg::ref_ptr<osg::Image>> SphericalMercatorToPlateCarreeTileSource::getSourceImages(const std::vector<QuadTreeTileKey>& keys, const std::function<bool()>& cancelSupplier) const
+{
+	std::vector<osg::ref_ptr<osg::Image>> images(keys.size());
+	std::vector<size_t> missingIndices;
+	for (size_t i = 0; i < keys.size(); ++i)
+	{
+		if (!mSourceTileCache.get(keys[i], images[i]))
+		{
+			missingIndices.push_back(i);
+		}
+	}
+
+	// Create missing images in parallel because each may involve a high latency network request.
+	// The fetch scheduler has a fixed number of threads, so the number of concurrent fetches is bounded
+	// no matter how many tile loader threads call this at once.
+	std::mutex exceptionMutex;
+	std::exception_ptr exception;
+	auto createImage = [&] (size_t i) {
+		try
+		{
+			images[i] = mTileSource->createImage(keys[i], cancelSupplier);
+		}
+		catch (...)
+		{
+			std::scoped_lock<std::mutex> lock(exceptionMutex);
+			exception = std::current_exception();
+		}
+	};
+
+	if (mFetchScheduler && missingIndices.size() > 1)
+	{
+		px_sched::Sync sync;
+		for (size_t i = 1; i < missingIndices.size(); ++i)
+		{
+			mFetchScheduler->run([&createImage, index = missingIndices[i]] { createImage(index); }, &sync);
+		}
+		createImage(missingIndices.front());
+		mFetchScheduler->waitFor(sync);
+	}
+	else
+	{
+		for (size_t i : missingIndices)
+		{
+			createImage(i);
+		}
+	}
+
+	if (exception)
+	{
+		std::rethrow_exception(exception);
+	}
+
+	for (size_t i : missingIndices)
+	{
+		if (images[i])
+		{
+			mSourceTileCache.putSafe(keys[i], images[i]);
+		}
+	}
+
+	for (const osg::ref_ptr<osg::Image>& image : images)
+	{
+		if (!image)
+		{
+			// Image not available
+			return {};
+		}
+	}
+	return images;
+}
+
 osg::ref_ptr<osg::Image> SphericalMercatorToPlateCarreeTileSource::createImage(const QuadTreeTileKey& key, std::function<bool()> cancelSupplier) const
 {
 	// Find the bounds of the PlateCarree tile in SpericalMercator space
@@ -86,97 +330,111 @@ osg::ref_ptr<osg::Image> SphericalMercatorToPlateCarreeTileSource::createImage(c
 	Box2i tilesBounds = convertPlateCarreeToSphericalMercator(quadTreeTileKey, keyBounds);
 
 	// The tile bounds give us all the Sperical Mercator tiles that the Plate Carree tile intersects.
-	// Download each tile.
-	GLenum pixelFormat;
-	GLenum type;
-	std::map<osg::Vec2i, osg::ref_ptr<osg::Image>> tiles;
-	std::optional<HeightMapElevationBounds> bounds;
-	std::optional<HeightMapElevationRerange> rerange;
+	// Get each tile, row by row.
+	std::vector<QuadTreeTileKey> sourceKeys;
 	for (int y = tilesBounds.minimum.y(); y <= tilesBounds.maximum.y(); ++y)
 	{
 		for (int x = tilesBounds.minimum.x(); x <= tilesBounds.maximum.x(); ++x)
 		{
-			// FIXME: Consider storing tiles in an LRU so that we don't need to re-download the same tile.
-			// It might not help very much because in practice only about 10% of tiles are re-downloaded.
-			// The cache must be thread-safe because a TileSource can be queried from multiple threads.
-			osg::ref_ptr<osg::Image> image = mTileSource->createImage(QuadTreeTileKey(quadTreeTileKey.level, x, y), cancelSupplier);
-			if (image)
-			{
-				tiles[osg::Vec2i(x, y)] = image;
-				pixelFormat = image->getPixelFormat();
-				type = image->getDataType();
+			sourceKeys.push_back(QuadTreeTileKey(quadTreeTileKey.level, x, y));
+		}
+	}
 
-				std::optional<HeightMapElevationBounds> thisTileBounds = getHeightMapElevationBounds(*image);
-				if (thisTileBounds)
-				{
-					if (!bounds)
-					{
-						bounds = thisTileBounds;
-					}
-					else
-					{
-						expand(*bounds, *thisTileBounds);
-					}
-				}
+	std::vector<osg::ref_ptr<osg::Image>> tiles = getSourceImages(sourceKeys, cancelSupplier);
+	if (tiles.empty() || cancelSupplier())
+	{
+		return nullptr;
+	}
 
-				std::optional<HeightMapElevationRerange> thisTileRerange = getHeightMapElevationRerange(*image);
-				if (thisTileRerange)
-				{
-					if (!rerange)
-					{
-						rerange = thisTileRerange;
-					}
-					else
-					{
-						if (*rerange != *thisTileRerange)
-						{
-							throw std::runtime_error("Source tiles have inconsistant elevation ranges");
-						}
-					}
-				}
+	std::optional<HeightMapElevationBounds> bounds;
+	std::optional<HeightMapElevationRerange> rerange;
+	for (const osg::ref_ptr<osg::Image>& image : tiles)
+	{
+		std::optional<HeightMapElevationBounds> thisTileBounds = getHeightMapElevationBounds(*image);
+		if (thisTileBounds)
+		{
+			if (!bounds)
+			{
+				bounds = thisTileBounds;
 			}
 			else
 			{
-				// Image not available
-				return nullptr;
+				expand(*bounds, *thisTileBounds);
 			}
+		}
 
-			if (cancelSupplier())
+		std::optional<HeightMapElevationRerange> thisTileRerange = getHeightMapElevationRerange(*image);
+		if (thisTileRerange)
+		{
+			if (!rerange)
 			{
-				return nullptr;
+				rerange = thisTileRerange;
+			}
+			else
+			{
+				if (*rerange != *thisTileRerange)
+				{
+					throw std::runtime_error("Source tiles have inconsistant elevation ranges");
+				}
 			}
 		}
 	}
 
-	if (tiles.empty())
-	{
-		return nullptr;
-	}
-
 	// Composite the Spherical Mercator tiles into a single Plate Carree tile and return it.
 	osg::ref_ptr<osg::Image> composite(new osg::Image);
-	composite->allocateImage(256, 256, 1, pixelFormat, type);
+	composite->allocateImage(tileSize, tileSize, 1, tiles.back()->getPixelFormat(), tiles.back()->getDataType());
+	std::memset(composite->data(), 0, composite->getTotalSizeInBytes());
 
 	if (isHeightMapDataFormat(*composite))
 	{
 		composite->setInternalTextureFormat(getHeightMapInternalTextureFormat());
 	}
 
+	// Precompute the source location of each output row and column. Rows have constant latitude and columns have constant longitude,
+	// so the expensive latitude to mercator conversion is done once per row rather than once per pixel.
 	osg::Vec2d size = keyBounds.size();
-	for (int y = 0; y < 256; ++y)
+	int gridWidth = tilesBounds.maximum.x() - tilesBounds.minimum.x() + 1;
+	int gridHeight = tilesBounds.maximum.y() - tilesBounds.minimum.y() + 1;
+
+	std::vector<SourceCoordinate> rows(tileSize);
+	for (int y = 0; y < tileSize; ++y)
 	{
-		for (int x = 0; x < 256; ++x)
-		{
-			osg::Vec2d latLon = keyBounds.minimum + osg::Vec2d(size.x() * (double(y) + 0.5) / 256.0, size.y() * (double(x) + 0.5) / 256.0);
-			osg::Vec2f srcXy = latLongToPixelXY(latLon.x(), latLon.y(), quadTreeTileKey.level);
+		double latitude = keyBounds.minimum.x() + size.x() * (double(y) + 0.5) / double(tileSize);
+		rows[y] = toSourceCoordinate(latitudeToPixelY(latitude, quadTreeTileKey.level), tilesBounds.minimum.y(), gridHeight, /* flip */ true);
+	}
 
-			auto it = tiles.find(pixelXYToTileXY(toVec2i(srcXy)));
-			if (it != tiles.end())
-			{
-				const osg::Image& src = *it->second;
-				composite->setColor(getColorBilinear(src, osg::Vec2f(fmodf(srcXy.x(), 256.f), 255.f - fmodf(srcXy.y(), 256.f))), x, y);
-			}
-		}
+	std::vector<SourceCoordinate> columns(tileSize);
+	for (int x = 0; x < tileSize; ++x)
+	{
+		double longitude = keyBounds.minimum.y() + size.y() * (double(x) + 0.5) / double(tileSize);
+		columns[x] = toSourceCoordinate(longitudeToPixelX(longitude, quadTreeTileKey.level), tilesBounds.minimum.x(), gridWidth, /* flip */ false);
+	}
+
+	std::vector<const osg::Image*> sourceGrid;
+	sourceGrid.reserve(tiles.size());
+	bool canUseRowKernel = true;
+	for (const osg::ref_ptr<osg::Image>& image : tiles)
+	{
+		sourceGrid.push_back(image.get());
+		canUseRowKernel &= canReprojectRows(*image, *composite);
+	}
+
+	GLenum dataType = composite->getDataType();
+	if (canUseRowKernel && dataType == GL_UNSIGNED_BYTE)
+	{
+		reprojectRows<std::uint8_t>(sourceGrid, gridWidth, rows, columns, toColumnRuns(columns), *composite);
+	}
+	else if (canUseRowKernel && dataType == GL_UNSIGNED_SHORT)
+	{
+		reprojectRows<std::uint16_t>(sourceGrid, gridWidth, rows, columns, toColumnRuns(columns), *composite);
+	}
+	else if (canUseRowKernel && dataType == GL_FLOAT)
+	{
+		reprojectRows<float>(sourceGrid, gridWidth, rows, columns, toColumnRuns(columns), *composite);
+	}
+	else
+	{
+		reprojectPixels(sourceGrid, gridWidth, rows, columns, *composite);
 	}
 
 	if (bounds)
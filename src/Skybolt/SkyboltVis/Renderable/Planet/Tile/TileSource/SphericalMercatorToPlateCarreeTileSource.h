@@ -7,6 +7,9 @@
 #pragma once
 #include "TileSource.h"
 #include "SkyboltVis/SkyboltVisFwd.h"
+#include <SkyboltCommon/ConcurrentLruCacheMap.h>
+
+#include <vector>
 
 namespace skybolt {
 namespace vis {
@@ -15,7 +18,10 @@ namespace vis {
 class SphericalMercatorToPlateCarreeTileSource : public TileSource
 {
 public:
-	SphericalMercatorToPlateCarreeTileSource(const TileSourcePtr& source);
+	//! @param fetchScheduler is used to create missing source tiles concurrently. If null, they are created one after another on the calling thread.
+	//! @param sourceTileCacheCapacityBytes is the maximum total size of source tiles retained for reuse by neighbouring tiles
+	SphericalMercatorToPlateCarreeTileSource(const TileSourcePtr& source, const std::shared_ptr<px_sched::Scheduler>& fetchScheduler = nullptr,
+		size_t sourceTileCacheCapacityBytes = 64 * 1024 * 1024);
 
 	osg::ref_ptr<osg::Image> createImage(const skybolt::QuadTreeTileKey& key, std::function<bool()> cancelSupplier) const override;
 
@@ -32,8 +38,15 @@ public:
 	const std::string& getCacheSha() const override { return mTileSource->getCacheSha(); }
 	const std::string& getCacheFileFormat() const override { return mTileSource->getCacheFileFormat(); }
 
+private:
+	//! @return images for all keys, or an empty vector if any image is not available
+	std::vector<osg::ref_ptr<osg::Image>> getSourceImages(const std::vector<skybolt::QuadTreeTileKey>& keys, const std::function<bool()>& cancelSupplier) const;
+
 private:
 	TileSourcePtr mTileSource;
+	std::shared_ptr<px_sched::Scheduler> mFetchScheduler;
+
+	mutable ConcurrentLruCacheMap<skybolt::QuadTreeTileKey, osg::ref_ptr<osg::Image>> mSourceTileCache;
 };
 
 } // namespace vis
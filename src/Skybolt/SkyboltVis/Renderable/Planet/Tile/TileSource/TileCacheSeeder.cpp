@@ -0,0 +1,270 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "TileCacheSeeder.h"
+#include "CachedTileSource.h"
+#include "SkyboltVis/OsgBox2.h"
+
+#include <boost/log/trivial.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <thread>
+
+namespace skybolt {
+namespace vis {
+
+namespace {
+
+using LonLatPolygon = std::vector<osg::Vec2d>;
+
+double cross(const osg::Vec2d& a, const osg::Vec2d& b)
+{
+	return a.x() * b.y() - a.y() * b.x();
+}
+
+bool segmentsIntersect(const osg::Vec2d& a0, const osg::Vec2d& a1, const osg::Vec2d& b0, const osg::Vec2d& b1)
+{
+	osg::Vec2d a = a1 - a0;
+	osg::Vec2d b = b1 - b0;
+	double d0 = cross(a, b0 - a0);
+	double d1 = cross(a, b1 - a0);
+	double d2 = cross(b, a0 - b0);
+	double d3 = cross(b, a1 - b0);
+	return ((d0 <= 0 && d1 >= 0) || (d0 >= 0 && d1 <= 0))
+		&& ((d2 <= 0 && d3 >= 0) || (d2 >= 0 && d3 <= 0));
+}
+
+bool isPointInPolygon(const osg::Vec2d& p, const LonLatPolygon& polygon)
+{
+	bool inside = false;
+	for (size_t i = 0, j = polygon.size() - 1; i < polygon.size(); j = i++)
+	{
+		const osg::Vec2d& a = polygon[i];
+		const osg::Vec2d& b = polygon[j];
+		if ((a.y() > p.y()) != (b.y() > p.y())
+			&& p.x() < (b.x() - a.x()) * (p.y() - a.y()) / (b.y() - a.y()) + a.x())
+		{
+			inside = !inside;
+		}
+	}
+	return inside;
+}
+
+bool intersects(const Box2d& box, const LonLatPolygon& polygon, const Box2d& polygonBounds)
+{
+	if (!box.intersects(polygonBounds))
+	{
+		return false;
+	}
+
+	// Polygon is at least partly inside the box
+	for (const osg::Vec2d& p : polygon)
+	{
+		if (box.intersects(p))
+		{
+			return true;
+		}
+	}
+
+	// Box is entirely inside the polygon
+	if (isPointInPolygon(box.center(), polygon))
+	{
+		return true;
+	}
+
+	// Boundaries cross
+	const osg::Vec2d corners[4] = {
+		box.minimum,
+		osg::Vec2d(box.maximum.x(), box.minimum.y()),
+		box.maximum,
+		osg::Vec2d(box.minimum.x(), box.maximum.y())
+	};
+	for (size_t i = 0, j = polygon.size() - 1; i < polygon.size(); j = i++)
+	{
+		for (int c = 0; c < 4; ++c)
+		{
+			if (segmentsIntersect(polygon[j], polygon[i], corners[c], corners[(c + 1) % 4]))
+			{
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+struct RegionQuery
+{
+	const TileSource& source;
+	LonLatPolygon polygon;
+	Box2d polygonBounds;
+	IntRangeInclusive levelRange;
+};
+
+void addKeysInRegion(const RegionQuery& query, const QuadTreeTileKey& key, std::vector<QuadTreeTileKey>& keys)
+{
+	if (!intersects(getKeyLonLatBounds<osg::Vec2d>(key), query.polygon, query.polygonBounds))
+	{
+		return;
+	}
+
+	if (key.level >= query.levelRange.minimum)
+	{
+		// Tiles are only seeded at levels where the source provides its own data, rather than data from an ancestor
+		std::optional<QuadTreeTileKey> availableKey = query.source.getHighestAvailableLevel(key);
+		if (availableKey && *availableKey == key)
+		{
+			keys.push_back(key);
+		}
+	}
+
+	if (key.level < query.levelRange.maximum && query.source.hasAnyChildren(key))
+	{
+		for (int y = 0; y < 2; ++y)
+		{
+			for (int x = 0; x < 2; ++x)
+			{
+				addKeysInRegion(query, QuadTreeTileKey(key.level + 1, key.x * 2 + x, key.y * 2 + y), keys);
+			}
+		}
+	}
+}
+
+} // namespace
+
+std::vector<QuadTreeTileKey> getTileKeysInRegion(const TileSource& source, const LatLonPolygon& region, const IntRangeInclusive& levelRange)
+{
+	if (region.size() < 3)
+	{
+		throw std::runtime_error("Tile region polygon must have at least 3 vertices");
+	}
+
+	LonLatPolygon polygon;
+	Box2d polygonBounds;
+	for (const sim::LatLon& latLon : region)
+	{
+		osg::Vec2d p(latLon.lon, latLon.lat);
+		polygon.push_back(p);
+		polygonBounds.merge(p);
+	}
+	RegionQuery query{source, polygon, polygonBounds, levelRange};
+
+	std::vector<QuadTreeTileKey> keys;
+
+	// The planet is covered by two root tiles, one for each hemisphere of longitude
+	addKeysInRegion(query, QuadTreeTileKey(0, 0, 0), keys);
+	addKeysInRegion(query, QuadTreeTileKey(0, 1, 0), keys);
+
+	// Seed coarse levels first so that an interrupted run leaves complete coverage of the region at as many levels as possible
+	std::stable_sort(keys.begin(), keys.end(), [] (const QuadTreeTileKey& a, const QuadTreeTileKey& b) {
+		return a.level < b.level;
+	});
+	return keys;
+}
+
+TileCacheSeederStats seedTileCache(const CachedTileSource& source, const TileCacheSeederConfig& config, const std::function<bool()>& cancelSupplier)
+{
+	auto startTime = std::chrono::steady_clock::now();
+	const std::vector<QuadTreeTileKey> keys = getTileKeysInRegion(source, config.region, config.levelRange);
+
+	std::atomic<size_t> nextKeyIndex = 0;
+	std::atomic<int64_t> seededCount = 0;
+	std::atomic<int64_t> skippedCount = 0;
+	std::atomic<int64_t> failedCount = 0;
+	std::atomic<int64_t> bytesWritten = 0;
+	std::atomic<bool> cancelled = false;
+
+	auto getStats = [&] {
+		TileCacheSeederStats stats;
+		stats.tileCount = int64_t(keys.size());
+		stats.seededCount = seededCount;
+		stats.skippedCount = skippedCount;
+		stats.failedCount = failedCount;
+		stats.bytesWritten = bytesWritten;
+		stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+		return stats;
+	};
+
+	auto seedTiles = [&] {
+		auto tileCancelSupplier = [&] { return bool(cancelled); };
+		for (size_t i = nextKeyIndex++; i < keys.size() && !cancelled; i = nextKeyIndex++)
+		{
+			const QuadTreeTileKey& key = keys[i];
+			if (source.isCached(key))
+			{
+				++skippedCount;
+				continue;
+			}
+
+			try
+			{
+				if (source.createImage(key, tileCancelSupplier))
+				{
+					std::error_code error;
+					uintmax_t size = std::filesystem::file_size(source.getCacheFilename(key), error);
+					bytesWritten += error ? 0 : int64_t(size);
+					++seededCount;
+				}
+				else if (!cancelled)
+				{
+					++failedCount;
+				}
+			}
+			catch (const std::exception& e)
+			{
+				BOOST_LOG_TRIVIAL(error) << "Could not seed tile " << key.level << "/" << key.x << "/" << key.y << ": " << e.what();
+				++failedCount;
+			}
+		}
+	};
+
+	const int threadCount = std::clamp(int(keys.size()), 1, std::max(1, config.threadCount));
+	std::atomic<int> activeThreadCount = threadCount;
+	std::vector<std::thread> threads;
+	for (int i = 0; i < threadCount; ++i)
+	{
+		threads.emplace_back([&] {
+			seedTiles();
+			--activeThreadCount;
+		});
+	}
+
+	// Cancellation and progress are handled on the calling thread so that the supplied callbacks need not be thread safe
+	const auto pollInterval = std::chrono::milliseconds(20);
+	auto lastProgressTime = std::chrono::steady_clock::now();
+	while (activeThreadCount > 0)
+	{
+		std::this_thread::sleep_for(pollInterval);
+		if (!cancelled && cancelSupplier())
+		{
+			cancelled = true;
+		}
+
+		auto now = std::chrono::steady_clock::now();
+		if (config.progressCallback && std::chrono::duration<double>(now - lastProgressTime).count() >= config.progressInterval)
+		{
+			config.progressCallback(getStats());
+			lastProgressTime = now;
+		}
+	}
+
+	for (std::thread& thread : threads)
+	{
+		thread.join();
+	}
+
+	TileCacheSeederStats stats = getStats();
+	if (config.progressCallback)
+	{
+		config.progressCallback(stats);
+	}
+	return stats;
+}
+
+} // namespace vis
+} // namespace skybolt
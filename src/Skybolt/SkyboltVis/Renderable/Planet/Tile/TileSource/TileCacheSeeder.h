@@ -0,0 +1,56 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#pragma once
+
+#include "SkyboltVis/SkyboltVisFwd.h"
+#include <SkyboltCommon/Range.h>
+#include <SkyboltCommon/Math/QuadTree.h>
+#include <SkyboltSim/Spatial/LatLon.h>
+
+#include <functional>
+#include <vector>
+
+namespace skybolt {
+namespace vis {
+
+//! Polygon with vertices in order around its boundary. Must not cross the antimeridian.
+using LatLonPolygon = std::vector<sim::LatLon>;
+
+//! @return keys of tiles intersecting the region, ordered by level, for which the tile source provides data at the key's level
+std::vector<QuadTreeTileKey> getTileKeysInRegion(const TileSource& source, const LatLonPolygon& region, const IntRangeInclusive& levelRange);
+
+struct TileCacheSeederStats
+{
+	int64_t tileCount = 0; //!< Number of tiles in the region
+	int64_t seededCount = 0; //!< Number of tiles fetched and written to the cache
+	int64_t skippedCount = 0; //!< Number of tiles already in the cache
+	int64_t failedCount = 0; //!< Number of tiles which could not be created or written
+	int64_t bytesWritten = 0;
+	double seconds = 0;
+
+	int64_t getProcessedCount() const { return seededCount + skippedCount + failedCount; }
+	double getSeededTilesPerSecond() const { return (seconds > 0) ? double(seededCount) / seconds : 0.0; }
+};
+
+struct TileCacheSeederConfig
+{
+	LatLonPolygon region;
+	IntRangeInclusive levelRange = IntRangeInclusive(0, 0);
+	int threadCount = 16; //!< Number of tiles created concurrently. Tile sources spend most of their time waiting on the network, so this can exceed the core count.
+	double progressInterval = 1.0; //!< Seconds between calls to the progress callback
+	std::function<void(const TileCacheSeederStats&)> progressCallback;
+};
+
+//! Fetches, transforms and writes the tiles of a region to a tile source's cache directory.
+//! Tiles already in the cache are skipped, so seeding resumes where a previous interrupted run stopped.
+//! @param cancelSupplier returns true to stop seeding. Tiles completed so far remain in the cache.
+//! @return stats for the run
+TileCacheSeederStats seedTileCache(const CachedTileSource& source, const TileCacheSeederConfig& config,
+	const std::function<bool()>& cancelSupplier = [] { return false; });
+
+} // namespace vis
+} // namespace skybolt
@@ -0,0 +1,477 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "TileImageDecoder.h"
+#include "SkyboltVis/OsgImageHelpers.h"
+#include "SkyboltVis/OsgTextureHelpers.h"
+#include "SkyboltVis/Renderable/Planet/Tile/HeightMapElevationBounds.h"
+
+#include <SkyboltCommon/Math/MathUtility.h>
+
+#include <osg/Endian>
+#include <png.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <limits>
+#include <optional>
+#include <vector>
+
+namespace skybolt {
+namespace vis {
+
+namespace {
+
+float terrainRgbCodeToElevation(uint32_t code)
+{
+	return -10000.f + float(code) * 0.1f;
+}
+
+//! Converts elevation to height map color value, clamping elevations outside of the rerange's representable range
+uint16_t toHeightMapColorValue(float elevation, const HeightMapElevationRerange& rerange)
+{
+	float value = (elevation - rerange.y()) / rerange.x();
+	return uint16_t(math::clamp(value, 0.f, 65535.f));
+}
+
+//! Converts a row of terrain-RGB pixels to height map color values, and expands the range of terrain-RGB codes seen
+template <int channelCount>
+void convertTerrainRgbRow(const uint8_t* src, uint16_t* dst, int width, const HeightMapElevationRerange& rerange, uint32_t& minCode, uint32_t& maxCode)
+{
+	uint32_t rowMinCode = minCode;
+	uint32_t rowMaxCode = maxCode;
+	for (int i = 0; i < width; ++i)
+	{
+		const uint8_t* p = src + i * channelCount;
+		uint32_t code = (uint32_t(p[0]) << 16) | (uint32_t(p[1]) << 8) | uint32_t(p[2]);
+		rowMinCode = std::min(rowMinCode, code);
+		rowMaxCode = std::max(rowMaxCode, code);
+		dst[i] = toHeightMapColorValue(terrainRgbCodeToElevation(code), rerange);
+	}
+	minCode = rowMinCode;
+	maxCode = rowMaxCode;
+}
+
+void convertTerrainRgbRow(const uint8_t* src, int channelCount, uint16_t* dst, int width, const HeightMapElevationRerange& rerange, uint32_t& minCode, uint32_t& maxCode)
+{
+	if (channelCount == 4)
+	{
+		convertTerrainRgbRow<4>(src, dst, width, rerange, minCode, maxCode);
+	}
+	else
+	{
+		assert(channelCount == 3);
+		convertTerrainRgbRow<3>(src, dst, width, rerange, minCode, maxCode);
+	}
+}
+
+//! Expands the range of color values seen with a row of height map color values
+void expandColorValueRange(const uint16_t* values, int width, uint16_t& minValue, uint16_t& maxValue)
+{
+	uint16_t rowMinValue = minValue;
+	uint16_t rowMaxValue = maxValue;
+	for (int i = 0; i < width; ++i)
+	{
+		rowMinValue = std::min(rowMinValue, values[i]);
+		rowMaxValue = std::max(rowMaxValue, values[i]);
+	}
+	minValue = rowMinValue;
+	maxValue = rowMaxValue;
+}
+
+//! Accumulates the range of color values in a height map
+struct ColorValueRange
+{
+	uint16_t minValue = std::numeric_limits<uint16_t>::max();
+	uint16_t maxValue = std::numeric_limits<uint16_t>::min();
+	bool empty = true;
+
+	void expand(const uint16_t* values, int width)
+	{
+		if (width > 0)
+		{
+			expandColorValueRange(values, width, minValue, maxValue);
+			empty = false;
+		}
+	}
+};
+
+// Elevation is a linear function of color value, so the bounds are found from the color value range
+// rather than by converting every pixel to elevation.
+void setHeightMapMetadata(osg::Image& image, const HeightMapElevationRerange& rerange, std::optional<std::pair<float, float>> elevationRange)
+{
+	image.setInternalTextureFormat(getHeightMapInternalTextureFormat());
+	setHeightMapElevationRerange(image, rerange);
+
+	HeightMapElevationBounds bounds = emptyHeightMapElevationBounds();
+	if (elevationRange)
+	{
+		expand(bounds, elevationRange->first);
+		expand(bounds, elevationRange->second);
+	}
+	setHeightMapElevationBounds(image, bounds);
+}
+
+std::optional<std::pair<float, float>> toElevationRange(const ColorValueRange& range, const HeightMapElevationRerange& rerange)
+{
+	if (range.empty)
+	{
+		return std::nullopt;
+	}
+	return std::make_pair(getElevationForColorValue(rerange, range.minValue), getElevationForColorValue(rerange, range.maxValue));
+}
+
+std::optional<std::pair<float, float>> toElevationRange(uint32_t minCode, uint32_t maxCode)
+{
+	if (minCode > maxCode)
+	{
+		return std::nullopt;
+	}
+	return std::make_pair(terrainRgbCodeToElevation(minCode), terrainRgbCodeToElevation(maxCode));
+}
+
+osg::ref_ptr<osg::Image> allocateHeightMap(int width, int height)
+{
+	osg::ref_ptr<osg::Image> image = new osg::Image();
+	image->allocateImage(width, height, 1, GL_LUMINANCE, GL_UNSIGNED_SHORT);
+	return image;
+}
+
+//! Receives rows of a PNG image as they are decoded
+class PngRowSink
+{
+public:
+	virtual ~PngRowSink() = default;
+
+	//! Called once the image format is known
+	//! @return false if the image can not be handled
+	virtual bool begin(int width, int height, int channelCount, int bitDepth) = 0;
+
+	//! @return buffer to decode the given row into
+	virtual unsigned char* getRowBuffer(int row) = 0;
+
+	//! Called after each row has been decoded into its buffer
+	virtual void endRow(int row) {}
+};
+
+GLenum getPixelFormatForChannelCount(int channelCount)
+{
+	switch (channelCount)
+	{
+		case 1: return GL_LUMINANCE;
+		case 2: return GL_LUMINANCE_ALPHA;
+		case 3: return GL_RGB;
+		default: return GL_RGBA;
+	}
+}
+
+//! OSG images are stored bottom row first, while PNG rows are top row first
+int toImageRow(const osg::Image& image, int pngRow)
+{
+	return image.t() - 1 - pngRow;
+}
+
+class ColorPngRowSink : public PngRowSink
+{
+public:
+	bool begin(int width, int height, int channelCount, int bitDepth) override
+	{
+		image = new osg::Image();
+		image->allocateImage(width, height, 1, getPixelFormatForChannelCount(channelCount), (bitDepth == 16) ? GL_UNSIGNED_SHORT : GL_UNSIGNED_BYTE);
+		return true;
+	}
+
+	unsigned char* getRowBuffer(int row) override
+	{
+		return image->data(0, toImageRow(*image, row));
+	}
+
+	osg::ref_ptr<osg::Image> image;
+};
+
+class ElevationPngRowSink : public PngRowSink
+{
+public:
+	bool begin(int width, int height, int channelCount, int bitDepth) override
+	{
+		if (channelCount != 1 || bitDepth != 16)
+		{
+			return false;
+		}
+		image = allocateHeightMap(width, height);
+		return true;
+	}
+
+	unsigned char* getRowBuffer(int row) override
+	{
+		return image->data(0, toImageRow(*image, row));
+	}
+
+	void endRow(int row) override
+	{
+		// Scan the row while it is still in cache
+		range.expand(reinterpret_cast<const uint16_t*>(getRowBuffer(row)), image->s());
+	}
+
+	osg::ref_ptr<osg::Image> image;
+	ColorValueRange range;
+};
+
+class TerrainRgbPngRowSink : public PngRowSink
+{
+public:
+	TerrainRgbPngRowSink(const HeightMapElevationRerange& rerange) : mRerange(rerange) {}
+
+	bool begin(int width, int height, int channelCount, int bitDepth) override
+	{
+		if ((channelCount != 3 && channelCount != 4) || bitDepth != 8)
+		{
+			return false;
+		}
+		mChannelCount = channelCount;
+		image = allocateHeightMap(width, height);
+
+		// Scratch row is reused by all images decoded on this thread
+		getScratchRow().resize(width * channelCount);
+		return true;
+	}
+
+	unsigned char* getRowBuffer(int row) override
+	{
+		return getScratchRow().data();
+	}
+
+	void endRow(int row) override
+	{
+		uint16_t* dst = reinterpret_cast<uint16_t*>(image->data(0, toImageRow(*image, row)));
+		convertTerrainRgbRow(getScratchRow().data(), mChannelCount, dst, image->s(), mRerange, minCode, maxCode);
+	}
+
+	osg::ref_ptr<osg::Image> image;
+	uint32_t minCode = std::numeric_limits<uint32_t>::max();
+	uint32_t maxCode = 0;
+
+private:
+	static std::vector<unsigned char>& getScratchRow()
+	{
+		static thread_local std::vector<unsigned char> row;
+		return row;
+	}
+
+private:
+	const HeightMapElevationRerange mRerange;
+	int mChannelCount = 0;
+};
+
+struct PngReadSource
+{
+	const unsigned char* data;
+	size_t size;
+	size_t offset;
+};
+
+void readPngData(png_structp png, png_bytep out, png_size_t length)
+{
+	PngReadSource* source = static_cast<PngReadSource*>(png_get_io_ptr(png));
+	if (length > source->size - source->offset)
+	{
+		png_error(png, "Unexpected end of PNG data");
+	}
+	std::memcpy(out, source->data + source->offset, length);
+	source->offset += length;
+}
+
+void onPngError(png_structp png, png_const_charp message)
+{
+	// Errors are reported by returning failure from readPng()
+	png_longjmp(png, 1);
+}
+
+void onPngWarning(png_structp png, png_const_charp message)
+{
+}
+
+bool isPng(const std::string& data)
+{
+	return data.size() >= 8 && png_sig_cmp(reinterpret_cast<png_const_bytep>(data.data()), 0, 8) == 0;
+}
+
+//! Decodes a non-interlaced PNG image, passing each row to the sink as it is decoded.
+//! libpng reports errors with longjmp, so this function must not hold objects with destructors.
+//! @return false if the image could not be decoded or the sink does not accept the image format
+bool readPng(const std::string& data, PngRowSink& sink)
+{
+	png_structp png = png_create_read_struct(PNG_LIBPNG_VER_STRING, nullptr, onPngError, onPngWarning);
+	if (!png)
+	{
+		return false;
+	}
+
+	png_infop info = png_create_info_struct(png);
+	if (!info)
+	{
+		png_destroy_read_struct(&png, nullptr, nullptr);
+		return false;
+	}
+
+	if (setjmp(png_jmpbuf(png)))
+	{
+		png_destroy_read_struct(&png, &info, nullptr);
+		return false;
+	}
+
+	PngReadSource source = { reinterpret_cast<const unsigned char*>(data.data()), data.size(), 0 };
+	png_set_read_fn(png, &source, readPngData);
+	png_read_info(png, info);
+
+	// Interlaced images are not decoded row by row
+	if (png_get_interlace_type(png, info) != PNG_INTERLACE_NONE)
+	{
+		png_destroy_read_struct(&png, &info, nullptr);
+		return false;
+	}
+
+	// Expand to whole bytes per channel
+	int colorType = png_get_color_type(png, info);
+	int bitDepth = png_get_bit_depth(png, info);
+	if (colorType == PNG_COLOR_TYPE_PALETTE)
+	{
+		png_set_palette_to_rgb(png);
+	}
+	if (colorType == PNG_COLOR_TYPE_GRAY && bitDepth < 8)
+	{
+		png_set_expand_gray_1_2_4_to_8(png);
+	}
+	if (png_get_valid(png, info, PNG_INFO_tRNS))
+	{
+		png_set_tRNS_to_alpha(png);
+	}
+	if (bitDepth == 16 && osg::getCpuByteOrder() == osg::LittleEndian)
+	{
+		png_set_swap(png); // PNG stores 16 bit values in big endian order
+	}
+	png_read_update_info(png, info);
+
+	int width = int(png_get_image_width(png, info));
+	int height = int(png_get_image_height(png, info));
+	if (!sink.begin(width, height, png_get_channels(png, info), png_get_bit_depth(png, info)))
+	{
+		png_destroy_read_struct(&png, &info, nullptr);
+		return false;
+	}
+
+	for (int row = 0; row < height; ++row)
+	{
+		png_read_row(png, sink.getRowBuffer(row), nullptr);
+		sink.endRow(row);
+	}
+
+	png_destroy_read_struct(&png, &info, nullptr);
+	return true;
+}
+
+} // namespace
+
+TileImageDecoder::TileImageDecoder(const TileImageDecoderConfig& config) :
+	mConfig(config)
+{
+}
+
+osg::ref_ptr<osg::Image> TileImageDecoder::decode(const std::string& data, const std::string& extension) const
+{
+	if (mConfig.type == TileImageDecoderType::Fused && isPng(data))
+	{
+		if (osg::ref_ptr<osg::Image> image = decodePng(data); image)
+		{
+			return image;
+		}
+		// Fall back to osgDB for images the fused decoder does not handle, e.g. interlaced images
+	}
+
+	osg::ref_ptr<osg::Image> image = readImageFromMemory(data, isPng(data) ? "png" : extension);
+	return image ? convert(image) : nullptr;
+}
+
+osg::ref_ptr<osg::Image> TileImageDecoder::decodePng(const std::string& data) const
+{
+	switch (mConfig.encoding)
+	{
+		case TileImageEncoding::Color:
+		{
+			ColorPngRowSink sink;
+			return readPng(data, sink) ? sink.image : nullptr;
+		}
+		case TileImageEncoding::Elevation:
+		{
+			ElevationPngRowSink sink;
+			if (!readPng(data, sink))
+			{
+				return nullptr;
+			}
+			setHeightMapMetadata(*sink.image, mConfig.elevationRerange, toElevationRange(sink.range, mConfig.elevationRerange));
+			return sink.image;
+		}
+		case TileImageEncoding::TerrainRgb:
+		{
+			TerrainRgbPngRowSink sink(mConfig.elevationRerange);
+			if (!readPng(data, sink))
+			{
+				return nullptr;
+			}
+			setHeightMapMetadata(*sink.image, mConfig.elevationRerange, toElevationRange(sink.minCode, sink.maxCode));
+			return sink.image;
+		}
+	}
+	return nullptr;
+}
+
+osg::ref_ptr<osg::Image> TileImageDecoder::convert(const osg::ref_ptr<osg::Image>& image) const
+{
+	switch (mConfig.encoding)
+	{
+		case TileImageEncoding::Color:
+			return image;
+		case TileImageEncoding::Elevation:
+		{
+			if (!isHeightMapDataFormat(*image))
+			{
+				return nullptr;
+			}
+
+			ColorValueRange range;
+			for (int row = 0; row < image->t(); ++row)
+			{
+				range.expand(reinterpret_cast<const uint16_t*>(image->data(0, row)), image->s());
+			}
+			setHeightMapMetadata(*image, mConfig.elevationRerange, toElevationRange(range, mConfig.elevationRerange));
+			return image;
+		}
+		case TileImageEncoding::TerrainRgb:
+		{
+			int channelCount = osg::Image::computeNumComponents(image->getPixelFormat());
+			if ((image->getPixelFormat() != GL_RGB && image->getPixelFormat() != GL_RGBA) || image->getDataType() != GL_UNSIGNED_BYTE)
+			{
+				return nullptr;
+			}
+
+			osg::ref_ptr<osg::Image> heightMap = allocateHeightMap(image->s(), image->t());
+			uint32_t minCode = std::numeric_limits<uint32_t>::max();
+			uint32_t maxCode = 0;
+			for (int row = 0; row < image->t(); ++row)
+			{
+				uint16_t* dst = reinterpret_cast<uint16_t*>(heightMap->data(0, row));
+				convertTerrainRgbRow(image->data(0, row), channelCount, dst, image->s(), mConfig.elevationRerange, minCode, maxCode);
+			}
+			setHeightMapMetadata(*heightMap, mConfig.elevationRerange, toElevationRange(minCode, maxCode));
+			return heightMap;
+		}
+	}
+	return nullptr;
+}
+
+} // namespace vis
+} // namespace skybolt
@@ -0,0 +1,64 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#pragma once
+
+#include "SkyboltVis/Renderable/Planet/Tile/HeightMapElevationRerange.h"
+
+#include <osg/Image>
+#include <string>
+
+namespace skybolt {
+namespace vis {
+
+enum class TileImageEncoding
+{
+	Color, //!< Color image, used as is
+	Elevation, //!< 16 bit luminance height map storing elevation with the decoder's elevation rerange
+	TerrainRgb //!< Elevation encoded in RGB channels, converted to a 16 bit height map. See https://docs.mapbox.com/data/tilesets/guides/access-elevation-data/
+};
+
+enum class TileImageDecoderType
+{
+	Osg, //!< Decodes with osgDB plugins, then converts the decoded image in separate passes
+	Fused //!< Decodes PNG images row by row, converting each row and computing elevation bounds as it is decoded. Other formats are decoded as for Osg.
+};
+
+struct TileImageDecoderConfig
+{
+	TileImageDecoderType type = TileImageDecoderType::Fused;
+	TileImageEncoding encoding = TileImageEncoding::Color;
+	HeightMapElevationRerange elevationRerange = getDefaultEarthRerange(); //!< Rerange of Elevation source images, or of height maps converted from TerrainRgb source images
+};
+
+//! Decodes tile images into the format used by terrain tiles.
+//! Height maps are returned as 16 bit luminance images with HeightMapElevationRerange and HeightMapElevationBounds user data.
+//! This class is thread safe.
+class TileImageDecoder
+{
+public:
+	TileImageDecoder(const TileImageDecoderConfig& config);
+
+	//! @param data is the encoded image, e.g. the contents of a PNG file
+	//! @param extension is the file extension of the encoding, e.g. "png", used to find an osgDB reader
+	//! @return the decoded image, or null if the image could not be decoded or was the wrong format for the encoding
+	osg::ref_ptr<osg::Image> decode(const std::string& data, const std::string& extension) const;
+
+	//! Converts an image already decoded by osgDB
+	//! @return the converted image, or null if the image was the wrong format for the encoding
+	osg::ref_ptr<osg::Image> convert(const osg::ref_ptr<osg::Image>& image) const;
+
+	const TileImageDecoderConfig& getConfig() const { return mConfig; }
+
+private:
+	osg::ref_ptr<osg::Image> decodePng(const std::string& data) const;
+
+private:
+	const TileImageDecoderConfig mConfig;
+};
+
+} // namespace vis
+} // namespace skybolt
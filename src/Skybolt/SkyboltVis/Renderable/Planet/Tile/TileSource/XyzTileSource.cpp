@@ -5,16 +5,19 @@
  * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
 
 #include "XyzTileSource.h"
+#include "HttpTileFetcher.h"
 
 #include "SkyboltVis/OsgImageHelpers.h"
-#include "SkyboltVis/OsgTextureHelpers.h"
-#include "SkyboltVis/Renderable/Planet/Tile/HeightMapElevationBounds.h"
-#include "SkyboltVis/Renderable/Planet/Tile/HeightMapElevationRerange.h"
+#include <osgDB/FileNameUtils>
 #include <osgDB/ReadFile>
 #include <boost/algorithm/string/replace.hpp>
 #include <boost/log/trivial.hpp>
 #include <SkyboltCommon/ShaUtility.h>
 
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
 using namespace skybolt;
 
 namespace skybolt {
@@ -26,8 +29,15 @@ XyzTileSource::XyzTileSource(const XyzTileSourceConfig& config) :
 	mYOrigin(config.yOrigin),
 	mApiKey(config.apiKey),
 	mCacheSha(skybolt::calcSha1(config.urlTemplate)),
-	mElevationRerange(config.elevationRerange),
-	mImageReadOptions(new osgDB::Options())
+	mDecoder([&] {
+		TileImageDecoderConfig c;
+		c.type = config.decoderType;
+		c.encoding = config.terrainRgb ? TileImageEncoding::TerrainRgb : (config.elevationRerange ? TileImageEncoding::Elevation : TileImageEncoding::Color);
+		c.elevationRerange = config.elevationRerange.value_or(getDefaultEarthRerange());
+		return c;
+	}()),
+	mImageReadOptions(new osgDB::Options()),
+	mHttpTileFetcher(config.httpTileFetcher)
 {
 	// Disable SSL verification CURL requests, so that we can read images from http:// tile servers.
 	// FIXME: Ideally we would allow the user keep verification on and provide a certificate.
@@ -37,25 +47,12 @@ XyzTileSource::XyzTileSource(const XyzTileSourceConfig& config) :
 bool XyzTileSource::validate() const
 {
 	// Validate the loader by loading level 0 image
-	osg::ref_ptr<osg::Image> image = osgDB::readImageFile(toUrl(QuadTreeTileKey()), mImageReadOptions);
+	osg::ref_ptr<osg::Image> image = readImage(toUrl(QuadTreeTileKey()), [] { return false; });
 	if (!image)
 	{
-		BOOST_LOG_TRIVIAL(error) << "Could not load image from XyzTileSource with URL template '" << mUrlTemplate << ".";
-		return false;
-	}
-
-	if (mElevationRerange)
-	{
-		if (image->getPixelFormat() != GL_LUMINANCE)
-		{
-			BOOST_LOG_TRIVIAL(error) << "Elevation image with URL template '" << mUrlTemplate << "' is in wrong format: "
-				<< image->getPixelFormat() << ". It should be GL_LUMINANCE.'";
-		}
-		if (image->getDataType() != GL_UNSIGNED_SHORT)
-		{
-			BOOST_LOG_TRIVIAL(error) << "Elevation image with URL template '" << mUrlTemplate << "' is in wrong format: "
-				<< image->getPixelFormat() << ". It should be GL_UNSIGNED_SHORT.'";
-		}
+		// The decoder rejects images in the wrong format, e.g elevation images which are not 16 bit luminance
+		BOOST_LOG_TRIVIAL(error) << "Could not load image from XyzTileSource with URL template '" << mUrlTemplate
+			<< "', or image was not in the expected format.";
 		return false;
 	}
 
@@ -69,31 +66,39 @@ static int flipY(int y, int level)
 
 osg::ref_ptr<osg::Image> XyzTileSource::createImage(const QuadTreeTileKey& key, std::function<bool()> cancelSupplier) const
 {
-	osg::ref_ptr<osg::Image> image = readImageWithoutWarnings(toUrl(key), mImageReadOptions);
-	if (image)
+	return readImage(toUrl(key), cancelSupplier);
+}
+
+static std::optional<std::string> readLocalFile(const std::string& filename)
+{
+	std::error_code ec;
+	if (!std::filesystem::is_regular_file(filename, ec))
+	{
+		return std::nullopt;
+	}
+
+	std::ifstream f(filename, std::ios::binary);
+	std::ostringstream data;
+	data << f.rdbuf();
+	return f ? std::optional<std::string>(data.str()) : std::nullopt;
+}
+
+osg::ref_ptr<osg::Image> XyzTileSource::readImage(const std::string& url, const std::function<bool()>& cancelSupplier) const
+{
+	if (mHttpTileFetcher && HttpTileFetcher::supportsUrl(url))
+	{
+		HttpTileResponsePtr response = mHttpTileFetcher->fetch(url, cancelSupplier);
+		return response ? mDecoder.decode(response->body, getImageFileExtension(*response, url)) : nullptr;
+	}
+
+	if (std::optional<std::string> data = readLocalFile(url); data)
 	{
-		if (mElevationRerange)
-		{
-			if (!isHeightMapDataFormat(*image))
-			{
-				return nullptr;
-			}
-			image->setInternalTextureFormat(getHeightMapInternalTextureFormat());
-
-			setHeightMapElevationRerange(*image, *mElevationRerange);
-
-			HeightMapElevationBounds bounds = emptyHeightMapElevationBounds();
-			uint16_t* p = reinterpret_cast<uint16_t*>(image->data());
-			int elementCount = image->s() * image->t();
-			for (int i = 0; i < elementCount; ++i)
-			{
-				expand(bounds, getElevationForColorValue(*mElevationRerange, p[i]));
-			}
-			setHeightMapElevationBounds(*image, bounds);
-		}
+		return mDecoder.decode(*data, osgDB::getLowerCaseFileExtension(url));
 	}
 
-	return image;
+	// Read other URLs, e.g https:// URLs if the HttpTileFetcher does not support them, with osgDB
+	osg::ref_ptr<osg::Image> image = readImageWithoutWarnings(url, mImageReadOptions);
+	return image ? mDecoder.convert(image) : nullptr;
 }
 
 std::string XyzTileSource::toUrl(const skybolt::QuadTreeTileKey& key) const
@@ -6,7 +6,9 @@
 
 #pragma once
 #include "TileSourceWithMinMaxLevel.h"
+#include "TileImageDecoder.h"
 #include "SkyboltVis/Renderable/Planet/Tile/HeightMapElevationRerange.h"
+#include "SkyboltVis/SkyboltVisFwd.h"
 #include <osgDB/Options>
 
 namespace skybolt {
@@ -30,6 +32,14 @@ struct XyzTileSourceConfig
 
 	IntRangeInclusive levelRange;
 	std::optional<HeightMapElevationRerange> elevationRerange; //!< If provided, treat images as heightmaps storing elevation with the given rerange
+
+	//! If true, images store elevation in terrain-RGB format and are converted to heightmaps
+	//! with elevationRerange, or the default earth rerange if elevationRerange is not provided.
+	bool terrainRgb = false;
+
+	TileImageDecoderType decoderType = TileImageDecoderType::Fused;
+
+	HttpTileFetcherPtr httpTileFetcher; //!< If provided, used to fetch images from http URLs. Otherwise all images are read through osgDB.
 };
 
 class XyzTileSource : public TileSourceWithMinMaxLevel
@@ -48,20 +58,23 @@ public:
 	{
 		static const std::string pngStr = "png";
 		static const std::string pngxStr = "pngx";
-		return mElevationRerange ? pngxStr : pngStr;
+		return (mDecoder.getConfig().encoding != TileImageEncoding::Color) ? pngxStr : pngStr;
 	}
 
 private:
 	std::string toUrl(const skybolt::QuadTreeTileKey& key) const;
 
+	osg::ref_ptr<osg::Image> readImage(const std::string& url, const std::function<bool()>& cancelSupplier) const;
+
 private:
 	const std::string mUrlTemplate;
 	const XyzTileSourceConfig::YOrigin mYOrigin;
 	const std::string mApiKey;
 	const std::string mCacheSha;
-	std::optional<HeightMapElevationRerange> mElevationRerange;
+	const TileImageDecoder mDecoder;
 
 	osg::ref_ptr<osgDB::Options> mImageReadOptions;
+	const HttpTileFetcherPtr mHttpTileFetcher;
 };
 
 } // namespace vis
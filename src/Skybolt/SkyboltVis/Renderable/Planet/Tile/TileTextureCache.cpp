@@ -11,11 +11,17 @@ using namespace skybolt;
 namespace skybolt {
 namespace vis {
 
-TileTextureCache::TileTextureCache()
+static size_t getTextureSizeInBytes(const osg::ref_ptr<osg::Texture2D>& texture)
+{
+	const osg::Image* image = texture->getImage();
+	return image ? image->getTotalSizeInBytes() : 1;
+}
+
+TileTextureCache::TileTextureCache(size_t capacityBytesPerType)
 {
 	for (size_t i = 0; i < size_t(TextureType::TypeCount); ++i)
 	{
-		mCaches.push_back(TextureCache(lruCacheSize));
+		mCaches.push_back(std::make_unique<TextureCache>(capacityBytesPerType, &getTextureSizeInBytes));
 	}
 }
 
@@ -23,14 +29,18 @@ TileTextureCache::~TileTextureCache() = default;
 
 osg::ref_ptr<osg::Texture2D> TileTextureCache::getOrCreateTexture(TextureType type, osg::ref_ptr<osg::Image> image, const TextureFactory& factory)
 {
-	auto& cache = mCaches[(size_t)type];
+	auto& cache = *mCaches[(size_t)type];
 
 	osg::ref_ptr<osg::Texture2D> texture;
 
 	if (!cache.get(image, texture))
 	{
 		texture = factory(image);
-		cache.put(image, texture);
+		if (!cache.putSafe(image, texture))
+		{
+			// Another thread created a texture for the image first. Share its texture.
+			cache.get(image, texture);
+		}
 	};
 
 	return texture;
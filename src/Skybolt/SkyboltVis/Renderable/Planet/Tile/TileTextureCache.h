@@ -7,10 +7,11 @@
 #pragma once
 
 #include <SkyboltVis/SkyboltVisFwd.h>
-#include <SkyboltCommon/LruCacheMap.h>
+#include <SkyboltCommon/ConcurrentLruCacheMap.h>
 #include <osg/Image>
 #include <osg/Texture2D>
 #include <functional>
+#include <memory>
 
 namespace std {
 template <typename T>
@@ -29,7 +30,8 @@ namespace vis {
 class TileTextureCache
 {
 public:
-	TileTextureCache();
+	//! @param capacityBytesPerType is the maximum total size of images of cached textures of each TextureType
+	explicit TileTextureCache(size_t capacityBytesPerType = 64 * 1024 * 1024);
 	~TileTextureCache();
 
 	enum class TextureType
@@ -43,12 +45,13 @@ public:
 	};
 
 	using TextureFactory = std::function<osg::ref_ptr<osg::Texture2D>(osg::ref_ptr<osg::Image>)>;
+
+	//! @ThreadSafe
 	osg::ref_ptr<osg::Texture2D> getOrCreateTexture(TextureType type, osg::ref_ptr<osg::Image> image, const TextureFactory& factory);
 
 private:
-	using TextureCache = LruCacheMap<osg::ref_ptr<osg::Image>, osg::ref_ptr<osg::Texture2D>>;
-	constexpr static size_t lruCacheSize = 256;
-	std::vector<TextureCache> mCaches;
+	using TextureCache = ConcurrentLruCacheMap<osg::ref_ptr<osg::Image>, osg::ref_ptr<osg::Texture2D>>;
+	std::vector<std::unique_ptr<TextureCache>> mCaches;
 };
 
 } // namespace vis
@@ -34,6 +34,7 @@ public:
 	RunwaysBatch(const Runways& runways, const osg::ref_ptr<osg::Program>& surfaceProgram, const osg::ref_ptr<osg::Program>& textProgram);
 
 protected:
+	UpdatePolicy getUpdatePolicy() const override { return UpdatePolicy::Always; }
 	void updatePreRender(const CameraRenderContext& context) override;
 
 private:
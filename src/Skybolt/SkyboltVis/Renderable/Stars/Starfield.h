@@ -24,7 +24,8 @@ public:
 	~Starfield();
 
 private:
-	void updatePreRender(const CameraRenderContext& context);
+	UpdatePolicy getUpdatePolicy() const override { return UpdatePolicy::Always; }
+	void updatePreRender(const CameraRenderContext& context) override;
 
 private:
 	osg::Geode* mGeode;
@@ -37,6 +37,7 @@ public:
 	LakesBatch(const Lakes& lakes, const LakesConfig& config);
 
 protected:
+	UpdatePolicy getUpdatePolicy() const override { return UpdatePolicy::Always; }
 	void updatePreRender(const CameraRenderContext& context) override;
 
 private:
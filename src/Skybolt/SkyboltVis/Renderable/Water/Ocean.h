@@ -39,7 +39,8 @@ public:
 	void setOrientation(const osg::Quat& orientation) {}; //!< Has no effect
 
 private:
-	void updatePreRender(const CameraRenderContext& context);
+	UpdatePolicy getUpdatePolicy() const override { return UpdatePolicy::Always; }
+	void updatePreRender(const CameraRenderContext& context) override;
 
 private:
 	Uniforms mUniforms;
@@ -12,6 +12,9 @@
 #include "VisObject.h"
 #include "Renderable/Planet/Planet.h"
 #include <SkyboltCommon/VectorUtility.h>
+#include <SkyboltCommon/Profiling/Profiler.h>
+
+#include <osg/Polytope>
 
 using namespace skybolt::vis;
 
@@ -50,6 +53,7 @@ Scene::~Scene() = default;
 
 void Scene::updatePreRender(const CameraRenderContext& context)
 {
+	SKYBOLT_PROFILE_ZONE("Scene::updatePreRender");
 	mLightDirectionUniform->set(-getPrimaryLightDirection());
 
 	mWrappedNoiseOriginUniform->set(mWrappedNoiseOrigin);
@@ -66,16 +70,60 @@ void Scene::updatePreRender(const CameraRenderContext& context)
 		mGroundIrradianceMultiplierUniform->set(multiplier);
 	}
 
-	for (auto& [object, bucket] : mObjects)
+	// Objects are culled against the side planes of the view frustum, and by distance.
+	// The near and far planes are not used because the projection may use a reversed or infinite depth range.
+	osg::Polytope frustum;
+	frustum.setToUnitFrustum(/* withNear */ false, /* withFar */ false);
+	frustum.transformProvidingInverse(context.camera.getViewMatrix() * context.camera.getProjectionMatrix());
+
+	const osg::Vec3d cameraPosition = context.camera.getPosition();
+	const double maxDistance = mMaxUpdateDistance.value_or(context.camera.getFarClipDistance());
+
+	auto isInView = [&] (const VisObject& object) {
+		if (!object.isVisible())
+		{
+			return false;
+		}
+		std::optional<osg::BoundingSphere> bound = object.getWorldBound();
+		if (!bound)
+		{
+			return true;
+		}
+		double distance = (osg::Vec3d(bound->center()) - cameraPosition).length() - bound->radius();
+		return distance <= maxDistance && frustum.contains(*bound);
+	};
+
+	SceneUpdateStats stats;
+	stats.objectCount = int(mObjects.size());
+
+	for (const ObjectEntry& entry : mObjects)
 	{
-		object->updatePreRender(context);
+		switch (entry.updatePolicy)
+		{
+		case VisObject::UpdatePolicy::Never:
+			break;
+		case VisObject::UpdatePolicy::WhenInView:
+			if (!isInView(*entry.object))
+			{
+				++stats.culledObjectCount;
+				break;
+			}
+			[[fallthrough]];
+		case VisObject::UpdatePolicy::Always:
+			entry.object->updatePreRender(context);
+			++stats.updatedObjectCount;
+			break;
+		}
 	}
+
+	mUpdateStats = stats;
 }
 
 void Scene::addObject(const VisObjectPtr& object, Bucket bucket)
 {
-	assert(mObjects.find(object) == mObjects.end());
-	mObjects[object] = bucket;
+	assert(mObjectIndices.find(object.get()) == mObjectIndices.end());
+	mObjectIndices[object.get()] = mObjects.size();
+	mObjects.push_back({object, bucket, object->getUpdatePolicy()});
 	mBucketGroups[(int)bucket]->addChild(object->_getNode());
 
 	if (Light* light = dynamic_cast<Light*>(object.get()))
@@ -95,11 +143,20 @@ void Scene::removeObject(const VisObjectPtr& object)
 	else if (object.get() == mPrimaryPlanet)
 		mPrimaryPlanet = 0;
 
-	auto i = mObjects.find(object);
-	if (i != mObjects.end())
+	auto i = mObjectIndices.find(object.get());
+	if (i != mObjectIndices.end())
 	{
-		mBucketGroups[(int)i->second]->removeChild(object->_getNode());
-		mObjects.erase(i);
+		size_t index = i->second;
+		mBucketGroups[(int)mObjects[index].bucket]->removeChild(object->_getNode());
+		mObjectIndices.erase(i);
+
+		// Swap with the last object to remove in constant time
+		if (index + 1 != mObjects.size())
+		{
+			mObjects[index] = std::move(mObjects.back());
+			mObjectIndices[mObjects[index].object.get()] = index;
+		}
+		mObjects.pop_back();
 	}
 }
 
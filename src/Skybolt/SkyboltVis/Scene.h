@@ -14,9 +14,19 @@
 #include <osg/ClipNode>
 #include <osg/Group>
 
+#include <optional>
+#include <unordered_map>
+
 namespace skybolt {
 namespace vis {
 
+struct SceneUpdateStats
+{
+	int objectCount = 0;
+	int updatedObjectCount = 0; //!< Number of objects whose updatePreRender() was called
+	int culledObjectCount = 0; //!< Number of objects with VisObject::UpdatePolicy::WhenInView that were not updated because they were out of view
+};
+
 class Scene
 {
 public:
@@ -52,14 +62,33 @@ public:
 
 	osg::Group* getBucketGroup(Bucket bucket) const;
 
+	//! Calls updatePreRender() on objects according to their VisObject::UpdatePolicy
 	void updatePreRender(const CameraRenderContext& context);
 
+	//! @returns stats from the most recent updatePreRender()
+	const SceneUpdateStats& getUpdateStats() const { return mUpdateStats; }
+
 	osg::ref_ptr<osg::StateSet> getStateSet() const { return mStateSet; }
 
+	//! Sets the maximum distance from the camera at which objects with VisObject::UpdatePolicy::WhenInView are updated.
+	//! Defaults to the camera's far clip distance.
+	void setMaxUpdateDistance(const std::optional<double>& distance) { mMaxUpdateDistance = distance; }
+
 private:
 	osg::ref_ptr<osg::StateSet> mStateSet;
 
-	std::map<VisObjectPtr, Bucket> mObjects;
+	struct ObjectEntry
+	{
+		VisObjectPtr object;
+		Bucket bucket;
+		VisObject::UpdatePolicy updatePolicy;
+	};
+
+	// Objects are stored contiguously for fast per-frame iteration, with an index for fast lookup and removal
+	std::vector<ObjectEntry> mObjects;
+	std::unordered_map<const VisObject*, size_t> mObjectIndices;
+	SceneUpdateStats mUpdateStats;
+	std::optional<double> mMaxUpdateDistance;
 	std::vector<osg::ref_ptr<osg::Group>> mBucketGroups;
 	Light* mPrimaryLight;
 	Planet* mPrimaryPlanet;
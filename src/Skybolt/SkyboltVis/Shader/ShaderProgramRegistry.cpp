@@ -7,6 +7,12 @@
 #include "ShaderProgramRegistry.h"
 #include "OsgShaderHelpers.h"
 
+#include <px_sched/px_sched.h>
+
+#include <exception>
+#include <mutex>
+#include <set>
+
 namespace skybolt {
 namespace vis {
 
@@ -175,18 +181,67 @@ osg::ref_ptr<osg::Program> createProgram(const std::string& name, const ShaderPr
 	return p;
 }
 
-ShaderPrograms createShaderPrograms()
-{
-	std::map<std::string, osg::ref_ptr<osg::Program>> programs;
+using ShaderFileKey = std::pair<osg::Shader::Type, std::string>;
 
+ShaderPrograms createShaderPrograms(px_sched::Scheduler* scheduler)
+{
 	ShaderProgramSourceFilesRegistry registry = createShaderProgramSourceFilesRegistry();
 
+	// Many programs share shader files, e.g. the screen quad vertex shader
+	std::set<ShaderFileKey> uniqueFiles;
+	for (const auto& i : registry)
+	{
+		uniqueFiles.insert(i.second.begin(), i.second.end());
+	}
+
+	std::map<ShaderFileKey, osg::ref_ptr<osg::Shader>> shaders;
+	for (const ShaderFileKey& key : uniqueFiles)
+	{
+		shaders[key] = nullptr;
+	}
+
+	if (scheduler)
+	{
+		std::mutex errorMutex;
+		std::exception_ptr error;
+
+		px_sched::Sync sync;
+		for (auto& entry : shaders)
+		{
+			scheduler->run([&entry, &errorMutex, &error] {
+				try
+				{
+					entry.second = vis::readShaderFile(entry.first.first, entry.first.second);
+				}
+				catch (...)
+				{
+					std::scoped_lock<std::mutex> lock(errorMutex);
+					error = std::current_exception();
+				}
+			}, &sync);
+		}
+		scheduler->waitFor(sync);
+
+		if (error)
+		{
+			std::rethrow_exception(error);
+		}
+	}
+	else
+	{
+		for (auto& [key, shader] : shaders)
+		{
+			shader = vis::readShaderFile(key.first, key.second);
+		}
+	}
+
+	std::map<std::string, osg::ref_ptr<osg::Program>> programs;
 	for (const auto& i : registry)
 	{
 		osg::ref_ptr<osg::Program> p = new osg::Program();
-		for (auto shader : i.second)
+		for (const auto& file : i.second)
 		{
-			p->addShader(vis::readShaderFile(shader.first, shader.second));
+			p->addShader(shaders[file]);
 		}
 		programs[i.first] = p;
 	}
@@ -6,6 +6,8 @@
 
 #pragma once
 
+#include "SkyboltVis/SkyboltVisFwd.h"
+
 #include <osg/Program>
 
 namespace skybolt {
@@ -33,7 +35,10 @@ osg::ref_ptr<osg::Program> createProgram(const std::string& name, const ShaderPr
 
 ShaderProgramSourceFiles getShaderSource_terrainFlatTile();
 
-ShaderPrograms createShaderPrograms();
+//! Each shader file is read once and its osg::Shader is shared by all programs which use it,
+//! so that it is only compiled once per graphics context.
+//! @param scheduler if not null, shader files are read in parallel on the scheduler's threads
+ShaderPrograms createShaderPrograms(px_sched::Scheduler* scheduler = nullptr);
 
 } // namespace vis
 } // namespace skybolt
@@ -21,6 +21,7 @@ class Billboard;
 class BillboardForest;
 class BuildingsBatch;
 struct BuildingTypes;
+class CachedTileSource;
 class Camera;
 struct CameraRenderContext;
 class Cloud;
@@ -34,14 +35,20 @@ class LlaToNedConverter;
 class GpuForest;
 class GpuForestTile;
 class GpuTextureGenerator;
+class HttpTileFetcher;
+class InstancedModel;
+class InstancedModelCache;
 class JsonTileSourceFactoryRegistry;
 class Model;
+class ModelCache;
 class ModelFactory;
+class ModelInstance;
 struct OsgTile;
 class OsgTileFactory;
 class PagedForest;
 class PlanetFeatures;
 struct PlanetSubdivisionPredicate;
+class PlanetTerrainIntersector;
 struct PlanetTileSources;
 class QuadTreeTileLoader;
 class Ocean;
@@ -90,24 +97,31 @@ typedef shared_ptr<BillboardForest> BillboardForestPtr;
 typedef shared_ptr<Billboard> BillboardPtr;
 typedef shared_ptr<BuildingsBatch> BuildingsBatchPtr;
 typedef shared_ptr<BuildingTypes> BuildingTypesPtr;
+typedef shared_ptr<CachedTileSource> CachedTileSourcePtr;
 typedef shared_ptr<Camera> CameraPtr;
 typedef shared_ptr<Cloud> CloudPtr;
 typedef shared_ptr<DetailMappingTechnique> DetailMappingTechniquePtr;
 typedef shared_ptr<ElevationProvider> ElevationProviderPtr;
 typedef shared_ptr<GpuForest> GpuForestPtr;
 typedef shared_ptr<GpuForestTile> GpuForestTilePtr;
+typedef shared_ptr<HttpTileFetcher> HttpTileFetcherPtr;
+typedef shared_ptr<InstancedModel> InstancedModelPtr;
+typedef shared_ptr<InstancedModelCache> InstancedModelCachePtr;
 typedef shared_ptr<JsonTileSourceFactoryRegistry> JsonTileSourceFactoryRegistryPtr;
 typedef shared_ptr<LakesBatch> LakesBatchPtr;
 typedef shared_ptr<Light> LightPtr;
 typedef shared_ptr<LlaToNedConverter> LlaToNedConverterPtr;
 typedef shared_ptr<Model> ModelPtr;
+typedef shared_ptr<ModelCache> ModelCachePtr;
 typedef shared_ptr<ModelFactory> ModelFactoryPtr;
+typedef shared_ptr<ModelInstance> ModelInstancePtr;
 typedef shared_ptr<Ocean> OceanPtr;
 typedef shared_ptr<OsgTile> OsgTilePtr;
 typedef shared_ptr<OsgTileFactory> OsgTileFactoryPtr;
 typedef shared_ptr<PagedForest> PagedForestPtr;
 typedef shared_ptr<Particles> ParticlesPtr;
 typedef shared_ptr<Planet> PlanetPtr;
+typedef shared_ptr<PlanetTerrainIntersector> PlanetTerrainIntersectorPtr;
 typedef shared_ptr<Polyline> PolylinePtr;
 typedef shared_ptr<QuadTreeTileLoader> QuadTreeTileLoaderPtr;
 typedef shared_ptr<RenderOperationSequence> RenderOperationSequencePtr;
@@ -18,7 +18,7 @@ namespace vis {
 
 void addDefaultFactories(VisFactoryRegistry& registry)
 {
-	registry[VisFactoryType::WaveHeightTextureGenerator] = std::make_shared<SimpleWaveHeightTextureGeneratorFactory>();
+	registry.add(VisFactoryType::WaveHeightTextureGenerator, std::make_shared<SimpleWaveHeightTextureGeneratorFactory>());
 }
 
 } // namespace vis
@@ -11,6 +11,8 @@
 #include <osg/Vec3f>
 #include <osg/Quat>
 
+#include <optional>
+
 namespace skybolt {
 namespace vis {
 
@@ -20,8 +22,23 @@ public:
 	VisObject();
 	virtual ~VisObject();
 
+	enum class UpdatePolicy
+	{
+		Never, //!< updatePreRender() is not called by the Scene
+		WhenInView, //!< updatePreRender() is called when the object is visible and its world bound is in the camera's view
+		Always //!< updatePreRender() is called every frame
+	};
+
+	//! Objects which implement updatePreRender() must opt in to being updated by the Scene.
+	//! The policy is queried once when the object is added to the Scene.
+	virtual UpdatePolicy getUpdatePolicy() const { return UpdatePolicy::Never; }
+
 	virtual void updatePreRender(const CameraRenderContext& context) {};
 
+	//! @returns bound in world space, used by the Scene to cull objects with UpdatePolicy::WhenInView.
+	//! Objects without a bound are never culled.
+	virtual std::optional<osg::BoundingSphere> getWorldBound() const { return std::nullopt; }
+
 	virtual void setVisibilityCategoryMask(uint32_t mask) {};
 	virtual void setVisible(bool visible) {};
 	virtual bool isVisible() const {return true;}
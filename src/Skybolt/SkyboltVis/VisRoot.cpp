@@ -11,6 +11,7 @@
 #include "SkyboltVis/RenderOperation/RenderTarget.h"
 #include "SkyboltVis/Window/Window.h"
 #include <SkyboltCommon/VectorUtility.h>
+#include <SkyboltCommon/Profiling/Profiler.h>
 
 #include <osgViewer/CompositeViewer>
 
@@ -54,6 +55,7 @@ VisRoot::VisRoot(const DisplaySettings& settings) :
 
 bool VisRoot::render()
 {
+	SKYBOLT_PROFILE_ZONE("VisRoot::render");
 	if (mWindows.empty())
 	{
 		// Don't call Viewer::frame() if there are no windows,
@@ -0,0 +1,39 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#pragma once
+
+#include <httplib/httplib.h>
+
+#include <string>
+#include <thread>
+
+//! Local stand-in for a remote tile server
+struct TestTileServer
+{
+	TestTileServer()
+	{
+		// Each keep-alive connection occupies a server thread, so provide plenty
+		server.new_task_queue = [] { return new httplib::ThreadPool(64); };
+		port = server.bind_to_any_port("127.0.0.1");
+		thread = std::thread([this] { server.listen_after_bind(); });
+	}
+
+	~TestTileServer()
+	{
+		server.stop();
+		thread.join();
+	}
+
+	std::string getUrl(const std::string& path) const
+	{
+		return "http://127.0.0.1:" + std::to_string(port) + path;
+	}
+
+	httplib::Server server;
+	int port;
+	std::thread thread;
+};
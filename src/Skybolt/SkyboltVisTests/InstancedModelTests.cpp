@@ -0,0 +1,91 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include <catch2/catch.hpp>
+
+#include <SkyboltVis/Camera.h>
+#include <SkyboltVis/RenderContext.h>
+#include <SkyboltVis/Renderable/Model/InstancedModel.h>
+
+#include <osg/Geode>
+#include <osg/Geometry>
+
+using namespace skybolt::vis;
+
+static osg::ref_ptr<osg::Node> createTestModel()
+{
+	osg::ref_ptr<osg::Vec3Array> vertices = new osg::Vec3Array;
+	vertices->push_back(osg::Vec3(-1, 0, 0));
+	vertices->push_back(osg::Vec3(1, 0, 0));
+	vertices->push_back(osg::Vec3(0, 1, 0));
+
+	osg::ref_ptr<osg::Geometry> geometry = new osg::Geometry;
+	geometry->setVertexArray(vertices);
+	geometry->addPrimitiveSet(new osg::DrawArrays(GL_TRIANGLES, 0, 3));
+
+	osg::ref_ptr<osg::Geode> geode = new osg::Geode;
+	geode->addDrawable(geometry);
+	return geode;
+}
+
+static void updateInstancedModel(VisObject& object, const Camera& camera)
+{
+	CameraRenderContext context(camera);
+	context.atmosphericDensity = 0;
+	object.updatePreRender(context);
+}
+
+TEST_CASE("Instanced model draws all instances with one draw call per primitive set")
+{
+	InstancedModelConfig config;
+	config.node = createTestModel();
+	auto model = std::make_shared<InstancedModel>(config);
+
+	// Camera looks along the +X axis
+	Camera camera(1.0f);
+
+	std::vector<ModelInstancePtr> instances;
+	for (int i = 0; i < 100; ++i)
+	{
+		ModelInstancePtr instance = model->createInstance();
+		instance->setPosition(osg::Vec3d(100 + i, 0, 0));
+		instances.push_back(instance);
+	}
+
+	updateInstancedModel(*model, camera);
+	CHECK(model->getStats().instanceCount == 100);
+	CHECK(model->getStats().visibleInstanceCount == 100);
+	CHECK(model->getStats().culledInstanceCount == 0);
+	CHECK(model->getStats().drawCallCount == 1);
+
+	SECTION("Instances outside frustum are culled")
+	{
+		for (int i = 0; i < 10; ++i)
+		{
+			instances[i]->setPosition(osg::Vec3d(-100, 0, 0));
+		}
+		updateInstancedModel(*model, camera);
+		CHECK(model->getStats().visibleInstanceCount == 90);
+		CHECK(model->getStats().culledInstanceCount == 10);
+		CHECK(model->getStats().drawCallCount == 1);
+	}
+
+	SECTION("Hidden instances are not drawn")
+	{
+		instances[0]->setVisible(false);
+		updateInstancedModel(*model, camera);
+		CHECK(model->getStats().visibleInstanceCount == 99);
+		CHECK(model->getStats().culledInstanceCount == 0);
+	}
+
+	SECTION("Destroyed instances are removed")
+	{
+		instances.clear();
+		updateInstancedModel(*model, camera);
+		CHECK(model->getStats().instanceCount == 0);
+		CHECK(model->getStats().drawCallCount == 0);
+	}
+}
@@ -0,0 +1,77 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include <catch2/catch.hpp>
+
+#include <SkyboltVis/Renderable/Planet/Features/MappedFeatureTile.h>
+#include <SkyboltVis/Renderable/Planet/Features/PlanetFeaturesSource.h>
+
+#include <filesystem>
+
+using namespace skybolt;
+using namespace skybolt::mapfeatures;
+using namespace skybolt::sim;
+
+TEST_CASE("Mapped feature tile round trip")
+{
+	auto road = std::make_shared<Road>();
+	road->points = { LatLonAlt(0.1, 0.2, 3), LatLonAlt(0.4, 0.5, 6) };
+	road->width = 7;
+	road->laneCount = 2;
+	road->endLaneCounts[1] = 3;
+	road->endControlPoints[1] = LatLonAlt(0.7, 0.8, 9);
+
+	auto building = std::make_shared<Building>();
+	building->points = { LatLonAlt(1, 2, 3), LatLonAlt(4, 5, 6), LatLonAlt(7, 8, 9) };
+	building->height = 12;
+
+	auto water = std::make_shared<Water>();
+	water->points = { LatLonAlt(-1, -2, 0) };
+
+	auto airport = std::make_shared<Airport>();
+	airport->runways = { { "09/27", LatLon(0.1, 0.2), LatLon(0.3, 0.4), 45 } };
+	airport->altitude = 100;
+
+	const std::string filename = (std::filesystem::temp_directory_path() / "MappedFeatureTileTest.ftr").string();
+	saveMappedFeatureTile({ road, building, water, airport }, filename);
+
+	REQUIRE(MappedFeatureTile::isMappedFormat(filename));
+
+	{
+		MappedFeatureTile tile(filename);
+
+		REQUIRE(tile.getRoads().size() == 1);
+		const mappedfeaturetile::RoadRecord& roadRecord = tile.getRoads()[0];
+		CHECK(roadRecord.width == road->width);
+		CHECK(roadRecord.laneCount == road->laneCount);
+		CHECK(roadRecord.endLaneCounts[0] == Road::noJunction);
+		CHECK(roadRecord.endLaneCounts[1] == 3);
+		CHECK(roadRecord.endControlPoints[1] == road->endControlPoints[1]);
+
+		auto roadPoints = tile.getPoints(roadRecord.points);
+		REQUIRE(roadPoints.size() == 2);
+		CHECK(roadPoints[1] == road->points[1]);
+
+		REQUIRE(tile.getBuildings().size() == 1);
+		CHECK(tile.getBuildings()[0].height == building->height);
+		CHECK(tile.getPoints(tile.getBuildings()[0].points).size() == 3);
+
+		REQUIRE(tile.getWaters().size() == 1);
+		CHECK(tile.getPoints(tile.getWaters()[0].points)[0] == water->points[0]);
+
+		std::vector<AirportPtr> airports = tile.loadAirports();
+		REQUIRE(airports.size() == 1);
+		CHECK(airports[0]->altitude == airport->altitude);
+		REQUIRE(airports[0]->runways.size() == 1);
+		CHECK(airports[0]->runways[0].name == "09/27");
+
+		std::vector<FeaturePtr> features;
+		loadTile(filename, features);
+		CHECK(features.size() == 4);
+	}
+
+	std::filesystem::remove(filename);
+}
@@ -0,0 +1,66 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include <catch2/catch.hpp>
+
+#include <SkyboltVis/Renderable/Model/ModelCache.h>
+
+#include <atomic>
+#include <thread>
+
+using namespace skybolt::vis;
+
+TEST_CASE("Model cache loads each model once when requested concurrently")
+{
+	ModelCache cache;
+	std::atomic<int> loadCount = 0;
+
+	auto loader = [&] {
+		++loadCount;
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+		return osg::ref_ptr<osg::Node>(new osg::Node);
+	};
+
+	std::vector<osg::ref_ptr<osg::Node>> results(8);
+	std::vector<std::thread> threads;
+	for (size_t i = 0; i < results.size(); ++i)
+	{
+		threads.emplace_back([&, i] { results[i] = cache.getOrLoad("model", loader); });
+	}
+	for (std::thread& thread : threads)
+	{
+		thread.join();
+	}
+
+	CHECK(loadCount == 1);
+	for (const osg::ref_ptr<osg::Node>& result : results)
+	{
+		CHECK(result == results.front());
+	}
+}
+
+TEST_CASE("Model cache evicts only unreferenced models")
+{
+	ModelCache cache;
+	osg::ref_ptr<osg::Node> usedModel = cache.getOrLoad("used", [] { return osg::ref_ptr<osg::Node>(new osg::Node); });
+	cache.getOrLoad("unused", [] { return osg::ref_ptr<osg::Node>(new osg::Node); });
+	REQUIRE(cache.size() == 2);
+
+	CHECK(cache.evictUnused() == 1);
+	CHECK(cache.size() == 1);
+
+	// Model remains cached while referenced
+	int loadCount = 0;
+	cache.getOrLoad("used", [&] { ++loadCount; return osg::ref_ptr<osg::Node>(new osg::Node); });
+	CHECK(loadCount == 0);
+}
+
+TEST_CASE("Model cache does not cache failed loads")
+{
+	ModelCache cache;
+	CHECK_THROWS(cache.getOrLoad("model", []() -> osg::ref_ptr<osg::Node> { throw std::runtime_error("Load failed"); }));
+	CHECK(cache.size() == 0);
+}
@@ -0,0 +1,362 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include <catch2/catch.hpp>
+#include <SkyboltVis/ElevationProvider/HeightMapElevationProvider.h>
+#include <SkyboltVis/ElevationProvider/PlanetTerrainIntersector.h>
+#include <SkyboltVis/Renderable/Planet/Tile/HeightMapElevationPyramid.h>
+#include <SkyboltVis/Renderable/Planet/Tile/HeightMapElevationRerange.h>
+#include <SkyboltCommon/Math/MathUtility.h>
+
+#include <osg/Image>
+#include <px_sched/px_sched.h>
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <random>
+
+using namespace skybolt;
+using namespace skybolt::vis;
+
+namespace {
+
+const double planetRadius = 1000;
+const int tileLevel = 1;
+const int tileSize = 33;
+
+float terrainFunction(double lon, double lat)
+{
+	return float(20 + 15 * std::sin(3 * lon) * std::cos(2 * lat) + 5 * std::sin(17 * lon + 11 * lat));
+}
+
+using TerrainFunction = std::function<float(double lon, double lat)>;
+
+osg::ref_ptr<osg::Image> createHeightMap(const QuadTreeTileKey& key, int size = tileSize, const TerrainFunction& terrain = terrainFunction,
+	const HeightMapElevationRerange& rerange = rerangeElevationFromUInt16WithElevationBounds(-10, 60))
+{
+	osg::ref_ptr<osg::Image> image = new osg::Image;
+	image->allocateImage(size, size, 1, GL_LUMINANCE, GL_UNSIGNED_SHORT);
+	setHeightMapElevationRerange(*image, rerange);
+
+	Box2d bounds = getKeyLonLatBounds<osg::Vec2d>(key);
+	osg::Vec2d boundsSize = bounds.size();
+	uint16_t* p = reinterpret_cast<uint16_t*>(image->data());
+	for (int y = 0; y < size; ++y)
+	{
+		for (int x = 0; x < size; ++x)
+		{
+			double lon = bounds.minimum.x() + boundsSize.x() * x / size;
+			double lat = bounds.minimum.y() + boundsSize.y() * y / size;
+			p[x + y * size] = getColorValueForElevation(rerange, terrain(lon, lat));
+		}
+	}
+	return image;
+}
+
+//! Height maps for tiles at the same level
+using HeightMaps = std::map<QuadTreeTileKey, osg::ref_ptr<osg::Image>>;
+
+//! @returns height maps covering the whole planet at tileLevel
+HeightMaps createHeightMaps()
+{
+	HeightMaps heightMaps;
+	for (int y = 0; y < (1 << tileLevel); ++y)
+	{
+		for (int x = 0; x < (2 << tileLevel); ++x)
+		{
+			QuadTreeTileKey key(tileLevel, x, y);
+			heightMaps[key] = createHeightMap(key);
+		}
+	}
+	return heightMaps;
+}
+
+void addTiles(PlanetTerrainIntersector& intersector, const HeightMaps& heightMaps)
+{
+	for (const auto& [key, image] : heightMaps)
+	{
+		intersector.addTile(key, TileImage{image, key});
+	}
+}
+
+osg::Vec3d llaToPosition(double lat, double lon, double altitude, double radius = planetRadius)
+{
+	double cosLat = std::cos(lat);
+	return osg::Vec3d(std::cos(lon) * cosLat, std::sin(lon) * cosLat, std::sin(lat)) * (radius + altitude);
+}
+
+//! @returns rays starting above the terrain and pointing down towards random points near the terrain
+std::vector<TerrainRay> createRays(int count)
+{
+	std::mt19937 generator(1);
+	std::uniform_real_distribution<double> random(0, 1);
+
+	std::vector<TerrainRay> rays;
+	for (int i = 0; i < count; ++i)
+	{
+		double lat = (random(generator) - 0.5) * 2.4;
+		double lon = (random(generator) * 2 - 1) * 3.1;
+		osg::Vec3d origin = llaToPosition(lat, lon, 70 + random(generator) * 100);
+		osg::Vec3d target = llaToPosition(lat + (random(generator) - 0.5) * 0.6, lon + (random(generator) - 0.5) * 0.6, random(generator) * 40 - 5);
+		osg::Vec3d direction = target - origin;
+		direction.normalize();
+		rays.push_back({origin, direction, 2000});
+	}
+	return rays;
+}
+
+//! Finds intersections by sampling the height maps at small fixed intervals
+class BruteForceIntersector
+{
+public:
+	BruteForceIntersector(const HeightMaps& heightMaps, double radius = planetRadius) :
+		mRadius(radius),
+		mLevel(heightMaps.begin()->first.level)
+	{
+		for (const auto& [key, image] : heightMaps)
+		{
+			Box2d bounds = getKeyLonLatBounds<osg::Vec2d>(key);
+			Box2f latLonBounds(osg::Vec2f(bounds.minimum.y(), bounds.minimum.x()), osg::Vec2f(bounds.maximum.y(), bounds.maximum.x()));
+			mProviders.emplace(key, HeightMapElevationProvider(image, getRequiredHeightMapElevationRerange(*image), latLonBounds));
+		}
+	}
+
+	std::optional<double> intersectRay(const TerrainRay& ray, double step) const
+	{
+		for (double t = 0; t < ray.maxDistance; t += step)
+		{
+			osg::Vec3d position = ray.origin + ray.direction * t;
+			double radius = position.length();
+			double lat = std::asin(position.z() / radius);
+			double lon = std::atan2(position.y(), position.x());
+
+			QuadTreeTileKey key = getKeyAtLevelIntersectingLonLatPoint(mLevel, osg::Vec2d(lon, lat));
+			key.x = std::clamp(key.x, 0, (2 << mLevel) - 1);
+			key.y = std::clamp(key.y, 0, (1 << mLevel) - 1);
+
+			auto i = mProviders.find(key);
+			if (i != mProviders.end() && radius - mRadius <= i->second.get(float(lat), float(lon)))
+			{
+				return t;
+			}
+		}
+		return std::nullopt;
+	}
+
+private:
+	double mRadius;
+	int mLevel;
+	std::map<QuadTreeTileKey, HeightMapElevationProvider> mProviders;
+};
+
+} // namespace
+
+TEST_CASE("HeightMapElevationPyramid blocks bound interpolated elevations")
+{
+	osg::ref_ptr<osg::Image> image = createHeightMap(QuadTreeTileKey(tileLevel, 1, 0));
+	HeightMapElevationPyramid pyramid(image, 4);
+
+	// 32 texel intervals in blocks of 4 gives 8x8 blocks at the finest level, reducing to 1x1
+	REQUIRE(pyramid.getLevelCount() == 4);
+	CHECK(pyramid.getBlockCountX(0) == 8);
+	CHECK(pyramid.getBlockCountX(3) == 1);
+
+	std::mt19937 generator(1);
+	std::uniform_real_distribution<double> random(0, tileSize);
+	for (int i = 0; i < 1000; ++i)
+	{
+		double u = random(generator);
+		double v = random(generator);
+		float elevation = pyramid.getElevation(u, v);
+		for (int level = 0; level < pyramid.getLevelCount(); ++level)
+		{
+			const HeightMapElevationBounds& bounds = pyramid.getBlockBounds(level, pyramid.getBlockIndexX(level, u), pyramid.getBlockIndexY(level, v));
+			CHECK(elevation >= bounds.x());
+			CHECK(elevation <= bounds.y());
+		}
+	}
+}
+
+TEST_CASE("PlanetTerrainIntersector matches brute force sampling")
+{
+	HeightMaps heightMaps = createHeightMaps();
+	PlanetTerrainIntersector intersector(planetRadius);
+	addTiles(intersector, heightMaps);
+
+	BruteForceIntersector bruteForce(heightMaps);
+	const double bruteForceStep = 0.02;
+
+	auto checkMatchesBruteForce = [&] {
+		int hitCount = 0;
+		for (const TerrainRay& ray : createRays(100))
+		{
+			std::optional<TerrainRayIntersection> intersection = intersector.intersectRay(ray);
+			std::optional<double> expectedDistance = bruteForce.intersectRay(ray, bruteForceStep);
+			REQUIRE(bool(intersection) == bool(expectedDistance));
+			if (intersection)
+			{
+				CHECK(intersection->distance == Approx(*expectedDistance).margin(bruteForceStep * 2));
+				osg::Vec3d expectedPosition = ray.origin + ray.direction * intersection->distance;
+				CHECK((intersection->position - expectedPosition).length() == Approx(0).margin(1e-6));
+				++hitCount;
+			}
+		}
+		CHECK(hitCount > 50);
+	};
+
+	checkMatchesBruteForce();
+
+	SECTION("Tiles using an ancestor's height map give the same result")
+	{
+		QuadTreeTileKey parentKey(tileLevel, 1, 0);
+		intersector.removeTile(parentKey);
+		for (int y = 0; y < 2; ++y)
+		{
+			for (int x = 0; x < 2; ++x)
+			{
+				intersector.addTile(QuadTreeTileKey(tileLevel + 1, parentKey.x * 2 + x, parentKey.y * 2 + y), TileImage{heightMaps[parentKey], parentKey});
+			}
+		}
+		checkMatchesBruteForce();
+	}
+}
+
+TEST_CASE("PlanetTerrainIntersector misses")
+{
+	HeightMaps heightMaps = createHeightMaps();
+	PlanetTerrainIntersector intersector(planetRadius);
+
+	osg::Vec3d origin = llaToPosition(0.3, 0.3, 100);
+	osg::Vec3d down = -origin / origin.length();
+	TerrainRay downRay{origin, down, 1000};
+
+	CHECK(!intersector.intersectRay(downRay)); // No tiles
+	CHECK(!intersector.getElevation(sim::LatLon(0.3, 0.3)));
+
+	addTiles(intersector, heightMaps);
+	CHECK(intersector.getElevation(sim::LatLon(0.3, 0.3)));
+
+	std::optional<TerrainRayIntersection> intersection = intersector.intersectRay(downRay);
+	REQUIRE(intersection);
+	CHECK(intersection->distance == Approx(100 - *intersector.getElevation(sim::LatLon(0.3, 0.3))).margin(0.01));
+
+	CHECK(!intersector.intersectRay(TerrainRay{origin, -down, 1e9})); // Pointing away from terrain
+	CHECK(!intersector.intersectRay(TerrainRay{origin, down, 10})); // Too short
+
+	// Removing the tile under the ray removes the intersection
+	intersector.removeTile(getKeyAtLevelIntersectingLonLatPoint(tileLevel, osg::Vec2d(0.3, 0.3)));
+	CHECK(!intersector.intersectRay(downRay));
+
+	intersector.clear();
+	CHECK(!intersector.getElevation(sim::LatLon(-0.3, -0.3)));
+}
+
+TEST_CASE("PlanetTerrainIntersector batched rays match single rays")
+{
+	PlanetTerrainIntersector intersector(planetRadius);
+	addTiles(intersector, createHeightMaps());
+
+	px_sched::Scheduler scheduler;
+	scheduler.init();
+
+	std::vector<TerrainRay> rays = createRays(500);
+	std::vector<std::optional<TerrainRayIntersection>> intersections = intersector.intersectRays(rays, &scheduler);
+	REQUIRE(intersections.size() == rays.size());
+	for (size_t i = 0; i < rays.size(); ++i)
+	{
+		std::optional<TerrainRayIntersection> expected = intersector.intersectRay(rays[i]);
+		REQUIRE(bool(intersections[i]) == bool(expected));
+		if (expected)
+		{
+			CHECK(intersections[i]->distance == expected->distance);
+		}
+	}
+}
+
+TEST_CASE("Benchmark PlanetTerrainIntersector", "[.benchmark]")
+{
+	// Earth sized planet with an 8x8 block of level 10 tiles, with rays cast from aircraft altitudes
+	const double radius = 6371000;
+	const int level = 10;
+	const int size = 257;
+	const int blockSize = 8;
+	auto terrain = [] (double lon, double lat) {
+		return float(800 + 600 * std::sin(900 * lon) * std::cos(700 * lat) + 200 * std::sin(5000 * lon + 3000 * lat));
+	};
+
+	HeightMaps heightMaps;
+	for (int y = 0; y < blockSize; ++y)
+	{
+		for (int x = 0; x < blockSize; ++x)
+		{
+			QuadTreeTileKey key(level, (1 << level) + x, (1 << level) / 2 + y);
+			heightMaps[key] = createHeightMap(key, size, terrain, getDefaultEarthRerange());
+		}
+	}
+
+	PlanetTerrainIntersector intersector(radius);
+	for (const auto& [key, image] : heightMaps)
+	{
+		intersector.addTile(key, TileImage{image, key});
+	}
+	BruteForceIntersector bruteForce(heightMaps, radius);
+
+	Box2d blockBounds = getKeyLonLatBounds<osg::Vec2d>(heightMaps.begin()->first);
+	blockBounds.minimum.y() -= blockBounds.size().y() * (blockSize - 1);
+	blockBounds.maximum.x() += blockBounds.size().x() * (blockSize - 1);
+
+	std::mt19937 generator(1);
+	std::uniform_real_distribution<double> random(0, 1);
+	std::vector<TerrainRay> rays;
+	for (int i = 0; i < 10000; ++i)
+	{
+		double lon = blockBounds.minimum.x() + blockBounds.size().x() * (0.25 + 0.5 * random(generator));
+		double lat = blockBounds.minimum.y() + blockBounds.size().y() * (0.25 + 0.5 * random(generator));
+		osg::Vec3d origin = llaToPosition(lat, lon, 3000 + random(generator) * 2000, radius);
+		double heading = random(generator) * math::twoPiD();
+		double pitch = -random(generator) * 0.5;
+		osg::Vec3d target = llaToPosition(lat + std::cos(heading) * 0.001, lon + std::sin(heading) * 0.001, 3000 + 2000 * random(generator) + std::tan(pitch) * 6371, radius);
+		osg::Vec3d direction = target - origin;
+		direction.normalize();
+		rays.push_back({origin, direction, 50000});
+	}
+
+	auto measureRaysPerSecond = [&] (const std::function<void()>& intersect) {
+		auto start = std::chrono::steady_clock::now();
+		intersect();
+		double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		return double(rays.size()) / seconds;
+	};
+
+	double singleRaysPerSecond = measureRaysPerSecond([&] {
+		for (const TerrainRay& ray : rays)
+		{
+			intersector.intersectRay(ray);
+		}
+	});
+
+	px_sched::Scheduler scheduler;
+	scheduler.init();
+	double batchedRaysPerSecond = measureRaysPerSecond([&] {
+		intersector.intersectRays(rays, &scheduler);
+	});
+
+	// Brute force sampling at the half-texel interval the intersector samples at near the terrain
+	const double texelSize = radius * blockBounds.size().y() / blockSize / size;
+	double bruteForceRaysPerSecond = measureRaysPerSecond([&] {
+		for (const TerrainRay& ray : rays)
+		{
+			bruteForce.intersectRay(ray, texelSize * 0.5);
+		}
+	});
+
+	std::cout << "Hierarchical: " << singleRaysPerSecond << " rays per second" << std::endl;
+	std::cout << "Hierarchical batched: " << batchedRaysPerSecond << " rays per second" << std::endl;
+	std::cout << "Brute force: " << bruteForceRaysPerSecond << " rays per second" << std::endl;
+}
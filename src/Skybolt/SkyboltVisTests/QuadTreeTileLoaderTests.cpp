@@ -103,6 +103,7 @@ SCENARIO("Test QuadTreeTileLoader requests load of tiles that pass predicate")
 					THEN("Second level load requested")
 					{
 						CHECK(asyncTileLoader->requests.size() == 10);
+						CHECK(loader.getFlatLoadedTree().getTileCount() == 2);
 					}
 
 					AND_WHEN("Second level loaded")
@@ -113,6 +114,7 @@ SCENARIO("Test QuadTreeTileLoader requests load of tiles that pass predicate")
 						THEN("Loaded tree contains the second level")
 						{
 							CHECK(loadedTree->leftTree.getRoot().hasChildren());
+							CHECK(loader.getFlatLoadedTree().getTileCount() == 10);
 						}
 
 						AND_WHEN("Second level mo longer passes predicate")
@@ -123,6 +125,7 @@ SCENARIO("Test QuadTreeTileLoader requests load of tiles that pass predicate")
 							THEN("Second level unloaded")
 							{
 								CHECK(!loadedTree->leftTree.getRoot().hasChildren());
+								CHECK(loader.getFlatLoadedTree().getTileCount() == 2);
 							}
 						}
 					}
@@ -180,6 +183,11 @@ TEST_CASE("Find all leaf tiles of a tree")
 		findLeafTiles(*tree, result, maxLevel);
 		CHECK(result.size() == 2);
 	}
+
+	// Flat snapshot of the tree finds the same tiles
+	TileKeyImagesMap flatResult;
+	findLeafTiles(createFlatQuadTree(*tree), flatResult, maxLevel);
+	CHECK(flatResult == result);
 }
 
 TEST_CASE("Find tiles added and removed from tree")
@@ -0,0 +1,170 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include <catch2/catch.hpp>
+
+#include <SkyboltVis/Camera.h>
+#include <SkyboltVis/DefaultRootNode.h>
+#include <SkyboltVis/RenderContext.h>
+#include <SkyboltVis/Scene.h>
+
+#include <osg/Geode>
+#include <osg/Geometry>
+
+#include <chrono>
+#include <iostream>
+
+using namespace skybolt::vis;
+
+class CountingVisObject : public DefaultRootNode
+{
+public:
+	CountingVisObject(UpdatePolicy policy) :
+		mPolicy(policy)
+	{
+		osg::ref_ptr<osg::Vec3Array> vertices = new osg::Vec3Array;
+		vertices->push_back(osg::Vec3(-1, 0, 0));
+		vertices->push_back(osg::Vec3(1, 0, 0));
+		vertices->push_back(osg::Vec3(0, 1, 0));
+
+		osg::ref_ptr<osg::Geometry> geometry = new osg::Geometry;
+		geometry->setVertexArray(vertices);
+		geometry->addPrimitiveSet(new osg::DrawArrays(GL_TRIANGLES, 0, 3));
+
+		osg::ref_ptr<osg::Geode> geode = new osg::Geode;
+		geode->addDrawable(geometry);
+		mTransform->addChild(geode);
+	}
+
+	UpdatePolicy getUpdatePolicy() const override { return mPolicy; }
+
+	void updatePreRender(const CameraRenderContext& context) override { ++updateCount; }
+
+	int updateCount = 0;
+
+private:
+	UpdatePolicy mPolicy;
+};
+
+static std::shared_ptr<CountingVisObject> createObject(Scene& scene, VisObject::UpdatePolicy policy, const osg::Vec3d& position)
+{
+	auto object = std::make_shared<CountingVisObject>(policy);
+	object->setPosition(position);
+	scene.addObject(object);
+	return object;
+}
+
+static Camera createCamera()
+{
+	Camera camera(1.0f);
+	camera.setFarClipDistance(1000.f);
+	return camera;
+}
+
+static void updateScene(Scene& scene, const Camera& camera)
+{
+	CameraRenderContext context(camera);
+	context.atmosphericDensity = 0;
+	scene.updatePreRender(context);
+}
+
+// Camera looks along the +X axis
+static const osg::Vec3d inViewPosition(100, 0, 0);
+static const osg::Vec3d behindCameraPosition(-100, 0, 0);
+static const osg::Vec3d beyondFarClipPosition(10000, 0, 0);
+
+TEST_CASE("Scene only updates objects in view when update policy is WhenInView")
+{
+	Scene scene(new osg::StateSet);
+	Camera camera = createCamera();
+
+	auto inView = createObject(scene, VisObject::UpdatePolicy::WhenInView, inViewPosition);
+	auto behindCamera = createObject(scene, VisObject::UpdatePolicy::WhenInView, behindCameraPosition);
+	auto beyondFarClip = createObject(scene, VisObject::UpdatePolicy::WhenInView, beyondFarClipPosition);
+	auto hidden = createObject(scene, VisObject::UpdatePolicy::WhenInView, inViewPosition);
+	hidden->setVisible(false);
+
+	updateScene(scene, camera);
+
+	CHECK(inView->updateCount == 1);
+	CHECK(behindCamera->updateCount == 0);
+	CHECK(beyondFarClip->updateCount == 0);
+	CHECK(hidden->updateCount == 0);
+
+	const SceneUpdateStats& stats = scene.getUpdateStats();
+	CHECK(stats.objectCount == 4);
+	CHECK(stats.updatedObjectCount == 1);
+	CHECK(stats.culledObjectCount == 3);
+
+	// Turn the camera around
+	camera.setOrientation(osg::Quat(osg::PI, osg::Vec3d(0, 0, 1)));
+	updateScene(scene, camera);
+
+	CHECK(inView->updateCount == 1);
+	CHECK(behindCamera->updateCount == 1);
+}
+
+TEST_CASE("Scene updates objects according to update policy")
+{
+	Scene scene(new osg::StateSet);
+	Camera camera = createCamera();
+
+	auto never = createObject(scene, VisObject::UpdatePolicy::Never, inViewPosition);
+	auto always = createObject(scene, VisObject::UpdatePolicy::Always, behindCameraPosition);
+
+	updateScene(scene, camera);
+
+	CHECK(never->updateCount == 0);
+	CHECK(always->updateCount == 1);
+	CHECK(scene.getUpdateStats().updatedObjectCount == 1);
+	CHECK(scene.getUpdateStats().culledObjectCount == 0);
+}
+
+TEST_CASE("Objects removed from Scene are no longer updated")
+{
+	Scene scene(new osg::StateSet);
+	Camera camera = createCamera();
+
+	auto a = createObject(scene, VisObject::UpdatePolicy::Always, inViewPosition);
+	auto b = createObject(scene, VisObject::UpdatePolicy::Always, inViewPosition);
+	auto c = createObject(scene, VisObject::UpdatePolicy::Always, inViewPosition);
+
+	scene.removeObject(a);
+	updateScene(scene, camera);
+
+	CHECK(a->updateCount == 0);
+	CHECK(b->updateCount == 1);
+	CHECK(c->updateCount == 1);
+	CHECK(scene.getUpdateStats().objectCount == 2);
+	CHECK(scene.getBucketGroup(Scene::Bucket::Default)->getNumChildren() == 2);
+}
+
+TEST_CASE("Benchmark Scene::updatePreRender with mostly out of view objects", "[.benchmark]")
+{
+	Scene scene(new osg::StateSet);
+	Camera camera = createCamera();
+
+	const int objectCount = 10000;
+	std::vector<std::shared_ptr<CountingVisObject>> objects;
+	for (int i = 0; i < objectCount; ++i)
+	{
+		// One in ten objects in front of the camera
+		osg::Vec3d position = (i % 10 == 0) ? inViewPosition : behindCameraPosition;
+		objects.push_back(createObject(scene, VisObject::UpdatePolicy::WhenInView, position));
+	}
+
+	const int frameCount = 100;
+	auto start = std::chrono::steady_clock::now();
+	for (int i = 0; i < frameCount; ++i)
+	{
+		updateScene(scene, camera);
+	}
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	CHECK(scene.getUpdateStats().updatedObjectCount == objectCount / 10);
+	std::cout << "Scene::updatePreRender with " << objectCount << " objects: "
+		<< seconds * 1000.0 / frameCount << " ms per frame" << std::endl;
+}
@@ -0,0 +1,278 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include <catch2/catch.hpp>
+#include "../Helpers/TestTileServer.h"
+#include <SkyboltVis/Renderable/Planet/Tile/TileSource/HttpTileFetcher.h>
+#include <SkyboltVis/Renderable/Planet/Tile/TileSource/XyzTileSource.h>
+
+#include <httplib/httplib.h>
+#include <osg/Image>
+#include <osgDB/Registry>
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <sstream>
+#include <thread>
+
+using namespace skybolt;
+using namespace skybolt::vis;
+
+namespace {
+
+HttpTileFetcherConfig createFastRetryConfig()
+{
+	HttpTileFetcherConfig config;
+	config.initialRetryDelay = 0.01;
+	return config;
+}
+
+void sleepSeconds(double seconds)
+{
+	std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+}
+
+} // namespace
+
+TEST_CASE("HttpTileFetcher fetches responses over pooled connections")
+{
+	TestTileServer tileServer;
+	tileServer.server.Get("/tile", [] (const httplib::Request&, httplib::Response& res) {
+		res.set_content("tileData", "image/png");
+	});
+
+	HttpTileFetcher fetcher(createFastRetryConfig());
+	for (int i = 0; i < 10; ++i)
+	{
+		HttpTileResponsePtr response = fetcher.fetch(tileServer.getUrl("/tile"));
+		REQUIRE(response);
+		CHECK(response->body == "tileData");
+		CHECK(response->contentType == "image/png");
+	}
+
+	HttpTileFetcherStats stats = fetcher.getStats();
+	CHECK(stats.requestCount == 10);
+	CHECK(stats.attemptCount == 10);
+	CHECK(stats.connectionCount == 1);
+	CHECK(stats.bytesReceived == 80);
+}
+
+TEST_CASE("HttpTileFetcher retries transient failures only")
+{
+	TestTileServer tileServer;
+	std::atomic<int> flakyRequestCount = 0;
+	tileServer.server.Get("/flaky", [&] (const httplib::Request&, httplib::Response& res) {
+		if (++flakyRequestCount < 3)
+		{
+			res.status = 503;
+			return;
+		}
+		res.set_content("tileData", "image/png");
+	});
+
+	std::atomic<int> missingRequestCount = 0;
+	tileServer.server.Get("/missing", [&] (const httplib::Request&, httplib::Response& res) {
+		++missingRequestCount;
+		res.status = 404;
+	});
+
+	HttpTileFetcher fetcher(createFastRetryConfig());
+	HttpTileResponsePtr response = fetcher.fetch(tileServer.getUrl("/flaky"));
+	REQUIRE(response);
+	CHECK(response->body == "tileData");
+	CHECK(flakyRequestCount == 3);
+	CHECK(fetcher.getStats().retryCount == 2);
+
+	CHECK(!fetcher.fetch(tileServer.getUrl("/missing")));
+	CHECK(missingRequestCount == 1);
+	CHECK(fetcher.getStats().failureCount == 1);
+}
+
+TEST_CASE("HttpTileFetcher coalesces concurrent requests for the same URL")
+{
+	TestTileServer tileServer;
+	std::atomic<int> requestCount = 0;
+	std::atomic<bool> released = false;
+	tileServer.server.Get("/tile", [&] (const httplib::Request&, httplib::Response& res) {
+		++requestCount;
+		while (!released)
+		{
+			sleepSeconds(0.001);
+		}
+		res.set_content("tileData", "image/png");
+	});
+
+	HttpTileFetcher fetcher(createFastRetryConfig());
+
+	const int threadCount = 8;
+	std::vector<HttpTileResponsePtr> responses(threadCount);
+	std::vector<std::thread> threads;
+	for (int i = 0; i < threadCount; ++i)
+	{
+		threads.emplace_back([&, i] {
+			responses[i] = fetcher.fetch(tileServer.getUrl("/tile"));
+		});
+	}
+
+	while (fetcher.getStats().requestCount < threadCount)
+	{
+		sleepSeconds(0.001);
+	}
+	released = true;
+
+	for (std::thread& thread : threads)
+	{
+		thread.join();
+	}
+
+	CHECK(requestCount == 1);
+	CHECK(fetcher.getStats().coalescedCount == threadCount - 1);
+	for (const HttpTileResponsePtr& response : responses)
+	{
+		REQUIRE(response);
+		CHECK(response == responses.front());
+	}
+}
+
+TEST_CASE("HttpTileFetcher abandons shared request only when all callers cancel")
+{
+	TestTileServer tileServer;
+	std::atomic<bool> released = false;
+	tileServer.server.Get("/tile", [&] (const httplib::Request&, httplib::Response& res) {
+		while (!released)
+		{
+			sleepSeconds(0.001);
+		}
+		res.set_content("tileData", "image/png");
+	});
+
+	HttpTileFetcher fetcher(createFastRetryConfig());
+
+	std::atomic<bool> leaderCancelled = false;
+	HttpTileResponsePtr leaderResponse;
+	std::thread leader([&] {
+		leaderResponse = fetcher.fetch(tileServer.getUrl("/tile"), [&] { return bool(leaderCancelled); });
+	});
+
+	while (fetcher.getStats().requestCount < 1)
+	{
+		sleepSeconds(0.001);
+	}
+
+	std::atomic<bool> followerCancelled = false;
+	HttpTileResponsePtr followerResponse;
+	std::thread follower([&] {
+		followerResponse = fetcher.fetch(tileServer.getUrl("/tile"), [&] { return bool(followerCancelled); });
+	});
+
+	while (fetcher.getStats().coalescedCount < 1)
+	{
+		sleepSeconds(0.001);
+	}
+
+	// The follower still needs the response, so the request continues
+	leaderCancelled = true;
+	sleepSeconds(0.05);
+	released = true;
+
+	follower.join();
+	leader.join();
+	REQUIRE(followerResponse);
+	CHECK(followerResponse->body == "tileData");
+
+	// A request with no remaining callers is abandoned
+	released = false;
+	followerCancelled = true;
+	auto start = std::chrono::steady_clock::now();
+	CHECK(!fetcher.fetch(tileServer.getUrl("/tile"), [] { return true; }));
+	CHECK(std::chrono::steady_clock::now() - start < std::chrono::seconds(5));
+	released = true;
+}
+
+TEST_CASE("XYZ tile source fetches and decodes images with HttpTileFetcher")
+{
+	std::string pngData;
+	{
+		osg::ref_ptr<osg::Image> image = new osg::Image();
+		image->allocateImage(2, 2, 1, GL_RGBA, GL_UNSIGNED_BYTE);
+		std::ostringstream stream;
+		osgDB::Registry::instance()->getReaderWriterForExtension("png")->writeImage(*image, stream);
+		pngData = stream.str();
+	}
+
+	TestTileServer tileServer;
+	tileServer.server.Get(R"(/tiles/(\d+)/(\d+)/(\d+))", [&] (const httplib::Request&, httplib::Response& res) {
+		res.set_content(pngData, "image/png");
+	});
+
+	XyzTileSourceConfig config;
+	config.urlTemplate = tileServer.getUrl("/tiles/{z}/{x}/{y}");
+	config.levelRange = IntRangeInclusive(0, 2);
+	config.httpTileFetcher = std::make_shared<HttpTileFetcher>();
+	XyzTileSource source(config);
+
+	osg::ref_ptr<osg::Image> image = source.createImage(QuadTreeTileKey(2, 1, 3), [] { return false; });
+	REQUIRE(image);
+	CHECK(image->s() == 2);
+	CHECK(image->t() == 2);
+}
+
+TEST_CASE("Benchmark HttpTileFetcher throughput against high latency server", "[.benchmark]")
+{
+	const double latency = 0.02;
+	const std::string tileData(20000, 'x');
+
+	TestTileServer tileServer;
+	tileServer.server.Get(R"(/tiles/(\d+))", [&] (const httplib::Request&, httplib::Response& res) {
+		sleepSeconds(latency);
+		res.set_content(tileData, "image/png");
+	});
+
+	const int tileCount = 256;
+	const int threadCount = 32;
+
+	// Serial fetching with a new connection per tile, approximating per-request loading through osgDB
+	{
+		auto start = std::chrono::steady_clock::now();
+		for (int i = 0; i < tileCount; ++i)
+		{
+			httplib::Client client(tileServer.getUrl(""));
+			client.Get(("/tiles/" + std::to_string(i)).c_str());
+		}
+		double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		std::cout << "Serial fetch: " << tileCount / seconds << " tiles per second" << std::endl;
+	}
+
+	for (int maxConcurrentRequests : {1, 6, 16})
+	{
+		HttpTileFetcherConfig config;
+		config.maxConcurrentRequests = maxConcurrentRequests;
+		config.maxConnectionsPerHost = maxConcurrentRequests;
+		HttpTileFetcher fetcher(config);
+
+		std::atomic<int> nextTile = 0;
+		auto start = std::chrono::steady_clock::now();
+		std::vector<std::thread> threads;
+		for (int i = 0; i < threadCount; ++i)
+		{
+			threads.emplace_back([&] {
+				for (int tile = nextTile++; tile < tileCount; tile = nextTile++)
+				{
+					fetcher.fetch(tileServer.getUrl("/tiles/" + std::to_string(tile)));
+				}
+			});
+		}
+		for (std::thread& thread : threads)
+		{
+			thread.join();
+		}
+		double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+		std::cout << "HttpTileFetcher with " << maxConcurrentRequests << " concurrent requests: " << tileCount / seconds
+			<< " tiles per second, " << fetcher.getStats().connectionCount << " connections" << std::endl;
+	}
+}
@@ -0,0 +1,188 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include <catch2/catch.hpp>
+#include <SkyboltVis/Renderable/Planet/Tile/TileSource/SphericalMercatorToPlateCarreeTileSource.h>
+
+#include <osg/Image>
+#include <osg/Vec4ub>
+#include <px_sched/px_sched.h>
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+using namespace skybolt;
+using namespace skybolt::vis;
+
+namespace {
+
+//! Creates Spherical Mercator tiles with either a constant color identifying the tile,
+//! or a horizontal gradient where the red channel equals the pixel column.
+class TestMercatorTileSource : public TileSource
+{
+public:
+	osg::ref_ptr<osg::Image> createImage(const QuadTreeTileKey& key, std::function<bool()> cancelSupplier) const override
+	{
+		++createdImageCount;
+		if (latency > 0)
+		{
+			std::this_thread::sleep_for(std::chrono::duration<double>(latency));
+		}
+
+		osg::ref_ptr<osg::Image> image = new osg::Image();
+		image->allocateImage(256, 256, 1, GL_RGBA, GL_UNSIGNED_BYTE);
+		unsigned char* p = image->data();
+		for (int y = 0; y < 256; ++y)
+		{
+			for (int x = 0; x < 256; ++x)
+			{
+				*p++ = gradient ? x : getTileColorValue(key.x);
+				*p++ = getTileColorValue(key.y);
+				*p++ = 0;
+				*p++ = 255;
+			}
+		}
+		return image;
+	}
+
+	bool hasAnyChildren(const QuadTreeTileKey& key) const override { return true; }
+	std::optional<QuadTreeTileKey> getHighestAvailableLevel(const QuadTreeTileKey& key) const override { return key; }
+
+	const std::string& getCacheSha() const override
+	{
+		static const std::string s = "test";
+		return s;
+	}
+
+	static int getTileColorValue(int tileIndex) { return 50 + tileIndex * 100; }
+
+	bool gradient = false;
+	double latency = 0;
+	mutable std::atomic<int> createdImageCount = 0;
+};
+
+osg::Vec4ub getPixel(const osg::Image& image, int x, int y)
+{
+	const unsigned char* p = image.data(x, y);
+	return osg::Vec4ub(p[0], p[1], p[2], p[3]);
+}
+
+} // namespace
+
+TEST_CASE("Spherical Mercator tiles are composited into Plate Carree tile")
+{
+	auto source = std::make_shared<TestMercatorTileSource>();
+	SphericalMercatorToPlateCarreeTileSource reprojector(source);
+
+	// Tile covers longitude [-90, 0] and latitude [0, 90] degrees,
+	// intersecting Mercator tiles x=1 and y=[0, 1] at level 2.
+	osg::ref_ptr<osg::Image> image = reprojector.createImage(QuadTreeTileKey(1, 1, 0), [] { return false; });
+	REQUIRE(image);
+	CHECK(image->s() == 256);
+	CHECK(image->t() == 256);
+	CHECK(source->createdImageCount == 2);
+
+	int colorX = TestMercatorTileSource::getTileColorValue(1);
+	int colorY0 = TestMercatorTileSource::getTileColorValue(0);
+	int colorY1 = TestMercatorTileSource::getTileColorValue(1);
+
+	// First image row is the southern edge, which lies in the southern Mercator tile
+	CHECK(getPixel(*image, 0, 0) == osg::Vec4ub(colorX, colorY1, 0, 255));
+	CHECK(getPixel(*image, 255, 255) == osg::Vec4ub(colorX, colorY0, 0, 255));
+}
+
+TEST_CASE("Plate Carree tile columns interpolate Mercator tile columns")
+{
+	auto source = std::make_shared<TestMercatorTileSource>();
+	source->gradient = true;
+	SphericalMercatorToPlateCarreeTileSource reprojector(source);
+
+	// Plate Carree tile columns are offset half a pixel from the Mercator tile columns
+	osg::ref_ptr<osg::Image> image = reprojector.createImage(QuadTreeTileKey(1, 1, 0), [] { return false; });
+	REQUIRE(image);
+	for (int y : {0, 128, 255})
+	{
+		for (int x = 0; x < 255; ++x)
+		{
+			int value = getPixel(*image, x, y).r();
+			CHECK((value == x || value == x + 1));
+		}
+	}
+}
+
+TEST_CASE("Spherical Mercator source tiles are reused from cache")
+{
+	auto source = std::make_shared<TestMercatorTileSource>();
+	QuadTreeTileKey key(1, 1, 0);
+
+	SphericalMercatorToPlateCarreeTileSource reprojector(source);
+	reprojector.createImage(key, [] { return false; });
+	reprojector.createImage(key, [] { return false; });
+	CHECK(source->createdImageCount == 2);
+
+	source->createdImageCount = 0;
+	SphericalMercatorToPlateCarreeTileSource uncachedReprojector(source, /* fetchScheduler */ nullptr, /* sourceTileCacheCapacityBytes */ 0);
+	uncachedReprojector.createImage(key, [] { return false; });
+	uncachedReprojector.createImage(key, [] { return false; });
+	CHECK(source->createdImageCount == 4);
+}
+
+TEST_CASE("Spherical Mercator source tiles are fetched on the fetch scheduler")
+{
+	auto source = std::make_shared<TestMercatorTileSource>();
+	auto scheduler = std::make_shared<px_sched::Scheduler>();
+	scheduler->init();
+
+	SphericalMercatorToPlateCarreeTileSource reprojector(source, scheduler);
+	SphericalMercatorToPlateCarreeTileSource serialReprojector(source);
+
+	QuadTreeTileKey key(1, 1, 0);
+	osg::ref_ptr<osg::Image> image = reprojector.createImage(key, [] { return false; });
+	osg::ref_ptr<osg::Image> expectedImage = serialReprojector.createImage(key, [] { return false; });
+	REQUIRE(image);
+	REQUIRE(expectedImage);
+	CHECK(image->compare(*expectedImage) == 0);
+	CHECK(source->createdImageCount == 4);
+}
+
+TEST_CASE("Benchmark Spherical Mercator to Plate Carree reprojection", "[.benchmark]")
+{
+	// Every tile at level 3, in row order as when paging in a large area of terrain
+	const int level = 3;
+	std::vector<QuadTreeTileKey> keys;
+	for (int y = 0; y < (1 << level); ++y)
+	{
+		for (int x = 0; x < (2 << level); ++x)
+		{
+			keys.push_back(QuadTreeTileKey(level, x, y));
+		}
+	}
+
+	auto scheduler = std::make_shared<px_sched::Scheduler>();
+	scheduler->init();
+
+	for (double latency : {0.0, 0.01})
+	{
+		for (size_t cacheCapacity : {size_t(0), size_t(64 * 1024 * 1024)})
+		{
+			auto source = std::make_shared<TestMercatorTileSource>();
+			source->latency = latency;
+			SphericalMercatorToPlateCarreeTileSource reprojector(source, scheduler, cacheCapacity);
+
+			auto start = std::chrono::steady_clock::now();
+			for (const QuadTreeTileKey& key : keys)
+			{
+				reprojector.createImage(key, [] { return false; });
+			}
+			double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+			std::cout << "Source latency " << latency * 1000.0 << " ms, cache " << (cacheCapacity ? "on" : "off") << ": "
+				<< keys.size() / seconds << " tiles per second, " << source->createdImageCount << " source tiles created" << std::endl;
+		}
+	}
+}
@@ -0,0 +1,163 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include <catch2/catch.hpp>
+#include "../Helpers/TestTileServer.h"
+#include <SkyboltVis/Renderable/Planet/Tile/TileSource/CachedTileSource.h>
+#include <SkyboltVis/Renderable/Planet/Tile/TileSource/HttpTileFetcher.h>
+#include <SkyboltVis/Renderable/Planet/Tile/TileSource/TileCacheSeeder.h>
+#include <SkyboltVis/Renderable/Planet/Tile/TileSource/XyzTileSource.h>
+#include <SkyboltCommon/Math/MathUtility.h>
+
+#include <osg/Image>
+#include <osgDB/Registry>
+
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <set>
+#include <sstream>
+#include <thread>
+
+using namespace skybolt;
+using namespace skybolt::vis;
+
+namespace fs = std::filesystem;
+
+namespace {
+
+sim::LatLon latLonDegrees(double lat, double lon)
+{
+	return sim::LatLon(lat * math::degToRadD(), lon * math::degToRadD());
+}
+
+//! Square from -10 to 10 degrees latitude and longitude, which intersects 2 tiles at level 0 and 4 tiles at levels 1 and 2
+LatLonPolygon createSquareRegion()
+{
+	return { latLonDegrees(-10, -10), latLonDegrees(10, -10), latLonDegrees(10, 10), latLonDegrees(-10, 10) };
+}
+
+std::shared_ptr<XyzTileSource> createXyzTileSource(const std::string& urlTemplate, const IntRangeInclusive& levelRange)
+{
+	XyzTileSourceConfig config;
+	config.urlTemplate = urlTemplate;
+	config.levelRange = levelRange;
+	config.httpTileFetcher = std::make_shared<HttpTileFetcher>();
+	return std::make_shared<XyzTileSource>(config);
+}
+
+std::string createPngData()
+{
+	osg::ref_ptr<osg::Image> image = new osg::Image();
+	image->allocateImage(4, 4, 1, GL_RGBA, GL_UNSIGNED_BYTE);
+	std::ostringstream stream;
+	osgDB::Registry::instance()->getReaderWriterForExtension("png")->writeImage(*image, stream);
+	return stream.str();
+}
+
+int countFilesWithSubstring(const fs::path& directory, const std::string& substring)
+{
+	int count = 0;
+	for (const fs::directory_entry& entry : fs::recursive_directory_iterator(directory))
+	{
+		if (entry.is_regular_file() && entry.path().filename().string().find(substring) != std::string::npos)
+		{
+			++count;
+		}
+	}
+	return count;
+}
+
+} // namespace
+
+TEST_CASE("Tile keys are found for tiles intersecting region")
+{
+	std::shared_ptr<XyzTileSource> source = createXyzTileSource("unused", IntRangeInclusive(0, 3));
+
+	SECTION("Keys are ordered by level")
+	{
+		std::vector<QuadTreeTileKey> keys = getTileKeysInRegion(*source, createSquareRegion(), IntRangeInclusive(0, 2));
+		REQUIRE(keys.size() == 10);
+		CHECK(std::is_sorted(keys.begin(), keys.end(), [] (const QuadTreeTileKey& a, const QuadTreeTileKey& b) {
+			return a.level < b.level;
+		}));
+	}
+
+	SECTION("Tiles within the region's bounding box but outside the region are excluded")
+	{
+		// Triangle whose hypotenuse passes to the south west of the level 3 tile spanning 22.5 to 45 degrees latitude and longitude
+		LatLonPolygon triangle = { latLonDegrees(1, 1), latLonDegrees(40, 1), latLonDegrees(1, 40) };
+		std::vector<QuadTreeTileKey> keys = getTileKeysInRegion(*source, triangle, IntRangeInclusive(3, 3));
+
+		std::set<QuadTreeTileKey> keySet(keys.begin(), keys.end());
+		std::set<QuadTreeTileKey> expectedKeys = { QuadTreeTileKey(3, 8, 3), QuadTreeTileKey(3, 8, 2), QuadTreeTileKey(3, 9, 3) };
+		CHECK(keySet == expectedKeys);
+	}
+
+	SECTION("Tiles are excluded at levels without source data")
+	{
+		std::shared_ptr<XyzTileSource> source = createXyzTileSource("unused", IntRangeInclusive(1, 1));
+		std::vector<QuadTreeTileKey> keys = getTileKeysInRegion(*source, createSquareRegion(), IntRangeInclusive(0, 2));
+		CHECK(keys.size() == 4);
+		for (const QuadTreeTileKey& key : keys)
+		{
+			CHECK(key.level == 1);
+		}
+	}
+}
+
+TEST_CASE("Tile cache is seeded from tile server and resumes after interruption")
+{
+	const std::string pngData = createPngData();
+
+	TestTileServer tileServer;
+	std::atomic<int> requestCount = 0;
+	tileServer.server.Get(R"(/tiles/(\d+)/(\d+)/(\d+))", [&] (const httplib::Request&, httplib::Response& res) {
+		++requestCount;
+		std::this_thread::sleep_for(std::chrono::milliseconds(20)); // Simulate network latency so that seeding can be interrupted part way through
+		res.set_content(pngData, "image/png");
+	});
+
+	fs::path cacheDirectory = fs::temp_directory_path() / "SkyboltTests" / "TileCacheSeeder";
+	fs::remove_all(cacheDirectory);
+
+	auto createCachedSource = [&] {
+		auto source = createXyzTileSource(tileServer.getUrl("/tiles/{z}/{x}/{y}"), IntRangeInclusive(0, 2));
+		return std::make_shared<CachedTileSource>(source, cacheDirectory.string());
+	};
+
+	TileCacheSeederConfig config;
+	config.region = createSquareRegion();
+	config.levelRange = IntRangeInclusive(0, 2);
+	config.threadCount = 2;
+
+	// Interrupt the first run part way through
+	TileCacheSeederStats stats = seedTileCache(*createCachedSource(), config, [&] { return requestCount >= 4; });
+	CHECK(stats.tileCount == 10);
+	CHECK(stats.seededCount < 10);
+	CHECK(stats.failedCount == 0);
+	int64_t firstRunSeededCount = stats.seededCount;
+
+	// Resume
+	int requestCountBeforeResume = requestCount;
+	stats = seedTileCache(*createCachedSource(), config);
+	CHECK(stats.skippedCount == firstRunSeededCount);
+	CHECK(stats.seededCount == 10 - firstRunSeededCount);
+	CHECK(stats.failedCount == 0);
+	CHECK(stats.bytesWritten > 0);
+	CHECK(requestCount - requestCountBeforeResume == stats.seededCount);
+
+	CHECK(countFilesWithSubstring(cacheDirectory, ".png") == 10);
+	CHECK(countFilesWithSubstring(cacheDirectory, ".partial") == 0);
+
+	// Seeding a complete cache makes no requests
+	requestCountBeforeResume = requestCount;
+	stats = seedTileCache(*createCachedSource(), config);
+	CHECK(stats.skippedCount == 10);
+	CHECK(requestCount == requestCountBeforeResume);
+
+	fs::remove_all(cacheDirectory);
+}
@@ -0,0 +1,192 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include <catch2/catch.hpp>
+#include <SkyboltVis/OsgImageHelpers.h>
+#include <SkyboltVis/Renderable/Planet/Tile/TileSource/TileImageDecoder.h>
+#include <SkyboltVis/Renderable/Planet/Tile/HeightMapElevationBounds.h>
+
+#include <osg/Image>
+#include <osgDB/Registry>
+
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+
+using namespace skybolt;
+using namespace skybolt::vis;
+
+namespace {
+
+const int imageSize = 256;
+
+std::string encodePng(const osg::Image& image)
+{
+	std::ostringstream stream;
+	osgDB::Registry::instance()->getReaderWriterForExtension("png")->writeImage(image, stream);
+	return stream.str();
+}
+
+int toTerrainRgbCode(float elevation)
+{
+	return int((elevation + 10000.f) * 10.f + 0.5f);
+}
+
+std::string createColorPng()
+{
+	osg::ref_ptr<osg::Image> image = new osg::Image();
+	image->allocateImage(imageSize, imageSize, 1, GL_RGBA, GL_UNSIGNED_BYTE);
+	unsigned char* p = image->data();
+	for (unsigned int i = 0; i < image->getTotalSizeInBytes(); ++i)
+	{
+		p[i] = (i * 7) % 256;
+	}
+	return encodePng(*image);
+}
+
+//! Creates elevation image with values increasing along each row
+std::string createElevationPng()
+{
+	osg::ref_ptr<osg::Image> image = new osg::Image();
+	image->allocateImage(imageSize, imageSize, 1, GL_LUMINANCE, GL_UNSIGNED_SHORT);
+	uint16_t* p = reinterpret_cast<uint16_t*>(image->data());
+	for (int i = 0; i < imageSize * imageSize; ++i)
+	{
+		p[i] = 1000 + (i % imageSize) * 10;
+	}
+	return encodePng(*image);
+}
+
+//! Creates terrain-RGB image with elevations in range [0, 2550] meters
+std::string createTerrainRgbPng()
+{
+	osg::ref_ptr<osg::Image> image = new osg::Image();
+	image->allocateImage(imageSize, imageSize, 1, GL_RGBA, GL_UNSIGNED_BYTE);
+	unsigned char* p = image->data();
+	for (int i = 0; i < imageSize * imageSize; ++i)
+	{
+		int code = toTerrainRgbCode(float(i % imageSize) * 10.f);
+		*p++ = (code >> 16) & 0xff;
+		*p++ = (code >> 8) & 0xff;
+		*p++ = code & 0xff;
+		*p++ = 255;
+	}
+	return encodePng(*image);
+}
+
+TileImageDecoder createDecoder(TileImageDecoderType type, TileImageEncoding encoding)
+{
+	TileImageDecoderConfig config;
+	config.type = type;
+	config.encoding = encoding;
+	return TileImageDecoder(config);
+}
+
+void checkImagesEqual(const osg::Image& a, const osg::Image& b)
+{
+	REQUIRE(a.s() == b.s());
+	REQUIRE(a.t() == b.t());
+	REQUIRE(a.getPixelFormat() == b.getPixelFormat());
+	REQUIRE(a.getDataType() == b.getDataType());
+	CHECK(std::memcmp(a.data(), b.data(), a.getTotalSizeInBytes()) == 0);
+	CHECK(getHeightMapElevationBounds(a) == getHeightMapElevationBounds(b));
+	CHECK(getHeightMapElevationRerange(a) == getHeightMapElevationRerange(b));
+}
+
+} // namespace
+
+TEST_CASE("Fused and osg tile image decoders produce the same images")
+{
+	std::vector<std::pair<TileImageEncoding, std::string>> images = {
+		{TileImageEncoding::Color, createColorPng()},
+		{TileImageEncoding::Elevation, createElevationPng()},
+		{TileImageEncoding::TerrainRgb, createTerrainRgbPng()}
+	};
+
+	for (const auto& [encoding, data] : images)
+	{
+		osg::ref_ptr<osg::Image> fusedImage = createDecoder(TileImageDecoderType::Fused, encoding).decode(data, "png");
+		osg::ref_ptr<osg::Image> osgImage = createDecoder(TileImageDecoderType::Osg, encoding).decode(data, "png");
+		REQUIRE(fusedImage);
+		REQUIRE(osgImage);
+		checkImagesEqual(*fusedImage, *osgImage);
+	}
+}
+
+TEST_CASE("Elevation tile images are tagged with elevation bounds")
+{
+	TileImageDecoder decoder = createDecoder(TileImageDecoderType::Fused, TileImageEncoding::Elevation);
+	osg::ref_ptr<osg::Image> image = decoder.decode(createElevationPng(), "png");
+	REQUIRE(image);
+	CHECK(isHeightMapDataFormat(*image));
+
+	const HeightMapElevationRerange& rerange = decoder.getConfig().elevationRerange;
+	auto bounds = getHeightMapElevationBounds(*image);
+	REQUIRE(bounds);
+	CHECK(bounds->x() == getElevationForColorValue(rerange, 1000));
+	CHECK(bounds->y() == getElevationForColorValue(rerange, 1000 + (imageSize - 1) * 10));
+
+	// Color images are not valid elevation images
+	CHECK(!decoder.decode(createColorPng(), "png"));
+}
+
+TEST_CASE("Terrain-RGB tile images are converted to height maps")
+{
+	TileImageDecoder decoder = createDecoder(TileImageDecoderType::Fused, TileImageEncoding::TerrainRgb);
+	osg::ref_ptr<osg::Image> image = decoder.decode(createTerrainRgbPng(), "pngraw");
+	REQUIRE(image);
+	CHECK(isHeightMapDataFormat(*image));
+
+	const HeightMapElevationRerange& rerange = decoder.getConfig().elevationRerange;
+	CHECK(getRequiredHeightMapElevationRerange(*image) == rerange);
+
+	auto bounds = getHeightMapElevationBounds(*image);
+	REQUIRE(bounds);
+	CHECK(bounds->x() == Approx(0).margin(0.1));
+	CHECK(bounds->y() == Approx(2550).margin(0.1));
+
+	uint16_t value = reinterpret_cast<const uint16_t*>(image->data(100, 0))[0];
+	CHECK(getElevationForColorValue(rerange, value) == Approx(1000).margin(rerange.x()));
+}
+
+TEST_CASE("Tile image decoder rejects invalid data")
+{
+	for (TileImageDecoderType type : {TileImageDecoderType::Fused, TileImageDecoderType::Osg})
+	{
+		TileImageDecoder decoder = createDecoder(type, TileImageEncoding::Color);
+		CHECK(!decoder.decode("not an image", "png"));
+		CHECK(!decoder.decode(createColorPng().substr(0, 100), "png"));
+	}
+}
+
+TEST_CASE("Benchmark tile image decoding", "[.benchmark]")
+{
+	std::vector<std::tuple<std::string, TileImageEncoding, std::string>> images = {
+		{"Color", TileImageEncoding::Color, createColorPng()},
+		{"Elevation", TileImageEncoding::Elevation, createElevationPng()},
+		{"TerrainRgb", TileImageEncoding::TerrainRgb, createTerrainRgbPng()}
+	};
+
+	const int tileCount = 500;
+	for (const auto& [name, encoding, data] : images)
+	{
+		for (TileImageDecoderType type : {TileImageDecoderType::Osg, TileImageDecoderType::Fused})
+		{
+			TileImageDecoder decoder = createDecoder(type, encoding);
+
+			auto start = std::chrono::steady_clock::now();
+			for (int i = 0; i < tileCount; ++i)
+			{
+				decoder.decode(data, "png");
+			}
+			double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+			std::cout << name << " decode with " << (type == TileImageDecoderType::Fused ? "fused" : "osg") << " decoder: "
+				<< tileCount / seconds << " tiles per second" << std::endl;
+		}
+	}
+}
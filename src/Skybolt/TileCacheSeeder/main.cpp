@@ -0,0 +1,147 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include <SkyboltEngine/EngineCommandLineParser.h>
+#include <SkyboltEngine/EngineRoot.h>
+#include <SkyboltEngine/EngineSettings.h>
+#include <SkyboltVis/Renderable/Planet/Tile/TileSource/CachedTileSource.h>
+#include <SkyboltVis/Renderable/Planet/Tile/TileSource/JsonTileSourceFactory.h>
+#include <SkyboltVis/Renderable/Planet/Tile/TileSource/TileCacheSeeder.h>
+#include <SkyboltCommon/Json/JsonHelpers.h>
+#include <SkyboltCommon/Json/ReadJsonFile.h>
+#include <SkyboltCommon/Math/MathUtility.h>
+
+#include <boost/algorithm/string/classification.hpp>
+#include <boost/algorithm/string/split.hpp>
+
+#include <atomic>
+#include <csignal>
+#include <iomanip>
+#include <iostream>
+
+using namespace skybolt;
+
+namespace po = boost::program_options;
+
+static std::atomic<bool> interrupted = false;
+
+static void onInterrupt(int)
+{
+	interrupted = true;
+}
+
+//! @param str is a list of vertices in the form "lat,lon lat,lon lat,lon ..." in degrees
+static vis::LatLonPolygon parseRegion(const std::string& str)
+{
+	std::vector<std::string> vertices;
+	boost::split(vertices, str, boost::is_any_of(" ;"), boost::token_compress_on);
+
+	vis::LatLonPolygon polygon;
+	for (const std::string& vertex : vertices)
+	{
+		if (vertex.empty())
+		{
+			continue;
+		}
+		std::vector<std::string> components;
+		boost::split(components, vertex, boost::is_any_of(","));
+		if (components.size() != 2)
+		{
+			throw std::runtime_error("Region vertex '" + vertex + "' not in form lat,lon");
+		}
+		polygon.push_back(sim::LatLon(std::stod(components[0]) * math::degToRadD(), std::stod(components[1]) * math::degToRadD()));
+	}
+	return polygon;
+}
+
+static void printStats(const vis::TileCacheSeederStats& stats)
+{
+	std::cout << stats.getProcessedCount() << "/" << stats.tileCount << " tiles processed ("
+		<< stats.seededCount << " seeded, " << stats.skippedCount << " already cached, " << stats.failedCount << " failed), "
+		<< std::fixed << std::setprecision(1) << stats.getSeededTilesPerSecond() << " tiles per second, "
+		<< double(stats.bytesWritten) / (1024.0 * 1024.0) << " MB written" << std::endl;
+}
+
+int main(int argc, char *argv[])
+{
+	try
+	{
+		po::options_description desc("Fetches the tiles of a region and writes them to a tile source's cache, so that they are available offline. "
+			"Tiles already in the cache are skipped, so an interrupted run can be resumed by running again with the same arguments.");
+		EngineCommandLineParser::addOptions(desc);
+		desc.add_options()
+			("tileSource", po::value<std::string>(), "JSON file containing the tile source definition")
+			("tileSourcePointer", po::value<std::string>()->default_value(""), "JSON pointer to the tile source definition within the file, e.g. /components/0/planet/surface/albedo")
+			("region", po::value<std::string>(), "polygon bounding the region to seed, as a list of vertices in degrees, e.g. \"47.0,-122.8 47.9,-122.8 47.9,-121.3 47.0,-121.3\"")
+			("minLevel", po::value<int>()->default_value(0), "minimum tile level to seed")
+			("maxLevel", po::value<int>(), "maximum tile level to seed")
+			("threads", po::value<int>()->default_value(16), "number of tiles to fetch concurrently")
+			("cacheDir", po::value<std::string>(), "cache directory to seed. If not set, the engine's cache directory is used");
+
+		po::variables_map params = EngineCommandLineParser::parse(argc, argv, desc);
+		if (params.count("help"))
+		{
+			std::cout << desc << std::endl;
+			return 0;
+		}
+		if (!params.count("tileSource"))
+		{
+			throw std::runtime_error("tileSource file not specified");
+		}
+		if (!params.count("region"))
+		{
+			throw std::runtime_error("region not specified");
+		}
+		if (!params.count("maxLevel"))
+		{
+			throw std::runtime_error("maxLevel not specified");
+		}
+
+		const nlohmann::json settings = readEngineSettings(params);
+
+		vis::JsonTileSourceFactoryRegistryConfig registryConfig;
+		registryConfig.apiKeys = readNameMap<std::string>(settings, "tileApiKeys");
+		registryConfig.cacheDirectory = params.count("cacheDir") ? params["cacheDir"].as<std::string>() : getCacheDir().string();
+		registryConfig.httpTileFetcher = getHttpTileFetcherConfig(settings);
+		vis::JsonTileSourceFactoryRegistry registry(registryConfig);
+		vis::addDefaultFactories(registry);
+
+		nlohmann::json tileSourceJson = readJsonFile(params["tileSource"].as<std::string>())
+			.at(nlohmann::json::json_pointer(params["tileSourcePointer"].as<std::string>()));
+
+		// Create the tile source with the same cache directory the engine would use for it
+		tileSourceJson["cache"] = true;
+		auto tileSource = std::dynamic_pointer_cast<vis::CachedTileSource>(registry.getFactory(tileSourceJson.at("format"))(tileSourceJson));
+		if (!tileSource)
+		{
+			throw std::runtime_error("Tile source format does not support caching: " + tileSourceJson.at("format").get<std::string>());
+		}
+
+		vis::TileCacheSeederConfig config;
+		config.region = parseRegion(params["region"].as<std::string>());
+		config.levelRange = IntRangeInclusive(params["minLevel"].as<int>(), params["maxLevel"].as<int>());
+		config.threadCount = params["threads"].as<int>();
+		config.progressInterval = 5.0;
+		config.progressCallback = printStats;
+
+		std::cout << "Seeding cache directory '" << registryConfig.cacheDirectory << "'" << std::endl;
+
+		std::signal(SIGINT, onInterrupt);
+		vis::TileCacheSeederStats stats = vis::seedTileCache(*tileSource, config, [] { return bool(interrupted); });
+
+		if (interrupted)
+		{
+			std::cout << "Interrupted. Run again with the same arguments to resume." << std::endl;
+			return 1;
+		}
+		return (stats.failedCount == 0) ? 0 : 1;
+	}
+	catch (const std::exception& e)
+	{
+		std::cerr << e.what() << std::endl;
+		return 1;
+	}
+}
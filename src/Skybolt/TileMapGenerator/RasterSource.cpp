@@ -0,0 +1,277 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "RasterSource.h"
+#include <SkyboltCommon/Exception.h>
+
+#include <assert.h>
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <type_traits>
+#include <vector>
+
+using namespace skybolt;
+
+RasterSource::RasterSource(int width, int height, GLenum pixelFormat, GLenum dataType) :
+	mWidth(width),
+	mHeight(height),
+	mPixelFormat(pixelFormat),
+	mDataType(dataType),
+	mPixelSizeBytes(osg::Image::computePixelSizeInBits(pixelFormat, dataType) / 8)
+{
+	assert(mWidth > 0);
+	assert(mHeight > 0);
+}
+
+int RasterSource::getLevelCount() const
+{
+	int level = 0;
+	while (getLevelWidth(level) > 1 || getLevelHeight(level) > 1)
+	{
+		++level;
+	}
+	return level + 1;
+}
+
+static int divideRoundingUp(int value, int divisor)
+{
+	return (value + divisor - 1) / divisor;
+}
+
+int RasterSource::getLevelWidth(int level) const
+{
+	return divideRoundingUp(mWidth, 1 << level);
+}
+
+int RasterSource::getLevelHeight(int level) const
+{
+	return divideRoundingUp(mHeight, 1 << level);
+}
+
+//! Adds base level pixels to the sums of the output pixels containing them
+//! @param firstColumn is the column of the first source pixel, relative to the first base level column of the output window
+template <typename T>
+static void accumulateRows(const uint8_t* src, int rowCount, int firstColumn, int columnCount, int componentCount, int scale, double* sums, int* counts)
+{
+	const T* values = reinterpret_cast<const T*>(src);
+	for (int row = 0; row < rowCount; ++row)
+	{
+		for (int x = firstColumn; x < firstColumn + columnCount; ++x)
+		{
+			int cell = x / scale;
+			for (int c = 0; c < componentCount; ++c)
+			{
+				sums[cell * componentCount + c] += double(*values++);
+			}
+			++counts[cell];
+		}
+	}
+}
+
+static void accumulateRows(GLenum dataType, const uint8_t* src, int rowCount, int firstColumn, int columnCount, int componentCount, int scale, double* sums, int* counts)
+{
+	switch (dataType)
+	{
+	case GL_UNSIGNED_BYTE:
+		accumulateRows<uint8_t>(src, rowCount, firstColumn, columnCount, componentCount, scale, sums, counts);
+		break;
+	case GL_UNSIGNED_SHORT:
+		accumulateRows<uint16_t>(src, rowCount, firstColumn, columnCount, componentCount, scale, sums, counts);
+		break;
+	case GL_FLOAT:
+		accumulateRows<float>(src, rowCount, firstColumn, columnCount, componentCount, scale, sums, counts);
+		break;
+	default:
+		throw Exception("Unsupported raster data type: " + std::to_string(dataType));
+	}
+}
+
+template <typename T>
+static void writeAverages(const double* sums, const int* counts, int width, int componentCount, uint8_t* dst)
+{
+	T* values = reinterpret_cast<T*>(dst);
+	for (int x = 0; x < width; ++x)
+	{
+		double invCount = 1.0 / std::max(1, counts[x]);
+		for (int c = 0; c < componentCount; ++c)
+		{
+			double average = sums[x * componentCount + c] * invCount;
+			*values++ = std::is_integral_v<T> ? T(average + 0.5) : T(average);
+		}
+	}
+}
+
+static void writeAverages(GLenum dataType, const double* sums, const int* counts, int width, int componentCount, uint8_t* dst)
+{
+	switch (dataType)
+	{
+	case GL_UNSIGNED_BYTE:
+		writeAverages<uint8_t>(sums, counts, width, componentCount, dst);
+		break;
+	case GL_UNSIGNED_SHORT:
+		writeAverages<uint16_t>(sums, counts, width, componentCount, dst);
+		break;
+	case GL_FLOAT:
+		writeAverages<float>(sums, counts, width, componentCount, dst);
+		break;
+	default:
+		throw Exception("Unsupported raster data type: " + std::to_string(dataType));
+	}
+}
+
+//! Maximum number of base level pixels read at once when generating lower resolution levels
+static constexpr int maxBlockPixelCount = 1024 * 1024;
+
+osg::ref_ptr<osg::Image> RasterSource::readWindow(const RasterWindow& window, int level) const
+{
+	assert(window.x >= 0 && window.x + window.width <= getLevelWidth(level));
+	assert(window.y >= 0 && window.y + window.height <= getLevelHeight(level));
+
+	osg::ref_ptr<osg::Image> result = new osg::Image;
+	result->allocateImage(window.width, window.height, 1, mPixelFormat, mDataType);
+
+	std::unique_ptr<BaseRowReader> reader = createBaseRowReader();
+
+	if (level == 0)
+	{
+		reader->readRows(window.y, window.height, window.x, window.width, result->data());
+		return result;
+	}
+
+	// Box filter the base level. The base level region covered by each output row grows with the level,
+	// so it is read in blocks of bounded size and accumulated.
+	const int scale = 1 << level;
+	const int componentCount = osg::Image::computeNumComponents(mPixelFormat);
+	const int baseX = window.x * scale;
+	const int baseWidth = std::min(window.width * scale, mWidth - baseX);
+	const int blockWidth = std::min(baseWidth, maxBlockPixelCount);
+	const int blockHeight = std::clamp(maxBlockPixelCount / blockWidth, 1, scale);
+
+	std::vector<uint8_t> block(size_t(blockWidth) * blockHeight * mPixelSizeBytes);
+	std::vector<double> sums(size_t(window.width) * componentCount);
+	std::vector<int> counts(window.width);
+
+	for (int y = 0; y < window.height; ++y)
+	{
+		const int baseY = (window.y + y) * scale;
+		const int rowCount = std::min(scale, mHeight - baseY);
+
+		std::fill(sums.begin(), sums.end(), 0.0);
+		std::fill(counts.begin(), counts.end(), 0);
+
+		for (int blockY = 0; blockY < rowCount; blockY += blockHeight)
+		{
+			const int blockRowCount = std::min(blockHeight, rowCount - blockY);
+			for (int blockX = 0; blockX < baseWidth; blockX += blockWidth)
+			{
+				const int blockColumnCount = std::min(blockWidth, baseWidth - blockX);
+				reader->readRows(baseY + blockY, blockRowCount, baseX + blockX, blockColumnCount, block.data());
+				accumulateRows(mDataType, block.data(), blockRowCount, blockX, blockColumnCount, componentCount, scale, sums.data(), counts.data());
+			}
+		}
+
+		writeAverages(mDataType, sums.data(), counts.data(), window.width, componentCount, result->data(0, y));
+	}
+	return result;
+}
+
+ImageRasterSource::ImageRasterSource(const osg::ref_ptr<osg::Image>& image) :
+	RasterSource(image->s(), image->t(), image->getPixelFormat(), image->getDataType()),
+	mImage(image)
+{
+}
+
+class ImageRasterSource::RowReader : public BaseRowReader
+{
+public:
+	RowReader(const osg::Image& image, size_t pixelSizeBytes) :
+		mImage(image),
+		mPixelSizeBytes(pixelSizeBytes)
+	{
+	}
+
+	void readRows(int y, int rowCount, int x, int width, uint8_t* dst) override
+	{
+		const size_t rowSizeBytes = size_t(width) * mPixelSizeBytes;
+		for (int row = 0; row < rowCount; ++row)
+		{
+			std::memcpy(dst, mImage.data(x, y + row), rowSizeBytes);
+			dst += rowSizeBytes;
+		}
+	}
+
+private:
+	const osg::Image& mImage;
+	const size_t mPixelSizeBytes;
+};
+
+std::unique_ptr<RasterSource::BaseRowReader> ImageRasterSource::createBaseRowReader() const
+{
+	return std::make_unique<RowReader>(*mImage, getPixelSizeBytes());
+}
+
+RawUInt16FileRasterSource::RawUInt16FileRasterSource(const RawUInt16FileRasterSourceConfig& config) :
+	RasterSource(config.width, config.height, GL_LUMINANCE, GL_UNSIGNED_SHORT),
+	mConfig(config)
+{
+	std::ifstream f(mConfig.filename, std::ios::in | std::ios::binary);
+	if (!f.is_open())
+	{
+		throw Exception("Unable to open file: " + mConfig.filename);
+	}
+}
+
+class RawUInt16FileRasterSource::RowReader : public BaseRowReader
+{
+public:
+	RowReader(const RawUInt16FileRasterSourceConfig& config) :
+		mConfig(config),
+		mFile(config.filename, std::ios::in | std::ios::binary)
+	{
+		if (!mFile.is_open())
+		{
+			throw Exception("Unable to open file: " + mConfig.filename);
+		}
+	}
+
+	void readRows(int y, int rowCount, int x, int width, uint8_t* dst) override
+	{
+		const size_t rowSizeBytes = size_t(width) * sizeof(uint16_t);
+		for (int row = 0; row < rowCount; ++row)
+		{
+			int fileRow = mConfig.flipVertical ? (mConfig.height - 1 - (y + row)) : (y + row);
+			mFile.seekg((std::streamoff(fileRow) * mConfig.width + x) * sizeof(uint16_t));
+			mFile.read(reinterpret_cast<char*>(dst), rowSizeBytes);
+			if (!mFile)
+			{
+				throw Exception("Error reading file: " + mConfig.filename);
+			}
+
+			uint16_t* values = reinterpret_cast<uint16_t*>(dst);
+			for (int i = 0; i < width; ++i)
+			{
+				uint16_t value = values[i];
+				if (mConfig.swapBytes)
+				{
+					value = uint16_t((value << 8) | (value >> 8));
+				}
+				values[i] = uint16_t(value + mConfig.valueOffset);
+			}
+			dst += rowSizeBytes;
+		}
+	}
+
+private:
+	const RawUInt16FileRasterSourceConfig& mConfig;
+	std::ifstream mFile;
+};
+
+std::unique_ptr<RasterSource::BaseRowReader> RawUInt16FileRasterSource::createBaseRowReader() const
+{
+	// Each reader opens its own stream so that windows can be read concurrently
+	return std::make_unique<RowReader>(mConfig);
+}
@@ -0,0 +1,110 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#pragma once
+
+#include <osg/Image>
+#include <memory>
+#include <string>
+
+//! Rectangular region of a raster in pixels
+struct RasterWindow
+{
+	int x;
+	int y;
+	int width;
+	int height;
+};
+
+//! Source of raster data which is read in windows, allowing rasters larger than available memory to be processed.
+//! Lower resolution levels are generated on the fly by box filtering the base level in blocks of bounded size,
+//! so memory use is bounded by the size of the requested window rather than the size of the raster or the level.
+class RasterSource
+{
+public:
+	RasterSource(int width, int height, GLenum pixelFormat, GLenum dataType);
+	virtual ~RasterSource() = default;
+
+	int getWidth() const { return mWidth; }
+	int getHeight() const { return mHeight; }
+	GLenum getPixelFormat() const { return mPixelFormat; }
+	GLenum getDataType() const { return mDataType; }
+
+	//! @returns number of levels, including the base level. Each level halves the resolution of the previous level.
+	int getLevelCount() const;
+	int getLevelWidth(int level) const;
+	int getLevelHeight(int level) const;
+
+	//! Reads a window of the raster at the given level.
+	//! @param window must be within the bounds of the level
+	//! @ThreadSafe
+	osg::ref_ptr<osg::Image> readWindow(const RasterWindow& window, int level) const;
+
+protected:
+	//! Reads rows of the base level. A reader is created for each readWindow() call and used by a single thread,
+	//! so it can hold state shared between reads, e.g. an open file.
+	class BaseRowReader
+	{
+	public:
+		virtual ~BaseRowReader() = default;
+
+		//! Reads base level pixels from rows [y, y + rowCount) and columns [x, x + width) into tightly packed rows in dst
+		virtual void readRows(int y, int rowCount, int x, int width, uint8_t* dst) = 0;
+	};
+
+	//! @ThreadSafe
+	virtual std::unique_ptr<BaseRowReader> createBaseRowReader() const = 0;
+
+	size_t getPixelSizeBytes() const { return mPixelSizeBytes; }
+
+private:
+	const int mWidth;
+	const int mHeight;
+	const GLenum mPixelFormat;
+	const GLenum mDataType;
+	const size_t mPixelSizeBytes;
+};
+
+using RasterSourcePtr = std::shared_ptr<RasterSource>;
+
+//! Raster source backed by an image in memory
+class ImageRasterSource : public RasterSource
+{
+public:
+	ImageRasterSource(const osg::ref_ptr<osg::Image>& image);
+
+protected:
+	std::unique_ptr<BaseRowReader> createBaseRowReader() const override;
+
+private:
+	class RowReader;
+	const osg::ref_ptr<osg::Image> mImage;
+};
+
+struct RawUInt16FileRasterSourceConfig
+{
+	std::string filename;
+	int width;
+	int height;
+	bool flipVertical = false; //!< If true, the first row in the file is the last row of the raster
+	bool swapBytes = false; //!< If true, converts values between big and little endian
+	uint16_t valueOffset = 0; //!< Value added to every element
+};
+
+//! Raster source which streams single channel 16 bit pixels from a headerless file, e.g. GLOBE elevation data.
+//! Only the rows required by each window are read from disk.
+class RawUInt16FileRasterSource : public RasterSource
+{
+public:
+	RawUInt16FileRasterSource(const RawUInt16FileRasterSourceConfig& config);
+
+protected:
+	std::unique_ptr<BaseRowReader> createBaseRowReader() const override;
+
+private:
+	class RowReader;
+	const RawUInt16FileRasterSourceConfig mConfig;
+};
@@ -0,0 +1,105 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <type_traits>
+#include <vector>
+
+//! Horizontal sampling positions for a span of destination pixels, shared by every row of the span.
+//! Precomputing these keeps the inner loops free of divisions and branches so that the compiler can vectorize them.
+struct ResampleColumns
+{
+	std::vector<int> x0; //!< Left source column of each destination pixel
+	std::vector<int> x1; //!< Right source column of each destination pixel
+	std::vector<float> fraction; //!< Weight of x1 relative to x0
+};
+
+//! @param srcWidth is the width of the source level in pixels
+//! @param srcX0 is the source coordinate of the first destination pixel, in pixels
+//! @param srcDx is the change in source coordinate per destination pixel
+inline ResampleColumns calcNearestColumns(int srcWidth, double srcX0, double srcDx, int count)
+{
+	ResampleColumns columns;
+	columns.x0.resize(count);
+	for (int i = 0; i < count; ++i)
+	{
+		columns.x0[i] = std::clamp(int((srcX0 + srcDx * i) * double(srcWidth - 1) / double(srcWidth)), 0, srcWidth - 1);
+	}
+	return columns;
+}
+
+inline ResampleColumns calcBilinearColumns(int srcWidth, double srcX0, double srcDx, int count)
+{
+	ResampleColumns columns;
+	columns.x0.resize(count);
+	columns.x1.resize(count);
+	columns.fraction.resize(count);
+	for (int i = 0; i < count; ++i)
+	{
+		double x = std::clamp(srcX0 + srcDx * i, 0.0, double(srcWidth - 1));
+		int x0 = int(x);
+		columns.x0[i] = x0;
+		columns.x1[i] = std::min(x0 + 1, srcWidth - 1);
+		columns.fraction[i] = float(x - x0);
+	}
+	return columns;
+}
+
+//! Makes columns relative to a window of the source starting at column windowX
+inline void offsetColumns(ResampleColumns& columns, int windowX)
+{
+	for (int& x : columns.x0) { x -= windowX; }
+	for (int& x : columns.x1) { x -= windowX; }
+}
+
+template <typename T, int ComponentCount>
+void resampleRowNearest(const T* srcRow, const ResampleColumns& columns, T* dst)
+{
+	const int count = int(columns.x0.size());
+	for (int i = 0; i < count; ++i)
+	{
+		const T* src = srcRow + columns.x0[i] * ComponentCount;
+		for (int c = 0; c < ComponentCount; ++c)
+		{
+			dst[i * ComponentCount + c] = src[c];
+		}
+	}
+}
+
+template <typename T>
+inline T fromFloat(float value)
+{
+	if constexpr (std::is_integral_v<T>)
+	{
+		return T(value + 0.5f);
+	}
+	else
+	{
+		return T(value);
+	}
+}
+
+//! @param fractionY is the weight of srcRow1 relative to srcRow0
+template <typename T, int ComponentCount>
+void resampleRowBilinear(const T* srcRow0, const T* srcRow1, float fractionY, const ResampleColumns& columns, T* dst)
+{
+	const int count = int(columns.x0.size());
+	for (int i = 0; i < count; ++i)
+	{
+		const int x0 = columns.x0[i] * ComponentCount;
+		const int x1 = columns.x1[i] * ComponentCount;
+		const float fx = columns.fraction[i];
+		for (int c = 0; c < ComponentCount; ++c)
+		{
+			float top = float(srcRow0[x0 + c]) + (float(srcRow0[x1 + c]) - float(srcRow0[x0 + c])) * fx;
+			float bottom = float(srcRow1[x0 + c]) + (float(srcRow1[x1 + c]) - float(srcRow1[x0 + c])) * fx;
+			dst[i * ComponentCount + c] = fromFloat<T>(top + (bottom - top) * fractionY);
+		}
+	}
+}
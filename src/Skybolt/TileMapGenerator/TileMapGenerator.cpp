@@ -5,13 +5,15 @@
  * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
 
 #include "TileMapGenerator.h"
+#include "ResampleKernels.h"
 #include <SkyboltVis/OsgImageHelpers.h>
 #include <SkyboltVis/OsgMathHelpers.h>
 #include <SkyboltCommon/Exception.h>
 #include <SkyboltCommon/Math/MathUtility.h>
 #include <SkyboltCommon/Math/QuadTree.h>
 
-#include <osgDB/WriteFile>
+#include <chrono>
+#include <cstring>
 #include <filesystem>
 #include <boost/noncopyable.hpp>
 
@@ -21,30 +23,96 @@
 using namespace skybolt;
 using namespace vis;
 
-static osg::Vec4f sampleImage(const osg::Image& image, const osg::Vec2d& point, Filtering filtering)
+//! @returns range [begin, end) of pixels that overlap the interval [min, max]
+static std::pair<int, int> calcPixelSpan(double min, double max, double tileMin, double pixelSize, int pixelCount)
 {
-	switch (filtering)
+	int begin = std::clamp(int(std::floor((min - tileMin) / pixelSize)), 0, pixelCount);
+	int end = std::clamp(int(std::ceil((max - tileMin) / pixelSize)), 0, pixelCount);
+	return { begin, end };
+}
+
+template <typename T, int ComponentCount>
+static void resampleWindow(const osg::Image& src, const ResampleColumns& columns, const ResampleColumns& rows, Filtering filtering, osg::Image& dst, int dstX, int dstY)
+{
+	for (int r = 0; r < int(rows.x0.size()); ++r)
 	{
-	case Filtering::NearestNeighbor:
-		return image.getColor(point);
-		break;
-	case Filtering::Bilinear:
-		return vis::getColorBilinear(image, osg::Vec2f(point.x() * image.s(), point.y() * image.t()));
-		break;
-	default:
-		assert(!"Not implemented");
+		T* dstRow = reinterpret_cast<T*>(dst.data(dstX, dstY + r));
+		const T* srcRow0 = reinterpret_cast<const T*>(src.data(0, rows.x0[r]));
+		if (filtering == Filtering::NearestNeighbor)
+		{
+			resampleRowNearest<T, ComponentCount>(srcRow0, columns, dstRow);
+		}
+		else
+		{
+			const T* srcRow1 = reinterpret_cast<const T*>(src.data(0, rows.x1[r]));
+			resampleRowBilinear<T, ComponentCount>(srcRow0, srcRow1, rows.fraction[r], columns, dstRow);
+		}
+	}
+}
+
+template <typename T>
+static bool resampleWindow(int componentCount, const osg::Image& src, const ResampleColumns& columns, const ResampleColumns& rows, Filtering filtering, osg::Image& dst, int dstX, int dstY)
+{
+	switch (componentCount)
+	{
+	case 1: resampleWindow<T, 1>(src, columns, rows, filtering, dst, dstX, dstY); return true;
+	case 2: resampleWindow<T, 2>(src, columns, rows, filtering, dst, dstX, dstY); return true;
+	case 3: resampleWindow<T, 3>(src, columns, rows, filtering, dst, dstX, dstY); return true;
+	case 4: resampleWindow<T, 4>(src, columns, rows, filtering, dst, dstX, dstY); return true;
+	}
+	return false;
+}
+
+//! Resamples with row kernels operating directly on the pixel data.
+//! @returns false if the image formats are not supported by the row kernels
+static bool resampleWindowFast(const osg::Image& src, const ResampleColumns& columns, const ResampleColumns& rows, Filtering filtering, osg::Image& dst, int dstX, int dstY)
+{
+	if (src.getPixelFormat() != dst.getPixelFormat() || src.getDataType() != dst.getDataType())
+	{
+		return false;
+	}
+
+	int componentCount = osg::Image::computeNumComponents(src.getPixelFormat());
+	switch (src.getDataType())
+	{
+	case GL_UNSIGNED_BYTE: return resampleWindow<uint8_t>(componentCount, src, columns, rows, filtering, dst, dstX, dstY);
+	case GL_UNSIGNED_SHORT: return resampleWindow<uint16_t>(componentCount, src, columns, rows, filtering, dst, dstX, dstY);
+	case GL_FLOAT: return resampleWindow<float>(componentCount, src, columns, rows, filtering, dst, dstX, dstY);
+	}
+	return false;
+}
+
+//! Resamples with per pixel format conversion. Used when the source and destination formats differ.
+static void resampleWindowGeneric(const osg::Image& src, const ResampleColumns& columns, const ResampleColumns& rows, Filtering filtering, osg::Image& dst, int dstX, int dstY)
+{
+	for (int r = 0; r < int(rows.x0.size()); ++r)
+	{
+		for (int i = 0; i < int(columns.x0.size()); ++i)
+		{
+			osg::Vec4f c;
+			if (filtering == Filtering::NearestNeighbor)
+			{
+				c = src.getColor(columns.x0[i], rows.x0[r]);
+			}
+			else
+			{
+				osg::Vec4f fx(columns.fraction[i], columns.fraction[i], columns.fraction[i], columns.fraction[i]);
+				osg::Vec4f c0 = math::componentWiseLerp(src.getColor(columns.x0[i], rows.x0[r]), src.getColor(columns.x1[i], rows.x0[r]), fx);
+				osg::Vec4f c1 = math::componentWiseLerp(src.getColor(columns.x0[i], rows.x1[r]), src.getColor(columns.x1[i], rows.x1[r]), fx);
+				c = math::componentWiseLerp(c0, c1, osg::Vec4f(rows.fraction[r], rows.fraction[r], rows.fraction[r], rows.fraction[r]));
+			}
+			dst.setColor(c, dstX + i, dstY + r);
+		}
 	}
-	return osg::Vec4f();
 }
 
 struct TileGeneratorConfig
 {
 	std::unique_ptr<px_sched::Scheduler> scheduler;
-	std::string outputDirectory;
+	TileWriter* writer;
 	osg::Vec2i tileDimensions;
 	std::vector<TileMapGeneratorLayer> layers;
 	Filtering filtering;
-	std::string extension;
 	double mipmapBias = 0; // Higher numbers blur the image, lower numbers sharpen, 0 is neutral.
 };
 
@@ -52,37 +120,42 @@ struct TileGenerator : public boost::noncopyable
 {
 	TileGenerator(TileGeneratorConfig config) :
 		mScheduler(std::move(config.scheduler)),
-		mOutputDirectory(std::move(config.outputDirectory)),
+		mWriter(config.writer),
 		mTileDimensions(std::move(config.tileDimensions)),
 		mLayers(std::move(config.layers)),
 		mFiltering(std::move(config.filtering)),
-		mExtension(std::move(config.extension)),
-		mMipmapBias(config.mipmapBias)
+		mMipmapBias(config.mipmapBias),
+		mMaxQueuedTasks(2 * mScheduler->params().num_threads)
 	{
-		printf("Generating mipmaps...\n");
+		assert(mWriter);
 		for (const TileMapGeneratorLayer& layer : mLayers)
 		{
-			mLayerResolutions.push_back(std::max(layer.image->s() / layer.bounds.size().x(), layer.image->t() / layer.bounds.size().y()));
-			mLayerImageMipmaps.push_back(generateMipmaps(layer.image));
+			mLayerResolutions.push_back(std::max(layer.source->getWidth() / layer.bounds.size().x(), layer.source->getHeight() / layer.bounds.size().y()));
 		}
 	}
 
 	~TileGenerator()
+	{
+		waitForCompletion();
+	}
+
+	void waitForCompletion()
 	{
 		mScheduler->waitFor(mLoadingTaskSync);
 	}
 
 	bool operator()(const DefaultTile<osg::Vec2d>& tile) const
 	{
-		if (mScheduler->num_tasks() > mScheduler->params().num_threads)
+		// Bound the number of queued tiles so that memory use does not grow with the size of the tree
+		if (mScheduler->num_tasks() < mMaxQueuedTasks)
 		{
 			mScheduler->run([this, bounds = tile.bounds, key = tile.key]() {
-				generateImage(bounds, key);
+				generateImageAndReportErrors(bounds, key);
 			}, &mLoadingTaskSync);
 		}
 		else // else all background threads are in use. Perform task on current thread.
 		{
-			generateImage(tile.bounds, tile.key);
+			generateImageAndReportErrors(tile.bounds, tile.key);
 		}
 
 		// Find find the highest resolution of the layers that interesect the tile
@@ -101,117 +174,119 @@ struct TileGenerator : public boost::noncopyable
 		return (maxSrcResolution > outputResolution);
 	}
 
+	size_t getTilesWrittenCount() const { return mFilesWrittenCount; }
+
+private:
+	void generateImageAndReportErrors(const vis::Box2d& tileBounds, const QuadTreeTileKey& tileKey) const
+	{
+		try
+		{
+			generateImage(tileBounds, tileKey);
+		}
+		catch (const std::exception& e)
+		{
+			printf("Error generating tile %i/%i/%i: %s\n", tileKey.level, tileKey.x, tileKey.y, e.what());
+		}
+	}
+
 	// @ThreadSafe
 	void generateImage(const vis::Box2d& tileBounds, const QuadTreeTileKey& tileKey) const
 	{
-		osg::Image* srcImage = mLayers.back().image;
+		const RasterSource& outputFormat = *mLayers.back().source;
 
 		osg::ref_ptr<osg::Image> image = new osg::Image();
-		image->allocateImage(mTileDimensions.x(), mTileDimensions.y(), 1, srcImage->getPixelFormat(), srcImage->getDataType());
+		image->allocateImage(mTileDimensions.x(), mTileDimensions.y(), 1, outputFormat.getPixelFormat(), outputFormat.getDataType());
+		std::memset(image->data(), 0, image->getTotalSizeInBytes());
 
-		for (int y = 0; y < mTileDimensions.y(); ++y)
+		// Draw layers from bottom to top so that upper layers overwrite lower layers
+		for (const TileMapGeneratorLayer& layer : mLayers)
 		{
-			for (int x = 0; x < mTileDimensions.x(); ++x)
+			if (layer.bounds.intersects(tileBounds))
 			{
-				Box2d destPixelBounds(osg::Vec2d(double(x) / double(mTileDimensions.x()), double(y) / double(mTileDimensions.y())),
-								  osg::Vec2d(double(x+1) / double(mTileDimensions.x()), double(y+1) / double(mTileDimensions.y())));
-
-				osg::Vec2d size = tileBounds.size();
-				destPixelBounds.minimum = tileBounds.minimum + math::componentWiseMultiply(destPixelBounds.minimum, size);
-				destPixelBounds.maximum = tileBounds.minimum + math::componentWiseMultiply(destPixelBounds.maximum, size);
-
-				bool pixelWritten = false;
-
-				for (int i = mLayers.size() - 1; i >= 0; --i)
-				{
-					const TileMapGeneratorLayer& layer = mLayers[i];
-					if (layer.bounds.intersects(destPixelBounds))
-					{
-						vis::Box2d layerPixelBounds(
-							math::componentWiseDivide(destPixelBounds.minimum - layer.bounds.minimum, layer.bounds.size()),
-							math::componentWiseDivide(destPixelBounds.maximum - layer.bounds.minimum, layer.bounds.size())
-						);
-
-						osg::ref_ptr<osg::Image> mipmap = getBestMipmap(mLayerImageMipmaps[i], layerPixelBounds.size());
-						osg::Vec4f c = sampleImage(*mipmap, layerPixelBounds.center(), mFiltering);
-						image->setColor(c, x, y);
-						pixelWritten = true;
-						break;
-					}
-				}
-
-				if (!pixelWritten)
-				{
-					image->setColor(osg::Vec4(0,0,0,0), x, y);
-				}
+				drawLayer(layer, tileBounds, *image);
 			}
 		}
 
-		std::string path = mOutputDirectory + "/" + std::to_string(tileKey.level);
-		std::filesystem::create_directory(path);
-		path += +"/" + std::to_string(tileKey.x);
-		std::filesystem::create_directory(path);
-
-		path += "/" + std::to_string(tileKey.y) + "." + mExtension;
-
-		bool verboseOutput = false;
-		if (verboseOutput)
-		{
-			printf("Writing %s\n", path.c_str());
-		}
-
-		osgDB::writeImageFile(*image, path);
+		mWriter->write(tileKey, *image);
 
 		{
 			int filesWrittenCount = mFilesWrittenCount++;
 			if ((filesWrittenCount % 1000) == 0)
 			{
-				printf("%i files written so far. Most recent file written: '%s'\n", filesWrittenCount, path.c_str());
+				printf("%i tiles written so far. Most recent tile written: %i/%i/%i\n", filesWrittenCount, tileKey.level, tileKey.x, tileKey.y);
 			}
 		}
 	}
 
-	using ImageMipmaps = std::vector<osg::ref_ptr<osg::Image>>; // Base image, followed by mipmaps in decreasing resolution
-	osg::ref_ptr<osg::Image> getBestMipmap(const ImageMipmaps& mipmaps, const osg::Vec2d& texelSizeNdc) const
+	void drawLayer(const TileMapGeneratorLayer& layer, const vis::Box2d& tileBounds, osg::Image& image) const
 	{
-		osg::Vec2d texelSizePixels = math::componentWiseMultiply(texelSizeNdc, osg::Vec2d(mipmaps.front()->s(), mipmaps.front()->t()));
+		const RasterSource& source = *layer.source;
+		const osg::Vec2d pixelSize = math::componentWiseDivide(tileBounds.size(), osg::Vec2d(mTileDimensions.x(), mTileDimensions.y()));
+
+		auto [xBegin, xEnd] = calcPixelSpan(layer.bounds.minimum.x(), layer.bounds.maximum.x(), tileBounds.minimum.x(), pixelSize.x(), mTileDimensions.x());
+		auto [yBegin, yEnd] = calcPixelSpan(layer.bounds.minimum.y(), layer.bounds.maximum.y(), tileBounds.minimum.y(), pixelSize.y(), mTileDimensions.y());
+		if (xBegin >= xEnd || yBegin >= yEnd)
+		{
+			return;
+		}
+
+		// Choose the level with texel size closest to the output pixel size
+		const osg::Vec2d layerSize = layer.bounds.size();
+		osg::Vec2d texelSizePixels(pixelSize.x() / layerSize.x() * source.getWidth(), pixelSize.y() / layerSize.y() * source.getHeight());
 		double dotProduct = texelSizePixels * texelSizePixels;
-		int level = std::clamp(int(0.5 * std::log2(dotProduct) + mMipmapBias), 0, int(mipmaps.size()) - 1);
-		return mipmaps[level];
+		int level = std::clamp(int(0.5 * std::log2(dotProduct) + mMipmapBias), 0, source.getLevelCount() - 1);
+		int levelWidth = source.getLevelWidth(level);
+		int levelHeight = source.getLevelHeight(level);
+
+		// Calculate source coordinates of destination pixel centers, in level pixels
+		double srcX0 = (tileBounds.minimum.x() + (xBegin + 0.5) * pixelSize.x() - layer.bounds.minimum.x()) / layerSize.x() * levelWidth;
+		double srcY0 = (tileBounds.minimum.y() + (yBegin + 0.5) * pixelSize.y() - layer.bounds.minimum.y()) / layerSize.y() * levelHeight;
+		double srcDx = pixelSize.x() / layerSize.x() * levelWidth;
+		double srcDy = pixelSize.y() / layerSize.y() * levelHeight;
+
+		bool nearest = (mFiltering == Filtering::NearestNeighbor);
+		ResampleColumns columns = nearest ? calcNearestColumns(levelWidth, srcX0, srcDx, xEnd - xBegin) : calcBilinearColumns(levelWidth, srcX0, srcDx, xEnd - xBegin);
+		ResampleColumns rows = nearest ? calcNearestColumns(levelHeight, srcY0, srcDy, yEnd - yBegin) : calcBilinearColumns(levelHeight, srcY0, srcDy, yEnd - yBegin);
+
+		// Read only the window of the source covered by the tile
+		RasterWindow window;
+		window.x = columns.x0.front();
+		window.y = rows.x0.front();
+		window.width = (nearest ? columns.x0.back() : columns.x1.back()) - window.x + 1;
+		window.height = (nearest ? rows.x0.back() : rows.x1.back()) - window.y + 1;
+		osg::ref_ptr<osg::Image> windowImage = source.readWindow(window, level);
+
+		offsetColumns(columns, window.x);
+		offsetColumns(rows, window.y);
+
+		if (!resampleWindowFast(*windowImage, columns, rows, mFiltering, image, xBegin, yBegin))
+		{
+			resampleWindowGeneric(*windowImage, columns, rows, mFiltering, image, xBegin, yBegin);
+		}
 	}
 
 private:
 	mutable std::unique_ptr<px_sched::Scheduler> mScheduler;
-	const std::string mOutputDirectory;
+	TileWriter* mWriter;
 	const osg::Vec2i mTileDimensions;
 	const std::vector<TileMapGeneratorLayer> mLayers;
 	const Filtering mFiltering;
-	const std::string mExtension;
 	const double mMipmapBias;
+	const uint32_t mMaxQueuedTasks;
 
 	std::vector<float> mLayerResolutions;
 	
-	std::vector<ImageMipmaps> mLayerImageMipmaps; //!< Image mipmaps for each item in mLayers
-	
 	mutable px_sched::Sync mLoadingTaskSync;
 	mutable std::atomic_int mFilesWrittenCount = 0;
 };
 
-void generateTileMap(const std::string& outputDirectory, const osg::Vec2i& tileDimensions, const std::vector<TileMapGeneratorLayer>& layers, Filtering filtering, const std::string& extension)
+TileMapGeneratorStats generateTileMap(TileWriter& writer, const osg::Vec2i& tileDimensions, const std::vector<TileMapGeneratorLayer>& layers, Filtering filtering)
 {
 	if (layers.empty())
 	{
 		throw skybolt::Exception("No tile map generator input layers layers");
 	}
 
-	if (!std::filesystem::exists(outputDirectory))
-	{
-		if (!std::filesystem::create_directories(outputDirectory))
-		{
-			throw skybolt::Exception("Could not create output directory '" + outputDirectory + "'");
-		}
-	}
-
 	Box2d bounds(osg::Vec2d(-math::piD(), -math::halfPiD()), osg::Vec2d(0, math::halfPiD()));
 	QuadTree<DefaultTile<osg::Vec2d>> treeLeft(createDefaultTile<osg::Vec2d>, QuadTreeTileKey(0, 0, 0), bounds);
 	
@@ -219,20 +294,21 @@ void generateTileMap(const std::string& outputDirectory, const osg::Vec2i& tileD
 	QuadTree<DefaultTile<osg::Vec2d>> treeRight(createDefaultTile<osg::Vec2d>, QuadTreeTileKey(0, 1, 0), bounds);
 
 	auto scheduler = std::make_unique<px_sched::Scheduler>();
-	int coreCount = std::thread::hardware_concurrency() - 1;
+	int coreCount = std::max(1, int(std::thread::hardware_concurrency()) - 1);
 	px_sched::SchedulerParams schedulerParams;
 	schedulerParams.max_running_threads = coreCount;
 	schedulerParams.num_threads = coreCount;
 	scheduler->init(schedulerParams);
 
+	auto startTime = std::chrono::steady_clock::now();
+
 	TileGenerator tileGenerator([&] {
 		TileGeneratorConfig c;
 		c.scheduler = std::move(scheduler);
-		c.outputDirectory = outputDirectory;
+		c.writer = &writer;
 		c.tileDimensions = tileDimensions;
 		c.layers = layers;
 		c.filtering = filtering;
-		c.extension = extension;
 
 		// Slight mipmap bias to sharpen images slightly. Prevents over blurring.
 		// FIXME: this should be set to 0, but it's currently -1 as a workaround for mipmaps
@@ -248,72 +324,27 @@ void generateTileMap(const std::string& outputDirectory, const osg::Vec2i& tileD
 
 	treeLeft.subdivideRecursively(treeLeft.getRoot(), predicate);
 	//treeRight.subdivideRecursively(treeRight.getRoot(), predicate);
-}
-
-static int nextPowerOfTwo(int v)
-{
-	// From https://stackoverflow.com/questions/4398711/round-to-the-nearest-power-of-two
-	v--;
-	v |= v >> 1;
-	v |= v >> 2;
-	v |= v >> 4;
-	v |= v >> 8;
-	v |= v >> 16;
-	v++;
-	return v;
-}
-
-//! Creates an copy of the image with new dimensions half the original, scaled up to next power of two.
-//! It's important the the resulting image is power of two, as non-power of two images in a mipmap chain may result
-//! in repeated resizing which introduces blurring and shifting.
-//! FIXME: scaling up to next power of two can make image appear sharper than expected for the given mipmap level.
-osg::ref_ptr<osg::Image> createNearestHalfSizePowerOfTwoCopy(const osg::Image& image)
-{
-	osg::ref_ptr<osg::Image> result(new osg::Image);
-	int outputWidth = std::max(1, nextPowerOfTwo(image.s() / 2));
-	int outputHeight = std::max(1, nextPowerOfTwo(image.t() / 2));
-	result->allocateImage(outputWidth, outputHeight, 1, image.getPixelFormat(), image.getDataType());
 
-	float scaleX = float(image.s()) / outputWidth;
-	float scaleY = float(image.t()) / outputHeight;
+	tileGenerator.waitForCompletion();
 
-	for (int y = 0; y < outputHeight; ++y)
-	{
-		for (int x = 0; x < outputWidth; ++x)
-		{
-			// Find the pixel coordinate in the source image.
-			// Note that scaleX and scaleY may be slightly larger than 2 if the source image has an odd number of pixels,
-			// in which case std::round is important to ensure the nearest coordinate is used to minimize shifting in the image.
-			int sx0 = std::min(image.s()-1, int(std::round(float(x)*scaleX)));
-			int sy0 = std::min(image.t()-1, int(std::round(float(y)*scaleY)));
-			int sx1 = std::min(image.s()-1, sx0+1);
-			int sy1 = std::min(image.t()-1, sy0+1);
-
-			osg::Vec4f c00 = image.getColor(sx0, sy0);
-			osg::Vec4f c10 = image.getColor(sx1, sy0);
-			osg::Vec4f c01 = image.getColor(sx0, sy1);
-			osg::Vec4f c11 = image.getColor(sx1, sy1);
-			osg::Vec4f color = (c00 + c10 + c01 + c11) * 0.25;
-			setPixelColor(*result, x, y, color);
-		}
-	}
-	return result;
+	TileMapGeneratorStats stats;
+	stats.tileCount = tileGenerator.getTilesWrittenCount();
+	stats.bytesWritten = writer.getBytesWritten();
+	stats.durationSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+	printf("Generated %zu tiles (%zu bytes) in %.1fs, %.1f tiles/sec\n", stats.tileCount, stats.bytesWritten, stats.durationSeconds, stats.getTilesPerSecond());
+	return stats;
 }
 
-std::vector<osg::ref_ptr<osg::Image>> generateMipmaps(const osg::ref_ptr<osg::Image>& base)
+TileMapGeneratorStats generateTileMap(const std::string& outputDirectory, const osg::Vec2i& tileDimensions, const std::vector<TileMapGeneratorLayer>& layers, Filtering filtering, const std::string& extension)
 {
-	assert(base);
-	std::vector<osg::ref_ptr<osg::Image>> result = { base };
-
-	while (true)
+	if (!std::filesystem::exists(outputDirectory))
 	{
-		const osg::Image& prevImage = *result.back();
-		int maxDim = std::max(prevImage.s(), prevImage.t());
-		if (maxDim <= 1)
+		if (!std::filesystem::create_directories(outputDirectory))
 		{
-			break;
+			throw skybolt::Exception("Could not create output directory '" + outputDirectory + "'");
 		}
-		result.push_back(createNearestHalfSizePowerOfTwoCopy(prevImage));
 	}
-	return result;
-}
\ No newline at end of file
+
+	DirectoryTileWriter writer(outputDirectory, extension);
+	return generateTileMap(writer, tileDimensions, layers, filtering);
+}
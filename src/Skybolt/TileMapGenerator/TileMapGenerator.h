@@ -6,13 +6,15 @@
 
 #pragma once
 
+#include "RasterSource.h"
+#include "TileWriter.h"
 #include <SkyboltVis/OsgBox2.h>
 #include <osg/Image>
 #include <osg/Vec2i>
 
 struct TileMapGeneratorLayer
 {
-	osg::ref_ptr<osg::Image> image;
+	RasterSourcePtr source;
 	skybolt::vis::Box2d bounds; //!< Bounds are (longitude, latitude), in radians
 };
 
@@ -22,9 +24,20 @@ enum class Filtering
 	Bilinear
 };
 
-//! Generates herichical tile map in XYZ format
+struct TileMapGeneratorStats
+{
+	size_t tileCount = 0;
+	size_t bytesWritten = 0;
+	double durationSeconds = 0;
+
+	double getTilesPerSecond() const { return durationSeconds > 0 ? double(tileCount) / durationSeconds : 0.0; }
+};
+
+//! Generates herichical tile map.
+//! Tiles are generated in parallel, with each tile reading only the windows of the layers that it intersects,
+//! so memory use is bounded by the number of tiles in flight rather than the size of the layers.
 //! @param layers are ordered from bottom to top. Upper layers appear on top of lower layers.
-void generateTileMap(const std::string& outputDirectory, const osg::Vec2i& tileDimensions, const std::vector<TileMapGeneratorLayer>& layers, Filtering filtering, const std::string& extension = "png");
+TileMapGeneratorStats generateTileMap(TileWriter& writer, const osg::Vec2i& tileDimensions, const std::vector<TileMapGeneratorLayer>& layers, Filtering filtering);
 
-//! @returns base image and mipmaps in increasing LOD order (largest to smallest images)
-std::vector<osg::ref_ptr<osg::Image>> generateMipmaps(const osg::ref_ptr<osg::Image>& base);
\ No newline at end of file
+//! Generates herichical tile map in XYZ format
+TileMapGeneratorStats generateTileMap(const std::string& outputDirectory, const osg::Vec2i& tileDimensions, const std::vector<TileMapGeneratorLayer>& layers, Filtering filtering, const std::string& extension = "png");
@@ -0,0 +1,41 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include "TileWriter.h"
+#include <SkyboltCommon/Exception.h>
+
+#include <osgDB/WriteFile>
+#include <filesystem>
+
+using namespace skybolt;
+
+DirectoryTileWriter::DirectoryTileWriter(const std::string& outputDirectory, const std::string& extension) :
+	mOutputDirectory(outputDirectory),
+	mExtension(extension)
+{
+}
+
+void DirectoryTileWriter::write(const QuadTreeTileKey& key, const osg::Image& image)
+{
+	std::string path = mOutputDirectory + "/" + std::to_string(key.level);
+	std::filesystem::create_directory(path);
+	path += +"/" + std::to_string(key.x);
+	std::filesystem::create_directory(path);
+
+	path += "/" + std::to_string(key.y) + "." + mExtension;
+
+	if (!osgDB::writeImageFile(image, path))
+	{
+		throw Exception("Could not write tile '" + path + "'");
+	}
+
+	std::error_code error;
+	uintmax_t size = std::filesystem::file_size(path, error);
+	if (!error)
+	{
+		mBytesWritten += size_t(size);
+	}
+}
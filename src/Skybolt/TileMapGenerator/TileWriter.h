@@ -0,0 +1,41 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#pragma once
+
+#include <SkyboltCommon/Math/QuadTree.h>
+#include <osg/Image>
+
+#include <atomic>
+#include <string>
+
+class TileWriter
+{
+public:
+	virtual ~TileWriter() = default;
+
+	//! @ThreadSafe
+	virtual void write(const skybolt::QuadTreeTileKey& key, const osg::Image& image) = 0;
+
+	//! @returns total number of encoded bytes written
+	size_t getBytesWritten() const { return mBytesWritten; }
+
+protected:
+	std::atomic<size_t> mBytesWritten = 0;
+};
+
+//! Writes each tile to a separate file in XYZ directory layout, i.e. {level}/{x}/{y}.{extension}
+class DirectoryTileWriter : public TileWriter
+{
+public:
+	DirectoryTileWriter(const std::string& outputDirectory, const std::string& extension);
+
+	void write(const skybolt::QuadTreeTileKey& key, const osg::Image& image) override;
+
+private:
+	const std::string mOutputDirectory;
+	const std::string mExtension;
+};
@@ -7,8 +7,10 @@
 #include "TileMapGenerator.h"
 #include <SkyboltVis/OsgImageHelpers.h>
 #include <SkyboltVis/OsgMathHelpers.h>
+#include <SkyboltCommon/Exception.h>
 #include <SkyboltCommon/Math/MathUtility.h>
 #include <osgDB/ReadFile>
+#include <functional>
 
 using namespace skybolt::vis;
 using namespace skybolt;
@@ -29,36 +31,18 @@ static Box2d getTileBounds(int x, int y, int numTilesX, int numTilesY)
 
 constexpr int defaultHeightmapSeaLevelValue = 32767;
 
-static osg::ref_ptr<osg::Image> loadRawImage16bit(const std::string& filename, int width, int height)
+static RasterSourcePtr readImageRasterSource(const std::string& filename, const std::function<void(osg::Image&)>& postProcess = nullptr)
 {
-	std::ifstream f(filename, std::ios::in | std::ios::binary);
-	if (!f.is_open())
-		throw skybolt::Exception("Unable to open file: " + filename);
-
-	osg::Image* image = new osg::Image;
-	image->allocateImage(width, height, 1, GL_LUMINANCE, GL_UNSIGNED_SHORT);
-	image->setInternalTextureFormat(GL_R16);
-
-	size_t elementCount = width * height;
-	size_t sizeBytes = elementCount * 2;
-	f.read((char*)image->data(), sizeBytes);
-
-	// Post process
-	char* p = (char*)image->data();
-	for (int i = 0; i < elementCount; ++i)
+	osg::ref_ptr<osg::Image> image = osgDB::readImageFile(filename);
+	if (!image)
 	{
-		// Convert from big to little endian
-		//std::swap(*p, *(p + 1));
-
-		// Offset sea level
-		uint16_t& value = *(uint16_t*)p;
-		value += defaultHeightmapSeaLevelValue;
-
-		p += 2;
+		throw skybolt::Exception("Unable to read image: " + filename);
 	}
-
-	f.close();
-	return image;
+	if (postProcess)
+	{
+		postProcess(*image);
+	}
+	return std::make_shared<ImageRasterSource>(image);
 }
 
 static void postProcessStrm(osg::Image& image)
@@ -94,7 +78,7 @@ static int main_blueMarble()
 			char letter = 'A' + x;
 
 			TileMapGeneratorLayer layer;
-			layer.image = osgDB::readImageFile("BlueMarble/world.200411.3x21600x21600." + std::string{letter} + std::to_string(y+1) + ".png");
+			layer.source = readImageRasterSource("BlueMarble/world.200411.3x21600x21600." + std::string{letter} + std::to_string(y+1) + ".png");
 			layer.bounds = Box2d(osg::Vec2d(minBoundX, minBoundY), osg::Vec2d(minBoundX + math::halfPiD(), minBoundY + math::halfPiD()));
 			layers.push_back(layer);
 		}
@@ -102,7 +86,7 @@ static int main_blueMarble()
 
 	{
 		TileMapGeneratorLayer layer;
-		layer.image = osgDB::readImageFile("D:/dev/tiles/combined_geodesic.jpg");
+		layer.source = readImageRasterSource("D:/dev/tiles/combined_geodesic.jpg");
 		layer.bounds = Box2d(
 			osg::Vec2d(-122.80517578125 * math::degToRadD(), 47.08508535995384 * math::degToRadD()),
 			osg::Vec2d(-121.28906250000001 * math::degToRadD(), 47.90161354142076 * math::degToRadD()));
@@ -132,7 +116,7 @@ static int main_nlcd()
 
 	// Add NLCD Seattle tile
 	TileMapGeneratorLayer layer;
-	layer.image = osgDB::readImageFile("nlcd_2011_landcover_2011_edition_2014_10_10/nlcd_2011_landcover_seattle.tif");
+	layer.source = readImageRasterSource("nlcd_2011_landcover_2011_edition_2014_10_10/nlcd_2011_landcover_seattle.tif");
 	layer.bounds = Box2d(osg::Vec2d(osg::DegreesToRadians(-124.0), osg::DegreesToRadians(45.0)), osg::Vec2d(osg::DegreesToRadians(-120.0), osg::DegreesToRadians(50.0)));
 	layers.push_back(layer);
 
@@ -180,9 +164,16 @@ static int main_dem()
 				int width = 10800;
 				int height = (y == 1 || y == 2) ? 6000 : 4800;
 
+				// Stream from disk rather than loading into memory because the GLOBE data set is large
+				RawUInt16FileRasterSourceConfig config;
+				config.filename = filename;
+				config.width = width;
+				config.height = height;
+				config.flipVertical = true;
+				config.valueOffset = defaultHeightmapSeaLevelValue;
+
 				TileMapGeneratorLayer layer;
-				layer.image = loadRawImage16bit(filename, width, height);
-				layer.image->flipVertical();
+				layer.source = std::make_shared<RawUInt16FileRasterSource>(config);
 				layer.bounds = getTileBounds(x, 3-y, 4, 4);
 				layer.bounds.minimum.y() = latitudes[3-y];
 				layer.bounds.maximum.y() = latitudes[(3-y)+1];
@@ -195,15 +186,13 @@ static int main_dem()
 	// Add STRM tiles
 	{
 		TileMapGeneratorLayer layer;
-		layer.image = osgDB::readImageFile("DEM/STRM_90m_DEM4/srtm_12_03.tif");
-		postProcessStrm(*layer.image);
+		layer.source = readImageRasterSource("DEM/STRM_90m_DEM4/srtm_12_03.tif", postProcessStrm);
 		layer.bounds = Box2d(osg::Vec2d(osg::DegreesToRadians(-125.0), osg::DegreesToRadians(45.0)), osg::Vec2d(osg::DegreesToRadians(-120.0), osg::DegreesToRadians(50.0)));
 		layers.push_back(layer);
 	}
 	{
 		TileMapGeneratorLayer layer;
-		layer.image = osgDB::readImageFile("DEM/STRM_90m_DEM4/srtm_14_06.tif");
-		postProcessStrm(*layer.image);
+		layer.source = readImageRasterSource("DEM/STRM_90m_DEM4/srtm_14_06.tif", postProcessStrm);
 		layer.bounds = Box2d(osg::Vec2d(osg::DegreesToRadians(-115.0), osg::DegreesToRadians(30.0)), osg::Vec2d(osg::DegreesToRadians(-110.0), osg::DegreesToRadians(35.0)));
 		layers.push_back(layer);
 	}
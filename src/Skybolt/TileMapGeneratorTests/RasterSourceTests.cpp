@@ -0,0 +1,246 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#define CATCH_CONFIG_MAIN
+#include <catch2/catch.hpp>
+#include <TileMapGenerator/RasterSource.h>
+
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <random>
+
+template <typename T>
+static osg::ref_ptr<osg::Image> createRandomImage(int width, int height, GLenum pixelFormat, GLenum dataType, T maxValue)
+{
+	osg::ref_ptr<osg::Image> image = new osg::Image;
+	image->allocateImage(width, height, 1, pixelFormat, dataType);
+
+	std::mt19937 generator(1);
+	std::uniform_int_distribution<int> distribution(0, int(maxValue));
+	T* values = reinterpret_cast<T*>(image->data());
+	size_t count = size_t(width) * height * osg::Image::computeNumComponents(pixelFormat);
+	for (size_t i = 0; i < count; ++i)
+	{
+		values[i] = T(distribution(generator));
+	}
+	return image;
+}
+
+template <typename T>
+static T getValue(const osg::Image& image, int x, int y, int component)
+{
+	return reinterpret_cast<const T*>(image.data(x, y))[component];
+}
+
+//! Reference implementation which averages the base level pixels covered by a single output pixel
+template <typename T>
+static double calcBoxFilteredValue(const osg::Image& base, int level, int x, int y, int component)
+{
+	const int scale = 1 << level;
+	double sum = 0;
+	int count = 0;
+	for (int baseY = y * scale; baseY < std::min(base.t(), (y + 1) * scale); ++baseY)
+	{
+		for (int baseX = x * scale; baseX < std::min(base.s(), (x + 1) * scale); ++baseX)
+		{
+			sum += double(getValue<T>(base, baseX, baseY, component));
+			++count;
+		}
+	}
+	return sum / count;
+}
+
+//! @returns number of pixel components which differ from the reference box filter
+template <typename T>
+static int countBoxFilterMismatches(const RasterSource& source, const osg::Image& base, const RasterWindow& window, int level)
+{
+	osg::ref_ptr<osg::Image> result = source.readWindow(window, level);
+	REQUIRE(result->s() == window.width);
+	REQUIRE(result->t() == window.height);
+
+	const int componentCount = osg::Image::computeNumComponents(base.getPixelFormat());
+	int mismatchCount = 0;
+	for (int y = 0; y < window.height; ++y)
+	{
+		for (int x = 0; x < window.width; ++x)
+		{
+			for (int c = 0; c < componentCount; ++c)
+			{
+				double expected = calcBoxFilteredValue<T>(base, level, window.x + x, window.y + y, c);
+				double actual = double(getValue<T>(*result, x, y, c));
+				double tolerance = std::is_integral_v<T> ? 0.5 : 1e-4 * std::max(1.0, std::abs(expected));
+				if (std::abs(actual - expected) > tolerance)
+				{
+					++mismatchCount;
+				}
+			}
+		}
+	}
+	return mismatchCount;
+}
+
+static std::vector<RasterWindow> getTestWindows(const RasterSource& source, int level)
+{
+	const int width = source.getLevelWidth(level);
+	const int height = source.getLevelHeight(level);
+	return {
+		{ 0, 0, width, height },
+		{ width / 3, height / 4, width - width / 3, height - height / 4 },
+		{ width - 1, height - 1, 1, 1 }
+	};
+}
+
+TEST_CASE("RasterSource level dimensions round up")
+{
+	osg::ref_ptr<osg::Image> image = createRandomImage<uint8_t>(45, 29, GL_LUMINANCE, GL_UNSIGNED_BYTE, 255);
+	ImageRasterSource source(image);
+
+	CHECK(source.getLevelCount() == 7);
+	CHECK(source.getLevelWidth(1) == 23);
+	CHECK(source.getLevelHeight(1) == 15);
+	CHECK(source.getLevelWidth(6) == 1);
+	CHECK(source.getLevelHeight(6) == 1);
+}
+
+TEST_CASE("Read base level windows from ImageRasterSource")
+{
+	osg::ref_ptr<osg::Image> image = createRandomImage<uint8_t>(37, 23, GL_RGB, GL_UNSIGNED_BYTE, 255);
+	ImageRasterSource source(image);
+
+	for (const RasterWindow& window : getTestWindows(source, 0))
+	{
+		osg::ref_ptr<osg::Image> result = source.readWindow(window, 0);
+		REQUIRE(result->s() == window.width);
+		REQUIRE(result->t() == window.height);
+		CHECK(result->getPixelFormat() == GL_RGB);
+		CHECK(result->getDataType() == GL_UNSIGNED_BYTE);
+
+		int mismatchCount = 0;
+		for (int y = 0; y < window.height; ++y)
+		{
+			for (int x = 0; x < window.width; ++x)
+			{
+				for (int c = 0; c < 3; ++c)
+				{
+					mismatchCount += getValue<uint8_t>(*result, x, y, c) != getValue<uint8_t>(*image, window.x + x, window.y + y, c);
+				}
+			}
+		}
+		CHECK(mismatchCount == 0);
+	}
+}
+
+TEST_CASE("Coarser RasterSource levels are box filtered from the base level")
+{
+	SECTION("uint8 RGB")
+	{
+		osg::ref_ptr<osg::Image> image = createRandomImage<uint8_t>(45, 29, GL_RGB, GL_UNSIGNED_BYTE, 255);
+		ImageRasterSource source(image);
+		for (int level = 1; level < source.getLevelCount(); ++level)
+		{
+			for (const RasterWindow& window : getTestWindows(source, level))
+			{
+				CHECK(countBoxFilterMismatches<uint8_t>(source, *image, window, level) == 0);
+			}
+		}
+	}
+
+	SECTION("uint16 luminance")
+	{
+		osg::ref_ptr<osg::Image> image = createRandomImage<uint16_t>(50, 33, GL_LUMINANCE, GL_UNSIGNED_SHORT, 65535);
+		ImageRasterSource source(image);
+		for (int level = 1; level < source.getLevelCount(); ++level)
+		{
+			for (const RasterWindow& window : getTestWindows(source, level))
+			{
+				CHECK(countBoxFilterMismatches<uint16_t>(source, *image, window, level) == 0);
+			}
+		}
+	}
+
+	SECTION("float luminance")
+	{
+		osg::ref_ptr<osg::Image> image = createRandomImage<float>(31, 40, GL_LUMINANCE, GL_FLOAT, 1000);
+		ImageRasterSource source(image);
+		for (int level = 1; level < source.getLevelCount(); ++level)
+		{
+			for (const RasterWindow& window : getTestWindows(source, level))
+			{
+				CHECK(countBoxFilterMismatches<float>(source, *image, window, level) == 0);
+			}
+		}
+	}
+}
+
+TEST_CASE("Box filtering rows wider than a read block accumulates all blocks")
+{
+	// Base level rows are wider than the maximum block size, so each output row is read in several blocks
+	osg::ref_ptr<osg::Image> image = createRandomImage<uint8_t>(1100000, 3, GL_LUMINANCE, GL_UNSIGNED_BYTE, 255);
+	ImageRasterSource source(image);
+
+	for (int level : {1, 2, 12})
+	{
+		const int width = source.getLevelWidth(level);
+		const int height = source.getLevelHeight(level);
+		CHECK(countBoxFilterMismatches<uint8_t>(source, *image, { 0, 0, width, height }, level) == 0);
+		CHECK(countBoxFilterMismatches<uint8_t>(source, *image, { width - 3, 0, 3, height }, level) == 0);
+	}
+}
+
+TEST_CASE("RawUInt16FileRasterSource matches ImageRasterSource of the same data")
+{
+	const int width = 41;
+	const int height = 27;
+	const uint16_t valueOffset = 1000;
+	osg::ref_ptr<osg::Image> image = createRandomImage<uint16_t>(width, height, GL_LUMINANCE, GL_UNSIGNED_SHORT, 60000);
+
+	// Write the image as a bottom-up, byte swapped file without the value offset
+	const std::string filename = (std::filesystem::temp_directory_path() / "RawUInt16FileRasterSourceTest.bin").string();
+	{
+		std::ofstream f(filename, std::ios::out | std::ios::binary | std::ios::trunc);
+		for (int y = height - 1; y >= 0; --y)
+		{
+			for (int x = 0; x < width; ++x)
+			{
+				uint16_t value = uint16_t(getValue<uint16_t>(*image, x, y, 0) - valueOffset);
+				value = uint16_t((value << 8) | (value >> 8));
+				f.write(reinterpret_cast<const char*>(&value), sizeof(value));
+			}
+		}
+	}
+
+	RawUInt16FileRasterSourceConfig config;
+	config.filename = filename;
+	config.width = width;
+	config.height = height;
+	config.flipVertical = true;
+	config.swapBytes = true;
+	config.valueOffset = valueOffset;
+	RawUInt16FileRasterSource source(config);
+
+	CHECK(source.getPixelFormat() == GL_LUMINANCE);
+	CHECK(source.getDataType() == GL_UNSIGNED_SHORT);
+	for (int level = 0; level < source.getLevelCount(); ++level)
+	{
+		for (const RasterWindow& window : getTestWindows(source, level))
+		{
+			CHECK(countBoxFilterMismatches<uint16_t>(source, *image, window, level) == 0);
+		}
+	}
+
+	std::filesystem::remove(filename);
+}
+
+TEST_CASE("RawUInt16FileRasterSource throws if file does not exist")
+{
+	RawUInt16FileRasterSourceConfig config;
+	config.filename = "NonExistentRasterFile.bin";
+	config.width = 1;
+	config.height = 1;
+	CHECK_THROWS(RawUInt16FileRasterSource(config));
+}
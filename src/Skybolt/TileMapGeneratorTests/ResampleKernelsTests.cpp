@@ -0,0 +1,221 @@
+/* Copyright Matthew Reid
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at https://mozilla.org/MPL/2.0/. */
+
+#include <catch2/catch.hpp>
+#include <TileMapGenerator/ResampleKernels.h>
+
+#include <cmath>
+#include <cstdint>
+#include <random>
+
+namespace {
+
+//! Single channel or interleaved multi channel raster stored row by row
+template <typename T, int ComponentCount>
+struct TestRaster
+{
+	int width;
+	int height;
+	std::vector<T> values;
+
+	const T* row(int y) const { return values.data() + size_t(y) * width * ComponentCount; }
+	T get(int x, int y, int c) const { return row(y)[x * ComponentCount + c]; }
+};
+
+template <typename T, int ComponentCount>
+TestRaster<T, ComponentCount> createRandomRaster(int width, int height, int maxValue)
+{
+	TestRaster<T, ComponentCount> raster{ width, height, {} };
+	raster.values.resize(size_t(width) * height * ComponentCount);
+
+	std::mt19937 generator(1);
+	std::uniform_int_distribution<int> distribution(0, maxValue);
+	for (T& value : raster.values)
+	{
+		value = T(distribution(generator));
+	}
+	return raster;
+}
+
+//! Reference per pixel nearest neighbor sample of the source coordinate, in pixels
+template <typename T, int ComponentCount>
+T sampleNearest(const TestRaster<T, ComponentCount>& src, double x, double y, int c)
+{
+	int ix = std::clamp(int(x * double(src.width - 1) / double(src.width)), 0, src.width - 1);
+	int iy = std::clamp(int(y * double(src.height - 1) / double(src.height)), 0, src.height - 1);
+	return src.get(ix, iy, c);
+}
+
+//! Reference per pixel bilinear sample of the source coordinate, in pixels, with edge clamping
+template <typename T, int ComponentCount>
+double sampleBilinear(const TestRaster<T, ComponentCount>& src, double x, double y, int c)
+{
+	x = std::clamp(x, 0.0, double(src.width - 1));
+	y = std::clamp(y, 0.0, double(src.height - 1));
+	int x0 = int(std::floor(x));
+	int y0 = int(std::floor(y));
+	int x1 = std::min(x0 + 1, src.width - 1);
+	int y1 = std::min(y0 + 1, src.height - 1);
+	double fx = x - x0;
+	double fy = y - y0;
+
+	double top = double(src.get(x0, y0, c)) * (1.0 - fx) + double(src.get(x1, y0, c)) * fx;
+	double bottom = double(src.get(x0, y1, c)) * (1.0 - fx) + double(src.get(x1, y1, c)) * fx;
+	return top * (1.0 - fy) + bottom * fy;
+}
+
+struct ResampleSpan
+{
+	double srcX0;
+	double srcY0;
+	double srcDx;
+	double srcDy;
+	int width;
+	int height;
+};
+
+//! Spans which minify, magnify and extend beyond the source edges
+const std::vector<ResampleSpan> testSpans = {
+	{ 0.5, 0.5, 1.0, 1.0, 37, 23 },
+	{ 0.25, 0.75, 0.37, 0.41, 64, 48 },
+	{ 3.5, 2.5, 2.3, 1.7, 15, 12 },
+	{ -2.0, -1.5, 0.9, 1.3, 50, 25 }
+};
+
+template <typename T, int ComponentCount>
+std::vector<T> resampleNearest(const TestRaster<T, ComponentCount>& src, const ResampleSpan& span)
+{
+	ResampleColumns columns = calcNearestColumns(src.width, span.srcX0, span.srcDx, span.width);
+	ResampleColumns rows = calcNearestColumns(src.height, span.srcY0, span.srcDy, span.height);
+
+	std::vector<T> dst(size_t(span.width) * span.height * ComponentCount);
+	for (int r = 0; r < span.height; ++r)
+	{
+		resampleRowNearest<T, ComponentCount>(src.row(rows.x0[r]), columns, dst.data() + size_t(r) * span.width * ComponentCount);
+	}
+	return dst;
+}
+
+template <typename T, int ComponentCount>
+std::vector<T> resampleBilinear(const TestRaster<T, ComponentCount>& src, const ResampleSpan& span)
+{
+	ResampleColumns columns = calcBilinearColumns(src.width, span.srcX0, span.srcDx, span.width);
+	ResampleColumns rows = calcBilinearColumns(src.height, span.srcY0, span.srcDy, span.height);
+
+	std::vector<T> dst(size_t(span.width) * span.height * ComponentCount);
+	for (int r = 0; r < span.height; ++r)
+	{
+		resampleRowBilinear<T, ComponentCount>(src.row(rows.x0[r]), src.row(rows.x1[r]), rows.fraction[r], columns, dst.data() + size_t(r) * span.width * ComponentCount);
+	}
+	return dst;
+}
+
+//! @returns number of pixel components which differ from the reference per pixel nearest neighbor sampler
+template <typename T, int ComponentCount>
+int countNearestMismatches(const TestRaster<T, ComponentCount>& src)
+{
+	int mismatchCount = 0;
+	for (const ResampleSpan& span : testSpans)
+	{
+		std::vector<T> dst = resampleNearest(src, span);
+		for (int y = 0; y < span.height; ++y)
+		{
+			for (int x = 0; x < span.width; ++x)
+			{
+				for (int c = 0; c < ComponentCount; ++c)
+				{
+					T expected = sampleNearest(src, span.srcX0 + span.srcDx * x, span.srcY0 + span.srcDy * y, c);
+					mismatchCount += dst[(size_t(y) * span.width + x) * ComponentCount + c] != expected;
+				}
+			}
+		}
+	}
+	return mismatchCount;
+}
+
+//! @returns number of pixel components which differ from the reference per pixel bilinear sampler
+template <typename T, int ComponentCount>
+int countBilinearMismatches(const TestRaster<T, ComponentCount>& src)
+{
+	int mismatchCount = 0;
+	for (const ResampleSpan& span : testSpans)
+	{
+		std::vector<T> dst = resampleBilinear(src, span);
+		for (int y = 0; y < span.height; ++y)
+		{
+			for (int x = 0; x < span.width; ++x)
+			{
+				for (int c = 0; c < ComponentCount; ++c)
+				{
+					double expected = sampleBilinear(src, span.srcX0 + span.srcDx * x, span.srcY0 + span.srcDy * y, c);
+					double actual = double(dst[(size_t(y) * span.width + x) * ComponentCount + c]);
+					// Kernels interpolate in single precision and integer kernels also round to nearest
+					double tolerance = (std::is_integral_v<T> ? 0.5 : 0.0) + 1e-5 * std::max(1.0, std::abs(expected));
+					mismatchCount += std::abs(actual - expected) > tolerance;
+				}
+			}
+		}
+	}
+	return mismatchCount;
+}
+
+} // namespace
+
+TEST_CASE("Nearest neighbor row kernel matches per pixel sampling")
+{
+	CHECK(countNearestMismatches(createRandomRaster<uint8_t, 3>(29, 17, 255)) == 0);
+	CHECK(countNearestMismatches(createRandomRaster<uint16_t, 1>(29, 17, 65535)) == 0);
+	CHECK(countNearestMismatches(createRandomRaster<float, 4>(29, 17, 1000)) == 0);
+}
+
+TEST_CASE("Bilinear row kernel matches per pixel sampling")
+{
+	CHECK(countBilinearMismatches(createRandomRaster<uint8_t, 3>(29, 17, 255)) == 0);
+	CHECK(countBilinearMismatches(createRandomRaster<uint16_t, 1>(29, 17, 65535)) == 0);
+	CHECK(countBilinearMismatches(createRandomRaster<float, 4>(29, 17, 1000)) == 0);
+}
+
+TEST_CASE("Row kernels give the same result on a window of the source after offsetting columns")
+{
+	TestRaster<uint16_t, 1> src = createRandomRaster<uint16_t, 1>(40, 30, 65535);
+	const ResampleSpan span = { 10.5, 8.5, 0.6, 0.45, 20, 20 };
+
+	for (bool nearest : {true, false})
+	{
+		ResampleColumns columns = nearest ? calcNearestColumns(src.width, span.srcX0, span.srcDx, span.width) : calcBilinearColumns(src.width, span.srcX0, span.srcDx, span.width);
+		ResampleColumns rows = nearest ? calcNearestColumns(src.height, span.srcY0, span.srcDy, span.height) : calcBilinearColumns(src.height, span.srcY0, span.srcDy, span.height);
+
+		// Copy the window covered by the span, as TileMapGenerator does when reading from a RasterSource
+		const int windowX = columns.x0.front();
+		const int windowY = rows.x0.front();
+		TestRaster<uint16_t, 1> window{ (nearest ? columns.x0.back() : columns.x1.back()) - windowX + 1, (nearest ? rows.x0.back() : rows.x1.back()) - windowY + 1, {} };
+		for (int y = 0; y < window.height; ++y)
+		{
+			const uint16_t* srcRow = src.row(windowY + y) + windowX;
+			window.values.insert(window.values.end(), srcRow, srcRow + window.width);
+		}
+
+		std::vector<uint16_t> expected = nearest ? resampleNearest(src, span) : resampleBilinear(src, span);
+
+		offsetColumns(columns, windowX);
+		offsetColumns(rows, windowY);
+
+		std::vector<uint16_t> actual(expected.size());
+		for (int r = 0; r < span.height; ++r)
+		{
+			uint16_t* dstRow = actual.data() + size_t(r) * span.width;
+			if (nearest)
+			{
+				resampleRowNearest<uint16_t, 1>(window.row(rows.x0[r]), columns, dstRow);
+			}
+			else
+			{
+				resampleRowBilinear<uint16_t, 1>(window.row(rows.x0[r]), window.row(rows.x1[r]), rows.fraction[r], columns, dstRow);
+			}
+		}
+		CHECK(actual == expected);
+	}
+}
@@ -226,7 +226,7 @@ int main(int argc, char *argv[])
 
 //#define SHOW_STATS
 #ifdef SHOW_STATS
-		engineRoot->systemRegistry->push_back(std::make_shared<StatsDisplaySystem>(&visRoot->getViewer(), window->getView(), overlayCamera));
+		engineRoot->systemRegistry->push_back(std::make_shared<StatsDisplaySystem>(&visRoot->getViewer(), window->getView(), overlayCamera, &engineRoot->stats));
 #endif
 
 		// Create entities
@@ -8,6 +8,8 @@
 #include <SkyboltQt/ContextAction/CreateContextActions.h>
 #include <SkyboltQt/Engine/EngineSettingsSerialization.h>
 #include <SkyboltQt/Engine/FindPython.h>
+#include <SkyboltQt/Engine/RenderRequestEventFilter.h>
+#include <SkyboltQt/Engine/RenderScheduler.h>
 #include <SkyboltQt/Engine/SimUpdater.h>
 #include <SkyboltQt/Input/ViewportInputSystem.h>
 #include <SkyboltQt/Input/InputPlatformQt.h>
@@ -48,6 +50,7 @@
 #include <SkyboltEngine/SimVisBinding/ForcesVisBinding.h>
 #include <SkyboltEngine/SimVisBinding/SimVisSystem.h>
 #include <SkyboltEngine/SimVisBinding/VisNameLabels.h>
+#include <SkyboltEngine/UpdateLoop/UpdateLoopUtility.h>
 #include <SkyboltSim/World.h>
 #include <SkyboltVis/Scene.h>
 #include <SkyboltVis/VisRoot.h>
@@ -59,13 +62,17 @@
 
 #include <QApplication>
 #include <QDialog>
+#include <QLabel>
 #include <QMenu>
 #include <QMenuBar>
 #include <QMessageBox>
 #include <QPushButton>
 #include <QSplashScreen>
+#include <QStatusBar>
 #include <QVBoxLayout>
 
+#include <chrono>
+
 using namespace skybolt;
 
 static vis::VisRootPtr createVisRoot(const EngineRoot& engineRoot)
@@ -319,20 +326,37 @@ public:
 
 		// Begin update timer
 		mSimUpdater = std::make_unique<SimUpdater>(mEngineRoot);
+		mSimUpdater->setPipelined(getMainLoopConfig(mEngineRoot->engineSettings).pipelined);
+
+		mRenderScheduler = std::make_shared<RenderScheduler>(getRenderSchedulerConfig(mEngineRoot->engineSettings));
+		installEventFilter(new RenderRequestEventFilter([scheduler = mRenderScheduler] { scheduler->requestRender(); }, this));
+
+		createAndStartIntervalDtTimer(10, mMainWindow.get(), [this, requestedTimeRate, actualTimeRate, viewportWidget, wallTime = sim::SecondsD(0), sceneStateVersion = uint64_t(0)] (sim::SecondsD wallDt) mutable {
+			auto updateStartTime = std::chrono::steady_clock::now();
+			wallTime += wallDt;
 
-		createAndStartIntervalDtTimer(10, mMainWindow.get(), [this, requestedTimeRate, actualTimeRate, viewportWidget] (sim::SecondsD wallDt) {
-			mSimUpdater->setRequestedTimeRate(requestedTimeRate->get());
-			mSimUpdater->update(wallDt);
-			
-			actualTimeRate->set(mSimUpdater->getActualTimeRate());
 			viewportWidget->update();
 
 			if (mShaderSourceFileChangeMonitor)
 			{
 				mShaderSourceFileChangeMonitor->update();
+				mRenderScheduler->requestRender();
 			}
 
-			mVisRoot->render();
+			// The scene state version is calculated after the previous update, so the decision to render
+			// does not read sim state which the dynamics may be writing on the worker thread in pipelined mode.
+			mSimUpdater->setRequestedTimeRate(requestedTimeRate->get());
+			mSimUpdater->update(wallDt, [&] {
+				if (mRenderScheduler->shouldRender(wallTime, sceneStateVersion, isSceneLoading(*mEngineRoot)))
+				{
+					mVisRoot->render();
+				}
+			});
+			sceneStateVersion = calcSceneStateVersion(*mEngineRoot);
+
+			actualTimeRate->set(mSimUpdater->getActualTimeRate());
+
+			mRenderScheduler->addBusyTime(wallTime, std::chrono::duration<double>(std::chrono::steady_clock::now() - updateStartTime).count());
 		});
 
 		// Load default window state
@@ -383,6 +407,11 @@ protected:
 			action->setCheckable(true);
 			QObject::connect(action, &QAction::triggered, [this](bool visible) { setViewportTextureDisplayEnabled(visible); });
 		}
+		{
+			QAction* action = devMenu->addAction("Render Stats");
+			action->setCheckable(true);
+			QObject::connect(action, &QAction::triggered, [this](bool visible) { setRenderStatsEnabled(visible); });
+		}
 		{
 			QAction* action = devMenu->addAction("Live Shader Editing");
 			action->setCheckable(true);
@@ -410,7 +439,7 @@ protected:
 		{
 			if (!mStatsDisplaySystem)
 			{
-				mStatsDisplaySystem = std::make_shared<StatsDisplaySystem>(&mVisRoot->getViewer(), mWindow->getView(), mViewport->getFinalRenderTarget()->getOsgCamera());
+				mStatsDisplaySystem = std::make_shared<StatsDisplaySystem>(&mVisRoot->getViewer(), mWindow->getView(), mViewport->getFinalRenderTarget()->getOsgCamera(), &mEngineRoot->stats);
 				mStatsDisplaySystem->setVisible(false);
 				mEngineRoot->systemRegistry->push_back(mStatsDisplaySystem);
 			}
@@ -436,6 +465,28 @@ protected:
 		}
 	}
 
+	//! Shows how often frames are rendered and how busy the main thread is, e.g. to check that an idle editor is not rendering
+	void setRenderStatsEnabled(bool enabled)
+	{
+		if (enabled && !mRenderStatsLabel)
+		{
+			mRenderStatsLabel = new QLabel(mMainWindow.get());
+			mMainWindow->statusBar()->addPermanentWidget(mRenderStatsLabel);
+			createAndStartIntervalTimer(500, mRenderStatsLabel, [this] {
+				const RenderSchedulerStats& stats = mRenderScheduler->getStats();
+				mRenderStatsLabel->setText(QString("Rendering %1 fps, main thread %2% busy, %3 frames skipped")
+					.arg(stats.renderedFramesPerSecond, 0, 'f', 1)
+					.arg(stats.busyFraction * 100.0, 0, 'f', 1)
+					.arg(stats.skippedFrameCount));
+			});
+		}
+		else if (!enabled && mRenderStatsLabel)
+		{
+			delete mRenderStatsLabel;
+			mRenderStatsLabel = nullptr;
+		}
+	}
+
 	void setLiveShaderEditingEnabled(bool enabled)
 	{
 		mShaderSourceFileChangeMonitor.reset();
@@ -463,6 +514,7 @@ protected:
 private:
 	vis::VisRootPtr mVisRoot;
 	std::unique_ptr<SimUpdater> mSimUpdater;
+	std::shared_ptr<RenderScheduler> mRenderScheduler;
 	std::unique_ptr<MainWindow> mMainWindow;
 	std::shared_ptr<EngineRoot> mEngineRoot;
 	std::unique_ptr<QSplashScreen> mSplashScreen;
@@ -474,6 +526,7 @@ private:
 	std::shared_ptr<skybolt::VisSelectionIcons> mVisSelectionIcons;
 	std::shared_ptr<skybolt::VisNameLabels> mVisNameLabels;
 	std::shared_ptr<skybolt::ForcesVisBinding> mForcesVisBinding;
+	QLabel* mRenderStatsLabel = nullptr;
 };
 
 int main(int argc, char *argv[])